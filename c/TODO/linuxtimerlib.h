@@ -1,2 +0,0 @@
-// By Srikanta Sing
-// https://qnaplus.com/implement-periodic-timer-linux/
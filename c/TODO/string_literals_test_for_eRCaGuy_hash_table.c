@@ -20,7 +20,7 @@ g++ -Wall -Wextra -Werror -O3 -std=c++17 string_literals_test_for_eRCaGuy_hash_t
 ```
 
 References:
-1.
+1. The finished library: "eRCaGuy_hello_world/cpp/eRCaGuy_hash_table.h"
 
 */
 
@@ -0,0 +1,536 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+*/
+
+// Required for `clock_gettime()` and the `timerfd`, `epoll`, and `eventfd` Linux APIs with
+// `-std=c17`.
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+// Local includes
+#include "linuxtimerlib.h"
+
+// Linux includes
+#include <pthread.h>
+#include <sys/epoll.h>    // `epoll_create1()`, `epoll_ctl()`, `epoll_wait()`
+#include <sys/eventfd.h>  // `eventfd()`
+#include <sys/resource.h> // `getrlimit()`, `setrlimit()`
+#include <sys/timerfd.h>  // `timerfd_create()`, `timerfd_settime()`
+#include <unistd.h>       // `read()`, `write()`, `close()`
+
+// C includes
+#include <errno.h>  // `errno`
+#include <stdio.h>  // `printf()`
+#include <stdlib.h> // `calloc()`, `free()`
+#include <string.h> // `strerror()`
+#include <time.h>   // `clock_gettime()`
+
+#define NS_PER_SEC (1000000000ULL)
+/// Max number of ready timers to handle per `epoll_wait()` call
+#define MAX_EVENTS_PER_WAIT 64
+/// `epoll_event.data.u64` value which identifies the shutdown `eventfd` rather than a timer
+#define SHUTDOWN_EVENT_ID UINT64_MAX
+
+struct linuxtimer_s
+{
+    int fd;
+    size_t index;
+    /// Incremented each time this timer slot is stopped, so that stale events and queued callbacks
+    /// for a previous user of this slot can be detected and ignored
+    uint32_t generation;
+    bool in_use;
+
+    linuxtimer_type_t type;
+    uint64_t interval_ns;
+    uint64_t first_expiration_ns;
+    linuxtimer_callback_t callback;
+    void* user_data;
+
+    /// True while a job for this timer slot is queued or running in a worker, including a stale
+    /// job left over from a stopped timer, which a new timer in the same slot waits for. So each
+    /// slot has at most one job in the ring at a time.
+    bool dispatch_pending;
+
+    /// Statistics; accessed atomically
+    uint64_t expiration_cnt;
+    uint64_t missed_cnt;
+};
+
+/// A callback waiting in the worker queue
+typedef struct job_s
+{
+    linuxtimer_t* timer;
+    uint32_t generation;
+    /// Copied from the timer when the job is queued, since the timer slot may be stopped and
+    /// reused for another timer before the job runs
+    linuxtimer_callback_t callback;
+    linuxtimer_event_t event;
+} job_t;
+
+struct linuxtimerlib_s
+{
+    int epoll_fd;
+    int shutdown_fd;
+    bool shutdown;
+
+    /// Protects everything below, and the `in_use`, `generation`, and `dispatch_pending` members
+    /// of each timer
+    pthread_mutex_t mutex;
+    pthread_cond_t job_available;
+
+    linuxtimer_t* timers;
+    size_t max_timers;
+
+    /// Ring buffer of jobs for the workers. Since each timer slot has at most one job pending at a
+    /// time (see `dispatch_pending`), it can never hold more than `max_timers` jobs, so it never
+    /// overflows.
+    job_t* jobs;
+    size_t job_head;
+    size_t job_count;
+
+    pthread_t event_loop_thread;
+    bool event_loop_thread_started;
+    pthread_t* worker_threads;
+    size_t num_workers;
+    size_t num_workers_started;
+};
+
+
+static uint64_t get_monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static struct timespec ns_to_timespec(uint64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns/NS_PER_SEC);
+    ts.tv_nsec = (long)(ns%NS_PER_SEC);
+    return ts;
+}
+
+static inline uint64_t make_event_id(const linuxtimer_t* timer)
+{
+    return ((uint64_t)timer->index << 32) | timer->generation;
+}
+
+/// Make sure we may open at least `num_fds` more file descriptors, by raising the soft limit up to
+/// the hard limit if needed.
+static void raise_open_file_limit(size_t num_fds)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+    {
+        return;
+    }
+
+    if (limit.rlim_cur < num_fds && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &limit) == -1)
+        {
+            printf("WARNING: failed to raise the open file limit. errno = %i: %s\n",
+                errno, strerror(errno));
+        }
+    }
+}
+
+static void* worker_run(void* argument)
+{
+    linuxtimerlib_t* lib = (linuxtimerlib_t*)argument;
+
+    pthread_mutex_lock(&lib->mutex);
+    while (true)
+    {
+        while (lib->job_count == 0 && !lib->shutdown)
+        {
+            pthread_cond_wait(&lib->job_available, &lib->mutex);
+        }
+        if (lib->shutdown)
+        {
+            break;
+        }
+
+        job_t job = lib->jobs[lib->job_head];
+        lib->job_head = (lib->job_head + 1) % lib->max_timers;
+        lib->job_count--;
+
+        // Skip the job if its timer was stopped since it was queued.
+        if (!job.timer->in_use || job.timer->generation != job.generation)
+        {
+            job.timer->dispatch_pending = false;
+            continue;
+        }
+
+        pthread_mutex_unlock(&lib->mutex);
+        job.callback(&job.event);
+        pthread_mutex_lock(&lib->mutex);
+
+        // Even if the timer was stopped, and its slot reused, while the callback ran: the flag
+        // belongs to the slot, and this was the slot's one job.
+        job.timer->dispatch_pending = false;
+    }
+    pthread_mutex_unlock(&lib->mutex);
+
+    return NULL;
+}
+
+/// Handle one ready timer: read its expiration count and dispatch its callback.
+static void handle_timer_event(linuxtimerlib_t* lib, uint64_t event_id)
+{
+    size_t index = (size_t)(event_id >> 32);
+    uint32_t generation = (uint32_t)event_id;
+    if (index >= lib->max_timers)
+    {
+        return;
+    }
+    linuxtimer_t* timer = &lib->timers[index];
+
+    pthread_mutex_lock(&lib->mutex);
+
+    // Ignore events for timers which were stopped after `epoll_wait()` returned.
+    if (!timer->in_use || timer->generation != generation)
+    {
+        pthread_mutex_unlock(&lib->mutex);
+        return;
+    }
+
+    uint64_t expirations;
+    ssize_t num_bytes = read(timer->fd, &expirations, sizeof(expirations));
+    if (num_bytes != (ssize_t)sizeof(expirations))
+    {
+        // EAGAIN: another expiration was already read; nothing to do
+        pthread_mutex_unlock(&lib->mutex);
+        return;
+    }
+
+    uint64_t expiration_cnt =
+        __atomic_add_fetch(&timer->expiration_cnt, expirations, __ATOMIC_RELAXED);
+    linuxtimer_event_t event =
+    {
+        .timer = timer,
+        .user_data = timer->user_data,
+        .expirations = expirations,
+        .expected_time_ns = timer->first_expiration_ns + (expiration_cnt - 1)*timer->interval_ns,
+    };
+
+    if (lib->num_workers == 0)
+    {
+        // Read the callback, and charge the missed expirations, under the lock, just like for a
+        // job below: once the lock is released, the timer may be stopped, and its slot reused by
+        // a new timer.
+        linuxtimer_callback_t callback = timer->callback;
+        __atomic_add_fetch(&timer->missed_cnt, expirations - 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&lib->mutex);
+        callback(&event);
+        return;
+    }
+
+    if (timer->dispatch_pending)
+    {
+        // The previous callback for this timer (or a stale job for the previous timer in this
+        // slot) hasn't finished yet.
+        __atomic_add_fetch(&timer->missed_cnt, expirations, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_add_fetch(&timer->missed_cnt, expirations - 1, __ATOMIC_RELAXED);
+        size_t tail = (lib->job_head + lib->job_count) % lib->max_timers;
+        lib->jobs[tail].timer = timer;
+        lib->jobs[tail].generation = generation;
+        lib->jobs[tail].callback = timer->callback;
+        lib->jobs[tail].event = event;
+        lib->job_count++;
+        timer->dispatch_pending = true;
+        pthread_cond_signal(&lib->job_available);
+    }
+
+    pthread_mutex_unlock(&lib->mutex);
+}
+
+static void* event_loop_run(void* argument)
+{
+    linuxtimerlib_t* lib = (linuxtimerlib_t*)argument;
+    struct epoll_event events[MAX_EVENTS_PER_WAIT];
+
+    while (true)
+    {
+        int num_events = epoll_wait(lib->epoll_fd, events, MAX_EVENTS_PER_WAIT, -1);
+        if (num_events == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            printf("ERROR: `epoll_wait()` failed. errno = %i: %s\n", errno, strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            if (events[i].data.u64 == SHUTDOWN_EVENT_ID)
+            {
+                return NULL;
+            }
+            handle_timer_event(lib, events[i].data.u64);
+        }
+    }
+
+    return NULL;
+}
+
+linuxtimerlib_t* linuxtimerlib_create(size_t max_timers, size_t num_workers)
+{
+    if (max_timers == 0 || max_timers > UINT32_MAX)
+    {
+        printf("ERROR: invalid `max_timers`.\n");
+        return NULL;
+    }
+
+    linuxtimerlib_t* lib = (linuxtimerlib_t*)calloc(1, sizeof(*lib));
+    if (lib == NULL)
+    {
+        printf("ERROR: out of memory\n");
+        return NULL;
+    }
+    lib->epoll_fd = -1;
+    lib->shutdown_fd = -1;
+    pthread_mutex_init(&lib->mutex, NULL);
+    pthread_cond_init(&lib->job_available, NULL);
+    lib->max_timers = max_timers;
+    lib->num_workers = num_workers;
+
+    lib->timers = (linuxtimer_t*)calloc(max_timers, sizeof(*lib->timers));
+    lib->jobs = (job_t*)calloc(max_timers, sizeof(*lib->jobs));
+    lib->worker_threads = (pthread_t*)calloc(num_workers > 0 ? num_workers : 1,
+        sizeof(*lib->worker_threads));
+    if (lib->timers == NULL || lib->jobs == NULL || lib->worker_threads == NULL)
+    {
+        printf("ERROR: out of memory\n");
+        linuxtimerlib_destroy(lib);
+        return NULL;
+    }
+    for (size_t i = 0; i < max_timers; i++)
+    {
+        lib->timers[i].fd = -1;
+        lib->timers[i].index = i;
+    }
+
+    raise_open_file_limit(max_timers + 64);
+
+    lib->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    lib->shutdown_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (lib->epoll_fd == -1 || lib->shutdown_fd == -1)
+    {
+        printf("ERROR: failed to create the epoll instance or eventfd. errno = %i: %s\n",
+            errno, strerror(errno));
+        linuxtimerlib_destroy(lib);
+        return NULL;
+    }
+
+    struct epoll_event shutdown_event;
+    shutdown_event.events = EPOLLIN;
+    shutdown_event.data.u64 = SHUTDOWN_EVENT_ID;
+    if (epoll_ctl(lib->epoll_fd, EPOLL_CTL_ADD, lib->shutdown_fd, &shutdown_event) == -1)
+    {
+        printf("ERROR: `epoll_ctl()` failed. errno = %i: %s\n", errno, strerror(errno));
+        linuxtimerlib_destroy(lib);
+        return NULL;
+    }
+
+    int retcode = pthread_create(&lib->event_loop_thread, NULL, event_loop_run, lib);
+    if (retcode != 0)
+    {
+        printf("ERROR: failed to create the event loop pthread. retcode = %i: %s\n",
+            retcode, strerror(retcode));
+        linuxtimerlib_destroy(lib);
+        return NULL;
+    }
+    lib->event_loop_thread_started = true;
+
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        retcode = pthread_create(&lib->worker_threads[i], NULL, worker_run, lib);
+        if (retcode != 0)
+        {
+            printf("ERROR: failed to create worker pthread %zu. retcode = %i: %s\n",
+                i, retcode, strerror(retcode));
+            linuxtimerlib_destroy(lib);
+            return NULL;
+        }
+        lib->num_workers_started++;
+    }
+
+    return lib;
+}
+
+void linuxtimerlib_destroy(linuxtimerlib_t* lib)
+{
+    if (lib == NULL)
+    {
+        return;
+    }
+
+    // Stop the threads.
+    pthread_mutex_lock(&lib->mutex);
+    lib->shutdown = true;
+    pthread_cond_broadcast(&lib->job_available);
+    pthread_mutex_unlock(&lib->mutex);
+
+    if (lib->event_loop_thread_started)
+    {
+        uint64_t one = 1;
+        if (write(lib->shutdown_fd, &one, sizeof(one)) != (ssize_t)sizeof(one))
+        {
+            printf("ERROR: failed to signal the event loop to shut down. errno = %i: %s\n",
+                errno, strerror(errno));
+        }
+        pthread_join(lib->event_loop_thread, NULL);
+    }
+    for (size_t i = 0; i < lib->num_workers_started; i++)
+    {
+        pthread_join(lib->worker_threads[i], NULL);
+    }
+
+    // Close all file descriptors.
+    if (lib->timers != NULL)
+    {
+        for (size_t i = 0; i < lib->max_timers; i++)
+        {
+            if (lib->timers[i].fd != -1)
+            {
+                close(lib->timers[i].fd);
+            }
+        }
+    }
+    if (lib->shutdown_fd != -1)
+    {
+        close(lib->shutdown_fd);
+    }
+    if (lib->epoll_fd != -1)
+    {
+        close(lib->epoll_fd);
+    }
+
+    pthread_cond_destroy(&lib->job_available);
+    pthread_mutex_destroy(&lib->mutex);
+    free(lib->timers);
+    free(lib->jobs);
+    free(lib->worker_threads);
+    free(lib);
+}
+
+linuxtimer_t* linuxtimer_start(linuxtimerlib_t* lib, linuxtimer_type_t type, uint64_t initial_ns,
+    uint64_t interval_ns, linuxtimer_callback_t callback, void* user_data)
+{
+    if (lib == NULL || callback == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return NULL;
+    }
+
+    if (initial_ns == 0 || (type == LINUXTIMER_TYPE_PERIODIC && interval_ns == 0))
+    {
+        printf("ERROR: `initial_ns` and, for periodic timers, `interval_ns` must be > 0.\n");
+        return NULL;
+    }
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1)
+    {
+        printf("ERROR: `timerfd_create()` failed. errno = %i: %s\n", errno, strerror(errno));
+        return NULL;
+    }
+
+    // Reserve a free timer slot.
+    pthread_mutex_lock(&lib->mutex);
+    linuxtimer_t* timer = NULL;
+    for (size_t i = 0; i < lib->max_timers; i++)
+    {
+        if (!lib->timers[i].in_use)
+        {
+            timer = &lib->timers[i];
+            break;
+        }
+    }
+    if (timer == NULL)
+    {
+        pthread_mutex_unlock(&lib->mutex);
+        close(fd);
+        printf("ERROR: all %zu timers are in use.\n", lib->max_timers);
+        return NULL;
+    }
+
+    timer->fd = fd;
+    timer->in_use = true;
+    timer->type = type;
+    timer->interval_ns = type == LINUXTIMER_TYPE_PERIODIC ? interval_ns : 0;
+    timer->callback = callback;
+    timer->user_data = user_data;
+    // NB: `dispatch_pending` is left as is, since a stale job from the previous timer in this slot
+    // may still be in the ring.
+    timer->expiration_cnt = 0;
+    timer->missed_cnt = 0;
+
+    // Use an absolute first expiration time, so that the expected time of every expiration is
+    // known exactly.
+    timer->first_expiration_ns = get_monotonic_ns() + initial_ns;
+    struct itimerspec timer_spec;
+    timer_spec.it_value = ns_to_timespec(timer->first_expiration_ns);
+    timer_spec.it_interval = ns_to_timespec(timer->interval_ns);
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = make_event_id(timer);
+
+    if (epoll_ctl(lib->epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1
+        || timerfd_settime(fd, TFD_TIMER_ABSTIME, &timer_spec, NULL) == -1)
+    {
+        printf("ERROR: failed to start the timer. errno = %i: %s\n", errno, strerror(errno));
+        close(fd);
+        timer->fd = -1;
+        timer->in_use = false;
+        timer->generation++;
+        timer = NULL;
+    }
+
+    pthread_mutex_unlock(&lib->mutex);
+    return timer;
+}
+
+void linuxtimer_stop(linuxtimerlib_t* lib, linuxtimer_t* timer)
+{
+    if (lib == NULL || timer == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    pthread_mutex_lock(&lib->mutex);
+    if (timer->in_use)
+    {
+        // Closing the fd also removes it from the epoll instance.
+        close(timer->fd);
+        timer->fd = -1;
+        timer->in_use = false;
+        // `dispatch_pending` stays set until a worker takes any queued job off the ring.
+        timer->generation++;
+    }
+    pthread_mutex_unlock(&lib->mutex);
+}
+
+uint64_t linuxtimer_get_expiration_cnt(const linuxtimer_t* timer)
+{
+    return timer == NULL ? 0 : __atomic_load_n(&timer->expiration_cnt, __ATOMIC_RELAXED);
+}
+
+uint64_t linuxtimer_get_missed_cnt(const linuxtimer_t* timer)
+{
+    return timer == NULL ? 0 : __atomic_load_n(&timer->missed_cnt, __ATOMIC_RELAXED);
+}
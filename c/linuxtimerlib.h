@@ -0,0 +1,108 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A Linux timer library for many periodic and one-shot timers per process, built on `timerfd` timers
+(`timerfd_create()` with `CLOCK_MONOTONIC`) and a single `epoll` event loop thread.
+
+Originally inspired by the periodic timer by Srikanta Sing here:
+https://qnaplus.com/implement-periodic-timer-linux/
+
+Why `timerfd` + `epoll` instead of POSIX `timer_create()` timers with signals:
+1. No signal handlers: the expirations are delivered as readable file descriptors, so callbacks
+   run in normal thread context, where any function may be called (not just async-signal-safe
+   ones), and no other thread's system calls get interrupted with `EINTR`.
+2. It scales: one `epoll_wait()` call waits on thousands of timers at once.
+3. Missed expirations are counted by the kernel: `read()`ing a `timerfd` returns the number of
+   expirations since the last read, so a slow callback shows up as `expirations > 1` rather than
+   as silently lost signals.
+
+How it works:
+1. Each timer owns one `timerfd`, registered with the library's `epoll` instance.
+2. The event loop thread waits in `epoll_wait()`, reads each ready `timerfd`, and dispatches the
+   timer's callback either directly (with 0 workers) or to a small pool of worker threads (with
+   N > 0 workers), via a bounded queue.
+3. A timer's callback never runs concurrently with itself: if a timer expires again while its
+   previous callback is still queued or running, the new expirations are counted as missed.
+
+Note: each timer uses one file descriptor. For thousands of timers, you may need to raise the
+open file limit (`ulimit -n`); `linuxtimerlib_create()` raises the soft limit to the hard limit if
+needed.
+
+STATUS: works!
+
+To compile and run:
+- See "linuxtimerlib_example.c" and "linuxtimerlib_latency_benchmark.c" as examples.
+
+References:
+1. https://man7.org/linux/man-pages/man2/timerfd_create.2.html
+1. https://man7.org/linux/man-pages/man7/epoll.7.html
+1. https://man7.org/linux/man-pages/man2/eventfd.2.html
+1. https://qnaplus.com/implement-periodic-timer-linux/
+
+*/
+
+#pragma once
+
+// C includes
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stddef.h>  // For `size_t`
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+
+
+typedef enum linuxtimer_type_e
+{
+    /// Expire once, `initial_ns` after the timer is started
+    LINUXTIMER_TYPE_ONE_SHOT = 0,
+    /// Expire first `initial_ns` after the timer is started, then every `interval_ns`
+    LINUXTIMER_TYPE_PERIODIC,
+} linuxtimer_type_t;
+
+/// Opaque timer object, owned by the library
+typedef struct linuxtimer_s linuxtimer_t;
+/// Opaque library object: one `epoll` event loop thread plus its worker pool
+typedef struct linuxtimerlib_s linuxtimerlib_t;
+
+/// Information passed to a timer callback
+typedef struct linuxtimer_event_s
+{
+    linuxtimer_t* timer;
+    void* user_data;
+    /// Number of expirations since the last callback for this timer. > 1 means expirations were
+    /// missed, since the callback could not be called in time.
+    uint64_t expirations;
+    /// Absolute time, in `CLOCK_MONOTONIC` ns (the same time base as timinglib's `nanos()`), at
+    /// which the latest of those expirations was due. Use it to measure the wake-up latency.
+    uint64_t expected_time_ns;
+} linuxtimer_event_t;
+
+/// A timer callback. It runs in the event loop thread (with 0 workers) or in a worker thread.
+typedef void (*linuxtimer_callback_t)(const linuxtimer_event_t* event);
+
+/// A "factory" function to create the library object and start its event loop thread and
+/// `num_workers` worker threads.
+/// - `max_timers` is the maximum number of timers which can be started at once.
+/// - With `num_workers` = 0, callbacks are called directly from the event loop thread, which has
+///   the lowest latency, but then a slow callback delays all other timers.
+/// Returns NULL if anything fails.
+linuxtimerlib_t* linuxtimerlib_create(size_t max_timers, size_t num_workers);
+
+/// Stop all timers and threads, and free all memory. Do NOT call this from within a callback.
+void linuxtimerlib_destroy(linuxtimerlib_t* lib);
+
+/// Start a new timer. For `LINUXTIMER_TYPE_ONE_SHOT` timers, `interval_ns` is ignored.
+/// `initial_ns` must be > 0.
+/// Returns the timer, or NULL if `max_timers` timers are already started or if anything fails.
+linuxtimer_t* linuxtimer_start(linuxtimerlib_t* lib, linuxtimer_type_t type, uint64_t initial_ns,
+    uint64_t interval_ns, linuxtimer_callback_t callback, void* user_data);
+
+/// Stop a timer and release it back to the library. After this returns, the timer's callback will
+/// not be called again, except possibly once if it is already running in another thread. One-shot
+/// timers must be stopped too, to release them. Safe to call from within a callback.
+void linuxtimer_stop(linuxtimerlib_t* lib, linuxtimer_t* timer);
+
+/// Get the total number of expirations of a timer so far.
+uint64_t linuxtimer_get_expiration_cnt(const linuxtimer_t* timer);
+
+/// Get the total number of missed expirations of a timer so far: expirations which did not get
+/// their own callback.
+uint64_t linuxtimer_get_missed_cnt(const linuxtimer_t* timer);
@@ -0,0 +1,138 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Demonstrate "linuxtimerlib.h": start a few periodic and one-shot timers, plus a thousand more
+periodic timers in the background, let them run for a while, then print how many times each one
+expired and how many expirations were missed.
+
+STATUS: works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. In C:
+gcc -Wall -Wextra -Werror -O3 -std=c17 linuxtimerlib_example.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+
+# 2. In C++
+g++ -Wall -Wextra -Werror -O3 -std=c++17 linuxtimerlib_example.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+```
+
+References:
+1. linuxtimerlib.h
+1. https://qnaplus.com/implement-periodic-timer-linux/
+
+*/
+
+
+// Local includes
+#include "linuxtimerlib.h"
+#include "timinglib.h"
+
+// C includes
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+#include <stdio.h>   // For `printf()`
+#include <stdlib.h>  // For `exit()`
+
+#define NUM_BACKGROUND_TIMERS 1000
+#define NUM_WORKERS 2
+#define RUN_TIME_MS 1000
+
+/// Print a message each time a timer expires.
+void print_callback(const linuxtimer_event_t* event)
+{
+    const char* name = (const char*)event->user_data;
+    printf("%-14s expired at t = %9lu us (%lu expiration(s))\n",
+        name, NS_TO_US(event->expected_time_ns), event->expirations);
+}
+
+/// Just count the number of callbacks.
+void count_callback(const linuxtimer_event_t* event)
+{
+    uint64_t* callback_cnt = (uint64_t*)event->user_data;
+    __atomic_add_fetch(callback_cnt, 1, __ATOMIC_RELAXED);
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    linuxtimerlib_t* lib = linuxtimerlib_create(NUM_BACKGROUND_TIMERS + 10, NUM_WORKERS);
+    if (lib == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    linuxtimer_t* timer_100ms = linuxtimer_start(lib, LINUXTIMER_TYPE_PERIODIC,
+        MS_TO_NS(100), MS_TO_NS(100), print_callback, (void*)"periodic_100ms");
+    linuxtimer_t* timer_250ms = linuxtimer_start(lib, LINUXTIMER_TYPE_PERIODIC,
+        MS_TO_NS(50), MS_TO_NS(250), print_callback, (void*)"periodic_250ms");
+    linuxtimer_t* timer_one_shot = linuxtimer_start(lib, LINUXTIMER_TYPE_ONE_SHOT,
+        MS_TO_NS(333), 0, print_callback, (void*)"one_shot_333ms");
+
+    // Many more timers at 100 Hz, with their phases spread out over the 10 ms period
+    static linuxtimer_t* background_timers[NUM_BACKGROUND_TIMERS];
+    static uint64_t background_callback_cnt = 0;
+    for (size_t i = 0; i < NUM_BACKGROUND_TIMERS; i++)
+    {
+        background_timers[i] = linuxtimer_start(lib, LINUXTIMER_TYPE_PERIODIC,
+            US_TO_NS(10*(i + 1)), MS_TO_NS(10), count_callback, &background_callback_cnt);
+    }
+
+    sleep_ms(RUN_TIME_MS);
+
+    uint64_t background_expiration_cnt = 0;
+    uint64_t background_missed_cnt = 0;
+    for (size_t i = 0; i < NUM_BACKGROUND_TIMERS; i++)
+    {
+        background_expiration_cnt += linuxtimer_get_expiration_cnt(background_timers[i]);
+        background_missed_cnt += linuxtimer_get_missed_cnt(background_timers[i]);
+        linuxtimer_stop(lib, background_timers[i]);
+    }
+
+    printf("\n");
+    printf("periodic_100ms: expirations = %lu, missed = %lu\n",
+        linuxtimer_get_expiration_cnt(timer_100ms), linuxtimer_get_missed_cnt(timer_100ms));
+    printf("periodic_250ms: expirations = %lu, missed = %lu\n",
+        linuxtimer_get_expiration_cnt(timer_250ms), linuxtimer_get_missed_cnt(timer_250ms));
+    printf("one_shot_333ms: expirations = %lu, missed = %lu\n",
+        linuxtimer_get_expiration_cnt(timer_one_shot),
+        linuxtimer_get_missed_cnt(timer_one_shot));
+    printf("%u background 100 Hz timers: expirations = %lu, missed = %lu, callbacks = %lu\n",
+        NUM_BACKGROUND_TIMERS, background_expiration_cnt, background_missed_cnt,
+        __atomic_load_n(&background_callback_cnt, __ATOMIC_RELAXED));
+
+    linuxtimer_stop(lib, timer_100ms);
+    linuxtimer_stop(lib, timer_250ms);
+    linuxtimer_stop(lib, timer_one_shot);
+    linuxtimerlib_destroy(lib);
+
+    return 0;
+}
+
+/*
+SAMPLE OUTPUT:
+
+In C, on a 1-core x86-64 VM:
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 linuxtimerlib_example.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+    periodic_250ms expired at t = 1364156752 us (1 expiration(s))
+    periodic_100ms expired at t = 1364206743 us (1 expiration(s))
+    periodic_100ms expired at t = 1364306743 us (1 expiration(s))
+    periodic_100ms expired at t = 1364406743 us (1 expiration(s))
+    periodic_250ms expired at t = 1364406752 us (1 expiration(s))
+    one_shot_333ms expired at t = 1364439756 us (1 expiration(s))
+    periodic_100ms expired at t = 1364506743 us (1 expiration(s))
+    periodic_100ms expired at t = 1364606743 us (1 expiration(s))
+    periodic_250ms expired at t = 1364656752 us (1 expiration(s))
+    periodic_100ms expired at t = 1364706743 us (1 expiration(s))
+    periodic_100ms expired at t = 1364806743 us (1 expiration(s))
+    periodic_100ms expired at t = 1364906743 us (1 expiration(s))
+    periodic_250ms expired at t = 1364906752 us (1 expiration(s))
+    periodic_100ms expired at t = 1365006743 us (1 expiration(s))
+    periodic_100ms expired at t = 1365106743 us (1 expiration(s))
+
+    periodic_100ms: expirations = 10, missed = 0
+    periodic_250ms: expirations = 4, missed = 0
+    one_shot_333ms: expirations = 1, missed = 0
+    1000 background 100 Hz timers: expirations = 100872, missed = 1183, callbacks = 99689
+
+*/
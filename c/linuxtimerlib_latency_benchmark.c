@@ -0,0 +1,180 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark the wake-up latency (actual wake-up time - scheduled time) of "linuxtimerlib.h" timers
+against a plain timinglib `sleep_until_ns()` loop, and print the latency percentiles of each:
+1. `sleep_until_ns()` in a loop, at 1 kHz
+2. one linuxtimerlib timer at 1 kHz, with its callback called directly by the event loop thread
+3. one linuxtimerlib timer at 1 kHz, with its callback dispatched to a worker thread
+4. many linuxtimerlib timers at once (1000 timers at 10 Hz each = 10 kHz total), called directly
+   by the event loop thread
+
+STATUS: works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. In C:
+gcc -Wall -Wextra -Werror -O3 -std=c17 linuxtimerlib_latency_benchmark.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+
+# 2. In C++
+g++ -Wall -Wextra -Werror -O3 -std=c++17 linuxtimerlib_latency_benchmark.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+```
+
+References:
+1. linuxtimerlib.h
+1. timinglib.h
+
+*/
+
+
+// Local includes
+#include "linuxtimerlib.h"
+#include "timinglib.h"
+
+// C includes
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+#include <stdio.h>   // For `printf()`
+#include <stdlib.h>  // For `exit()`
+
+#define RUN_TIME_MS 2000
+#define PERIOD_1KHZ_NS MS_TO_NS(1)
+#define NUM_MANY_TIMERS 1000
+#define PERIOD_10HZ_NS MS_TO_NS(100)
+
+/// Record the wake-up latency of each timer callback into the histogram in `user_data`.
+/// - Only one thread at a time records into the histogram: either the event loop thread, or the
+///   one worker which is running this timer's callback.
+void record_latency_callback(const linuxtimer_event_t* event)
+{
+    uint64_t time_now_ns = nanos();
+    latency_histogram_t* hist = (latency_histogram_t*)event->user_data;
+    latency_histogram_record(hist,
+        time_now_ns > event->expected_time_ns ? time_now_ns - event->expected_time_ns : 0);
+}
+
+/// Benchmark `num_timers` linuxtimerlib timers, with `num_workers` workers, into `hist`.
+void benchmark_linuxtimerlib(latency_histogram_t* hist, size_t num_timers, uint64_t period_ns,
+    size_t num_workers)
+{
+    linuxtimerlib_t* lib = linuxtimerlib_create(num_timers, num_workers);
+    if (lib == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    static linuxtimer_t* timers[NUM_MANY_TIMERS];
+    for (size_t i = 0; i < num_timers; i++)
+    {
+        // Spread the timers' phases out over the period.
+        uint64_t initial_ns = period_ns + i*period_ns/num_timers;
+        timers[i] = linuxtimer_start(lib, LINUXTIMER_TYPE_PERIODIC, initial_ns, period_ns,
+            record_latency_callback, hist);
+    }
+
+    sleep_ms(RUN_TIME_MS);
+
+    uint64_t missed_cnt = 0;
+    for (size_t i = 0; i < num_timers; i++)
+    {
+        missed_cnt += linuxtimer_get_missed_cnt(timers[i]);
+        linuxtimer_stop(lib, timers[i]);
+    }
+    linuxtimerlib_destroy(lib);
+
+    printf("  (missed expirations = %lu)\n", missed_cnt);
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    // static to keep the histograms off the stack
+    static latency_histogram_t hists[4];
+    for (size_t i = 0; i < ARRAY_LEN(hists); i++)
+    {
+        latency_histogram_init(&hists[i]);
+    }
+
+    printf("Running each benchmark for %u ms.\n\n", RUN_TIME_MS);
+
+    printf("1. sleep_until_ns() at 1 kHz\n");
+    uint64_t wake_time_ns = nanos();
+    uint64_t t_end_ns = wake_time_ns + MS_TO_NS(RUN_TIME_MS);
+    while (wake_time_ns < t_end_ns)
+    {
+        sleep_until_ns(&wake_time_ns, PERIOD_1KHZ_NS);
+        uint64_t time_now_ns = nanos();
+        latency_histogram_record(&hists[0],
+            time_now_ns > wake_time_ns ? time_now_ns - wake_time_ns : 0);
+    }
+
+    printf("2. linuxtimerlib, 1 timer at 1 kHz, 0 workers\n");
+    benchmark_linuxtimerlib(&hists[1], 1, PERIOD_1KHZ_NS, 0);
+
+    printf("3. linuxtimerlib, 1 timer at 1 kHz, 1 worker\n");
+    benchmark_linuxtimerlib(&hists[2], 1, PERIOD_1KHZ_NS, 1);
+
+    printf("4. linuxtimerlib, %u timers at 10 Hz each, 0 workers\n", NUM_MANY_TIMERS);
+    benchmark_linuxtimerlib(&hists[3], NUM_MANY_TIMERS, PERIOD_10HZ_NS, 0);
+
+    printf("\nWake-up latency (actual - scheduled wake-up time):\n\n");
+    latency_histogram_print(&hists[0], "1. sleep_until_ns(), 1 kHz");
+    latency_histogram_print(&hists[1], "2. linuxtimerlib, 1 timer, 0 workers, 1 kHz");
+    latency_histogram_print(&hists[2], "3. linuxtimerlib, 1 timer, 1 worker, 1 kHz");
+    latency_histogram_print(&hists[3], "4. linuxtimerlib, 1000 timers, 0 workers, 10 kHz total");
+
+    return 0;
+}
+
+/*
+SAMPLE OUTPUT:
+
+In C, on a 1-core x86-64 VM, with the default `SCHED_OTHER` scheduler:
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 linuxtimerlib_latency_benchmark.c linuxtimerlib.c timinglib.c -o bin/a -pthread && time bin/a
+    Running each benchmark for 2000 ms.
+
+    1. sleep_until_ns() at 1 kHz
+    2. linuxtimerlib, 1 timer at 1 kHz, 0 workers
+      (missed expirations = 8)
+    3. linuxtimerlib, 1 timer at 1 kHz, 1 worker
+      (missed expirations = 15)
+    4. linuxtimerlib, 1000 timers at 10 Hz each, 0 workers
+      (missed expirations = 0)
+
+    Wake-up latency (actual - scheduled wake-up time):
+
+    1. sleep_until_ns(), 1 kHz:
+      count = 2000
+      min   =        49639 ns
+      p50   =        75775 ns
+      p90   =       110591 ns
+      p99   =       466943 ns
+      p99.9 =      2228223 ns
+      max   =      4201064 ns
+    2. linuxtimerlib, 1 timer, 0 workers, 1 kHz:
+      count = 1992
+      min   =         9572 ns
+      p50   =        33791 ns
+      p90   =        75775 ns
+      p99   =       143359 ns
+      p99.9 =       606207 ns
+      max   =       684999 ns
+    3. linuxtimerlib, 1 timer, 1 worker, 1 kHz:
+      count = 1985
+      min   =        10970 ns
+      p50   =        45055 ns
+      p90   =        96255 ns
+      p99   =       368639 ns
+      p99.9 =       868351 ns
+      max   =       871319 ns
+    4. linuxtimerlib, 1000 timers, 0 workers, 10 kHz total:
+      count = 19140
+      min   =         5555 ns
+      p50   =         8959 ns
+      p90   =        10751 ns
+      p99   =        61439 ns
+      p99.9 =      1900543 ns
+      max   =      3211647 ns
+
+*/
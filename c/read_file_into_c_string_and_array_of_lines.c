@@ -15,263 +15,2334 @@ individually-addressable lines. Use static memory allocation, not dynamic, for t
    an array.
 1. It's extensible via dynamic memory allocation if needed.
 
+For files too large for the static buffers (multi-GB log files, for instance), use
+`file_load_mmap()` instead of `file_load()`. It memory-maps the whole file read-only, so the file's
+bytes are never copied, and builds a dynamically-allocated line index which points directly into
+the mapping. All of the `file_print_*()` functions work the same way on a file loaded either way.
+Call `file_unload()` when done with an `mmap`ed file. For the largest files,
+`file_load_mmap_parallel()` does the same thing, but indexes the lines on N threads.
+
+To copy files of any size into memory instead, use `dyn_file_load()`, which loads a `dyn_file_t`.
+It keeps the file's chars and its line start offsets back to back in a single `file_arena_t`
+memory block, which grows geometrically, with no per-line allocations. The offsets are 32-bit
+integers rather than 64-bit `char*` ptrs for files < 4 GiB, halving the index memory, and they stay
+valid even when the arena moves as it grows. Release all files in an arena at once with
+`file_arena_reset()` and load more into it, reusing its memory without calling `malloc()` again.
+
+To load thousands of small files (ex: config and data files at startup) into `dyn_file_t`s, use
+`dyn_file_load_batch()`. Instead of one blocking `open()` and `read()` at a time, it keeps many
+opens, `statx()`s, reads, and closes in flight at once through io_uring, driven with the raw
+`io_uring_setup()` and `io_uring_enter()` system calls so that liburing is not needed. If the
+kernel doesn't support io_uring (ex: kernels older than 5.6, or containers which block it), it
+falls back to a pool of threads doing blocking reads instead. On an NVMe drive, which can serve many
+requests at once, this cuts the cold-cache load time by a large factor.
+
+Both loaders find the line starts with a vectorized newline scanner, `newline_index_*()`, which
+checks 64 bytes per step with AVX2 or SSE2 "compare + movemask" instructions (chosen at run-time
+based on the CPU), and falls back to a portable `memchr()` loop on other CPUs. Windows-style "\r\n"
+(CRLF) line endings are supported too: the '\n' ends the line either way, and
+`file_get_line_len()` and the `file_print_*()` functions strip the '\r'.
+
 STATUS: works!
 
-To compile and run (assuming you've already `cd`ed into this dir):
-1. In C:
-```bash
-gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
-```
-2. In C++
-```bash
-g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
-```
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C:
+```bash
+gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
+```
+2. In C++
+```bash
+g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
+```
+3. Optionally pass in the path to any other file, of any size, to also load it with
+`file_load_mmap()` and print some stats about it, and benchmark the newline indexers and
+`file_load_mmap_parallel()` with 1 to 32 threads, and `dyn_file_load()`, on it. Ex:
+```bash
+bin/a /var/log/syslog
+```
+
+References:
+1. I'm seeking to answer this question, more or less:
+   [C function to load file content in string array](https://stackoverflow.com/q/71330345/4561887)
+    1. *****+[my answer] https://stackoverflow.com/a/71346853/4561887
+1. https://en.cppreference.com/w/c/io/fopen
+1. https://en.cppreference.com/w/c/string/byte/strerror - shows a good usage example of
+   `printf("File opening error: %s\n", strerror(errno));` if `fopen()` fails when opening a file.
+1. https://en.cppreference.com/w/c/io/fgetc
+1. https://man7.org/linux/man-pages/man2/mmap.2.html
+1. https://man7.org/linux/man-pages/man2/madvise.2.html
+1. https://man7.org/linux/man-pages/man3/pthread_create.3.html
+1. https://man7.org/linux/man-pages/man7/io_uring.7.html
+1. https://man7.org/linux/man-pages/man2/io_uring_enter.2.html
+1. https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html - for
+   `_mm256_cmpeq_epi8()` and `_mm256_movemask_epi8()`
+1. https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html - for `__builtin_cpu_supports()`
+
+
+*/
+
+// Required for `madvise()` and `clock_gettime()` with `-std=c17`. See:
+// https://man7.org/linux/man-pages/man2/madvise.2.html
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+// Linux includes
+#include <fcntl.h>    // For `open()`
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sys/mman.h> // For `mmap()`, `madvise()`, `munmap()`
+#include <sys/stat.h> // For `fstat()`, `struct statx`
+#include <sys/syscall.h> // For `syscall()` and `__NR_io_uring_*`
+#include <unistd.h>   // For `close()`
+
+// C includes
+#include <errno.h>
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+#include <stdio.h>   // For `printf()`
+#include <stdlib.h>  // For `realloc()`, `free()`
+#include <string.h>  // for `strerror()`
+#include <time.h>    // For `clock_gettime()`
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define NEWLINE_INDEX_X86 1
+    #include <immintrin.h>
+#else
+    #define NEWLINE_INDEX_X86 0
+#endif
+
+
+// Get the number of elements in any C array
+// - Usage example: [my own answer]:
+//   https://arduino.stackexchange.com/questions/80236/initializing-array-of-structs/80289#80289
+#define ARRAY_LEN(array) (sizeof(array) / sizeof(array[0]))
+
+/// Max and min gcc/clang **statement expressions** (safer than macros) for C. By Gabriel Staples.
+/// See: https://stackoverflow.com/a/58532788/4561887
+#define MAX(a, b)               \
+    ({                          \
+        __typeof__(a) _a = (a); \
+        __typeof__(b) _b = (b); \
+        _a > _b ? _a : _b;      \
+    })
+#define MIN(a, b)               \
+    ({                          \
+        __typeof__(a) _a = (a); \
+        __typeof__(b) _b = (b); \
+        _a < _b ? _a : _b;      \
+    })
+
+/// Bytes per megabyte
+#define BYTES_PER_MB (1000*1000)
+/// Bytes per mebibyte
+#define BYTES_PER_MIB (1024*1024)
+
+/// Convert bytes to megabytes
+#define BYTES_TO_MB(bytes) (((double)(bytes))/BYTES_PER_MB)
+/// Convert bytes to mebibytes
+#define BYTES_TO_MIB(bytes) (((double)(bytes))/BYTES_PER_MIB)
+
+#define MAX_NUM_LINES 10000UL
+#define MAX_NUM_CHARS (MAX_NUM_LINES*200UL) // 2 MB
+#define MAX_PATH_LEN (1000)
+
+typedef struct file_s
+{
+    /// The path to the file to open.
+    char path[MAX_PATH_LEN];
+
+    /// All characters read from the file.
+    char file_str[MAX_NUM_CHARS];     // array of `char`
+
+    /// The total number of chars read into the `file_str` string, including
+    //  null terminator.
+    size_t num_chars;
+
+    /// A ptr to each line in the file.
+    const char* line_array[MAX_NUM_LINES];  // array of `const char*` (ptr to const char)
+
+    /// The total number of lines in the file, and hence in the `line_array`
+    //  above.
+    size_t num_lines;
+
+    /// true if the file was loaded with `file_load_mmap()` rather than `file_load()`, in which
+    /// case the file data is in `mapped_str` and `mapped_line_array` below instead of in
+    /// `file_str` and `line_array` above.
+    bool is_mapped;
+
+    /// All characters in the file: a read-only memory map of the whole file. NOT null-terminated.
+    const char* mapped_str;
+
+    /// A ptr to each line in `mapped_str`; dynamically allocated, with room for
+    /// `mapped_line_array_capacity` ptrs.
+    const char** mapped_line_array;
+    size_t mapped_line_array_capacity;
+} file_t;
+
+/// Get a ptr to the first char of the file's data, however it was loaded.
+static inline const char* file_get_data(const file_t* file)
+{
+    return file->is_mapped ? file->mapped_str : file->file_str;
+}
+
+/// Get a ptr to the start of the line at 0-based index `i_line`, however the file was loaded.
+static inline const char* file_get_line_ptr(const file_t* file, size_t i_line)
+{
+    return file->is_mapped ? file->mapped_line_array[i_line] : file->line_array[i_line];
+}
+
+/// A newline indexer: scan `data[*i_start]` up to `data[len - 1]` for '\n' chars, and write a ptr
+/// to the start of the line following each one (`data + i_newline + 1`) into
+/// `line_array[num_lines]`, `line_array[num_lines + 1]`, etc., until the data ends or
+/// `line_array` holds `max_lines` ptrs. A '\n' at the very end of the data does not start a new
+/// line. The caller must add the first line, at `data`, itself.
+/// - Returns the new number of lines in `line_array`, and sets `*i_start` to `len` if the whole
+///   data was indexed, or else to the index of the first '\n' which did not fit, so that the
+///   caller can make room in `line_array` and call it again from there.
+typedef size_t (*newline_indexer_t)(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines);
+
+/// Portable newline indexer. `memchr()` is usually vectorized by the C library itself, so this is
+/// far faster than a loop over each char, but still has the overhead of 1 call per line.
+size_t newline_index_portable(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines)
+{
+    size_t i = *i_start;
+    while (i < len)
+    {
+        const char* newline = (const char*)memchr(&data[i], '\n', len - i);
+        if (newline == NULL)
+        {
+            break;
+        }
+        size_t i_newline = newline - data;
+        if (i_newline + 1 == len)
+        {
+            break;
+        }
+        if (num_lines == max_lines)
+        {
+            *i_start = i_newline;
+            return num_lines;
+        }
+        line_array[num_lines] = newline + 1;
+        num_lines++;
+        i = i_newline + 1;
+    }
+
+    *i_start = len;
+    return num_lines;
+}
+
+#if NEWLINE_INDEX_X86
+
+/// Add a line start for each set bit in `newline_mask`, in which bit `n` is set if
+/// `data[i_block + n]` is a '\n'. The shared inner loop of the SIMD newline indexers.
+/// - Returns false if `line_array` filled up first, with `*i_stop` set to the index of the '\n'
+///   which did not fit.
+static inline bool newline_index_mask(const char* data, size_t len, size_t i_block,
+    uint64_t newline_mask, const char** line_array, size_t* num_lines, size_t max_lines,
+    size_t* i_stop)
+{
+    while (newline_mask != 0)
+    {
+        size_t i_newline = i_block + __builtin_ctzll(newline_mask);
+        if (i_newline + 1 == len)
+        {
+            break;
+        }
+        if (*num_lines == max_lines)
+        {
+            *i_stop = i_newline;
+            return false;
+        }
+        line_array[*num_lines] = &data[i_newline + 1];
+        (*num_lines)++;
+        // clear the lowest set bit
+        newline_mask &= newline_mask - 1;
+    }
+    return true;
+}
+
+/// SSE2 newline indexer: 4 x 16-byte compares per 64-byte step. SSE2 is part of every x86-64 CPU.
+__attribute__((target("sse2")))
+size_t newline_index_sse2(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines)
+{
+    const __m128i newlines = _mm_set1_epi8('\n');
+    size_t i = *i_start;
+    for (; i + 64 <= len; i += 64)
+    {
+        uint64_t mask = 0;
+        for (size_t j = 0; j < 64; j += 16)
+        {
+            __m128i chars = _mm_loadu_si128((const __m128i*)&data[i + j]);
+            uint64_t mask16 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, newlines));
+            mask |= mask16 << j;
+        }
+        if (!newline_index_mask(data, len, i, mask, line_array, &num_lines, max_lines, i_start))
+        {
+            return num_lines;
+        }
+    }
+
+    *i_start = i;
+    return newline_index_portable(data, len, i_start, line_array, num_lines, max_lines);
+}
+
+/// AVX2 newline indexer: 2 x 32-byte compares per 64-byte step.
+__attribute__((target("avx2")))
+size_t newline_index_avx2(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines)
+{
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    size_t i = *i_start;
+    for (; i + 64 <= len; i += 64)
+    {
+        __m256i chars_lo = _mm256_loadu_si256((const __m256i*)&data[i]);
+        __m256i chars_hi = _mm256_loadu_si256((const __m256i*)&data[i + 32]);
+        uint64_t mask_lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars_lo, newlines));
+        uint64_t mask_hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars_hi, newlines));
+        uint64_t mask = mask_lo | (mask_hi << 32);
+        if (!newline_index_mask(data, len, i, mask, line_array, &num_lines, max_lines, i_start))
+        {
+            return num_lines;
+        }
+    }
+
+    *i_start = i;
+    return newline_index_portable(data, len, i_start, line_array, num_lines, max_lines);
+}
+
+#endif // NEWLINE_INDEX_X86
+
+/// Get the fastest newline indexer which the CPU we are running on supports, and its name (if
+/// `name` is not NULL).
+newline_indexer_t newline_indexer_get(const char** name)
+{
+    newline_indexer_t indexer = newline_index_portable;
+    const char* indexer_name = "portable";
+
+#if NEWLINE_INDEX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        indexer = newline_index_avx2;
+        indexer_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        indexer = newline_index_sse2;
+        indexer_name = "sse2";
+    }
+#endif
+
+    if (name != NULL)
+    {
+        *name = indexer_name;
+    }
+    return indexer;
+}
+
+/// Get the fastest newline indexer which the CPU supports, choosing it only on the first call.
+/// The first call is NOT thread-safe, so make it before starting any threads which index lines.
+static newline_indexer_t newline_indexer_get_cached()
+{
+    static newline_indexer_t indexer = NULL;
+    if (indexer == NULL)
+    {
+        indexer = newline_indexer_get(NULL);
+    }
+    return indexer;
+}
+
+/// Index lines with the fastest newline indexer which the CPU supports. See `newline_indexer_t`.
+size_t newline_index(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines)
+{
+    return newline_indexer_get_cached()(data, len, i_start, line_array, num_lines, max_lines);
+}
+
+/// Copy the file path pointed to by `path` into the `file_t` object.
+void file_store_path(file_t* file, const char *path)
+{
+    if (file == NULL || path == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    // Leave room for, and always write, a null terminator, even if `path` is too long
+    strncpy(file->path, path, sizeof(file->path) - 1);
+    file->path[sizeof(file->path) - 1] = '\0';
+}
+
+/// Get the length of a line which is `len` chars long including its line ending, if any, NOT
+/// including its line ending ("\n" or "\r\n"), and set `*has_line_ending` to whether or not it
+/// has one.
+static inline size_t line_len_without_ending(const char* line, size_t len, bool* has_line_ending)
+{
+    *has_line_ending = len > 0 && line[len - 1] == '\n';
+    if (*has_line_ending)
+    {
+        len--;
+        if (len > 0 && line[len - 1] == '\r')
+        {
+            len--;
+        }
+    }
+    return len;
+}
+
+/// Get the length of the line at 0-based index `i_line`, NOT including its line ending ("\n" or
+/// "\r\n"), in O(1) time, from the start of the next line. `*has_line_ending` is set to whether or
+/// not the line has a line ending at all; only the last line of a file may not.
+size_t file_get_line_len(const file_t* file, size_t i_line, bool* has_line_ending)
+{
+    const char* line = file_get_line_ptr(file, i_line);
+    const char* line_end = i_line + 1 < file->num_lines ?
+        file_get_line_ptr(file, i_line + 1) : file_get_data(file) + file->num_chars;
+    return line_len_without_ending(line, line_end - line, has_line_ending);
+}
+
+/// Print the entire line at 1-based line number `line_number` in file `file`, including the
+/// '\n' at the end of the line. A "\r\n" line ending is printed as just '\n'.
+void file_print_line(const file_t* file, size_t line_number)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    // Ensure we don't read outside the `file->line_array`
+    if (line_number > file->num_lines)
+    {
+        printf("ERROR in function %s(): line_number (%zu) is too large (file->num_lines = %zu).\n",
+            __func__, line_number, file->num_lines);
+        return;
+    }
+
+    size_t i_line = line_number - 1;
+    const char* line = file_get_line_ptr(file, i_line);
+    if (line == NULL)
+    {
+        printf("ERROR in function %s(): line_array contains NULL ptr for line_number = %zu at "
+               "index = %zu.\n", __func__, line_number, i_line);
+        return;
+    }
+
+    // print all chars in the line, but never past the end of the valid data, since an `mmap`ed
+    // file is not null-terminated
+    bool has_line_ending;
+    size_t len = file_get_line_len(file, i_line, &has_line_ending);
+    fwrite(line, 1, len, stdout);
+    if (has_line_ending)
+    {
+        printf("\n");
+    }
+}
+
+/// Print `num_lines` number of lines in a file, starting at 1-based line number `first_line`,
+/// and including the '\n' at the end of each line.
+/// At the start of each line, the line number is also printed, followed by a colon (:).
+void file_print_lines(const file_t* file, size_t first_line, size_t num_lines)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    if (num_lines == 0 || file->num_lines == 0)
+    {
+        printf("ERROR in function %s(): num_lines passed in == %zu; file->num_lines = %zu.\n",
+            __func__, num_lines, file->num_lines);
+        return;
+    }
+
+    // Ensure we don't read outside the valid data
+    size_t last_line = MIN(first_line + num_lines - 1, file->num_lines);
+    // printf("last_line = %zu\n", last_line); // DEBUGGING
+    for (size_t line_number = first_line; line_number <= last_line; line_number++)
+    {
+        printf("%4lu: ", line_number);
+        file_print_line(file, line_number);
+    }
+}
+
+/// Print an entire file.
+void file_print_all(const file_t* file)
+{
+    printf("num_chars to print = %zu\n", file->num_chars);
+    printf("num_lines to print = %zu\n", file->num_lines);
+    printf("========== FILE START ==========\n");
+    file_print_lines(file, 1, file->num_lines);
+    printf("=========== FILE END ===========\n");
+}
+
+/// Read all characters from a file on your system at the path specified in the
+/// file object and copy this file data **into** the passed-in `file` object.
+void file_load(file_t* file)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    FILE* fp = fopen(file->path, "r");
+    if (fp == NULL)
+    {
+        printf("ERROR in function %s(): Failed to open file (%s).\n",
+            __func__, strerror(errno));
+        return;
+    }
+
+    // Read the whole file at once, up to the size of `file_str`, and then check whether there
+    // was more. See: https://en.cppreference.com/w/c/io/fread
+    size_t num_chars = fread(file->file_str, 1, sizeof(file->file_str), fp);
+    if (num_chars == sizeof(file->file_str) && fgetc(fp) != EOF)
+    {
+        printf("ERROR in function %s(): file is full (the file is larger than "
+               "file_str, which is only %zu bytes).\n", __func__, sizeof(file->file_str));
+    }
+
+    // Index the lines
+    size_t num_lines = 0;
+    if (num_chars > 0)
+    {
+        file->line_array[0] = file->file_str;
+        size_t i_start = 0;
+        num_lines = newline_index(file->file_str, num_chars, &i_start, file->line_array, 1,
+            ARRAY_LEN(file->line_array));
+        if (i_start < num_chars)
+        {
+            printf("ERROR in function %s(): file is full (the file has more lines than "
+                   "line_array, which only holds %zu lines).\n", __func__,
+                   ARRAY_LEN(file->line_array));
+            // Drop the data after the last line which fit, so the last line's length is right
+            num_chars = i_start + 1;
+        }
+    }
+
+    file->num_chars = num_chars;
+    file->num_lines = num_lines;
+    file->is_mapped = false;
+
+    fclose(fp);
+}
+
+/// Grow the file's `mapped_line_array` geometrically, to make room for more lines. Return false
+/// if out of memory.
+static bool file_grow_mapped_line_array(file_t* file)
+{
+    size_t new_capacity = MAX(file->mapped_line_array_capacity*2, (size_t)1024);
+    const char** new_line_array = (const char**)realloc(
+        file->mapped_line_array, new_capacity*sizeof(file->mapped_line_array[0]));
+    if (new_line_array == NULL)
+    {
+        return false;
+    }
+    file->mapped_line_array = new_line_array;
+    file->mapped_line_array_capacity = new_capacity;
+    return true;
+}
+
+/// Release an `mmap`ed file's memory map and line index, which were created by
+/// `file_load_mmap()`. Safe to call on a file loaded with `file_load()` too, in which case it does
+/// nothing.
+void file_unload(file_t* file)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    if (!file->is_mapped)
+    {
+        return;
+    }
+
+    if (file->mapped_str != NULL)
+    {
+        munmap((void*)file->mapped_str, file->num_chars);
+    }
+    free(file->mapped_line_array);
+
+    file->is_mapped = false;
+    file->mapped_str = NULL;
+    file->mapped_line_array = NULL;
+    file->mapped_line_array_capacity = 0;
+    file->num_chars = 0;
+    file->num_lines = 0;
+}
+
+/// Memory-map the whole file at the path specified in the file object, read-only, into
+/// `file->mapped_str`, with 0 lines indexed so far. The shared first step of `file_load_mmap()` and
+/// `file_load_mmap_parallel()`. Returns false and prints an error if anything fails.
+static bool file_map(file_t* file)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return false;
+    }
+
+    file->is_mapped = true;
+    file->mapped_str = NULL;
+    file->mapped_line_array = NULL;
+    file->mapped_line_array_capacity = 0;
+    file->num_chars = 0;
+    file->num_lines = 0;
+
+    int fd = open(file->path, O_RDONLY);
+    if (fd == -1)
+    {
+        printf("ERROR in function %s(): Failed to open file (%s).\n",
+            __func__, strerror(errno));
+        return false;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) == -1)
+    {
+        printf("ERROR in function %s(): Failed to stat file (%s).\n",
+            __func__, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    // `mmap()` of 0 bytes fails with `EINVAL`, so an empty file is simply left unmapped, with 0
+    // chars and 0 lines
+    size_t file_size = stat_buf.st_size;
+    if (file_size == 0)
+    {
+        close(fd);
+        return true;
+    }
+
+    void* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        printf("ERROR in function %s(): Failed to mmap file (%s).\n",
+            __func__, strerror(errno));
+        return false;
+    }
+    file->mapped_str = (const char*)map;
+    file->num_chars = file_size;
+
+    // Tell the kernel we are about to read the whole mapping front to back, so it reads ahead
+    // aggressively and can drop pages behind us; this is only a hint, so ignore any error.
+    madvise(map, file_size, MADV_SEQUENTIAL);
+
+    return true;
+}
+
+/// Memory-map the whole file at the path specified in the file object, read-only, and index the
+/// start of each of its lines, without copying any of the file's data, and without any limit on
+/// the file size or number of lines. Unlike `file_load()`, this works for multi-GB files.
+/// - Call `file_unload()` when done with the file, and before loading another file into the same
+///   `file_t` object with this function.
+/// - Returns false and prints an error if anything fails.
+bool file_load_mmap(file_t* file)
+{
+    if (!file_map(file))
+    {
+        return false;
+    }
+    size_t file_size = file->num_chars;
+
+    // Index the lines: each line starts at the start of the file or just after a '\n', except that
+    // a '\n' at the very end of the file does not start a new, empty line, matching `file_load()`.
+    // Each time the line array fills up, grow it and continue where the indexer stopped.
+    size_t i_start = 0;
+    while (i_start < file_size)
+    {
+        if (!file_grow_mapped_line_array(file))
+        {
+            printf("ERROR in function %s(): Out of memory after indexing %zu lines.\n",
+                __func__, file->num_lines);
+            file_unload(file);
+            return false;
+        }
+
+        if (file->num_lines == 0)
+        {
+            file->mapped_line_array[0] = file->mapped_str;
+            file->num_lines = 1;
+        }
+        file->num_lines = newline_index(file->mapped_str, file_size, &i_start,
+            file->mapped_line_array, file->num_lines, file->mapped_line_array_capacity);
+    }
+
+    // Later line accesses by line number are random, not sequential
+    if (file_size > 0)
+    {
+        madvise((void*)file->mapped_str, file_size, MADV_NORMAL);
+    }
+
+    return true;
+}
+
+/// The minimum number of bytes per chunk for `file_load_mmap_parallel()`, so that small files
+/// aren't split into more chunks than are worth a thread each
+#define PARALLEL_INDEX_MIN_CHUNK_SIZE (1024*1024)
+/// The number of chunks per thread for `file_load_mmap_parallel()`. More chunks than threads let
+/// threads which finish early (ex: because their pages were already in the page cache) take over
+/// more of the work.
+#define PARALLEL_INDEX_CHUNKS_PER_THREAD 4
+
+/// One chunk of a file to be indexed by `file_load_mmap_parallel()`, and its results
+typedef struct parallel_index_chunk_s
+{
+    /// Index of the first and one-past-the-last chars of the chunk
+    size_t i_start;
+    size_t i_end;
+    /// Line starts found in this chunk: one per '\n' in the chunk, except a '\n' at the very end
+    /// of the file. Dynamically allocated, with room for `capacity` line ptrs.
+    const char** line_array;
+    size_t num_lines;
+    size_t capacity;
+    /// Index of this chunk's first line in the file's `mapped_line_array`: the prefix sum of the
+    /// `num_lines` of all chunks before it, plus 1 for the first line of the file
+    size_t i_first_line;
+    bool out_of_memory;
+} parallel_index_chunk_t;
+
+/// State shared by all of the `file_load_mmap_parallel()` worker threads
+typedef struct parallel_index_s
+{
+    const char* data;
+    size_t len;
+    newline_indexer_t indexer;
+    parallel_index_chunk_t* chunks;
+    size_t num_chunks;
+    /// The next chunk for a worker to take, in each of the 2 phases
+    size_t next_chunk_to_index;
+    size_t next_chunk_to_copy;
+    /// The file's `mapped_line_array`, to copy the chunks' line ptrs into in phase 2
+    const char** line_array;
+    /// Workers wait here between phase 1 (index) and phase 2 (copy)
+    pthread_barrier_t barrier;
+    /// Workers wait for `started` before starting phase 1, since the barrier can only be set up
+    /// once the calling thread knows how many workers it managed to start
+    pthread_mutex_t start_mutex;
+    pthread_cond_t start_cond;
+    bool started;
+} parallel_index_t;
+
+/// Phase 1: index one chunk into its own line array, growing it as needed.
+static void parallel_index_chunk(parallel_index_t* index, parallel_index_chunk_t* chunk)
+{
+    // A first guess at the number of lines in the chunk, assuming ~64-char lines
+    chunk->capacity = MAX((chunk->i_end - chunk->i_start)/64, (size_t)1024);
+    chunk->line_array = (const char**)malloc(chunk->capacity*sizeof(chunk->line_array[0]));
+    if (chunk->line_array == NULL)
+    {
+        chunk->out_of_memory = true;
+        return;
+    }
+
+    size_t i_start = chunk->i_start;
+    while (true)
+    {
+        // Index only up to the end of this chunk. The indexer treats the end of the chunk as the
+        // end of the data, so a '\n' at the very end of the chunk is handled separately, below.
+        chunk->num_lines = index->indexer(index->data, chunk->i_end, &i_start, chunk->line_array,
+            chunk->num_lines, chunk->capacity);
+        bool done = i_start >= chunk->i_end;
+        bool newline_at_chunk_end = done && index->data[chunk->i_end - 1] == '\n'
+            && chunk->i_end < index->len;
+
+        if ((!done || newline_at_chunk_end) && chunk->num_lines == chunk->capacity)
+        {
+            size_t new_capacity = chunk->capacity*2;
+            const char** new_line_array = (const char**)realloc(chunk->line_array,
+                new_capacity*sizeof(chunk->line_array[0]));
+            if (new_line_array == NULL)
+            {
+                chunk->out_of_memory = true;
+                return;
+            }
+            chunk->line_array = new_line_array;
+            chunk->capacity = new_capacity;
+        }
+
+        if (done)
+        {
+            if (newline_at_chunk_end)
+            {
+                chunk->line_array[chunk->num_lines] = &index->data[chunk->i_end];
+                chunk->num_lines++;
+            }
+            return;
+        }
+    }
+}
+
+/// Phase 1 of `file_load_mmap_parallel()`, on each thread: take chunks to index until none are left.
+static void parallel_index_phase_index(parallel_index_t* index)
+{
+    size_t i_chunk;
+    while ((i_chunk = __atomic_fetch_add(&index->next_chunk_to_index, 1, __ATOMIC_RELAXED))
+        < index->num_chunks)
+    {
+        parallel_index_chunk(index, &index->chunks[i_chunk]);
+    }
+}
+
+/// Phase 3 of `file_load_mmap_parallel()`, on each thread: take chunks to copy into place in the
+/// file's line array until none are left. Does nothing if the line array couldn't be allocated.
+static void parallel_index_phase_copy(parallel_index_t* index)
+{
+    size_t i_chunk;
+    while (index->line_array != NULL
+        && (i_chunk = __atomic_fetch_add(&index->next_chunk_to_copy, 1, __ATOMIC_RELAXED))
+        < index->num_chunks)
+    {
+        parallel_index_chunk_t* chunk = &index->chunks[i_chunk];
+        memcpy(&index->line_array[chunk->i_first_line], chunk->line_array,
+            chunk->num_lines*sizeof(chunk->line_array[0]));
+    }
+}
+
+/// The worker thread function for `file_load_mmap_parallel()`. Between phases 1 and 3, the calling
+/// thread does phase 2 (the prefix sum) alone, while the workers wait on the barrier twice.
+static void* parallel_index_worker(void* arg)
+{
+    parallel_index_t* index = (parallel_index_t*)arg;
+    pthread_mutex_lock(&index->start_mutex);
+    while (!index->started)
+    {
+        pthread_cond_wait(&index->start_cond, &index->start_mutex);
+    }
+    pthread_mutex_unlock(&index->start_mutex);
+
+    parallel_index_phase_index(index);
+    pthread_barrier_wait(&index->barrier);
+    pthread_barrier_wait(&index->barrier);
+    parallel_index_phase_copy(index);
+    return NULL;
+}
+
+/// Same as `file_load_mmap()`, except that the lines are indexed on `num_threads` threads
+/// (including the calling thread), to use more of the machine's memory bandwidth on huge files.
+/// 1. The file is split into chunks, several per thread, and each thread repeatedly takes the next
+///    chunk and indexes its line starts into that chunk's own growable line array.
+/// 2. A prefix sum over the chunks' line counts gives each chunk's first line number, and the
+///    file's `mapped_line_array` is allocated at its exact final size.
+/// 3. The threads copy each chunk's line ptrs into place in the `mapped_line_array`, in parallel.
+/// The result is identical to `file_load_mmap()`'s. Files smaller than a few MB get fewer threads,
+/// since each chunk is at least `PARALLEL_INDEX_MIN_CHUNK_SIZE` bytes. If some threads can't be
+/// started, it prints an error and carries on with the ones which did start.
+bool file_load_mmap_parallel(file_t* file, size_t num_threads)
+{
+    if (!file_map(file))
+    {
+        return false;
+    }
+    size_t file_size = file->num_chars;
+    if (file_size == 0)
+    {
+        return true;
+    }
+
+    size_t num_chunks = MIN(num_threads*PARALLEL_INDEX_CHUNKS_PER_THREAD,
+        (file_size + PARALLEL_INDEX_MIN_CHUNK_SIZE - 1)/PARALLEL_INDEX_MIN_CHUNK_SIZE);
+    num_threads = MIN(num_threads, num_chunks);
+
+    parallel_index_t index;
+    memset(&index, 0, sizeof(index));
+    index.data = file->mapped_str;
+    index.len = file_size;
+    index.indexer = newline_indexer_get(NULL);
+    index.num_chunks = MAX(num_chunks, (size_t)1);
+    index.chunks = (parallel_index_chunk_t*)calloc(index.num_chunks, sizeof(index.chunks[0]));
+    if (index.chunks == NULL)
+    {
+        printf("ERROR in function %s(): Out of memory.\n", __func__);
+        file_unload(file);
+        return false;
+    }
+    for (size_t i = 0; i < index.num_chunks; i++)
+    {
+        index.chunks[i].i_start = file_size*i/index.num_chunks;
+        index.chunks[i].i_end = file_size*(i + 1)/index.num_chunks;
+    }
+
+    // Phase 1: index, on `num_threads` threads, including this one. If the worker threads can't
+    // all be allocated or started, just run with fewer of them, or with none but this one.
+    size_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+    pthread_t* threads = NULL;
+    if (num_workers > 0)
+    {
+        threads = (pthread_t*)malloc(num_workers*sizeof(threads[0]));
+        if (threads == NULL)
+        {
+            num_workers = 0;
+        }
+    }
+    pthread_mutex_init(&index.start_mutex, NULL);
+    pthread_cond_init(&index.start_cond, NULL);
+    size_t num_workers_started = 0;
+    for (; num_workers_started < num_workers; num_workers_started++)
+    {
+        int retcode = pthread_create(&threads[num_workers_started], NULL, parallel_index_worker,
+            &index);
+        if (retcode != 0)
+        {
+            printf("ERROR in function %s(): pthread_create() failed, so using %zu threads instead "
+                "of %zu. retcode = %i: %s\n", __func__, num_workers_started + 1, num_threads,
+                retcode, strerror(retcode));
+            break;
+        }
+    }
+    num_workers = num_workers_started;
+    pthread_barrier_init(&index.barrier, NULL, (unsigned)(num_workers + 1));
+    pthread_mutex_lock(&index.start_mutex);
+    index.started = true;
+    pthread_cond_broadcast(&index.start_cond);
+    pthread_mutex_unlock(&index.start_mutex);
+
+    parallel_index_phase_index(&index);
+    pthread_barrier_wait(&index.barrier);
+
+    // Phase 2: prefix sum, and allocate the file's line array at its exact size
+    bool out_of_memory = false;
+    size_t num_lines = 1;  // the first line, at the start of the file
+    for (size_t i = 0; i < index.num_chunks; i++)
+    {
+        out_of_memory |= index.chunks[i].out_of_memory;
+        index.chunks[i].i_first_line = num_lines;
+        num_lines += index.chunks[i].num_lines;
+    }
+    if (!out_of_memory)
+    {
+        file->mapped_line_array = (const char**)malloc(num_lines*sizeof(file->mapped_line_array[0]));
+    }
+    if (file->mapped_line_array != NULL)
+    {
+        file->mapped_line_array[0] = file->mapped_str;
+        file->mapped_line_array_capacity = num_lines;
+        file->num_lines = num_lines;
+        index.line_array = file->mapped_line_array;
+    }
+    pthread_barrier_wait(&index.barrier);
+
+    // Phase 3: copy the chunks' line ptrs into place, on all threads
+    parallel_index_phase_copy(&index);
+
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&index.barrier);
+    pthread_cond_destroy(&index.start_cond);
+    pthread_mutex_destroy(&index.start_mutex);
+    free(threads);
+    for (size_t i = 0; i < index.num_chunks; i++)
+    {
+        free(index.chunks[i].line_array);
+    }
+    free(index.chunks);
+
+    if (index.line_array == NULL)
+    {
+        printf("ERROR in function %s(): Out of memory.\n", __func__);
+        file_unload(file);
+        return false;
+    }
+
+    madvise((void*)file->mapped_str, file_size, MADV_NORMAL);
+    return true;
+}
+
+/// The number of lines `dyn_file_load()` indexes at a time, into a small array on the stack
+#define DYN_FILE_INDEX_BATCH_NUM_LINES 1024
+
+/// An arena: one dynamically-allocated block of memory, handed out front to back, which only ever
+/// grows, geometrically. All of a `dyn_file_t`'s data lives in an arena. Releasing everything in it
+/// at once is just `file_arena_reset()`, which keeps the memory for the next loads, so loading many
+/// files one after another only calls `realloc()` when they need more room than any before them.
+typedef struct file_arena_s
+{
+    /// The memory block. It may move when the arena grows, so everything in it is referred to by
+    /// its offset from the start of the block, never by ptr.
+    char* buf;
+    size_t capacity;
+    size_t num_bytes_used;
+
+    /// The number of times `buf` has been (re)allocated, for stats
+    size_t num_grows;
+} file_arena_t;
+
+/// A dynamically-sized file, with no limit on its size or number of lines, like a `file_t` loaded
+/// with `file_load_mmap()`, but with its chars copied into memory, like with `file_load()`, and
+/// with no per-line allocations. The file's chars (plus a null terminator) and then its line start
+/// offsets are stored back to back in a `file_arena_t`. The line start offsets are 32-bit for files
+/// < 4 GiB, which is half the memory of the 64-bit `char*` line ptrs of a `file_t`, and 64-bit
+/// otherwise.
+typedef struct dyn_file_s
+{
+    /// The arena which holds this file's data. It may hold other files too.
+    file_arena_t* arena;
+
+    /// Offset of the file's first char in the arena
+    size_t i_data;
+    /// The total number of chars in the file, NOT including the null terminator after them
+    size_t num_chars;
+
+    /// Offset in the arena of the array of line start offsets, one per line, each relative to the
+    /// file's first char
+    size_t i_line_offsets;
+    size_t num_lines;
+    /// true if the line start offsets are `uint64_t`s; else they are `uint32_t`s
+    bool line_offsets_are_64_bit;
+} dyn_file_t;
+
+/// Initialize an arena to empty. It allocates no memory until the first load into it.
+void file_arena_init(file_arena_t* arena)
+{
+    memset(arena, 0, sizeof(*arena));
+}
+
+/// Release all files in the arena at once, but keep its memory to reuse for the next loads.
+/// All `dyn_file_t` objects loaded into it become invalid.
+void file_arena_reset(file_arena_t* arena)
+{
+    arena->num_bytes_used = 0;
+}
+
+/// Free the arena's memory. All `dyn_file_t` objects loaded into it become invalid.
+void file_arena_free(file_arena_t* arena)
+{
+    free(arena->buf);
+    file_arena_init(arena);
+}
+
+/// Make sure the arena has room for at least `num_bytes` more bytes, growing it geometrically if
+/// needed. Return false if out of memory.
+static bool file_arena_reserve(file_arena_t* arena, size_t num_bytes)
+{
+    size_t min_capacity = arena->num_bytes_used + num_bytes;
+    if (min_capacity <= arena->capacity)
+    {
+        return true;
+    }
+
+    size_t new_capacity = MAX(arena->capacity*2, (size_t)64*1024);
+    while (new_capacity < min_capacity)
+    {
+        new_capacity *= 2;
+    }
+    // Note: for large blocks, glibc's `realloc()` uses `mremap()`, so growing the arena does not
+    // copy its contents, even when the block moves.
+    char* new_buf = (char*)realloc(arena->buf, new_capacity);
+    if (new_buf == NULL)
+    {
+        return false;
+    }
+    arena->buf = new_buf;
+    arena->capacity = new_capacity;
+    arena->num_grows++;
+    return true;
+}
+
+/// Get a ptr to the first char of the dynamic file's data. It is null-terminated. This ptr is
+/// only valid until the arena grows, ie: until the next load into the same arena.
+static inline const char* dyn_file_get_data(const dyn_file_t* file)
+{
+    return &file->arena->buf[file->i_data];
+}
+
+/// Get the offset of the start of the line at 0-based index `i_line` from the start of the file.
+static inline size_t dyn_file_get_line_offset(const dyn_file_t* file, size_t i_line)
+{
+    const char* line_offsets = &file->arena->buf[file->i_line_offsets];
+    return file->line_offsets_are_64_bit ?
+        ((const uint64_t*)line_offsets)[i_line] : ((const uint32_t*)line_offsets)[i_line];
+}
+
+/// Get a ptr to the start of the line at 0-based index `i_line` in the dynamic file. Same validity
+/// as for `dyn_file_get_data()`.
+static inline const char* dyn_file_get_line_ptr(const dyn_file_t* file, size_t i_line)
+{
+    return dyn_file_get_data(file) + dyn_file_get_line_offset(file, i_line);
+}
+
+/// Same as `file_get_line_len()`, but for a dynamic file.
+size_t dyn_file_get_line_len(const dyn_file_t* file, size_t i_line, bool* has_line_ending)
+{
+    size_t line_end = i_line + 1 < file->num_lines ?
+        dyn_file_get_line_offset(file, i_line + 1) : file->num_chars;
+    return line_len_without_ending(dyn_file_get_line_ptr(file, i_line),
+        line_end - dyn_file_get_line_offset(file, i_line), has_line_ending);
+}
+
+/// Same as `file_print_lines()`, but for a dynamic file.
+void dyn_file_print_lines(const dyn_file_t* file, size_t first_line, size_t num_lines)
+{
+    if (file == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return;
+    }
+
+    if (num_lines == 0 || first_line == 0 || first_line > file->num_lines)
+    {
+        printf("ERROR in function %s(): first_line = %zu; num_lines = %zu; file->num_lines = "
+            "%zu.\n", __func__, first_line, num_lines, file->num_lines);
+        return;
+    }
+
+    size_t last_line = MIN(first_line + num_lines - 1, file->num_lines);
+    for (size_t line_number = first_line; line_number <= last_line; line_number++)
+    {
+        bool has_line_ending;
+        size_t len = dyn_file_get_line_len(file, line_number - 1, &has_line_ending);
+        printf("%4lu: ", line_number);
+        fwrite(dyn_file_get_line_ptr(file, line_number - 1), 1, len, stdout);
+        if (has_line_ending)
+        {
+            printf("\n");
+        }
+    }
+}
+
+/// Index the start of each line of a dynamic file whose chars, plus a null terminator, are the last
+/// thing in its arena, and append the line start offsets to the arena. Returns false if out of
+/// memory, in which case the caller must roll the arena back.
+static bool dyn_file_index(dyn_file_t* file)
+{
+    // Index the lines. The indexers write line ptrs, so index a batch of lines at a time into a
+    // small array of ptrs, and then convert that batch to offsets and append it to the arena. The
+    // arena may move whenever it grows, so take a fresh ptr to the file's data each time.
+    file_arena_t* arena = file->arena;
+    file->num_lines = 0;
+    file->line_offsets_are_64_bit = file->num_chars > UINT32_MAX;
+    size_t offset_size = file->line_offsets_are_64_bit ? sizeof(uint64_t) : sizeof(uint32_t);
+    arena->num_bytes_used = (arena->num_bytes_used + sizeof(uint64_t) - 1)
+        & ~(sizeof(uint64_t) - 1);
+    file->i_line_offsets = arena->num_bytes_used;
+
+    const char* batch[DYN_FILE_INDEX_BATCH_NUM_LINES];
+    size_t i_start = 0;
+    while (file->num_chars > 0 && i_start < file->num_chars)
+    {
+        if (!file_arena_reserve(arena, DYN_FILE_INDEX_BATCH_NUM_LINES*offset_size))
+        {
+            printf("ERROR in function %s(): Out of memory.\n", __func__);
+            return false;
+        }
+
+        const char* data = dyn_file_get_data(file);
+        size_t num_lines_in_batch = 0;
+        if (file->num_lines == 0)
+        {
+            batch[num_lines_in_batch++] = data;
+        }
+        num_lines_in_batch = newline_index(data, file->num_chars, &i_start, batch,
+            num_lines_in_batch, DYN_FILE_INDEX_BATCH_NUM_LINES);
+
+        char* line_offsets = &arena->buf[file->i_line_offsets];
+        for (size_t i = 0; i < num_lines_in_batch; i++)
+        {
+            size_t offset = batch[i] - data;
+            if (file->line_offsets_are_64_bit)
+            {
+                ((uint64_t*)line_offsets)[file->num_lines + i] = offset;
+            }
+            else
+            {
+                ((uint32_t*)line_offsets)[file->num_lines + i] = (uint32_t)offset;
+            }
+        }
+        file->num_lines += num_lines_in_batch;
+        arena->num_bytes_used += num_lines_in_batch*offset_size;
+    }
+
+    return true;
+}
+
+/// Same as `dyn_file_load()`, but copy the file's chars from `len` bytes of `data` in memory
+/// instead of reading them from a file. Returns false if out of memory, in which case the arena is
+/// left as it was.
+bool dyn_file_load_from_memory(dyn_file_t* file, file_arena_t* arena, const char* data, size_t len)
+{
+    size_t num_bytes_used_at_start = arena->num_bytes_used;
+    memset(file, 0, sizeof(*file));
+    file->arena = arena;
+    if (!file_arena_reserve(arena, len + 1))
+    {
+        printf("ERROR in function %s(): Out of memory.\n", __func__);
+        return false;
+    }
+    file->i_data = arena->num_bytes_used;
+    file->num_chars = len;
+    if (len > 0)
+    {
+        memcpy(&arena->buf[file->i_data], data, len);
+    }
+    arena->buf[file->i_data + len] = '\0';
+    arena->num_bytes_used += len + 1;
+
+    if (!dyn_file_index(file))
+    {
+        arena->num_bytes_used = num_bytes_used_at_start;
+        return false;
+    }
+    return true;
+}
+
+/// Read the whole file at `path` into the next free space in `arena`, and index the start of each
+/// of its lines into the arena right after it, without any limit on the file size or number of
+/// lines. Any number of files can be loaded into the same arena; release them all at once with
+/// `file_arena_reset()` to reuse the arena's memory for the next loads without any new allocations.
+/// - Returns false and prints an error if anything fails, in which case the arena is left as it was.
+bool dyn_file_load(dyn_file_t* file, file_arena_t* arena, const char* path)
+{
+    if (file == NULL || arena == NULL || path == NULL)
+    {
+        printf("ERROR in function %s(): NULL ptr.\n", __func__);
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        printf("ERROR in function %s(): Failed to open file (%s).\n",
+            __func__, strerror(errno));
+        return false;
+    }
+
+    size_t num_bytes_used_at_start = arena->num_bytes_used;
+    memset(file, 0, sizeof(*file));
+    file->arena = arena;
+    file->i_data = arena->num_bytes_used;
+
+    // Reserve room for the whole file plus a null terminator up front if we can get its size, but
+    // read until EOF regardless, so that pipes and files which are still growing work too
+    struct stat stat_buf;
+    size_t num_bytes_to_reserve = 64*1024;
+    if (fstat(fileno(fp), &stat_buf) == 0 && S_ISREG(stat_buf.st_mode))
+    {
+        num_bytes_to_reserve = stat_buf.st_size + 1;
+    }
+
+    bool ok = true;
+    while (true)
+    {
+        if (!file_arena_reserve(arena, num_bytes_to_reserve))
+        {
+            printf("ERROR in function %s(): Out of memory.\n", __func__);
+            ok = false;
+            break;
+        }
+        size_t num_bytes_free = arena->capacity - arena->num_bytes_used;
+        // Leave room for the null terminator
+        size_t num_bytes_read = fread(&arena->buf[arena->num_bytes_used], 1, num_bytes_free - 1, fp);
+        arena->num_bytes_used += num_bytes_read;
+        if (num_bytes_read < num_bytes_free - 1)
+        {
+            if (ferror(fp))
+            {
+                printf("ERROR in function %s(): Failed to read file.\n", __func__);
+                ok = false;
+            }
+            break;
+        }
+        // The file is bigger than we reserved room for; grow the arena
+        num_bytes_to_reserve = arena->capacity;
+    }
+    fclose(fp);
+    if (!ok)
+    {
+        arena->num_bytes_used = num_bytes_used_at_start;
+        return false;
+    }
+
+    file->num_chars = arena->num_bytes_used - file->i_data;
+    arena->buf[arena->num_bytes_used] = '\0';
+    arena->num_bytes_used++;
+
+    if (!dyn_file_index(file))
+    {
+        arena->num_bytes_used = num_bytes_used_at_start;
+        return false;
+    }
+
+    return true;
+}
+
+/// The ways `dyn_file_load_batch()` can load files
+typedef enum file_batch_backend_e
+{
+    /// io_uring if this kernel supports it, else a thread pool
+    FILE_BATCH_BACKEND_AUTO = 0,
+    /// io_uring: one thread keeps many opens, reads, and closes in flight at once
+    FILE_BATCH_BACKEND_IO_URING,
+    /// A pool of threads, each doing blocking `open()`, `read()`, and `close()` calls
+    FILE_BATCH_BACKEND_THREAD_POOL,
+} file_batch_backend_t;
+
+/// The default number of files `dyn_file_load_batch()` keeps in flight at once with io_uring
+#define FILE_BATCH_DEFAULT_QUEUE_DEPTH 64
+/// The default number of threads `dyn_file_load_batch()` uses for its thread pool. Blocking reads
+/// mostly wait on the disk, not the CPU, so this is more than the number of CPUs, to keep many
+/// requests in flight on an NVMe drive.
+#define FILE_BATCH_DEFAULT_NUM_THREADS 16
+
+/// State shared by the whole batch, whichever backend loads it
+typedef struct file_batch_s
+{
+    const char* const* paths;
+    dyn_file_t* files;
+    bool* loaded;
+    size_t num_files;
+    file_arena_t* arena;
+    /// Protects the arena in the thread pool backend; the io_uring backend uses 1 thread
+    pthread_mutex_t arena_mutex;
+    /// The next file for a thread pool worker to load
+    size_t next_file;
+} file_batch_t;
+
+/// Deliver one file's `len` bytes of `data`, read by either backend, into the batch's arena, and
+/// index its lines.
+static void file_batch_deliver(file_batch_t* batch, size_t i_file, const char* data, size_t len)
+{
+    batch->loaded[i_file] = dyn_file_load_from_memory(&batch->files[i_file], batch->arena, data,
+        len);
+}
+
+/// Record that a file failed to load, with the `errno`-style error `error`.
+static void file_batch_fail(file_batch_t* batch, size_t i_file, int error)
+{
+    printf("ERROR in function dyn_file_load_batch(): Failed to load file \"%s\" (%s).\n",
+        batch->paths[i_file], strerror(error));
+    memset(&batch->files[i_file], 0, sizeof(batch->files[i_file]));
+    batch->files[i_file].arena = batch->arena;
+    batch->loaded[i_file] = false;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Thread pool backend
+// -------------------------------------------------------------------------------------------------
+
+/// A thread pool worker: take the next file, read it into this thread's own buffer with blocking
+/// calls, and then deliver it into the shared arena under the mutex, until no files are left.
+static void* file_batch_worker(void* arg)
+{
+    file_batch_t* batch = (file_batch_t*)arg;
+    char* buf = NULL;
+    size_t buf_capacity = 0;
+
+    size_t i_file;
+    while ((i_file = __atomic_fetch_add(&batch->next_file, 1, __ATOMIC_RELAXED))
+        < batch->num_files)
+    {
+        int fd = open(batch->paths[i_file], O_RDONLY | O_CLOEXEC);
+        struct stat stat_buf;
+        if (fd < 0 || fstat(fd, &stat_buf) != 0)
+        {
+            int error = errno;
+            pthread_mutex_lock(&batch->arena_mutex);
+            file_batch_fail(batch, i_file, error);
+            pthread_mutex_unlock(&batch->arena_mutex);
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            continue;
+        }
+
+        size_t file_size = stat_buf.st_size;
+        if (file_size > buf_capacity)
+        {
+            char* new_buf = (char*)realloc(buf, file_size);
+            if (new_buf == NULL)
+            {
+                pthread_mutex_lock(&batch->arena_mutex);
+                file_batch_fail(batch, i_file, ENOMEM);
+                pthread_mutex_unlock(&batch->arena_mutex);
+                close(fd);
+                continue;
+            }
+            buf = new_buf;
+            buf_capacity = file_size;
+        }
+
+        size_t num_bytes_read = 0;
+        ssize_t ret = 1;
+        while (num_bytes_read < file_size
+            && (ret = read(fd, &buf[num_bytes_read], file_size - num_bytes_read)) > 0)
+        {
+            num_bytes_read += ret;
+        }
+        int error = errno;
+        close(fd);
+
+        pthread_mutex_lock(&batch->arena_mutex);
+        if (ret < 0)
+        {
+            file_batch_fail(batch, i_file, error);
+        }
+        else
+        {
+            file_batch_deliver(batch, i_file, buf, num_bytes_read);
+        }
+        pthread_mutex_unlock(&batch->arena_mutex);
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/// Load the whole batch with `num_threads` threads, including the calling thread.
+static void file_batch_load_thread_pool(file_batch_t* batch, size_t num_threads)
+{
+    size_t num_workers = MIN(num_threads, batch->num_files);
+    num_workers = num_workers > 1 ? num_workers - 1 : 0;
+    pthread_t* threads = NULL;
+    if (num_workers > 0)
+    {
+        threads = (pthread_t*)malloc(num_workers*sizeof(threads[0]));
+    }
+    size_t num_workers_started = 0;
+    for (size_t i = 0; threads != NULL && i < num_workers; i++)
+    {
+        // Fewer threads just means fewer reads in flight, so carry on with those that did start
+        if (pthread_create(&threads[i], NULL, file_batch_worker, batch) != 0)
+        {
+            break;
+        }
+        num_workers_started++;
+    }
+
+    file_batch_worker(batch);
+
+    for (size_t i = 0; i < num_workers_started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+}
+
+// -------------------------------------------------------------------------------------------------
+// io_uring backend
+// -------------------------------------------------------------------------------------------------
+
+/// A minimal io_uring instance, set up with the raw system calls, so that liburing is not needed.
+/// See: https://man7.org/linux/man-pages/man7/io_uring.7.html
+typedef struct file_batch_uring_s
+{
+    int fd;
+
+    // The submission queue (SQ) ring, and its array of submission queue entries (SQEs)
+    void* sq_ring;
+    size_t sq_ring_size;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    /// Number of SQEs queued, but not yet submitted to the kernel
+    unsigned num_to_submit;
+
+    // The completion queue (CQ) ring, which may be the same mapping as the SQ ring
+    void* cq_ring;
+    size_t cq_ring_size;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+} file_batch_uring_t;
+
+/// Return true if this kernel supports all of the io_uring operations the batch loader uses.
+static bool file_batch_uring_probe(int ring_fd)
+{
+    const uint8_t OPS_NEEDED[] = {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ,
+        IORING_OP_CLOSE};
+    const size_t NUM_OPS = 256;
+    struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1,
+        sizeof(*probe) + NUM_OPS*sizeof(probe->ops[0]));
+    if (probe == NULL)
+    {
+        return false;
+    }
+    bool supported = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe,
+        NUM_OPS) == 0;
+    for (size_t i = 0; supported && i < ARRAY_LEN(OPS_NEEDED); i++)
+    {
+        supported = OPS_NEEDED[i] <= probe->last_op
+            && (probe->ops[OPS_NEEDED[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    return supported;
+}
+
+/// Set up an io_uring instance with room for `num_entries` SQEs. Returns false if io_uring, or any
+/// operation the batch loader needs, is not available (ex: on kernels older than 5.6, or in many
+/// containers, where `io_uring_setup()` fails with `EPERM`).
+static bool file_batch_uring_init(file_batch_uring_t* ring, unsigned num_entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, num_entries, &params);
+    if (ring->fd < 0)
+    {
+        return false;
+    }
+    if (!file_batch_uring_probe(ring->fd))
+    {
+        close(ring->fd);
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+    {
+        ring->sq_ring_size = ring->cq_ring_size = MAX(ring->sq_ring_size, ring->cq_ring_size);
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring : mmap(NULL, ring->cq_ring_size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries*sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+        // Leaking any of the 3 mappings which did succeed is harmless here; this never happens
+        // unless the process is out of address space
+        close(ring->fd);
+        return false;
+    }
+
+    char* sq_ring = (char*)ring->sq_ring;
+    ring->sq_tail = (unsigned*)(sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq_ring + params.sq_off.array);
+    char* cq_ring = (char*)ring->cq_ring;
+    ring->cq_head = (unsigned*)(cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+    return true;
+}
+
+static void file_batch_uring_deinit(file_batch_uring_t* ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring)
+    {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/// Get the next free SQE, zeroed, to fill in and then queue with `file_batch_uring_queue()`. There
+/// is always one free, since the ring has room for every operation the batch can have in flight.
+static struct io_uring_sqe* file_batch_uring_get_sqe(file_batch_uring_t* ring)
+{
+    unsigned index = *ring->sq_tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/// Queue the SQE from `file_batch_uring_get_sqe()`, to be submitted with the next
+/// `io_uring_enter()` call.
+static void file_batch_uring_queue(file_batch_uring_t* ring)
+{
+    // We are the only writer of the SQ tail
+    unsigned tail = *ring->sq_tail;
+    ring->sq_array[tail & *ring->sq_mask] = tail & *ring->sq_mask;
+    // Publish the SQE to the kernel only after it is fully written
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->num_to_submit++;
+}
+
+/// The operations a slot has in flight, stored in the low bits of each SQE's `user_data`, with the
+/// slot index above them
+typedef enum file_batch_op_e
+{
+    FILE_BATCH_OP_OPEN = 0,
+    FILE_BATCH_OP_STATX,
+    FILE_BATCH_OP_READ,
+    FILE_BATCH_OP_CLOSE,
+} file_batch_op_t;
+
+/// The number of low bits of each SQE's `user_data` which hold its `file_batch_op_t`
+#define FILE_BATCH_OP_BITS 2
+/// The mask to get the `file_batch_op_t` out of an SQE's `user_data`
+#define FILE_BATCH_OP_MASK ((1U << FILE_BATCH_OP_BITS) - 1)
+
+/// One file being loaded by the io_uring backend. Each slot goes through these steps, with the
+/// open and `statx()` in flight at the same time:
+///     open + statx -> read (repeated on short reads) -> close
+typedef struct file_batch_slot_s
+{
+    size_t i_file;
+    bool active;
+    int fd;
+    struct statx statx_buf;
+    /// Number of operations in flight for this slot
+    unsigned num_in_flight;
+    /// The first error, as a positive `errno` value, or 0 if none
+    int error;
+
+    /// This slot's read buffer, reused and grown as needed for each file it loads
+    char* buf;
+    size_t buf_capacity;
+    size_t file_size;
+    size_t num_bytes_read;
+} file_batch_slot_t;
+
+/// Start loading file `i_file` in a slot: queue its open and `statx()` at once.
+static void file_batch_slot_start(file_batch_t* batch, file_batch_uring_t* ring,
+    file_batch_slot_t* slot, size_t i_slot, size_t i_file)
+{
+    slot->i_file = i_file;
+    slot->active = true;
+    slot->fd = -1;
+    slot->error = 0;
+    slot->num_bytes_read = 0;
+
+    struct io_uring_sqe* sqe = file_batch_uring_get_sqe(ring);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)batch->paths[i_file];
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = (i_slot << FILE_BATCH_OP_BITS) | FILE_BATCH_OP_OPEN;
+    file_batch_uring_queue(ring);
+
+    sqe = file_batch_uring_get_sqe(ring);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)batch->paths[i_file];
+    sqe->len = STATX_SIZE;
+    sqe->off = (uint64_t)(uintptr_t)&slot->statx_buf;
+    sqe->user_data = (i_slot << FILE_BATCH_OP_BITS) | FILE_BATCH_OP_STATX;
+    file_batch_uring_queue(ring);
+
+    slot->num_in_flight = 2;
+}
+
+/// Queue a read of the rest of the slot's file, or its close if it has all been read or if
+/// anything failed.
+static void file_batch_slot_continue(file_batch_uring_t* ring, file_batch_slot_t* slot,
+    size_t i_slot)
+{
+    struct io_uring_sqe* sqe = file_batch_uring_get_sqe(ring);
+    if (slot->error == 0 && slot->num_bytes_read < slot->file_size)
+    {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = slot->fd;
+        sqe->addr = (uint64_t)(uintptr_t)&slot->buf[slot->num_bytes_read];
+        sqe->len = (unsigned)MIN(slot->file_size - slot->num_bytes_read, (size_t)1 << 30);
+        sqe->off = slot->num_bytes_read;
+        sqe->user_data = (i_slot << FILE_BATCH_OP_BITS) | FILE_BATCH_OP_READ;
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = slot->fd;
+        sqe->user_data = (i_slot << FILE_BATCH_OP_BITS) | FILE_BATCH_OP_CLOSE;
+    }
+    file_batch_uring_queue(ring);
+    slot->num_in_flight++;
+}
+
+/// Handle one completed operation for a slot, and queue its next one. Returns true when the slot
+/// is done with its file, which has then been delivered (or failed).
+static bool file_batch_slot_complete(file_batch_t* batch, file_batch_uring_t* ring,
+    file_batch_slot_t* slot, size_t i_slot, file_batch_op_t op, int res)
+{
+    slot->num_in_flight--;
+    if (res < 0 && slot->error == 0 && op != FILE_BATCH_OP_CLOSE)
+    {
+        slot->error = -res;
+    }
+
+    switch (op)
+    {
+        case FILE_BATCH_OP_OPEN:
+        case FILE_BATCH_OP_STATX:
+            if (op == FILE_BATCH_OP_OPEN && res >= 0)
+            {
+                slot->fd = res;
+            }
+            if (slot->num_in_flight > 0)
+            {
+                // Still waiting for the other one
+                return false;
+            }
+            if (slot->fd < 0)
+            {
+                // Nothing to close
+                break;
+            }
+            if (slot->error == 0)
+            {
+                slot->file_size = slot->statx_buf.stx_size;
+                if (slot->file_size > slot->buf_capacity)
+                {
+                    char* new_buf = (char*)realloc(slot->buf, slot->file_size);
+                    if (new_buf == NULL)
+                    {
+                        slot->error = ENOMEM;
+                    }
+                    else
+                    {
+                        slot->buf = new_buf;
+                        slot->buf_capacity = slot->file_size;
+                    }
+                }
+            }
+            file_batch_slot_continue(ring, slot, i_slot);
+            return false;
+
+        case FILE_BATCH_OP_READ:
+            if (res == 0)
+            {
+                // The file shrank since its `statx()`; keep what we got
+                slot->file_size = slot->num_bytes_read;
+            }
+            else if (res > 0)
+            {
+                slot->num_bytes_read += res;
+            }
+            file_batch_slot_continue(ring, slot, i_slot);
+            return false;
+
+        case FILE_BATCH_OP_CLOSE:
+        default:
+            break;
+    }
+
+    if (slot->error != 0)
+    {
+        file_batch_fail(batch, slot->i_file, slot->error);
+    }
+    else
+    {
+        file_batch_deliver(batch, slot->i_file, slot->buf, slot->num_bytes_read);
+    }
+    slot->active = false;
+    return true;
+}
+
+/// Load the whole batch with io_uring, with up to `queue_depth` files in flight at once. Returns
+/// false, having loaded nothing, if io_uring is not available.
+static bool file_batch_load_io_uring(file_batch_t* batch, size_t queue_depth)
+{
+    queue_depth = MAX(MIN(queue_depth, batch->num_files), (size_t)1);
+    file_batch_uring_t ring;
+    // Each slot has at most 2 operations in flight at once
+    if (!file_batch_uring_init(&ring, (unsigned)(2*queue_depth)))
+    {
+        return false;
+    }
+    file_batch_slot_t* slots = (file_batch_slot_t*)calloc(queue_depth, sizeof(slots[0]));
+    if (slots == NULL)
+    {
+        file_batch_uring_deinit(&ring);
+        return false;
+    }
+
+    size_t next_file = 0;
+    size_t num_active = 0;
+    bool ring_failed = false;
+    for (size_t i_slot = 0; i_slot < queue_depth && next_file < batch->num_files; i_slot++)
+    {
+        file_batch_slot_start(batch, &ring, &slots[i_slot], i_slot, next_file++);
+        num_active++;
+    }
+
+    while (num_active > 0)
+    {
+        // Submit everything queued since the last call, and wait for at least 1 completion
+        int ret = (int)syscall(__NR_io_uring_enter, ring.fd, ring.num_to_submit, 1,
+            IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            {
+                continue;
+            }
+            // The ring itself is broken, which should never happen; give up on the rest
+            printf("ERROR in function %s(): io_uring_enter() failed (%s).\n", __func__,
+                strerror(errno));
+            ring_failed = true;
+            break;
+        }
+        ring.num_to_submit -= ret;
+
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            const struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+            size_t i_slot = cqe->user_data >> FILE_BATCH_OP_BITS;
+            file_batch_op_t op = (file_batch_op_t)(cqe->user_data & FILE_BATCH_OP_MASK);
+            if (file_batch_slot_complete(batch, &ring, &slots[i_slot], i_slot, op, cqe->res))
+            {
+                if (next_file < batch->num_files)
+                {
+                    file_batch_slot_start(batch, &ring, &slots[i_slot], i_slot, next_file++);
+                }
+                else
+                {
+                    num_active--;
+                }
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    if (ring_failed)
+    {
+        // Reads may still be in flight into the slots' buffers, so leak them rather than free them
+        for (size_t i = 0; i < queue_depth; i++)
+        {
+            if (slots[i].active)
+            {
+                file_batch_fail(batch, slots[i].i_file, EIO);
+            }
+        }
+        for (; next_file < batch->num_files; next_file++)
+        {
+            file_batch_fail(batch, next_file, EIO);
+        }
+        close(ring.fd);
+        return true;
+    }
+
+    for (size_t i = 0; i < queue_depth; i++)
+    {
+        free(slots[i].buf);
+    }
+    free(slots);
+    file_batch_uring_deinit(&ring);
+    return true;
+}
 
-References:
-1. I'm seeking to answer this question, more or less:
-   [C function to load file content in string array](https://stackoverflow.com/q/71330345/4561887)
-    1. *****+[my answer] https://stackoverflow.com/a/71346853/4561887
-1. https://en.cppreference.com/w/c/io/fopen
-1. https://en.cppreference.com/w/c/string/byte/strerror - shows a good usage example of
-   `printf("File opening error: %s\n", strerror(errno));` if `fopen()` fails when opening a file.
-1. https://en.cppreference.com/w/c/io/fgetc
+/// Load many files at once, into consecutive space in `arena`, keeping many opens and reads in
+/// flight at once, rather than one blocking `open()` and `read()` at a time as `dyn_file_load()`
+/// does. On an NVMe drive, which can serve many requests in parallel, this cuts the time to load
+/// thousands of small files with a cold page cache by a large factor.
+/// - `files` and `loaded` must each have room for `num_files` elements. `files[i]` gets the
+///   contents and line index of the file at `paths[i]`, and `loaded[i]` is set to whether it
+///   loaded. A file which fails to load is left empty, with an error printed.
+/// - `backend` selects io_uring or a thread pool; `FILE_BATCH_BACKEND_AUTO` uses io_uring if the
+///   kernel supports it, and the thread pool otherwise.
+/// - `concurrency` is the number of files in flight at once with io_uring, or the number of
+///   threads in the thread pool; 0 uses `FILE_BATCH_DEFAULT_QUEUE_DEPTH` or
+///   `FILE_BATCH_DEFAULT_NUM_THREADS`, respectively.
+/// - Returns the backend actually used.
+file_batch_backend_t dyn_file_load_batch(dyn_file_t* files, bool* loaded,
+    const char* const* paths, size_t num_files, file_arena_t* arena, file_batch_backend_t backend,
+    size_t concurrency)
+{
+    file_batch_t batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.paths = paths;
+    batch.files = files;
+    batch.loaded = loaded;
+    batch.num_files = num_files;
+    batch.arena = arena;
+    pthread_mutex_init(&batch.arena_mutex, NULL);
 
+    // Pick the newline indexer now, in this thread, since `newline_index()` does so lazily, and
+    // not thread-safely, on its first call
+    newline_indexer_get_cached();
 
-*/
+    if (backend != FILE_BATCH_BACKEND_THREAD_POOL)
+    {
+        size_t queue_depth = concurrency > 0 ? concurrency : FILE_BATCH_DEFAULT_QUEUE_DEPTH;
+        if (file_batch_load_io_uring(&batch, queue_depth))
+        {
+            backend = FILE_BATCH_BACKEND_IO_URING;
+        }
+        else
+        {
+            backend = FILE_BATCH_BACKEND_THREAD_POOL;
+        }
+    }
+    if (backend == FILE_BATCH_BACKEND_THREAD_POOL)
+    {
+        size_t num_threads = concurrency > 0 ? concurrency : FILE_BATCH_DEFAULT_NUM_THREADS;
+        file_batch_load_thread_pool(&batch, num_threads);
+    }
 
-#include <errno.h>
-#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
-#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
-#include <stdio.h>   // For `printf()`
-#include <string.h>  // for `strerror()`
+    pthread_mutex_destroy(&batch.arena_mutex);
+    return backend;
+}
 
+/// Get a monotonic timestamp in seconds, for timing the file loads.
+static double get_time_sec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1e9;
+}
 
-// Get the number of elements in any C array
-// - Usage example: [my own answer]:
-//   https://arduino.stackexchange.com/questions/80236/initializing-array-of-structs/80289#80289
-#define ARRAY_LEN(array) (sizeof(array) / sizeof(array[0]))
+/// A newline indexer with the same signature as the others, but which checks one char at a time,
+/// like the original `fgetc()` loop in `file_load()` did; only used as a benchmark baseline.
+static size_t newline_index_per_char(const char* data, size_t len, size_t* i_start,
+    const char** line_array, size_t num_lines, size_t max_lines)
+{
+    for (size_t i = *i_start; i + 1 < len; i++)
+    {
+        if (data[i] == '\n')
+        {
+            if (num_lines == max_lines)
+            {
+                *i_start = i;
+                return num_lines;
+            }
+            line_array[num_lines] = &data[i + 1];
+            num_lines++;
+        }
+    }
 
-/// Max and min gcc/clang **statement expressions** (safer than macros) for C. By Gabriel Staples.
-/// See: https://stackoverflow.com/a/58532788/4561887
-#define MAX(a, b)               \
-    ({                          \
-        __typeof__(a) _a = (a); \
-        __typeof__(b) _b = (b); \
-        _a > _b ? _a : _b;      \
-    })
-#define MIN(a, b)               \
-    ({                          \
-        __typeof__(a) _a = (a); \
-        __typeof__(b) _b = (b); \
-        _a < _b ? _a : _b;      \
-    })
+    *i_start = len;
+    return num_lines;
+}
 
-/// Bytes per megabyte
-#define BYTES_PER_MB (1000*1000)
-/// Bytes per mebibyte
-#define BYTES_PER_MIB (1024*1024)
+typedef struct newline_indexer_info_s
+{
+    const char* name;
+    newline_indexer_t indexer;
+    bool supported;
+} newline_indexer_info_t;
 
-/// Convert bytes to megabytes
-#define BYTES_TO_MB(bytes) (((double)(bytes))/BYTES_PER_MB)
-/// Convert bytes to mebibytes
-#define BYTES_TO_MIB(bytes) (((double)(bytes))/BYTES_PER_MIB)
+/// Get all of the newline indexers, and whether or not this CPU supports each one.
+static size_t newline_indexers_get_all(newline_indexer_info_t indexers[4])
+{
+    size_t num_indexers = 0;
+    indexers[num_indexers++] = (newline_indexer_info_t){"per_char", newline_index_per_char, true};
+    indexers[num_indexers++] = (newline_indexer_info_t){"portable", newline_index_portable, true};
+#if NEWLINE_INDEX_X86
+    __builtin_cpu_init();
+    indexers[num_indexers++] = (newline_indexer_info_t){"sse2", newline_index_sse2,
+        (bool)__builtin_cpu_supports("sse2")};
+    indexers[num_indexers++] = (newline_indexer_info_t){"avx2", newline_index_avx2,
+        (bool)__builtin_cpu_supports("avx2")};
+#endif
+    return num_indexers;
+}
 
-#define MAX_NUM_LINES 10000UL
-#define MAX_NUM_CHARS (MAX_NUM_LINES*200UL) // 2 MB
-#define MAX_PATH_LEN (1000)
+/// Index all lines in `data` with `indexer`, `max_lines` at a time, resuming each time the line
+/// array fills up, like `file_load_mmap()` does. Returns the number of lines.
+static size_t newline_index_all(newline_indexer_t indexer, const char* data, size_t len,
+    const char** line_array, size_t max_lines)
+{
+    size_t num_lines = 0;
+    size_t i_start = 0;
+    if (len > 0)
+    {
+        line_array[0] = data;
+        num_lines = 1;
+    }
+    while (i_start < len)
+    {
+        // Pretend that the caller makes room by dropping the lines found so far
+        size_t num_lines_before = num_lines;
+        size_t num_lines_found = indexer(data, len, &i_start, line_array, 0, max_lines);
+        num_lines = num_lines_before + num_lines_found;
+    }
+    return num_lines;
+}
 
-typedef struct file_s
+/// Check that all newline indexers find the same line starts as the per-char loop, on random data
+/// made of "\n", "\r\n", and other chars, for every length from 0 to 300, starting at every
+/// alignment, and with line arrays so small that they fill up and must be resumed many times.
+/// Also check `file_get_line_len()` on CRLF lines. Returns true if all checks pass.
+static bool newline_index_test()
 {
-    /// The path to the file to open.
-    char path[MAX_PATH_LEN];
+    static char buf[400];
+    static const char* expected[400];
+    static const char* actual[400];
+    newline_indexer_info_t indexers[4];
+    size_t num_indexers = newline_indexers_get_all(indexers);
 
-    /// All characters read from the file.
-    char file_str[MAX_NUM_CHARS];     // array of `char`
+    srand(12345);
+    for (size_t len = 0; len <= 300; len++)
+    {
+        for (size_t offset = 0; offset < 64; offset += 7)
+        {
+            char* data = &buf[offset];
+            for (size_t i = 0; i < len; i++)
+            {
+                int r = rand() % 8;
+                data[i] = r == 0 ? '\n' : r == 1 ? '\r' : (char)('a' + r);
+            }
 
-    /// The total number of chars read into the `file_str` string, including
-    //  null terminator.
-    size_t num_chars;
+            size_t i_start = 0;
+            size_t num_expected = newline_index_per_char(data, len, &i_start, expected, 0,
+                ARRAY_LEN(expected));
 
-    /// A ptr to each line in the file.
-    char* line_array[MAX_NUM_LINES];  // array of `char*` (ptr to char)
+            for (size_t i_indexer = 1; i_indexer < num_indexers; i_indexer++)
+            {
+                if (!indexers[i_indexer].supported)
+                {
+                    continue;
+                }
+                newline_indexer_t indexer = indexers[i_indexer].indexer;
 
-    /// The total number of lines in the file, and hence in the `line_array`
-    //  above.
-    size_t num_lines;
-} file_t;
+                // All at once
+                i_start = 0;
+                size_t num_actual = indexer(data, len, &i_start, actual, 0, ARRAY_LEN(actual));
+                if (i_start != len || num_actual != num_expected
+                    || memcmp(actual, expected, num_expected*sizeof(expected[0])) != 0)
+                {
+                    printf("  %s: mismatch for len = %zu, offset = %zu\n",
+                        indexers[i_indexer].name, len, offset);
+                    return false;
+                }
 
-/// Copy the file path pointed to by `path` into the `file_t` object.
-void file_store_path(file_t* file, const char *path)
-{
-    if (file == NULL || path == NULL)
+                // 3 lines at a time, resuming each time
+                i_start = 0;
+                num_actual = 0;
+                while (i_start < len)
+                {
+                    num_actual = indexer(data, len, &i_start, actual, num_actual,
+                        MIN(num_actual + 3, ARRAY_LEN(actual)));
+                }
+                if (num_actual != num_expected
+                    || memcmp(actual, expected, num_expected*sizeof(expected[0])) != 0)
+                {
+                    printf("  %s: resume mismatch for len = %zu, offset = %zu\n",
+                        indexers[i_indexer].name, len, offset);
+                    return false;
+                }
+            }
+        }
+    }
+
+    // CRLF line lengths
+    static file_t crlf_file;
+    const char CRLF_STR[] = "ab\r\n\r\nc\n\rd\r\nlast";
+    memcpy(crlf_file.file_str, CRLF_STR, sizeof(CRLF_STR) - 1);
+    crlf_file.num_chars = sizeof(CRLF_STR) - 1;
+    crlf_file.line_array[0] = crlf_file.file_str;
+    size_t i_start = 0;
+    crlf_file.num_lines = newline_index(crlf_file.file_str, crlf_file.num_chars, &i_start,
+        crlf_file.line_array, 1, ARRAY_LEN(crlf_file.line_array));
+    const size_t EXPECTED_LENS[] = {2, 0, 1, 2, 4};
+    const bool EXPECTED_HAS_LINE_ENDINGS[] = {true, true, true, true, false};
+    if (crlf_file.num_lines != ARRAY_LEN(EXPECTED_LENS))
     {
-        printf("ERROR in function %s(): NULL ptr.\n", __func__);
-        return;
+        printf("  CRLF: num_lines = %zu\n", crlf_file.num_lines);
+        return false;
+    }
+    for (size_t i = 0; i < crlf_file.num_lines; i++)
+    {
+        bool has_line_ending;
+        size_t len = file_get_line_len(&crlf_file, i, &has_line_ending);
+        if (len != EXPECTED_LENS[i] || has_line_ending != EXPECTED_HAS_LINE_ENDINGS[i])
+        {
+            printf("  CRLF: line %zu has len = %zu\n", i + 1, len);
+            return false;
+        }
     }
 
-    strncpy(file->path, path, sizeof(file->path));
+    return true;
 }
 
-/// Print the entire line at 1-based line number `line_number` in file `file`, including the
-/// '\n' at the end of the line.
-void file_print_line(const file_t* file, size_t line_number)
+/// Time each newline indexer on an already-loaded (and hence already in the page cache) file, and
+/// print its throughput.
+static void newline_index_benchmark(const file_t* file)
 {
-    if (file == NULL)
+    const size_t MAX_LINES = 1024*1024;
+    const char** line_array = (const char**)malloc(MAX_LINES*sizeof(line_array[0]));
+    if (line_array == NULL)
     {
-        printf("ERROR in function %s(): NULL ptr.\n", __func__);
         return;
     }
 
-    // Ensure we don't read outside the `file->line_array`
-    if (line_number > file->num_lines)
+    newline_indexer_info_t indexers[4];
+    size_t num_indexers = newline_indexers_get_all(indexers);
+    for (size_t i = 0; i < num_indexers; i++)
     {
-        printf("ERROR in function %s(): line_number (%zu) is too large (file->num_lines = %zu).\n",
-            __func__, line_number, file->num_lines);
-        return;
+        if (!indexers[i].supported)
+        {
+            continue;
+        }
+        double t_start = get_time_sec();
+        size_t num_lines = newline_index_all(indexers[i].indexer, file_get_data(file),
+            file->num_chars, line_array, MAX_LINES);
+        double t_elapsed = get_time_sec() - t_start;
+        printf("  %-8s  %10.1f MB/sec  (%zu lines)\n", indexers[i].name,
+            BYTES_TO_MB(file->num_chars)/t_elapsed, num_lines);
     }
 
-    size_t i_line = line_number - 1;
-    char* line = file->line_array[i_line];
-    if (line == NULL)
-    {
-        printf("ERROR in function %s(): line_array contains NULL ptr for line_number = %zu at "
-               "index = %zu.\n", __func__, line_number, i_line);
-        return;
-    }
+    free(line_array);
+}
 
-    // print all chars in the line
-    size_t i_char = 0;
-    while (true)
+/// Load the file at `path` with `file_load_mmap_parallel()` using 1 to 32 threads, check that each
+/// result is identical to `reference` (loaded with `file_load_mmap()`), and print the scaling.
+/// The file should already be in the page cache, so that this measures the indexing, not the disk.
+static void file_load_mmap_parallel_benchmark(const char* path, const file_t* reference)
+{
+    static file_t file_parallel;
+    file_store_path(&file_parallel, path);
+
+    double t_elapsed_1_thread = 0;
+    for (size_t num_threads = 1; num_threads <= 32; num_threads *= 2)
     {
-        if (i_char > file->num_chars - 1)
+        double t_start = get_time_sec();
+        bool ok = file_load_mmap_parallel(&file_parallel, num_threads);
+        double t_elapsed = get_time_sec() - t_start;
+        if (!ok)
         {
-            // outside valid data
-            break;
+            return;
+        }
+        if (num_threads == 1)
+        {
+            t_elapsed_1_thread = t_elapsed;
         }
 
-        char c = line[i_char];
-        if (c == '\n')
+        bool matches = file_parallel.num_lines == reference->num_lines;
+        for (size_t i = 0; matches && i < reference->num_lines; i++)
         {
-            printf("%c", c);
-            break;
+            matches = file_parallel.mapped_line_array[i] - file_parallel.mapped_str
+                == reference->mapped_line_array[i] - reference->mapped_str;
         }
-        else if (c == '\0')
+        printf("  %2zu threads  %10.1f MB/sec  %5.2fx  (%zu lines; matches file_load_mmap(): %s)\n",
+            num_threads, BYTES_TO_MB(file_parallel.num_chars)/t_elapsed,
+            t_elapsed_1_thread/t_elapsed, file_parallel.num_lines, matches ? "yes" : "==NO!==");
+        file_unload(&file_parallel);
+    }
+}
+
+/// Load the file at `path` with `dyn_file_load()` twice, first into a new arena, and then into the
+/// same arena after releasing it, check that each result is identical to `reference` (loaded with
+/// `file_load_mmap()`), and print the speed and memory use of each.
+static void dyn_file_benchmark(const char* path, file_arena_t* arena, const file_t* reference)
+{
+    file_arena_free(arena);
+    for (size_t i_load = 0; i_load < 2; i_load++)
+    {
+        file_arena_reset(arena);
+        size_t num_grows = arena->num_grows;
+        dyn_file_t dyn_file;
+        double t_start = get_time_sec();
+        bool ok = dyn_file_load(&dyn_file, arena, path);
+        double t_elapsed = get_time_sec() - t_start;
+        if (!ok)
         {
-            // null terminator
-            break;
+            return;
         }
 
-        printf("%c", c);
-        i_char++;
+        bool matches = dyn_file.num_lines == reference->num_lines;
+        for (size_t i = 0; matches && i < reference->num_lines; i++)
+        {
+            matches = dyn_file_get_line_offset(&dyn_file, i)
+                == (size_t)(reference->mapped_line_array[i] - reference->mapped_str);
+        }
+        size_t offset_size = dyn_file.line_offsets_are_64_bit ? sizeof(uint64_t) : sizeof(uint32_t);
+        printf("dyn_file_load() into %s arena: %.3f sec (%.1f MB/sec); arena allocations = %zu; "
+               "matches file_load_mmap(): %s\n", i_load == 0 ? "a new" : "the same, released,",
+               t_elapsed, BYTES_TO_MB(dyn_file.num_chars)/t_elapsed, arena->num_grows - num_grows,
+               matches ? "yes" : "==NO!==");
+        printf("  line index memory: %.3f MB (%zu-byte offsets), vs %.3f MB for `char*` line ptrs\n",
+            BYTES_TO_MB(dyn_file.num_lines*offset_size), offset_size,
+            BYTES_TO_MB(dyn_file.num_lines*sizeof(const char*)));
     }
 }
 
-/// Print `num_lines` number of lines in a file, starting at 1-based line number `first_line`,
-/// and including the '\n' at the end of each line.
-/// At the start of each line, the line number is also printed, followed by a colon (:).
-void file_print_lines(const file_t* file, size_t first_line, size_t num_lines)
+/// The number and location of the small files for `dyn_file_load_batch_benchmark()`
+#define BATCH_BENCHMARK_NUM_FILES 2000
+#define BATCH_BENCHMARK_DIR "/tmp/read_file_into_c_string_and_array_of_lines_batch"
+
+/// Generate `num_files` small text files of random sizes, up to 16 KiB, like a program's config and
+/// data files, into `dir`, or reuse them if they were already generated by an earlier run. Their
+/// data is flushed to disk, so that their pages can then be evicted from the page cache. Returns
+/// false if anything fails.
+static bool batch_benchmark_create_files(const char* dir, char (*paths)[MAX_PATH_LEN],
+    size_t num_files)
 {
-    if (file == NULL)
+    for (size_t i = 0; i < num_files; i++)
     {
-        printf("ERROR in function %s(): NULL ptr.\n", __func__);
-        return;
+        snprintf(paths[i], MAX_PATH_LEN, "%s/file_%04zu.txt", dir, i);
+    }
+    char done_path[MAX_PATH_LEN];
+    snprintf(done_path, sizeof(done_path), "%s/done_%zu", dir, num_files);
+    if (access(done_path, F_OK) == 0)
+    {
+        return true;
     }
 
-    if (num_lines == 0 || file->num_lines == 0)
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
     {
-        printf("ERROR in function %s(): num_lines passed in == %zu; file->num_lines = %zu.\n",
-            __func__, num_lines, file->num_lines);
-        return;
+        printf("ERROR in function %s(): Failed to create dir (%s).\n", __func__, strerror(errno));
+        return false;
+    }
+    uint64_t rand_state = 0x9E3779B97F4A7C15ULL;
+    char buf[16*1024];
+    for (size_t i = 0; i < num_files; i++)
+    {
+        rand_state ^= rand_state << 13;
+        rand_state ^= rand_state >> 7;
+        rand_state ^= rand_state << 17;
+        size_t len = rand_state % sizeof(buf);
+        for (size_t j = 0; j < len; j++)
+        {
+            rand_state ^= rand_state << 13;
+            rand_state ^= rand_state >> 7;
+            rand_state ^= rand_state << 17;
+            buf[j] = rand_state % 40 == 0 ? '\n' : (char)('a' + (rand_state >> 32) % 26);
+        }
+        FILE* fp = fopen(paths[i], "w");
+        if (fp == NULL || fwrite(buf, 1, len, fp) != len)
+        {
+            printf("ERROR in function %s(): Failed to write file (%s).\n", __func__,
+                strerror(errno));
+            if (fp != NULL)
+            {
+                fclose(fp);
+            }
+            return false;
+        }
+        fclose(fp);
     }
+    sync();
 
-    // Ensure we don't read outside the valid data
-    size_t last_line = MIN(first_line + num_lines - 1, file->num_lines);
-    // printf("last_line = %zu\n", last_line); // DEBUGGING
-    for (size_t line_number = first_line; line_number <= last_line; line_number++)
+    FILE* fp = fopen(done_path, "w");
+    if (fp != NULL)
     {
-        printf("%4lu: ", line_number);
-        file_print_line(file, line_number);
+        fclose(fp);
     }
+    return true;
 }
 
-/// Print an entire file.
-void file_print_all(const file_t* file)
+/// Evict all of the files' pages from the page cache, without needing root.
+static void batch_benchmark_drop_page_cache(const char* const* paths, size_t num_files)
 {
-    printf("num_chars to print = %zu\n", file->num_chars);
-    printf("num_lines to print = %zu\n", file->num_lines);
-    printf("========== FILE START ==========\n");
-    file_print_lines(file, 1, file->num_lines);
-    printf("=========== FILE END ===========\n");
+    for (size_t i = 0; i < num_files; i++)
+    {
+        int fd = open(paths[i], O_RDONLY);
+        if (fd >= 0)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
 }
 
-/// Read all characters from a file on your system at the path specified in the
-/// file object and copy this file data **into** the passed-in `file` object.
-void file_load(file_t* file)
+/// Return true if 2 dynamic files have identical contents and line indexes.
+static bool dyn_file_equals(const dyn_file_t* file1, const dyn_file_t* file2)
 {
-    if (file == NULL)
+    if (file1->num_chars != file2->num_chars || file1->num_lines != file2->num_lines
+        || memcmp(dyn_file_get_data(file1), dyn_file_get_data(file2), file1->num_chars) != 0)
     {
-        printf("ERROR in function %s(): NULL ptr.\n", __func__);
-        return;
+        return false;
+    }
+    for (size_t i = 0; i < file1->num_lines; i++)
+    {
+        if (dyn_file_get_line_offset(file1, i) != dyn_file_get_line_offset(file2, i))
+        {
+            return false;
+        }
     }
+    return true;
+}
 
-    FILE* fp = fopen(file->path, "r");
-    if (fp == NULL)
+/// Load `BATCH_BENCHMARK_NUM_FILES` small files one at a time with `dyn_file_load()`, and then all
+/// at once with `dyn_file_load_batch()` with each backend, with a cold and a warm page cache, check
+/// that each batch's results are identical to the one-at-a-time results, and print the times.
+static void dyn_file_load_batch_benchmark()
+{
+    const size_t NUM_FILES = BATCH_BENCHMARK_NUM_FILES;
+    char (*path_bufs)[MAX_PATH_LEN] = (char (*)[MAX_PATH_LEN])malloc(NUM_FILES*MAX_PATH_LEN);
+    const char** paths = (const char**)malloc(NUM_FILES*sizeof(paths[0]));
+    dyn_file_t* expected_files = (dyn_file_t*)malloc(NUM_FILES*sizeof(expected_files[0]));
+    dyn_file_t* files = (dyn_file_t*)malloc(NUM_FILES*sizeof(files[0]));
+    bool* loaded = (bool*)malloc(NUM_FILES*sizeof(loaded[0]));
+    file_arena_t expected_arena;
+    file_arena_t arena;
+    file_arena_init(&expected_arena);
+    file_arena_init(&arena);
+    if (path_bufs == NULL || paths == NULL || expected_files == NULL || files == NULL
+        || loaded == NULL || !batch_benchmark_create_files(BATCH_BENCHMARK_DIR, path_bufs, NUM_FILES))
     {
-        printf("ERROR in function %s(): Failed to open file (%s).\n",
-            __func__, strerror(errno));
-        return;
+        goto cleanup;
+    }
+    for (size_t i = 0; i < NUM_FILES; i++)
+    {
+        paths[i] = path_bufs[i];
     }
 
-    // See: https://en.cppreference.com/w/c/io/fgetc
-    int c; // note: int, not char, required to handle EOF
-    size_t i_write_char = 0;
-    size_t i_write_line = 0;
-    bool start_of_line = true;
-    const size_t I_WRITE_CHAR_MAX = ARRAY_LEN(file->file_str) - 1;
-    const size_t I_WRITE_LINE_MAX = ARRAY_LEN(file->line_array) - 1;
-    while ((c = fgetc(fp)) != EOF) // standard C I/O file reading loop
+    printf("Loading %zu small files from \"%s\":\n", NUM_FILES, BATCH_BENCHMARK_DIR);
+    for (int cold = 1; cold >= 0; cold--)
     {
-        // 1. Write the char
-        if (i_write_char > I_WRITE_CHAR_MAX)
+        const char* cache = cold ? "cold" : "warm";
+
+        // The baseline: one blocking open and read at a time
+        if (cold)
         {
-            printf("ERROR in function %s(): file is full (i_write_char = "
-                   "%zu, but I_WRITE_CHAR_MAX is only %zu).\n",
-                   __func__, i_write_char, I_WRITE_CHAR_MAX);
-            break;
+            batch_benchmark_drop_page_cache(paths, NUM_FILES);
         }
-        file->file_str[i_write_char] = c;
-
-        // 2. Write the ptr to the line
-        if (start_of_line)
+        file_arena_reset(&expected_arena);
+        double t_start = get_time_sec();
+        for (size_t i = 0; i < NUM_FILES; i++)
         {
-            start_of_line = false;
+            dyn_file_load(&expected_files[i], &expected_arena, paths[i]);
+        }
+        double t_elapsed_baseline = get_time_sec() - t_start;
+        printf("  %-34s  %s cache: %8.2f ms  (%7.0f files/sec)\n", "dyn_file_load() one at a time",
+            cache, t_elapsed_baseline*1000, NUM_FILES/t_elapsed_baseline);
 
-            if (i_write_line > I_WRITE_LINE_MAX)
+        const file_batch_backend_t BACKENDS[] =
+        {
+            FILE_BATCH_BACKEND_IO_URING,
+            FILE_BATCH_BACKEND_THREAD_POOL,
+        };
+        for (size_t i_backend = 0; i_backend < ARRAY_LEN(BACKENDS); i_backend++)
+        {
+            if (cold)
             {
-                printf("ERROR in function %s(): file is full (i_write_line = "
-                       "%zu, but I_WRITE_LINE_MAX is only %zu).\n",
-                       __func__, i_write_line, I_WRITE_LINE_MAX);
-                break;
+                batch_benchmark_drop_page_cache(paths, NUM_FILES);
             }
-            file->line_array[i_write_line] = &(file->file_str[i_write_char]);
-            i_write_line++;
-        }
+            file_arena_reset(&arena);
+            t_start = get_time_sec();
+            file_batch_backend_t backend = dyn_file_load_batch(files, loaded, paths, NUM_FILES,
+                &arena, BACKENDS[i_backend], 0);
+            double t_elapsed = get_time_sec() - t_start;
 
-        // end of line
-        if (c == '\n')
-        {
-            // '\n' indicates the end of a line, so prepare to start a new line
-            // on the next iteration
-            start_of_line = true;
+            bool matches = true;
+            for (size_t i = 0; matches && i < NUM_FILES; i++)
+            {
+                matches = loaded[i] && dyn_file_equals(&files[i], &expected_files[i]);
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "dyn_file_load_batch(), %s",
+                backend == FILE_BATCH_BACKEND_IO_URING ? "io_uring" : "thread pool");
+            printf("  %-34s  %s cache: %8.2f ms  (%7.0f files/sec; %5.2fx; matches: %s)\n",
+                name, cache, t_elapsed*1000, NUM_FILES/t_elapsed, t_elapsed_baseline/t_elapsed,
+                matches ? "yes" : "==NO!==");
         }
-
-        i_write_char++;
     }
 
-    file->num_chars = i_write_char;
-    file->num_lines = i_write_line;
-
-    fclose(fp);
+cleanup:
+    file_arena_free(&arena);
+    file_arena_free(&expected_arena);
+    free(loaded);
+    free(files);
+    free(expected_files);
+    free(paths);
+    free(path_bufs);
 }
 
 // Make this huge struct `static` so that the buffers it contains will be `static` so that they are
@@ -280,8 +2351,7 @@ void file_load(file_t* file)
 // https://stackoverflow.com/a/64085509/4561887.
 static file_t file;
 
-// int main(int argc, char *argv[])  // alternative prototype
-int main()
+int main(int argc, char *argv[])
 {
     printf("The size of the `file_t` struct is %zu bytes (%.6f MB; %.6f MiB).\n"
            "Max file size that can be read into this struct is %zu bytes or %lu lines, whichever "
@@ -318,9 +2388,105 @@ int main()
     // `$` for this `file_t` object.
     printf("Causing some intentional errors here:\n");
     file_t $;
+    $.is_mapped = false;
     file_print_lines(&$, 243, 4);
+    printf("\n");
+
+    const char* indexer_name;
+    newline_indexer_get(&indexer_name);
+    printf("Testing the newline indexers (this CPU uses \"%s\"): %s\n\n", indexer_name,
+        newline_index_test() ? "TEST PASSED!" : "TEST ==FAILED!==");
 
+    // Load the same file again, but with `file_load_mmap()`, and check that it matches
+    static file_t file_mapped;
+    file_store_path(&file_mapped, FILENAME);
+    printf("Loading the same file with file_load_mmap().\n");
+    if (file_load_mmap(&file_mapped))
+    {
+        bool matches = file_mapped.num_chars == file.num_chars
+            && file_mapped.num_lines == file.num_lines
+            && memcmp(file_mapped.mapped_str, file.file_str, file.num_chars) == 0;
+        for (size_t i = 0; matches && i < file.num_lines; i++)
+        {
+            matches = file_mapped.mapped_line_array[i] - file_mapped.mapped_str
+                == file.line_array[i] - file.file_str;
+        }
+        printf("num_chars = %zu; num_lines = %zu; matches file_load(): %s\n",
+            file_mapped.num_chars, file_mapped.num_lines, matches ? "yes" : "==NO!==");
+
+        printf("Printing 4 lines starting at this line number:\n");
+        file_print_lines(&file_mapped, 256, 4);
+        file_unload(&file_mapped);
+    }
+    printf("\n");
+
+    // Load the same file again, but with `dyn_file_load()`, and check that it matches. Then load it
+    // many more times, releasing and reusing the same arena each time, which needs no more
+    // allocations.
+    file_arena_t arena;
+    file_arena_init(&arena);
+    dyn_file_t dyn_file;
+    printf("Loading the same file with dyn_file_load().\n");
+    if (dyn_file_load(&dyn_file, &arena, FILENAME))
+    {
+        bool matches = dyn_file.num_chars == file.num_chars
+            && dyn_file.num_lines == file.num_lines
+            && memcmp(dyn_file_get_data(&dyn_file), file.file_str, file.num_chars) == 0;
+        for (size_t i = 0; matches && i < file.num_lines; i++)
+        {
+            matches = dyn_file_get_line_offset(&dyn_file, i)
+                == (size_t)(file.line_array[i] - file.file_str);
+        }
+        printf("num_chars = %zu; num_lines = %zu; matches file_load(): %s\n",
+            dyn_file.num_chars, dyn_file.num_lines, matches ? "yes" : "==NO!==");
+        printf("Printing 4 lines starting at this line number:\n");
+        dyn_file_print_lines(&dyn_file, 256, 4);
+
+        const size_t NUM_RELOADS = 1000;
+        size_t num_grows = arena.num_grows;
+        for (size_t i = 0; i < NUM_RELOADS; i++)
+        {
+            file_arena_reset(&arena);
+            dyn_file_load(&dyn_file, &arena, FILENAME);
+        }
+        printf("Reloaded it %zu times into the same arena; arena allocations during the reloads "
+               "= %zu (arena capacity = %zu bytes).\n", NUM_RELOADS, arena.num_grows - num_grows,
+               arena.capacity);
+    }
+    printf("\n");
+
+    dyn_file_load_batch_benchmark();
+    printf("\n");
+
+    // Optionally load any other file, of any size, with `file_load_mmap()`
+    if (argc > 1)
+    {
+        file_store_path(&file_mapped, argv[1]);
+        printf("Loading file at path \"%s\" with file_load_mmap().\n", file_mapped.path);
+        double t_start = get_time_sec();
+        bool ok = file_load_mmap(&file_mapped);
+        double t_elapsed = get_time_sec() - t_start;
+        if (ok)
+        {
+            printf("num_chars = %zu (%.3f MB); num_lines = %zu; loaded and indexed in %.3f sec "
+                   "(%.1f MB/sec).\n", file_mapped.num_chars, BYTES_TO_MB(file_mapped.num_chars),
+                   file_mapped.num_lines, t_elapsed, BYTES_TO_MB(file_mapped.num_chars)/t_elapsed);
+            printf("Printing the first and last lines:\n");
+            file_print_lines(&file_mapped, 1, 1);
+            file_print_lines(&file_mapped, file_mapped.num_lines, 1);
+            printf("\n");
+            printf("Newline indexer speeds on this file (now in the page cache):\n");
+            newline_index_benchmark(&file_mapped);
+            printf("\n");
+            printf("file_load_mmap_parallel() speeds on this file (now in the page cache):\n");
+            file_load_mmap_parallel_benchmark(file_mapped.path, &file_mapped);
+            printf("\n");
+            dyn_file_benchmark(file_mapped.path, &arena, &file_mapped);
+            file_unload(&file_mapped);
+        }
+    }
 
+    file_arena_free(&arena);
     return 0;
 }
 
@@ -328,14 +2494,14 @@ int main()
 //
 // In C:
 //
-//      eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
-//      The size of the `file_t` struct is 2081016 bytes (2.081016 MB; 1.984612 MiB).
+//      eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
+//      The size of the `file_t` struct is 2081048 bytes (2.081048 MB; 1.984642 MiB).
 //      Max file size that can be read into this struct is 2000000 bytes or 10000 lines, whichever limit is hit first.
 //
 //      Loading file at path "read_file_into_c_string_and_array_of_lines.c".
 //      Printing the entire file:
-//      num_chars to print = 15714
-//      num_lines to print = 425
+//      num_chars to print = 101978
+//      num_lines to print = 2626
 //      ========== FILE START ==========
 //         1: /*
 //         2: This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
@@ -359,11 +2525,11 @@ int main()
 //        20: To compile and run (assuming you've already `cd`ed into this dir):
 //        21: 1. In C:
 //        22: ```bash
-//        23: gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
+//        23: gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
 //        24: ```
 //        25: 2. In C++
 //        26: ```bash
-//        27: g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
+//        27: g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
 //        28: ```
 //        29:
 //        30: References:
@@ -396,12 +2562,12 @@ int main()
 //       399: //   293:
 //       400: //   294: In C:
 //       401: //   295:
-//       402: //   296:     eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
+//       402: //   296:     eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
 //       403: //   297:
 //       404: //   298:
 //       405: //   299: OR, in C++:
 //       406: //   300:
-//       407: //   301:     eRCaGuy_hello_world/c$ g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a && bin/a
+//       407: //   301:     eRCaGuy_hello_world/c$ g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_into_c_string_and_array_of_lines.c -o bin/a -pthread && bin/a
 //       408: //   302:
 //       409: //   303:
 //       410: //   304: */
@@ -423,22 +2589,76 @@ int main()
 //      =========== FILE END ===========
 //
 //      Printing just this 1 line number:
-//                  file->line_array[i_write_line] = &(file->file_str[i_write_char]);
+//              {
 //
 //      Printing 4 lines starting at this line number:
-//       256:             file->line_array[i_write_line] = &(file->file_str[i_write_char]);
-//       257:             i_write_line++;
-//       258:         }
-//       259:
+//       256:         {
+//       257:             *i_stop = i_newline;
+//       258:             return false;
+//       259:         }
 //
 //      Causing some intentional errors here:
-//       243: ERROR in function file_print_line(): line_array contains NULL ptr for line_number = 243 at index = 242.
-//       244: ERROR in function file_print_line(): line_array contains NULL ptr for line_number = 244 at index = 243.
-//       245: ERROR in function file_print_line(): line_array contains NULL ptr for line_number = 245 at index = 244.
-//       246: ERROR in function file_print_line(): line_array contains NULL ptr for line_number = 246 at index = 245.
+//      ERROR in function file_print_lines(): num_lines passed in == 4; file->num_lines = 0.
+//
+//      Testing the newline indexers (this CPU uses "avx2"): TEST PASSED!
+//
+//      Loading the same file with file_load_mmap().
+//      num_chars = 101978; num_lines = 2626; matches file_load(): yes
+//      Printing 4 lines starting at this line number:
+//       256:         {
+//       257:             *i_stop = i_newline;
+//       258:             return false;
+//       259:         }
+//
+//      Loading the same file with dyn_file_load().
+//      num_chars = 101978; num_lines = 2626; matches file_load(): yes
+//      Printing 4 lines starting at this line number:
+//       256:         {
+//       257:             *i_stop = i_newline;
+//       258:             return false;
+//       259:         }
+//      Reloaded it 1000 times into the same arena; arena allocations during the reloads = 0 (arena capacity = 131072 bytes).
 //
+//      Loading 2000 small files from "/tmp/read_file_into_c_string_and_array_of_lines_batch":
+//        dyn_file_load() one at a time       cold cache:   111.20 ms  (  17986 files/sec)
+//        dyn_file_load_batch(), io_uring     cold cache:    71.92 ms  (  27809 files/sec;  1.55x; matches: yes)
+//        dyn_file_load_batch(), thread pool  cold cache:    43.28 ms  (  46212 files/sec;  2.57x; matches: yes)
+//        dyn_file_load() one at a time       warm cache:    21.61 ms  (  92570 files/sec)
+//        dyn_file_load_batch(), io_uring     warm cache:    17.43 ms  ( 114770 files/sec;  1.24x; matches: yes)
+//        dyn_file_load_batch(), thread pool  warm cache:    17.51 ms  ( 114199 files/sec;  1.23x; matches: yes)
 //
 //
 // OR, in C++:
 //
 // [SAME AS THE C OUTPUT]
+//
+//
+// Also loading a 405 MB file with `file_load_mmap()`, and benchmarking the newline indexers and
+// `file_load_mmap_parallel()` and `dyn_file_load()` on it. Note: this was run on a 1-CPU VM, so the threads can only
+// overlap page faults with indexing here; expect much better scaling on a real multi-core machine:
+//
+//      eRCaGuy_hello_world/c$ bin/a /tmp/big.txt
+//      [SAME AS ABOVE]
+//      Loading file at path "/tmp/big.txt" with file_load_mmap().
+//      num_chars = 405263175 (405.263 MB); num_lines = 5263159; loaded and indexed in 0.085 sec (4766.4 MB/sec).
+//      Printing the first and last lines:
+//         1: wtSj9ukIATDdsIzAZ2+ZRZjw6rd3gWEBU+M12gWRQyHZQqG/sKfcpKyTsUGNPcskG16B3m9k1oCL
+//      5263159: no newline at end
+//      Newline indexer speeds on this file (now in the page cache):
+//        per_char       926.2 MB/sec  (5263159 lines)
+//        portable      4699.2 MB/sec  (5263159 lines)
+//        sse2          5904.3 MB/sec  (5263159 lines)
+//        avx2          6518.7 MB/sec  (5263159 lines)
+//
+//      file_load_mmap_parallel() speeds on this file (now in the page cache):
+//         1 threads      2713.9 MB/sec   1.00x  (5263159 lines; matches file_load_mmap(): yes)
+//         2 threads      2611.0 MB/sec   0.96x  (5263159 lines; matches file_load_mmap(): yes)
+//         4 threads      2944.9 MB/sec   1.09x  (5263159 lines; matches file_load_mmap(): yes)
+//         8 threads      3301.8 MB/sec   1.22x  (5263159 lines; matches file_load_mmap(): yes)
+//        16 threads      3135.8 MB/sec   1.16x  (5263159 lines; matches file_load_mmap(): yes)
+//        32 threads      3554.0 MB/sec   1.31x  (5263159 lines; matches file_load_mmap(): yes)
+//
+//      dyn_file_load() into a new arena: 0.623 sec (650.4 MB/sec); arena allocations = 1; matches file_load_mmap(): yes
+//        line index memory: 21.053 MB (4-byte offsets), vs 42.105 MB for `char*` line ptrs
+//      dyn_file_load() into the same, released, arena: 0.158 sec (2567.7 MB/sec); arena allocations = 0; matches file_load_mmap(): yes
+//        line index memory: 21.053 MB (4-byte offsets), vs 42.105 MB for `char*` line ptrs
@@ -0,0 +1,980 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+
+Speed test this implementation by @GaspardP: https://stackoverflow.com/a/71331152/4561887
+Compare the results of that to the speed of my own implementation, here:
+"read_file_into_c_string_and_array_of_lines.c" and online: https://stackoverflow.com/a/71346853/4561887
+
+Then, either post a new answer, or at least update the above answer and make comments there to
+present my results.
+
+A file-reading benchmark suite. It reads the same generated text files (lines of random length,
+~80 chars on average) from 1 KiB up to 4 GiB with each of these methods, counts the lines in each,
+and prints the read speed (MB/sec) and line rate (lines/sec) of each as CSV:
+1. `fgetc()`, one char at a time
+1. POSIX `getline()`, one line at a time (the usual line-by-line approach, as in @GaspardP's answer)
+1. `fread()` into a 4 KiB, 64 KiB, or 1 MiB buffer, or into one buffer for the whole file at once
+   (which is what `file_load()` in "read_file_into_c_string_and_array_of_lines.c" does)
+1. Linux `read()` into a 64 KiB or 1 MiB buffer
+1. `mmap()` of the whole file, with `MADV_SEQUENTIAL` (like `file_load_mmap()` in
+   "read_file_into_c_string_and_array_of_lines.c")
+1. `O_DIRECT` `read()`s into an aligned 1 MiB buffer, bypassing the page cache entirely
+1. io_uring, with 4 1 MiB reads in flight at once, via the raw `io_uring_setup()` and
+   `io_uring_enter()` system calls, so that liburing is not needed
+1. In C++ only: `std::ifstream` with `std::getline()`, as in
+   "eRCaGuy_hello_world/cpp/file_open_and_read_by_linux_open_and_std_ifstream_at_once.cpp", and
+   `std::ifstream::read()` of the whole file at once
+
+Each method is run with a "cold" page cache (the file's pages are evicted from the page cache
+before each run, with `posix_fadvise(POSIX_FADV_DONTNEED)`, and `mincore()` confirms it, so no root
+is needed), and a "warm" one (the whole file is read once before the runs). Each method is run
+repeatedly, for at least ~0.25 sec and 3 runs, up to ~2 sec, and the fastest run is reported.
+Methods which this kernel or file system does not support (ex: io_uring in many containers, or
+`O_DIRECT` on tmpfs) are skipped, with a note on stderr.
+
+Only the CSV goes to stdout, so you can redirect it to a file:
+```bash
+bin/a > results.csv
+```
+
+STATUS: works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C:
+```bash
+gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_speedtest1.c timinglib.c -o bin/a -pthread && bin/a
+```
+2. In C++
+```bash
+g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_speedtest1.c timinglib.c -o bin/a -pthread && bin/a
+```
+3. Optionally pass in the max file size to test, in bytes or with a K, M, or G (binary) suffix
+(default: 64M), and the dir in which to generate the test files (default: /tmp/read_file_speedtest1).
+The files are kept and reused by later runs. Ex: to test all sizes, up to 4 GiB:
+```bash
+bin/a 4G
+```
+
+References:
+1. See: read_file_into_c_string_and_array_of_lines.c
+1. https://man7.org/linux/man-pages/man2/posix_fadvise.2.html
+1. https://man7.org/linux/man-pages/man2/mincore.2.html
+1. https://man7.org/linux/man-pages/man2/open.2.html - see the "O_DIRECT" section
+1. https://man7.org/linux/man-pages/man7/io_uring.7.html
+1. https://man7.org/linux/man-pages/man2/io_uring_setup.2.html
+1. https://man7.org/linux/man-pages/man2/io_uring_enter.2.html
+
+*/
+
+// Required for `O_DIRECT`, `getline()`, `posix_fadvise()`, `madvise()`, and `mincore()` with
+// `-std=c17`
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+// Local includes
+#include "timinglib.h"
+
+// Linux includes
+#include <fcntl.h>        // For `open()`, `O_DIRECT`, `posix_fadvise()`
+#include <linux/io_uring.h>
+#include <sys/mman.h>     // For `mmap()`, `madvise()`, `mincore()`
+#include <sys/stat.h>     // For `stat()`, `mkdir()`
+#include <sys/syscall.h>  // For `syscall()` and `__NR_io_uring_*`
+#include <unistd.h>       // For `read()`, `close()`, `sysconf()`
+
+// C++ includes
+#ifdef __cplusplus
+#include <fstream>  // For `std::ifstream`
+#include <string>
+#endif
+
+// C includes
+#include <errno.h>
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+#include <stdio.h>   // For `printf()`
+#include <stdlib.h>  // For `malloc()`, `free()`, `strtoull()`
+#include <string.h>  // For `strerror()`, `memset()`
+
+
+#define KiB (1024ULL)
+#define MiB (1024ULL*KiB)
+#define GiB (1024ULL*MiB)
+
+#define BYTES_PER_MB (1000000.0)
+#define BYTES_TO_MB(bytes) (((double)(bytes))/BYTES_PER_MB)
+
+/// The default max file size to test; pass a larger one as the 1st argument
+#define DEFAULT_MAX_FILE_SIZE (64*MiB)
+/// The default dir in which to generate the test files; pass another one as the 2nd argument
+#define DEFAULT_TEST_DIR "/tmp/read_file_speedtest1"
+
+/// Each method is run at least this many times, and for at least `MIN_TOTAL_RUN_TIME_NS` in total,
+/// but once it has run for `MAX_TOTAL_RUN_TIME_NS` in total, it is not run again.
+#define MIN_NUM_RUNS 3
+#define MIN_TOTAL_RUN_TIME_NS (SEC_TO_NS(1ULL)/4)
+#define MAX_TOTAL_RUN_TIME_NS SEC_TO_NS(2ULL)
+
+/// `O_DIRECT` reads must be aligned to the logical block size of the device, which is at most 4 KiB
+#define O_DIRECT_ALIGNMENT (4*KiB)
+
+/// io_uring queue depth (number of reads in flight at once), and size of each read
+#define IO_URING_QUEUE_DEPTH 4
+#define IO_URING_READ_SIZE (1*MiB)
+
+/// The file sizes to test, up to the max file size
+static const uint64_t FILE_SIZES[] = {1*KiB, 16*KiB, 256*KiB, 4*MiB, 64*MiB, 1*GiB, 4*GiB};
+
+typedef enum read_status_e
+{
+    READ_STATUS_OK = 0,
+    /// This method is not supported by this kernel or file system
+    READ_STATUS_UNSUPPORTED,
+    READ_STATUS_ERROR,
+} read_status_t;
+
+/// A file-reading method: read the whole file at `path`, which is `file_size` bytes, and count its
+/// '\n' chars into `*num_lines`. `buf_size` is the method's read buffer size, if it has one, or 0
+/// to read the whole file at once.
+typedef read_status_t (*read_method_func_t)(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines);
+
+typedef struct read_method_s
+{
+    const char* name;
+    read_method_func_t func;
+    size_t buf_size;
+} read_method_t;
+
+/// Count the '\n' chars in `data`. The compiler vectorizes this simple loop, so it is much faster
+/// than the reads themselves for all but the fastest methods.
+static uint64_t count_newlines(const char* data, size_t len)
+{
+    uint64_t num_newlines = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        num_newlines += data[i] == '\n';
+    }
+    return num_newlines;
+}
+
+/// Print an error for `path` with the current `errno`, and return `READ_STATUS_ERROR`.
+static read_status_t read_error(const char* func, const char* path)
+{
+    fprintf(stderr, "ERROR in function %s(): \"%s\": %s\n", func, path, strerror(errno));
+    return READ_STATUS_ERROR;
+}
+
+static read_status_t read_fgetc(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)file_size;
+    (void)buf_size;
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return read_error(__func__, path);
+    }
+    uint64_t num_newlines = 0;
+    int c;
+    while ((c = fgetc(fp)) != EOF)
+    {
+        num_newlines += c == '\n';
+    }
+    fclose(fp);
+    *num_lines = num_newlines;
+    return READ_STATUS_OK;
+}
+
+static read_status_t read_getline(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)file_size;
+    (void)buf_size;
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return read_error(__func__, path);
+    }
+    char* line = NULL;
+    size_t line_buf_size = 0;
+    uint64_t num_newlines = 0;
+    ssize_t len;
+    while ((len = getline(&line, &line_buf_size, fp)) > 0)
+    {
+        num_newlines += line[len - 1] == '\n';
+    }
+    free(line);
+    fclose(fp);
+    *num_lines = num_newlines;
+    return READ_STATUS_OK;
+}
+
+static read_status_t read_fread(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return read_error(__func__, path);
+    }
+    // Read into a buffer of the given size, or one big enough for the whole file (+ 1 to detect EOF
+    // in the same `fread()` call)
+    size_t alloc_size = buf_size > 0 ? buf_size : file_size + 1;
+    char* buf = (char*)malloc(alloc_size);
+    if (buf == NULL)
+    {
+        fclose(fp);
+        return read_error(__func__, path);
+    }
+    uint64_t num_newlines = 0;
+    size_t num_bytes_read;
+    while ((num_bytes_read = fread(buf, 1, alloc_size, fp)) > 0)
+    {
+        num_newlines += count_newlines(buf, num_bytes_read);
+    }
+    bool ok = !ferror(fp);
+    free(buf);
+    fclose(fp);
+    *num_lines = num_newlines;
+    return ok ? READ_STATUS_OK : read_error(__func__, path);
+}
+
+/// Read the whole file with `read()` calls of `buf_size` bytes. For `O_DIRECT`, `flags` must include
+/// `O_DIRECT`, and `buf_size` must be a multiple of `O_DIRECT_ALIGNMENT`.
+static read_status_t read_read_with_flags(const char* func, const char* path, size_t buf_size,
+    int flags, uint64_t* num_lines)
+{
+    int fd = open(path, O_RDONLY | flags);
+    if (fd < 0)
+    {
+        // Ex: tmpfs does not support `O_DIRECT`
+        return errno == EINVAL ? READ_STATUS_UNSUPPORTED : read_error(func, path);
+    }
+    char* buf = (char*)aligned_alloc(O_DIRECT_ALIGNMENT, buf_size);
+    if (buf == NULL)
+    {
+        close(fd);
+        return read_error(func, path);
+    }
+    uint64_t num_newlines = 0;
+    ssize_t num_bytes_read;
+    while ((num_bytes_read = read(fd, buf, buf_size)) > 0)
+    {
+        num_newlines += count_newlines(buf, num_bytes_read);
+    }
+    read_status_t status = READ_STATUS_OK;
+    if (num_bytes_read < 0)
+    {
+        status = (flags & O_DIRECT) && errno == EINVAL ?
+            READ_STATUS_UNSUPPORTED : read_error(func, path);
+    }
+    free(buf);
+    close(fd);
+    *num_lines = num_newlines;
+    return status;
+}
+
+static read_status_t read_read(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)file_size;
+    return read_read_with_flags(__func__, path, buf_size, 0, num_lines);
+}
+
+static read_status_t read_o_direct(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)file_size;
+    return read_read_with_flags(__func__, path, buf_size, O_DIRECT, num_lines);
+}
+
+static read_status_t read_mmap(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)buf_size;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return read_error(__func__, path);
+    }
+    void* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return read_error(__func__, path);
+    }
+    madvise(map, file_size, MADV_SEQUENTIAL);
+    *num_lines = count_newlines((const char*)map, file_size);
+    munmap(map, file_size);
+    return READ_STATUS_OK;
+}
+
+/// A minimal io_uring instance, set up with the raw system calls. See:
+/// https://man7.org/linux/man-pages/man7/io_uring.7.html
+typedef struct io_uring_s
+{
+    int fd;
+
+    // The submission queue (SQ) ring, and its array of submission queue entries (SQEs)
+    void* sq_ring;
+    size_t sq_ring_size;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+
+    // The completion queue (CQ) ring, which may be the same mapping as the SQ ring
+    void* cq_ring;
+    size_t cq_ring_size;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+} io_uring_t;
+
+/// Set up an io_uring instance with room for `num_entries` SQEs. Returns false, with `errno` set,
+/// if io_uring is not available (ex: `ENOSYS` on old kernels, or `EPERM` in many containers).
+static bool io_uring_init(io_uring_t* ring, unsigned num_entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, num_entries, &params);
+    if (ring->fd < 0)
+    {
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+    {
+        ring->sq_ring_size = ring->cq_ring_size =
+            ring->sq_ring_size > ring->cq_ring_size ? ring->sq_ring_size : ring->cq_ring_size;
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring : mmap(NULL, ring->cq_ring_size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries*sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+        int mmap_errno = errno;
+        close(ring->fd);
+        errno = mmap_errno;
+        return false;
+    }
+
+    char* sq_ring = (char*)ring->sq_ring;
+    ring->sq_tail = (unsigned*)(sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq_ring + params.sq_off.array);
+    char* cq_ring = (char*)ring->cq_ring;
+    ring->cq_head = (unsigned*)(cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+    return true;
+}
+
+static void io_uring_deinit(io_uring_t* ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring)
+    {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/// Queue (but do not yet submit) a read of `len` bytes at `offset` in `fd` into `buf`. We are the
+/// only submitter, so there is always room, since we never have more reads in flight than entries.
+static void io_uring_queue_read(io_uring_t* ring, int fd, void* buf, unsigned len,
+    uint64_t offset, uint64_t user_data)
+{
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    // Publish the SQE to the kernel only after it is fully written
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static read_status_t read_io_uring(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    io_uring_t ring;
+    if (!io_uring_init(&ring, IO_URING_QUEUE_DEPTH))
+    {
+        return READ_STATUS_UNSUPPORTED;
+    }
+    int fd = open(path, O_RDONLY);
+    char* bufs = (char*)malloc(IO_URING_QUEUE_DEPTH*buf_size);
+    if (fd < 0 || bufs == NULL)
+    {
+        read_status_t status = read_error(__func__, path);
+        free(bufs);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        io_uring_deinit(&ring);
+        return status;
+    }
+
+    // Each slot `i` has its own buffer, and one read in flight at a time. Each completed read is
+    // counted, and then the slot reads the next unread part of the file. Lines may be counted out
+    // of order, since only their total matters.
+    uint64_t offsets[IO_URING_QUEUE_DEPTH];
+    unsigned lens[IO_URING_QUEUE_DEPTH];
+    uint64_t next_offset = 0;
+    unsigned num_in_flight = 0;
+    unsigned num_to_submit = 0;
+    for (unsigned i = 0; i < IO_URING_QUEUE_DEPTH && next_offset < file_size; i++)
+    {
+        offsets[i] = next_offset;
+        lens[i] = (unsigned)(file_size - next_offset < buf_size ? file_size - next_offset : buf_size);
+        io_uring_queue_read(&ring, fd, &bufs[i*buf_size], lens[i], offsets[i], i);
+        next_offset += lens[i];
+        num_in_flight++;
+        num_to_submit++;
+    }
+
+    read_status_t status = READ_STATUS_OK;
+    uint64_t num_newlines = 0;
+    while (num_in_flight > 0 && status == READ_STATUS_OK)
+    {
+        // Submit all queued reads, and wait for at least 1 to complete
+        if (syscall(__NR_io_uring_enter, ring.fd, num_to_submit, 1, IORING_ENTER_GETEVENTS,
+            NULL, 0) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            status = read_error(__func__, path);
+            break;
+        }
+        num_to_submit = 0;
+
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            const struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+            unsigned i = (unsigned)cqe->user_data;
+            int res = cqe->res;
+            num_in_flight--;
+            if (res <= 0)
+            {
+                // `-EINVAL` means this kernel is too old for `IORING_OP_READ` (Linux 5.6)
+                errno = -res;
+                status = res == -EINVAL ? READ_STATUS_UNSUPPORTED : read_error(__func__, path);
+                continue;
+            }
+            num_newlines += count_newlines(&bufs[i*buf_size], res);
+
+            // Read the rest of a short read, or else the next unread part of the file
+            if ((unsigned)res < lens[i])
+            {
+                offsets[i] += res;
+                lens[i] -= res;
+            }
+            else if (next_offset < file_size)
+            {
+                offsets[i] = next_offset;
+                lens[i] = (unsigned)(file_size - next_offset < buf_size ?
+                    file_size - next_offset : buf_size);
+                next_offset += lens[i];
+            }
+            else
+            {
+                continue;
+            }
+            io_uring_queue_read(&ring, fd, &bufs[i*buf_size], lens[i], offsets[i], i);
+            num_in_flight++;
+            num_to_submit++;
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    // On an error, wait for the reads still in flight, since they write into `bufs`
+    while (num_in_flight > 0)
+    {
+        if (syscall(__NR_io_uring_enter, ring.fd, num_to_submit, 1, IORING_ENTER_GETEVENTS,
+            NULL, 0) < 0 && errno != EINTR)
+        {
+            break;
+        }
+        num_to_submit = 0;
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        num_in_flight -= tail - head;
+        __atomic_store_n(ring.cq_head, tail, __ATOMIC_RELEASE);
+    }
+
+    free(bufs);
+    close(fd);
+    io_uring_deinit(&ring);
+    *num_lines = num_newlines;
+    return status;
+}
+
+#ifdef __cplusplus
+
+static read_status_t read_ifstream_getline(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)file_size;
+    (void)buf_size;
+
+    std::ifstream inputFileStream(path);
+    if (!inputFileStream.is_open())
+    {
+        return read_error(__func__, path);
+    }
+    // `std::getline()` strips the '\n', but sets `eof()` if the last line did not have one
+    std::string line;
+    uint64_t num_newlines = 0;
+    while (std::getline(inputFileStream, line))
+    {
+        num_newlines += !inputFileStream.eof();
+    }
+    *num_lines = num_newlines;
+    return READ_STATUS_OK;
+}
+
+static read_status_t read_ifstream_read(const char* path, uint64_t file_size, size_t buf_size,
+    uint64_t* num_lines)
+{
+    (void)buf_size;
+
+    std::ifstream inputFileStream(path, std::ios::binary);
+    if (!inputFileStream.is_open())
+    {
+        return read_error(__func__, path);
+    }
+    std::string fileContents(file_size, '\0');
+    inputFileStream.read(&fileContents[0], file_size);
+    *num_lines = count_newlines(fileContents.data(), inputFileStream.gcount());
+    return READ_STATUS_OK;
+}
+
+#endif
+
+static const read_method_t READ_METHODS[] =
+{
+    {"fgetc", read_fgetc, 0},
+    {"getline", read_getline, 0},
+    {"fread_4KiB", read_fread, 4*KiB},
+    {"fread_64KiB", read_fread, 64*KiB},
+    {"fread_1MiB", read_fread, 1*MiB},
+    {"fread_whole_file", read_fread, 0},
+    {"read_64KiB", read_read, 64*KiB},
+    {"read_1MiB", read_read, 1*MiB},
+    {"mmap", read_mmap, 0},
+    {"O_DIRECT_1MiB", read_o_direct, 1*MiB},
+    {"io_uring_4x1MiB", read_io_uring, IO_URING_READ_SIZE},
+#ifdef __cplusplus
+    {"ifstream_getline", read_ifstream_getline, 0},
+    {"ifstream_read_whole_file", read_ifstream_read, 0},
+#endif
+};
+
+/// Write a test file of exactly `file_size` bytes: lines of 0 to 159 random printable chars, each
+/// ending in '\n', including the last one, so that the number of lines is the number of '\n' chars.
+/// If the file already exists with the right size, it is reused as-is. Its data is then flushed to
+/// disk, so that `page_cache_drop()` can evict its pages. Returns false if anything fails.
+static bool test_file_create(const char* path, uint64_t file_size)
+{
+    struct stat stat_buf;
+    if (stat(path, &stat_buf) == 0 && (uint64_t)stat_buf.st_size == file_size)
+    {
+        return true;
+    }
+
+    fprintf(stderr, "Generating %llu-byte test file \"%s\"...\n", (unsigned long long)file_size,
+        path);
+    FILE* fp = fopen(path, "w");
+    if (fp == NULL)
+    {
+        read_error(__func__, path);
+        return false;
+    }
+    char* buf = (char*)malloc(1*MiB);
+    if (buf == NULL)
+    {
+        fclose(fp);
+        return false;
+    }
+
+    // A fixed seed, so that every run of this program tests the same data
+    uint64_t rand_state = 0x9E3779B97F4A7C15ULL;
+    size_t line_len_remaining = 0;
+    bool ok = true;
+    for (uint64_t num_bytes_written = 0; ok && num_bytes_written < file_size; )
+    {
+        size_t len = file_size - num_bytes_written < 1*MiB ? file_size - num_bytes_written : 1*MiB;
+        for (size_t i = 0; i < len; i++)
+        {
+            // xorshift64
+            rand_state ^= rand_state << 13;
+            rand_state ^= rand_state >> 7;
+            rand_state ^= rand_state << 17;
+            if (line_len_remaining == 0)
+            {
+                buf[i] = '\n';
+                line_len_remaining = rand_state % 160 + 1;
+            }
+            else
+            {
+                buf[i] = (char)(' ' + (rand_state >> 32) % 95);
+            }
+            line_len_remaining--;
+        }
+        num_bytes_written += len;
+        if (num_bytes_written == file_size)
+        {
+            buf[len - 1] = '\n';
+        }
+        ok = fwrite(buf, 1, len, fp) == len;
+    }
+    ok = ok && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    if (!ok)
+    {
+        read_error(__func__, path);
+    }
+    free(buf);
+    fclose(fp);
+    return ok;
+}
+
+/// Evict all of the file's pages from the page cache. This works without root, but only for clean
+/// pages, which is why `test_file_create()` `fsync()`s the file.
+static void page_cache_drop(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+/// Read the whole file once, so that all of its pages are in the page cache.
+static void page_cache_warm(const char* path)
+{
+    uint64_t num_lines;
+    read_read_with_flags(__func__, path, 1*MiB, 0, &num_lines);
+}
+
+/// Get the fraction (0.0 to 1.0) of the file's pages which are currently in the page cache.
+static double page_cache_get_resident_fraction(const char* path, uint64_t file_size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    void* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t num_pages = (file_size + page_size - 1)/page_size;
+    unsigned char* residency = (unsigned char*)malloc(num_pages);
+    size_t num_resident = 0;
+    if (residency != NULL && mincore(map, file_size, residency) == 0)
+    {
+        for (size_t i = 0; i < num_pages; i++)
+        {
+            num_resident += residency[i] & 1;
+        }
+    }
+    free(residency);
+    munmap(map, file_size);
+    return (double)num_resident/num_pages;
+}
+
+/// Run one method on one file repeatedly, with a cold or warm page cache, and print one CSV row
+/// with its fastest run.
+static void benchmark_method(const read_method_t* method, const char* path, uint64_t file_size,
+    bool cold)
+{
+    uint64_t best_time_ns = UINT64_MAX;
+    uint64_t total_time_ns = 0;
+    uint64_t num_lines = 0;
+    unsigned num_runs = 0;
+    while (num_runs == 0 || ((num_runs < MIN_NUM_RUNS || total_time_ns < MIN_TOTAL_RUN_TIME_NS)
+        && total_time_ns < MAX_TOTAL_RUN_TIME_NS))
+    {
+        if (cold)
+        {
+            page_cache_drop(path);
+            if (num_runs == 0 && page_cache_get_resident_fraction(path, file_size) > 0.01)
+            {
+                fprintf(stderr, "WARNING: failed to evict \"%s\" from the page cache; its "
+                    "\"cold\" results are really warm.\n", path);
+            }
+        }
+        else if (num_runs == 0)
+        {
+            page_cache_warm(path);
+        }
+
+        uint64_t t_start_ns = nanos();
+        read_status_t status = method->func(path, file_size, method->buf_size, &num_lines);
+        uint64_t t_elapsed_ns = nanos() - t_start_ns;
+        if (status == READ_STATUS_UNSUPPORTED)
+        {
+            fprintf(stderr, "NOTE: %s is not supported here (%s); skipping it.\n",
+                method->name, strerror(errno));
+            return;
+        }
+        if (status != READ_STATUS_OK)
+        {
+            return;
+        }
+
+        total_time_ns += t_elapsed_ns;
+        best_time_ns = t_elapsed_ns < best_time_ns ? t_elapsed_ns : best_time_ns;
+        num_runs++;
+    }
+
+    double best_time_sec = (double)best_time_ns/NS_PER_SEC;
+    printf("%llu,%s,%s,%llu,%u,%.9f,%.1f,%.0f\n", (unsigned long long)file_size,
+        cold ? "cold" : "warm", method->name, (unsigned long long)num_lines, num_runs,
+        best_time_sec, BYTES_TO_MB(file_size)/best_time_sec, num_lines/best_time_sec);
+    fflush(stdout);
+}
+
+/// Parse a size in bytes, with an optional K, M, or G (binary) suffix. Returns 0 if invalid.
+static uint64_t parse_size(const char* str)
+{
+    char* end;
+    uint64_t size = strtoull(str, &end, 10);
+    switch (*end)
+    {
+        case 'K': case 'k': size *= KiB; end++; break;
+        case 'M': case 'm': size *= MiB; end++; break;
+        case 'G': case 'g': size *= GiB; end++; break;
+        default: break;
+    }
+    return *end == '\0' ? size : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t max_file_size = argc > 1 ? parse_size(argv[1]) : DEFAULT_MAX_FILE_SIZE;
+    const char* test_dir = argc > 2 ? argv[2] : DEFAULT_TEST_DIR;
+    if (max_file_size == 0)
+    {
+        fprintf(stderr, "Usage: %s [max_file_size[K|M|G]] [test_dir]\n", argv[0]);
+        return 1;
+    }
+    if (mkdir(test_dir, 0755) != 0 && errno != EEXIST)
+    {
+        read_error(__func__, test_dir);
+        return 1;
+    }
+
+    printf("file_size_bytes,cache,method,num_lines,num_runs,best_time_sec,MB_per_sec,"
+           "lines_per_sec\n");
+    for (size_t i_size = 0; i_size < ARRAY_LEN(FILE_SIZES); i_size++)
+    {
+        uint64_t file_size = FILE_SIZES[i_size];
+        if (file_size > max_file_size)
+        {
+            break;
+        }
+
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/speedtest_%llu.txt", test_dir,
+            (unsigned long long)file_size);
+        if (!test_file_create(path, file_size))
+        {
+            return 1;
+        }
+
+        for (int cold = 1; cold >= 0; cold--)
+        {
+            for (size_t i_method = 0; i_method < ARRAY_LEN(READ_METHODS); i_method++)
+            {
+                benchmark_method(&READ_METHODS[i_method], path, file_size, cold);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+SAMPLE OUTPUT:
+
+In C++ (the test files up to 4 MiB had already been generated by an earlier run). Note that this
+was run on a VM whose virtual disk is cached by the host, so even the "cold" reads here are much
+faster than reads from a real SSD or HDD would be:
+
+    eRCaGuy_hello_world/c$ g++ -Wall -Wextra -Werror -O3 -std=c++17 read_file_speedtest1.c timinglib.c -o bin/a -pthread && bin/a
+    Generating 67108864-byte test file "/tmp/read_file_speedtest1/speedtest_67108864.txt"...
+    file_size_bytes,cache,method,num_lines,num_runs,best_time_sec,MB_per_sec,lines_per_sec
+    1024,cold,fgetc,14,6033,0.000032054,31.9,436763
+    1024,cold,getline,14,7452,0.000024642,41.6,568136
+    1024,cold,fread_4KiB,14,7517,0.000025479,40.2,549472
+    1024,cold,fread_64KiB,14,7324,0.000021949,46.7,637842
+    1024,cold,fread_1MiB,14,8884,0.000019519,52.5,717250
+    1024,cold,fread_whole_file,14,7822,0.000023853,42.9,586928
+    1024,cold,read_64KiB,14,7660,0.000025823,39.7,542152
+    1024,cold,read_1MiB,14,7811,0.000023713,43.2,590393
+    1024,cold,mmap,14,5760,0.000031990,32.0,437637
+    1024,cold,O_DIRECT_1MiB,14,3385,0.000057812,17.7,242164
+    1024,cold,io_uring_4x1MiB,14,2763,0.000046476,22.0,301231
+    1024,cold,ifstream_getline,14,7751,0.000022935,44.6,610421
+    1024,cold,ifstream_read_whole_file,14,6737,0.000029851,34.3,468996
+    1024,warm,fgetc,14,24028,0.000007201,142.2,1944174
+    1024,warm,getline,14,49931,0.000003570,286.8,3921569
+    1024,warm,fread_4KiB,14,48072,0.000003545,288.9,3949224
+    1024,warm,fread_64KiB,14,49720,0.000003345,306.1,4185351
+    1024,warm,fread_1MiB,14,51637,0.000003626,282.4,3861004
+    1024,warm,fread_whole_file,14,48649,0.000003411,300.2,4104368
+    1024,warm,read_64KiB,14,66133,0.000002551,401.4,5488044
+    1024,warm,read_1MiB,14,69554,0.000002458,416.6,5695688
+    1024,warm,mmap,14,19393,0.000010061,101.8,1391512
+    1024,warm,O_DIRECT_1MiB,14,3501,0.000056310,18.2,248624
+    1024,warm,io_uring_4x1MiB,14,4693,0.000027813,36.8,503362
+    1024,warm,ifstream_getline,14,49250,0.000003900,262.6,3589744
+    1024,warm,ifstream_read_whole_file,14,56466,0.000003666,279.3,3818876
+    16384,cold,fgetc,207,1873,0.000107568,152.3,1924364
+    16384,cold,getline,207,4279,0.000038290,427.9,5406111
+    16384,cold,fread_4KiB,207,4549,0.000036848,444.6,5617673
+    16384,cold,fread_64KiB,207,4070,0.000038069,430.4,5437495
+    16384,cold,fread_1MiB,207,3941,0.000032795,499.6,6311938
+    16384,cold,fread_whole_file,207,4253,0.000037067,442.0,5584482
+    16384,cold,read_64KiB,207,4450,0.000037125,441.3,5575758
+    16384,cold,read_1MiB,207,4413,0.000038362,427.1,5395965
+    16384,cold,mmap,207,3326,0.000048309,339.2,4284916
+    16384,cold,O_DIRECT_1MiB,207,3500,0.000057957,282.7,3571613
+    16384,cold,io_uring_4x1MiB,207,2243,0.000053497,306.3,3869376
+    16384,cold,ifstream_getline,207,3477,0.000045080,363.4,4591837
+    16384,cold,ifstream_read_whole_file,207,3990,0.000030506,537.1,6785550
+    16384,warm,fgetc,207,2261,0.000075469,217.1,2742848
+    16384,warm,getline,207,16783,0.000011849,1382.7,17469829
+    16384,warm,fread_4KiB,207,21014,0.000008157,2008.6,25376977
+    16384,warm,fread_64KiB,207,22862,0.000007438,2202.7,27830062
+    16384,warm,fread_1MiB,207,25186,0.000007107,2305.3,29126214
+    16384,warm,fread_whole_file,207,27431,0.000007424,2206.9,27882543
+    16384,warm,read_64KiB,207,25417,0.000006273,2611.8,32998565
+    16384,warm,read_1MiB,207,24283,0.000006555,2499.5,31578947
+    16384,warm,mmap,207,11488,0.000016175,1012.9,12797527
+    16384,warm,O_DIRECT_1MiB,207,3128,0.000057162,286.6,3621287
+    16384,warm,io_uring_4x1MiB,207,4219,0.000030978,528.9,6682162
+    16384,warm,ifstream_getline,207,17110,0.000008456,1937.6,24479659
+    16384,warm,ifstream_read_whole_file,207,22958,0.000008152,2009.8,25392542
+    262144,cold,fgetc,3215,148,0.001195070,219.4,2690219
+    262144,cold,getline,3215,687,0.000263803,993.7,12187124
+    262144,cold,fread_4KiB,3215,873,0.000194751,1346.0,16508259
+    262144,cold,fread_64KiB,3215,975,0.000198637,1319.7,16185303
+    262144,cold,fread_1MiB,3215,856,0.000201353,1301.9,15966983
+    262144,cold,fread_whole_file,3215,890,0.000203849,1286.0,15771478
+    262144,cold,read_64KiB,3215,959,0.000150812,1738.2,21317932
+    262144,cold,read_1MiB,3215,976,0.000161874,1619.4,19861127
+    262144,cold,mmap,3215,874,0.000217921,1202.9,14753053
+    262144,cold,O_DIRECT_1MiB,3215,847,0.000178173,1471.3,18044260
+    262144,cold,io_uring_4x1MiB,3215,746,0.000279961,936.4,11483742
+    262144,cold,ifstream_getline,3215,649,0.000244281,1073.1,13161073
+    262144,cold,ifstream_read_whole_file,3215,1107,0.000161694,1621.2,19883236
+    262144,warm,fgetc,3215,211,0.000945982,277.1,3398585
+    262144,warm,getline,3215,1557,0.000120621,2173.3,26653734
+    262144,warm,fread_4KiB,3215,2093,0.000088796,2952.2,36206586
+    262144,warm,fread_64KiB,3215,2588,0.000075218,3485.1,42742429
+    262144,warm,fread_1MiB,3215,3047,0.000074675,3510.5,43053231
+    262144,warm,fread_whole_file,3215,2858,0.000074716,3508.5,43029605
+    262144,warm,read_64KiB,3215,2972,0.000073223,3580.1,43906969
+    262144,warm,read_1MiB,3215,2868,0.000073131,3584.6,43962205
+    262144,warm,mmap,3215,2829,0.000076818,3412.5,41852170
+    262144,warm,O_DIRECT_1MiB,3215,984,0.000179819,1457.8,17879090
+    262144,warm,io_uring_4x1MiB,3215,1332,0.000126094,2079.0,25496852
+    262144,warm,ifstream_getline,3215,1323,0.000153398,1708.9,20958552
+    262144,warm,ifstream_read_whole_file,3215,1819,0.000085842,3053.8,37452529
+    4194304,cold,fgetc,52288,10,0.021085973,198.9,2479753
+    4194304,cold,getline,52288,52,0.003786682,1107.6,13808395
+    4194304,cold,fread_4KiB,52288,74,0.002696909,1555.2,19388122
+    4194304,cold,fread_64KiB,52288,82,0.002683482,1563.0,19485132
+    4194304,cold,fread_1MiB,52288,61,0.003630678,1155.2,14401718
+    4194304,cold,fread_whole_file,52288,49,0.003995830,1049.7,13085642
+    4194304,cold,read_64KiB,52288,67,0.003098857,1353.5,16873318
+    4194304,cold,read_1MiB,52288,59,0.003336560,1257.1,15671230
+    4194304,cold,mmap,52288,63,0.003403848,1232.2,15361438
+    4194304,cold,O_DIRECT_1MiB,52288,67,0.003173607,1321.6,16475890
+    4194304,cold,io_uring_4x1MiB,52288,51,0.003758692,1115.9,13911222
+    4194304,cold,ifstream_getline,52288,45,0.004671521,897.8,11192928
+    4194304,cold,ifstream_read_whole_file,52288,42,0.004885830,858.5,10701969
+    4194304,warm,fgetc,52288,10,0.023100027,181.6,2263547
+    4194304,warm,getline,52288,62,0.002883377,1454.6,18134292
+    4194304,warm,fread_4KiB,52288,99,0.001713674,2447.6,30512221
+    4194304,warm,fread_64KiB,52288,127,0.001465819,2861.4,35671526
+    4194304,warm,fread_1MiB,52288,98,0.001671920,2508.7,31274224
+    4194304,warm,fread_whole_file,52288,107,0.001558443,2691.3,33551436
+    4194304,warm,read_64KiB,52288,167,0.001438256,2916.2,36355141
+    4194304,warm,read_1MiB,52288,142,0.001409931,2974.8,37085503
+    4194304,warm,mmap,52288,150,0.001564652,2680.7,33418294
+    4194304,warm,O_DIRECT_1MiB,52288,68,0.002756791,1521.4,18966980
+    4194304,warm,io_uring_4x1MiB,52288,117,0.001706974,2457.2,30631984
+    4194304,warm,ifstream_getline,52288,67,0.002954792,1419.5,17696000
+    4194304,warm,ifstream_read_whole_file,52288,112,0.001814921,2311.0,28810069
+    67108864,cold,fgetc,833764,3,0.323947745,207.2,2573761
+    67108864,cold,getline,833764,4,0.063725527,1053.1,13083674
+    67108864,cold,fread_4KiB,833764,6,0.044848845,1496.3,18590534
+    67108864,cold,fread_64KiB,833764,7,0.035104418,1911.7,23750971
+    67108864,cold,fread_1MiB,833764,6,0.045377446,1478.9,18373974
+    67108864,cold,fread_whole_file,833764,3,0.086229162,778.3,9669165
+    67108864,cold,read_64KiB,833764,5,0.042246620,1588.5,19735638
+    67108864,cold,read_1MiB,833764,6,0.041700081,1609.3,19994302
+    67108864,cold,mmap,833764,7,0.033745178,1988.7,24707649
+    67108864,cold,O_DIRECT_1MiB,833764,5,0.052212030,1285.3,15968810
+    67108864,cold,io_uring_4x1MiB,833764,6,0.039348673,1705.5,21189126
+    67108864,cold,ifstream_getline,833764,4,0.068155943,984.6,12233181
+    67108864,cold,ifstream_read_whole_file,833764,3,0.122740546,546.8,6792898
+    67108864,warm,fgetc,833764,3,0.416234638,161.2,2003111
+    67108864,warm,getline,833764,4,0.070954247,945.8,11750727
+    67108864,warm,fread_4KiB,833764,6,0.043967463,1526.3,18963205
+    67108864,warm,fread_64KiB,833764,7,0.034571663,1941.2,24116977
+    67108864,warm,fread_1MiB,833764,8,0.033429902,2007.5,24940665
+    67108864,warm,fread_whole_file,833764,3,0.084369893,795.4,9882246
+    67108864,warm,read_64KiB,833764,7,0.036013152,1863.5,23151653
+    67108864,warm,read_1MiB,833764,8,0.033639125,1995.0,24785544
+    67108864,warm,mmap,833764,10,0.026432392,2538.9,31543267
+    67108864,warm,O_DIRECT_1MiB,833764,5,0.054670290,1227.5,15250770
+    67108864,warm,io_uring_4x1MiB,833764,8,0.030479454,2201.8,27354952
+    67108864,warm,ifstream_getline,833764,5,0.054570967,1229.8,15278527
+    67108864,warm,ifstream_read_whole_file,833764,3,0.082350939,814.9,10124523
+
+
+OR, in C:
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 read_file_speedtest1.c timinglib.c -o bin/a -pthread && bin/a
+    [SAME AS THE C++ OUTPUT, BUT WITHOUT THE `ifstream_*` ROWS]
+
+
+*/
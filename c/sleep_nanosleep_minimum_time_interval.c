@@ -82,6 +82,11 @@ gcc -Wall -Wextra -Werror -O3 -std=c17 sleep_nanosleep_minimum_time_interval.c t
 gcc -Wall -Wextra -Werror -O3 -std=c17 sleep_nanosleep_minimum_time_interval.c timinglib.c -o bin/a -lm -pthread && time sudo chrt --fifo 99 bin/a
 
 
+# KNOBS MODE: measure the effect of each `realtime_setup()` knob (see "timinglib.h") separately,
+# each in its own child process so that the knobs don't affect each other
+gcc -Wall -Wextra -Werror -O3 -std=c17 sleep_nanosleep_minimum_time_interval.c timinglib.c -o bin/a -lm -pthread && time sudo bin/a knobs
+
+
 # 2. In C++
 # With the **regular** `SCHED_OTHER`/`SCHED_NORMAL` "Default Linux time-sharing" scheduler
 g++ -Wall -Wextra -Werror -O3 -std=c++17 sleep_nanosleep_minimum_time_interval.c timinglib.c -o bin/a -pthread && time bin/a
@@ -120,6 +125,8 @@ References:
 #include <pthread.h>
 #include <sched.h>    // https://man7.org/linux/man-pages/man2/sched_setscheduler.2.html
 #include <sys/mman.h> // `mlockall()` https://man7.org/linux/man-pages/man2/mlock.2.html
+#include <sys/wait.h> // `waitpid()`
+#include <unistd.h>   // `fork()`
 
 // C includes
 #include <errno.h>   // `errno`
@@ -151,10 +158,10 @@ void run_sleep_tests(uint64_t sleep_time_ns, uint64_t num_measurements)
     printf("ts_requested.tv_sec  = %lu\n", ts_requested.tv_sec);
     printf("ts_requested.tv_nsec = %lu\n", ts_requested.tv_nsec);
 
-    // uint64_t time_measurement_array[NUM_MEASUREMENTS];
-    uint64_t sum_ns = 0;
-    uint64_t min_dt_ns = UINT64_MAX;
-    uint64_t max_dt_ns = 0;
+    // Histogram of the sleep overshoot (actual sleep time - requested sleep time), to get the jitter
+    // percentiles. Each thread which calls this function gets its own histogram on its own stack.
+    latency_histogram_t overshoot_hist;
+    latency_histogram_init(&overshoot_hist);
     uint64_t failure_cnt = 0;
     for (size_t i = 0; i < num_measurements; i++)
     {
@@ -189,26 +196,12 @@ void run_sleep_tests(uint64_t sleep_time_ns, uint64_t num_measurements)
         // Uncomment to print ALL sleep times!
         // printf("%6lu\n", dt_ns);
 
-        sum_ns += dt_ns;
-        if (dt_ns > max_dt_ns)
-        {
-            max_dt_ns = dt_ns;
-        }
-
-        if (dt_ns < min_dt_ns)
-        {
-            min_dt_ns = dt_ns;
-        }
+        latency_histogram_record(&overshoot_hist, dt_ns > sleep_time_ns ? dt_ns - sleep_time_ns : 0);
     }
 
-    double avg_dt_ns = (double)sum_ns/num_measurements;
-    printf("failure_cnt                                              = %16lu\n", failure_cnt);
-    printf("average time required per `clock_nanosleep()` sleep call = %16.0f ns", avg_dt_ns);
-    printf(";   error = %9.0f **us**\n", NS_TO_US((double)sleep_time_ns - (double)avg_dt_ns));
-    printf("minimum time for a `clock_nanosleep()` sleep call        = %16lu ns", min_dt_ns);
-    printf(";   error = %9.0f **us**\n", NS_TO_US((double)sleep_time_ns - (double)min_dt_ns));
-    printf("maximum time for a `clock_nanosleep()` sleep call        = %16lu ns", max_dt_ns);
-    printf(";   error = %9.0f **us**\n", NS_TO_US((double)sleep_time_ns - (double)max_dt_ns));
+    printf("failure_cnt = %lu\n", failure_cnt);
+    latency_histogram_print(&overshoot_hist,
+        "sleep overshoot (actual - requested sleep time) percentiles");
     printf("\n");
 }
 
@@ -599,9 +592,81 @@ void set_scheduler()
     printf("End of `set_scheduler()`.\n\n");
 }
 
-// int main(int argc, char *argv[])  // alternative prototype
-int main()
+/// Measure the sleep jitter with each `realtime_setup()` knob applied separately, and then with
+/// all of them together. Each measurement runs in a forked child process, so that each knob
+/// starts from the default settings of a fresh process.
+void measure_realtime_knobs()
+{
+    // Start from a config with every knob turned off.
+    realtime_config_t config_none = realtime_config_get_default();
+    config_none.sched_policy = -1;
+    config_none.lock_memory = false;
+
+    typedef struct knob_s
+    {
+        const char* name;
+        realtime_config_t config;
+    } knob_t;
+    knob_t knobs[7];
+    for (size_t i = 0; i < ARRAY_LEN(knobs); i++)
+    {
+        knobs[i].config = config_none;
+    }
+    knobs[0].name = "no knobs (baseline)";
+    knobs[1].name = "SCHED_RR scheduler only";
+    knobs[1].config.sched_policy = SCHED_RR;
+    knobs[2].name = "CPU affinity (CPU 0) only";
+    knobs[2].config.cpu = 0;
+    knobs[3].name = "mlockall() only";
+    knobs[3].config.lock_memory = true;
+    knobs[4].name = "stack + heap prefault only";
+    knobs[4].config.prefault_stack_size = 512*1024;
+    knobs[4].config.prefault_heap_size = 16*1024*1024;
+    knobs[5].name = "timer slack = 1 ns only";
+    knobs[5].config.timer_slack_ns = 1;
+    knobs[6].name = "all knobs";
+    knobs[6].config = knobs[4].config;
+    knobs[6].config.sched_policy = SCHED_RR;
+    knobs[6].config.cpu = 0;
+    knobs[6].config.lock_memory = true;
+    knobs[6].config.timer_slack_ns = 1;
+
+    for (size_t i = 0; i < ARRAY_LEN(knobs); i++)
+    {
+        printf("======== %s ========\n", knobs[i].name);
+        fflush(stdout); // so the child doesn't print our buffered output again
+
+        pid_t pid = fork();
+        if (pid == -1)
+        {
+            printf("ERROR: `fork()` failed. errno = %i: %s.\n", errno, strerror(errno));
+            return;
+        }
+        if (pid == 0)
+        {
+            // child process
+            realtime_status_t status = realtime_setup(&knobs[i].config);
+            realtime_status_print(&status);
+            run_sleep_tests(1, 10000);      // 1 ns
+            run_sleep_tests(100000, 1000);  // 100 us
+            fflush(stdout);
+            _exit(EXIT_SUCCESS);
+        }
+
+        // parent process
+        int child_status;
+        waitpid(pid, &child_status, 0);
+    }
+}
+
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "knobs") == 0)
+    {
+        measure_realtime_knobs();
+        return 0;
+    }
+
     uint64_t t_start_ns = nanos();
 
     // set_scheduler(); // comment this in or out for testing
@@ -631,6 +696,40 @@ SAMPLE OUTPUT:
 
 In C:
 
+KNOBS MODE: `sudo bin/a knobs`, on a 1-core x86-64 VM. Summary of the sleep overshoot percentiles
+for the 1 ns sleep test with each knob. Note that reducing the timer slack from the default 50 us
+to 1 ns is, on its own, almost as good as the `SCHED_RR` scheduler, which also ignores the timer
+slack:
+
+    knob                          p50         p99           max
+    no knobs (baseline)         58367 ns    61439 ns    2227758 ns
+    SCHED_RR scheduler only      6527 ns     7807 ns      92716 ns
+    CPU affinity (CPU 0) only   57343 ns    62463 ns    1393573 ns
+    mlockall() only             57343 ns    67583 ns     899395 ns
+    stack + heap prefault only  56319 ns    63487 ns    1511764 ns
+    timer slack = 1 ns only      5759 ns    11007 ns      75805 ns
+    all knobs                    5247 ns     8063 ns      43557 ns
+
+
+NEW: reporting jitter percentiles via timinglib's `latency_histogram_t` (Linux default scheduler;
+first test only, on a 1-core x86-64 VM):
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 sleep_nanosleep_minimum_time_interval.c timinglib.c -o bin/a -lm -pthread && time bin/a
+    Attempt to sleep 1 ns per `clock_nanosleep()` call, 100000 times.
+    ts_requested.tv_sec  = 0
+    ts_requested.tv_nsec = 1
+    failure_cnt = 0
+    sleep overshoot (actual - requested sleep time) percentiles:
+      count = 100000
+      min   =         5371 ns
+      p50   =         7423 ns
+      p90   =         7807 ns
+      p99   =         8703 ns
+      p99.9 =        23551 ns
+      max   =       167859 ns
+
+OLDER OUTPUT, from before the percentiles were added:
+
 Linux default scheduler:
 
     eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 sleep_nanosleep_minimum_time_interval.c timinglib.c -o bin/a -lm -pthread && time bin/a
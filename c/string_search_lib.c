@@ -0,0 +1,851 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+*/
+
+// Local includes
+#include "string_search_lib.h"
+
+// C includes
+#include <stdint.h> // For `uint8_t`, `uint32_t`, etc.
+#include <stdlib.h> // `calloc()`, `malloc()`, `free()`
+#include <string.h> // `memchr()`, `memcmp()`, `strlen()`
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define STRING_SEARCH_X86 1
+    #include <immintrin.h> // SSE2 and AVX2 intrinsics
+#else
+    #define STRING_SEARCH_X86 0
+#endif
+
+/// Once the SIMD filter has spent more than this many char comparisons checking candidates which
+/// turned out to be false matches, plus `FALSE_CANDIDATE_COST_PER_CHAR` per haystack char scanned
+/// so far, switch to the Two-Way algorithm for the rest of the haystack.
+#define FALSE_CANDIDATE_COST_BUDGET 4096
+#define FALSE_CANDIDATE_COST_PER_CHAR 4
+
+/// Marks "no pattern" in the matcher's `uint32_t` pattern index arrays
+#define NO_PATTERN UINT32_MAX
+
+/// The lowest bit of each matcher table entry: set if any pattern ends at the next state
+#define HAS_MATCH_BIT 1U
+
+/// The most distinct first chars of all of the patterns for which the matcher skips ahead through
+/// the text with SIMD while it is in the root state
+#define MAX_START_CHARS 8
+
+/// Fold char `c` to lowercase if `case_insensitive` and it is an uppercase ASCII letter.
+static inline uint8_t fold_char(uint8_t c, bool case_insensitive)
+{
+    return (case_insensitive && (uint8_t)(c - 'A') < 26) ? (uint8_t)(c | 0x20) : c;
+}
+
+/// Return true if chars `a` and `b` are equal, ignoring case if `case_insensitive`.
+static inline bool char_equal(uint8_t a, uint8_t b, bool case_insensitive)
+{
+    return fold_char(a, case_insensitive) == fold_char(b, case_insensitive);
+}
+
+/// Return true if the `len` chars at `a` and `b` are equal, ignoring case if `case_insensitive`.
+static inline bool chars_equal(const uint8_t* a, const uint8_t* b, size_t len,
+    bool case_insensitive)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!char_equal(a[i], b[i], case_insensitive))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================ Two-Way ============================================
+
+/// Find the critical factorization of `needle`: the split point `needle[0:i]`, `needle[i:n]` at
+/// which the local period equals the global period. Also returns the period of the right half in
+/// `*period`. This is the maximal suffix of `needle` under both the normal char order and the
+/// reversed char order, whichever is longer.
+/// Note: `max_suffix` starts at `SIZE_MAX` (ie: "-1"), so `max_suffix + k` wraps around to `k - 1`.
+static size_t critical_factorization(const uint8_t* needle, size_t needle_len, size_t* period,
+    bool case_insensitive)
+{
+    // Maximal suffix under the normal char order
+    size_t max_suffix = SIZE_MAX;
+    size_t j = 0;
+    size_t k = 1;
+    size_t p = 1;
+    while (j + k < needle_len)
+    {
+        uint8_t a = fold_char(needle[j + k], case_insensitive);
+        uint8_t b = fold_char(needle[max_suffix + k], case_insensitive);
+        if (a < b)
+        {
+            // Suffix is smaller; period is the entire prefix so far
+            j += k;
+            k = 1;
+            p = j - max_suffix;
+        }
+        else if (a == b)
+        {
+            // Advance through the repetition of the current period
+            if (k != p)
+            {
+                k++;
+            }
+            else
+            {
+                j += p;
+                k = 1;
+            }
+        }
+        else
+        {
+            // Suffix is larger; start over from the current position
+            max_suffix = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+
+    // Maximal suffix under the reversed char order
+    size_t max_suffix_rev = SIZE_MAX;
+    j = 0;
+    k = p = 1;
+    while (j + k < needle_len)
+    {
+        uint8_t a = fold_char(needle[j + k], case_insensitive);
+        uint8_t b = fold_char(needle[max_suffix_rev + k], case_insensitive);
+        if (b < a)
+        {
+            j += k;
+            k = 1;
+            p = j - max_suffix_rev;
+        }
+        else if (a == b)
+        {
+            if (k != p)
+            {
+                k++;
+            }
+            else
+            {
+                j += p;
+                k = 1;
+            }
+        }
+        else
+        {
+            max_suffix_rev = j++;
+            k = p = 1;
+        }
+    }
+
+    // Choose the longer suffix. Both `max_suffix` values may be `SIZE_MAX`, so compare them + 1.
+    if (max_suffix_rev + 1 < max_suffix + 1)
+    {
+        return max_suffix + 1;
+    }
+    *period = p;
+    return max_suffix_rev + 1;
+}
+
+const char* str_search_two_way(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive)
+{
+    if (needle_len == 0)
+    {
+        return haystack;
+    }
+    if (haystack_len < needle_len)
+    {
+        return NULL;
+    }
+
+    const uint8_t* hay = (const uint8_t*)haystack;
+    const uint8_t* ndl = (const uint8_t*)needle;
+    const size_t n = needle_len;
+
+    size_t period;
+    size_t suffix = critical_factorization(ndl, n, &period, case_insensitive);
+
+    if (chars_equal(ndl, ndl + period, suffix, case_insensitive))
+    {
+        // The needle is periodic: the left half is a repeat of part of the right half. After a
+        // mismatch in the left half, remember how much of the needle is already known to match
+        // (`memory`), so that no haystack char is compared more than twice.
+        size_t memory = 0;
+        size_t j = 0;
+        while (j <= haystack_len - n)
+        {
+            // Scan the right half, left to right
+            size_t i = suffix > memory ? suffix : memory;
+            while (i < n && char_equal(ndl[i], hay[i + j], case_insensitive))
+            {
+                i++;
+            }
+            if (i >= n)
+            {
+                // Scan the left half, right to left
+                i = suffix - 1;
+                while (memory < i + 1 && char_equal(ndl[i], hay[i + j], case_insensitive))
+                {
+                    i--;
+                }
+                if (i + 1 < memory + 1)
+                {
+                    return haystack + j;
+                }
+                j += period;
+                memory = n - period;
+            }
+            else
+            {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    }
+    else
+    {
+        // The needle is not periodic, so a mismatch in the left half allows a shift of at least
+        // the length of the longer half
+        period = (suffix > n - suffix ? suffix : n - suffix) + 1;
+        size_t j = 0;
+        while (j <= haystack_len - n)
+        {
+            size_t i = suffix;
+            while (i < n && char_equal(ndl[i], hay[i + j], case_insensitive))
+            {
+                i++;
+            }
+            if (i >= n)
+            {
+                i = suffix - 1;
+                while (i != SIZE_MAX && char_equal(ndl[i], hay[i + j], case_insensitive))
+                {
+                    i--;
+                }
+                if (i == SIZE_MAX)
+                {
+                    return haystack + j;
+                }
+                j += period;
+            }
+            else
+            {
+                j += i - suffix + 1;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// ========================================== SIMD filter ==========================================
+
+/// A SIMD "first and last byte" search kernel. It searches from `haystack[0]` until either a match
+/// is found (returned), fewer than a vector of positions is left, or the false candidates have cost
+/// too much. In the latter 2 cases it returns NULL, with the index to continue from in `*i_end`.
+typedef const char* (*filter_func_t)(const char* haystack, size_t haystack_len,
+    const char* needle, size_t needle_len, bool case_insensitive, size_t* i_end);
+
+/// Check a filter candidate at `haystack[i]`: the first and last chars are already known to match,
+/// so compare the chars between them.
+static inline bool candidate_matches(const char* haystack, size_t i, const char* needle,
+    size_t needle_len, bool case_insensitive)
+{
+    if (needle_len <= 2)
+    {
+        return true;
+    }
+    if (!case_insensitive)
+    {
+        return memcmp(haystack + i + 1, needle + 1, needle_len - 2) == 0;
+    }
+    return chars_equal((const uint8_t*)haystack + i + 1, (const uint8_t*)needle + 1,
+        needle_len - 2, case_insensitive);
+}
+
+#if STRING_SEARCH_X86
+
+/// Fold the uppercase ASCII letters 'A' to 'Z' in `chars` to lowercase. Same as
+/// `fold_case_sse2()` in "strncmpci.c": shift 'A' to 'Z' down to -128 to -103 so that a single
+/// signed compare can find them, then set bit 5 (0x20) in just those bytes.
+__attribute__((target("sse2")))
+static inline __m128i fold_case_sse2(__m128i chars)
+{
+    __m128i shifted = _mm_sub_epi8(chars, _mm_set1_epi8((char)('A' + 128)));
+    __m128i is_upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+    return _mm_or_si128(chars, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+
+/// The same as `fold_case_sse2()`, with AVX2. AVX2 has only a "greater than" signed byte compare.
+__attribute__((target("avx2")))
+static inline __m256i fold_case_avx2(__m256i chars)
+{
+    __m256i shifted = _mm256_sub_epi8(chars, _mm256_set1_epi8((char)('A' + 128)));
+    __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_or_si256(chars, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
+
+/// The SSE2 filter: check 16 positions per loop iteration.
+__attribute__((target("sse2")))
+static const char* filter_sse2(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive, size_t* i_end)
+{
+    const size_t VEC_SIZE = 16;
+    const __m128i first = _mm_set1_epi8((char)fold_char((uint8_t)needle[0], case_insensitive));
+    const __m128i last =
+        _mm_set1_epi8((char)fold_char((uint8_t)needle[needle_len - 1], case_insensitive));
+    size_t false_candidate_cost = 0;
+
+    size_t i = 0;
+    // Both loads must stay within the haystack
+    for (; i + needle_len - 1 + VEC_SIZE <= haystack_len; i += VEC_SIZE)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(haystack + i + needle_len - 1));
+        if (case_insensitive)
+        {
+            block_first = fold_case_sse2(block_first);
+            block_last = fold_case_sse2(block_last);
+        }
+        uint32_t candidates = (uint32_t)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+        while (candidates != 0)
+        {
+            size_t i_candidate = i + __builtin_ctz(candidates);
+            if (candidate_matches(haystack, i_candidate, needle, needle_len, case_insensitive))
+            {
+                return haystack + i_candidate;
+            }
+            false_candidate_cost += needle_len;
+            candidates &= candidates - 1;
+        }
+        if (false_candidate_cost > FALSE_CANDIDATE_COST_BUDGET + FALSE_CANDIDATE_COST_PER_CHAR * i)
+        {
+            // All positions before `i + VEC_SIZE` have been checked
+            i += VEC_SIZE;
+            break;
+        }
+    }
+
+    *i_end = i;
+    return NULL;
+}
+
+/// The AVX2 filter: check 32 positions per loop iteration.
+__attribute__((target("avx2")))
+static const char* filter_avx2(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive, size_t* i_end)
+{
+    const size_t VEC_SIZE = 32;
+    const __m256i first = _mm256_set1_epi8((char)fold_char((uint8_t)needle[0], case_insensitive));
+    const __m256i last =
+        _mm256_set1_epi8((char)fold_char((uint8_t)needle[needle_len - 1], case_insensitive));
+    size_t false_candidate_cost = 0;
+
+    size_t i = 0;
+    for (; i + needle_len - 1 + VEC_SIZE <= haystack_len; i += VEC_SIZE)
+    {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(haystack + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(haystack + i + needle_len - 1));
+        if (case_insensitive)
+        {
+            block_first = fold_case_avx2(block_first);
+            block_last = fold_case_avx2(block_last);
+        }
+        uint32_t candidates = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+        while (candidates != 0)
+        {
+            size_t i_candidate = i + __builtin_ctz(candidates);
+            if (candidate_matches(haystack, i_candidate, needle, needle_len, case_insensitive))
+            {
+                return haystack + i_candidate;
+            }
+            false_candidate_cost += needle_len;
+            candidates &= candidates - 1;
+        }
+        if (false_candidate_cost > FALSE_CANDIDATE_COST_BUDGET + FALSE_CANDIDATE_COST_PER_CHAR * i)
+        {
+            i += VEC_SIZE;
+            break;
+        }
+    }
+
+    *i_end = i;
+    return NULL;
+}
+
+#endif // #if STRING_SEARCH_X86
+
+/// `filter_get()`'s "not chosen yet" state, since NULL already means "no filter for this CPU". If it
+/// were ever called, it would leave the whole haystack to Two-Way, just like no filter at all.
+static const char* filter_not_chosen(const char* haystack, size_t haystack_len,
+    const char* needle, size_t needle_len, bool case_insensitive, size_t* i_end)
+{
+    (void)haystack;
+    (void)haystack_len;
+    (void)needle;
+    (void)needle_len;
+    (void)case_insensitive;
+    *i_end = 0;
+    return NULL;
+}
+
+/// Get the best filter for this CPU, or NULL if there is none. The CPU check is done only once.
+static filter_func_t filter_get()
+{
+    static filter_func_t filter = filter_not_chosen;
+    filter_func_t filter_local = __atomic_load_n(&filter, __ATOMIC_RELAXED);
+
+    if (filter_local == filter_not_chosen)
+    {
+        filter_local = NULL;
+#if STRING_SEARCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            filter_local = filter_avx2;
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            filter_local = filter_sse2;
+        }
+#endif
+        __atomic_store_n(&filter, filter_local, __ATOMIC_RELAXED);
+    }
+    return filter_local;
+}
+
+/// Search with the best filter for this CPU, then with Two-Way for whatever part of the haystack
+/// the filter leaves unsearched.
+static const char* str_search_impl(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive)
+{
+    if (needle_len == 0)
+    {
+        return haystack;
+    }
+    if (haystack_len < needle_len)
+    {
+        return NULL;
+    }
+
+    size_t i = 0;
+    filter_func_t filter = filter_get();
+    if (filter != NULL)
+    {
+        const char* match = filter(haystack, haystack_len, needle, needle_len,
+            case_insensitive, &i);
+        if (match != NULL)
+        {
+            return match;
+        }
+    }
+    return str_search_two_way(haystack + i, haystack_len - i, needle, needle_len,
+        case_insensitive);
+}
+
+const char* str_search(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len)
+{
+    if (needle_len == 1)
+    {
+        // `memchr()` is already vectorized in every libc
+        return (const char*)memchr(haystack, needle[0], haystack_len);
+    }
+    return str_search_impl(haystack, haystack_len, needle, needle_len, false);
+}
+
+const char* str_search_ci(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len)
+{
+    return str_search_impl(haystack, haystack_len, needle, needle_len, true);
+}
+
+// ========================================= Aho-Corasick ==========================================
+
+struct str_matcher_s
+{
+    size_t num_patterns;
+    /// Length of each pattern
+    size_t* pattern_lens;
+
+    /// The equivalence class (table column) of each char
+    uint8_t char_classes[256];
+    size_t num_classes;
+    size_t num_states;
+
+    /// The DFA table: `num_states` rows of `num_classes` entries. Each entry is the next state's
+    /// row offset (state * `num_classes`), shifted left by 1, ORed with `HAS_MATCH_BIT` if any
+    /// pattern ends at the next state. State 0 is the root (nothing matched yet).
+    uint32_t* table;
+
+    /// For each state: the index of the first pattern which ends exactly at this state, or
+    /// `NO_PATTERN`
+    uint32_t* state_first_pattern;
+    /// For each pattern: the next (duplicate) pattern which ends at the same state, or
+    /// `NO_PATTERN`
+    uint32_t* next_pattern;
+    /// For each state: the nearest state along its chain of failure links (ie: its longest proper
+    /// suffix which is in the trie) at which a pattern ends, or 0 if none. This is the
+    /// Aho-Corasick "dictionary suffix link", which finds all shorter patterns which end at the
+    /// same place as a longer one.
+    uint32_t* output_link;
+
+    /// The distinct first chars of all of the patterns (both cases of letters, for a
+    /// case-insensitive matcher), if there are at most `MAX_START_CHARS`; otherwise
+    /// `num_start_chars` is 0. The unused entries repeat `start_chars[0]`.
+    uint8_t start_chars[MAX_START_CHARS];
+    size_t num_start_chars;
+    /// True if `skip_to_start_char_sse2()` may be used on this CPU
+    bool use_sse2;
+};
+
+void str_matcher_destroy(str_matcher_t* matcher)
+{
+    if (matcher == NULL)
+    {
+        return;
+    }
+    free(matcher->pattern_lens);
+    free(matcher->table);
+    free(matcher->state_first_pattern);
+    free(matcher->next_pattern);
+    free(matcher->output_link);
+    free(matcher);
+}
+
+size_t str_matcher_get_num_states(const str_matcher_t* matcher)
+{
+    return matcher->num_states;
+}
+
+/// Build the `char_classes` map. Returns false if a pattern is empty.
+static bool matcher_build_char_classes(str_matcher_t* matcher, const char* const* patterns,
+    bool case_insensitive)
+{
+    // Which (folded) chars are used in any pattern
+    bool is_used[256] = {false};
+    for (size_t i_pattern = 0; i_pattern < matcher->num_patterns; i_pattern++)
+    {
+        if (matcher->pattern_lens[i_pattern] == 0)
+        {
+            return false;
+        }
+        const uint8_t* pattern = (const uint8_t*)patterns[i_pattern];
+        for (size_t i = 0; i < matcher->pattern_lens[i_pattern]; i++)
+        {
+            is_used[fold_char(pattern[i], case_insensitive)] = true;
+        }
+    }
+
+    // Class 0 is for all unused chars, unless every char is used. Number the folded chars first,
+    // then map the unfolded ones to the same class as their folded version.
+    size_t num_used = 0;
+    for (size_t c = 0; c < 256; c++)
+    {
+        num_used += is_used[c];
+    }
+    uint8_t folded_class[256] = {0};
+    size_t num_classes = (num_used == 256) ? 0 : 1;
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (is_used[c])
+        {
+            folded_class[c] = (uint8_t)num_classes++;
+        }
+    }
+    for (size_t c = 0; c < 256; c++)
+    {
+        matcher->char_classes[c] = folded_class[fold_char((uint8_t)c, case_insensitive)];
+    }
+    matcher->num_classes = num_classes;
+    return true;
+}
+
+/// Build the matcher's DFA table, with room for up to `max_states` states. Returns false if memory
+/// allocation fails.
+static bool matcher_build_table(str_matcher_t* matcher, const char* const* patterns,
+    size_t max_states)
+{
+    const size_t num_patterns = matcher->num_patterns;
+    const size_t num_classes = matcher->num_classes;
+
+    matcher->table = (uint32_t*)calloc(max_states * num_classes, sizeof(uint32_t));
+    matcher->state_first_pattern = (uint32_t*)malloc(max_states * sizeof(uint32_t));
+    matcher->next_pattern = (uint32_t*)malloc(num_patterns * sizeof(uint32_t));
+    matcher->output_link = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    uint32_t* failure_links = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    uint32_t* queue = (uint32_t*)malloc(max_states * sizeof(uint32_t));
+    if (matcher->table == NULL || matcher->state_first_pattern == NULL
+        || matcher->next_pattern == NULL || matcher->output_link == NULL
+        || failure_links == NULL || queue == NULL)
+    {
+        free(failure_links);
+        free(queue);
+        return false;
+    }
+    memset(matcher->state_first_pattern, 0xFF, max_states * sizeof(uint32_t)); // `NO_PATTERN`
+
+    // 1. Build the trie. In the table, 0 means "no child" for now, since no state can go back to
+    //    the root (state 0) in a trie. Insert the patterns in reverse order, so that duplicates end
+    //    up listed in their original order.
+    uint32_t* table = matcher->table;
+    size_t num_states = 1;
+    for (size_t i_pattern = num_patterns; i_pattern-- > 0;)
+    {
+        const uint8_t* pattern = (const uint8_t*)patterns[i_pattern];
+        uint32_t state = 0;
+        for (size_t i = 0; i < matcher->pattern_lens[i_pattern]; i++)
+        {
+            uint32_t* child = &table[state * num_classes + matcher->char_classes[pattern[i]]];
+            if (*child == 0)
+            {
+                *child = (uint32_t)num_states++;
+            }
+            state = *child;
+        }
+        matcher->next_pattern[i_pattern] = matcher->state_first_pattern[state];
+        matcher->state_first_pattern[state] = (uint32_t)i_pattern;
+    }
+    matcher->num_states = num_states;
+
+    // 2. Visit the states in breadth-first order, so that each state's failure link, which is
+    //    always to a shallower state, has its row of the table already complete. Fill in the
+    //    missing transitions of each state with those of its failure link state, which turns the
+    //    trie into a DFA. The root's children all fail back to the root.
+    size_t queue_head = 0;
+    size_t queue_tail = 0;
+    for (size_t c = 0; c < num_classes; c++)
+    {
+        if (table[c] != 0)
+        {
+            queue[queue_tail++] = table[c];
+        }
+    }
+    while (queue_head < queue_tail)
+    {
+        uint32_t state = queue[queue_head++];
+        uint32_t failure = failure_links[state];
+        for (size_t c = 0; c < num_classes; c++)
+        {
+            uint32_t* entry = &table[state * num_classes + c];
+            uint32_t failure_next = table[failure * num_classes + c];
+            if (*entry == 0)
+            {
+                *entry = failure_next;
+                continue;
+            }
+            uint32_t child = *entry;
+            failure_links[child] = failure_next;
+            matcher->output_link[child] = matcher->state_first_pattern[failure_next] != NO_PATTERN
+                ? failure_next : matcher->output_link[failure_next];
+            queue[queue_tail++] = child;
+        }
+    }
+    free(failure_links);
+    free(queue);
+
+    // 3. Find the chars which leave the root state, to skip ahead to in the text
+    matcher->num_start_chars = 0;
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (table[matcher->char_classes[c]] == 0)
+        {
+            continue;
+        }
+        if (matcher->num_start_chars == MAX_START_CHARS)
+        {
+            matcher->num_start_chars = 0;
+            break;
+        }
+        matcher->start_chars[matcher->num_start_chars++] = (uint8_t)c;
+    }
+    for (size_t i = matcher->num_start_chars; i < MAX_START_CHARS; i++)
+    {
+        matcher->start_chars[i] = matcher->start_chars[0];
+    }
+#if STRING_SEARCH_X86
+    __builtin_cpu_init();
+    matcher->use_sse2 = __builtin_cpu_supports("sse2");
+#endif
+
+    // 4. Convert each entry from a state number to the scan loop's format
+    for (size_t i = 0; i < num_states * num_classes; i++)
+    {
+        uint32_t next = table[i];
+        bool has_match = matcher->state_first_pattern[next] != NO_PATTERN
+            || matcher->output_link[next] != 0;
+        table[i] = ((next * (uint32_t)num_classes) << 1) | (has_match ? HAS_MATCH_BIT : 0);
+    }
+
+    // The trie used fewer states than the worst case if the patterns share prefixes
+    uint32_t* shrunk = (uint32_t*)realloc(table, num_states * num_classes * sizeof(uint32_t));
+    if (shrunk != NULL)
+    {
+        matcher->table = shrunk;
+    }
+    return true;
+}
+
+str_matcher_t* str_matcher_create(const char* const* patterns, const size_t* pattern_lens,
+    size_t num_patterns, bool case_insensitive)
+{
+    if (patterns == NULL || num_patterns == 0 || num_patterns >= NO_PATTERN)
+    {
+        return NULL;
+    }
+
+    str_matcher_t* matcher = (str_matcher_t*)calloc(1, sizeof(*matcher));
+    if (matcher == NULL)
+    {
+        return NULL;
+    }
+    matcher->num_patterns = num_patterns;
+    matcher->pattern_lens = (size_t*)malloc(num_patterns * sizeof(size_t));
+    if (matcher->pattern_lens == NULL)
+    {
+        str_matcher_destroy(matcher);
+        return NULL;
+    }
+
+    // The trie can have at most 1 state per pattern char, plus the root
+    size_t max_states = 1;
+    for (size_t i = 0; i < num_patterns; i++)
+    {
+        matcher->pattern_lens[i] = pattern_lens ? pattern_lens[i] : strlen(patterns[i]);
+        max_states += matcher->pattern_lens[i];
+    }
+
+    // Table entries hold row offsets shifted left by 1, in a `uint32_t`
+    if (!matcher_build_char_classes(matcher, patterns, case_insensitive)
+        || max_states > (UINT32_MAX >> 1) / matcher->num_classes
+        || !matcher_build_table(matcher, patterns, max_states))
+    {
+        str_matcher_destroy(matcher);
+        return NULL;
+    }
+
+    return matcher;
+}
+
+#if STRING_SEARCH_X86
+
+/// Find the index of the next char, from `chars[i]` on, which is one of the `MAX_START_CHARS`
+/// `start_chars`, 16 chars at a time. Returns `len` if there is none.
+__attribute__((target("sse2")))
+static size_t skip_to_start_char_sse2(const uint8_t* start_chars, const uint8_t* chars, size_t i,
+    size_t len)
+{
+    __m128i targets[MAX_START_CHARS];
+    for (size_t k = 0; k < MAX_START_CHARS; k++)
+    {
+        targets[k] = _mm_set1_epi8((char)start_chars[k]);
+    }
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(chars + i));
+        __m128i is_start = _mm_cmpeq_epi8(block, targets[0]);
+        for (size_t k = 1; k < MAX_START_CHARS; k++)
+        {
+            is_start = _mm_or_si128(is_start, _mm_cmpeq_epi8(block, targets[k]));
+        }
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(is_start);
+        if (mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i;
+}
+
+#endif // #if STRING_SEARCH_X86
+
+/// Find the index of the next char, from `chars[i]` on, which can start a match. Returns `len` if
+/// there is none.
+static size_t skip_to_start_char(const str_matcher_t* matcher, const uint8_t* chars, size_t i,
+    size_t len)
+{
+    if (matcher->num_start_chars == 1)
+    {
+        const uint8_t* next = (const uint8_t*)memchr(chars + i, matcher->start_chars[0], len - i);
+        return next ? (size_t)(next - chars) : len;
+    }
+#if STRING_SEARCH_X86
+    if (matcher->use_sse2)
+    {
+        i = skip_to_start_char_sse2(matcher->start_chars, chars, i, len);
+    }
+#endif
+    // The last few chars, or all of them without SSE2
+    for (; i < len; i++)
+    {
+        if (matcher->table[matcher->char_classes[chars[i]]] != 0)
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+size_t str_matcher_scan(const str_matcher_t* matcher, const char* text, size_t text_len,
+    str_match_callback_t callback, void* user_data)
+{
+    const uint32_t* table = matcher->table;
+    const uint8_t* char_classes = matcher->char_classes;
+    const uint8_t* chars = (const uint8_t*)text;
+    size_t num_matches = 0;
+
+    const bool skip_in_root_state = matcher->num_start_chars > 0;
+    uint32_t entry = 0;
+    for (size_t i = 0; i < text_len; i++)
+    {
+        if (entry == 0 && skip_in_root_state)
+        {
+            // Nothing is partially matched, so jump to the next char which can start a match
+            i = skip_to_start_char(matcher, chars, i, text_len);
+            if (i == text_len)
+            {
+                break;
+            }
+        }
+        entry = table[(entry >> 1) + char_classes[chars[i]]];
+        if ((entry & HAS_MATCH_BIT) == 0)
+        {
+            continue;
+        }
+
+        // Report the patterns which end at this state, then those which end at each shorter
+        // suffix of it
+        uint32_t state = (entry >> 1) / (uint32_t)matcher->num_classes;
+        for (; state != 0; state = matcher->output_link[state])
+        {
+            for (uint32_t i_pattern = matcher->state_first_pattern[state];
+                i_pattern != NO_PATTERN; i_pattern = matcher->next_pattern[i_pattern])
+            {
+                num_matches++;
+                if (callback == NULL)
+                {
+                    continue;
+                }
+                str_match_t match = {
+                    .pattern_index = i_pattern,
+                    .start = i + 1 - matcher->pattern_lens[i_pattern],
+                    .len = matcher->pattern_lens[i_pattern],
+                };
+                if (!callback(&match, user_data))
+                {
+                    return num_matches;
+                }
+            }
+        }
+    }
+
+    return num_matches;
+}
@@ -0,0 +1,131 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A fast substring search library, for case-sensitive and case-insensitive (ASCII) search for one
+pattern at a time, plus an Aho-Corasick multi-pattern matcher which finds all occurrences of
+thousands of patterns in a single pass over the text. The typical use is to scan a big log file,
+loaded into one contiguous buffer (ex: the `file_str` or `mapped_str` buffer of a `file_t` from
+"read_file_into_c_string_and_array_of_lines.c"), for a list of keywords.
+
+All functions take explicit lengths, so the text and patterns do NOT need to be null-terminated,
+and may contain null chars.
+
+How the single-pattern search works:
+1. `str_search()` and `str_search_ci()` use a SIMD "first and last byte" filter: for 16 (SSE2) or
+   32 (AVX2) positions at once, compare the haystack chars with the needle's first char, and the
+   chars `needle_len - 1` further on with the needle's last char. Only the positions where both
+   match are candidates, which are then checked with a plain comparison of the chars in between.
+   For a needle of 2 or more "rare" chars, almost no positions are candidates, so this runs at
+   close to memory bandwidth. The case-insensitive version folds each block of chars to lower case
+   first, with the same branch-free ASCII case folding as `strncmpci_sse2()` in "strncmpci.c".
+2. The filter has a bad worst case, though: with a haystack like "aaaaaaaa..." and a needle like
+   "aaab", every position is a candidate and the search is O(haystack_len * needle_len). So, if
+   the candidate checks cost too much compared to the number of chars scanned, the search switches
+   to `str_search_two_way()` for the rest of the haystack: the Crochemore-Perrin "Two-Way"
+   algorithm (also used by glibc's `memmem()` and `strstr()`), which is O(haystack_len) in the
+   worst case and needs only O(1) extra memory.
+3. The SIMD version to use (AVX2, SSE2, or none) is chosen at run-time based on the CPU.
+
+How the multi-pattern matcher works:
+1. `str_matcher_create()` builds a trie of all of the patterns, adds the Aho-Corasick "failure"
+   links, and then turns the whole thing into a deterministic finite automaton (DFA): a table with
+   the next state for every (state, char) pair, so that scanning costs exactly 1 table lookup per
+   char of text, no matter how many patterns there are.
+2. To keep the table small, the 256 possible chars are first mapped into "equivalence classes": all
+   chars which appear in no pattern share 1 class, and, for a case-insensitive matcher, upper and
+   lower case versions of each letter share 1 class. The table then has one column per class
+   rather than one per char.
+3. Each table entry holds the next state's row offset, pre-multiplied by the number of columns,
+   with its lowest bit set if any pattern ends at that state, so that the scan loop needs no
+   multiply and only 1 extra branch per char to check for matches.
+4. Each step of the DFA depends on the table lookup of the step before, so scanning is limited by
+   the memory load latency, to about 1 char per 3 to 5 CPU cycles. But, most of the time, the
+   automaton is in its root state (nothing partially matched). While it is, if all of the patterns
+   together start with at most 8 distinct chars, the matcher instead jumps straight to the next
+   one of those chars with `memchr()` or an SSE2 scan, 16 chars at a time.
+
+STATUS: works!
+
+To compile and run:
+- See "string_search_lib_benchmark.c" as an example.
+
+References:
+1. Wojciech Mula, "SIMD-friendly algorithms for substring searching":
+   http://0x80.pl/articles/simd-strfind.html - for the "first and last byte" filter
+1. Crochemore, M. and Perrin, D., "Two-way string-matching", Journal of the ACM, 1991;
+   https://en.wikipedia.org/wiki/Two-way_string-matching_algorithm
+1. Aho, A. and Corasick, M., "Efficient string matching: an aid to bibliographic search",
+   Communications of the ACM, 1975; https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+1. https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+1. https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html - for `__builtin_cpu_supports()`
+
+*/
+
+#pragma once
+
+// C includes
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stddef.h>  // For `size_t`
+
+/// Find the first occurrence of `needle` in `haystack`, comparing chars exactly, like `memmem()`.
+/// Returns a ptr to the start of the first occurrence in `haystack`, or NULL if there is none. An
+/// empty needle matches at the start of the haystack.
+const char* str_search(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len);
+
+/// Same as `str_search()`, but ignoring the case of ASCII letters, like `strcasestr()` in the
+/// default "C" locale.
+const char* str_search_ci(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len);
+
+/// The portable Two-Way algorithm which `str_search()` and `str_search_ci()` fall back to. It
+/// never reads any char of `haystack` more than a few times, so it is O(haystack_len) in the worst
+/// case. Exposed for testing and benchmarking.
+const char* str_search_two_way(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive);
+
+/// Opaque multi-pattern matcher object: an Aho-Corasick automaton
+typedef struct str_matcher_s str_matcher_t;
+
+/// One match found by `str_matcher_scan()`
+typedef struct str_match_s
+{
+    /// Index of the pattern which matched, in the `patterns` array passed to
+    /// `str_matcher_create()`
+    size_t pattern_index;
+    /// Index of the first char of the match in the scanned text
+    size_t start;
+    /// Length of the match, which is the length of the pattern
+    size_t len;
+} str_match_t;
+
+/// A match callback for `str_matcher_scan()`. Return `true` to continue scanning, or `false` to
+/// stop.
+typedef bool (*str_match_callback_t)(const str_match_t* match, void* user_data);
+
+/// A "factory" function to build a matcher for `num_patterns` patterns.
+/// - `pattern_lens` holds the length of each pattern. If it is NULL, the patterns must be
+///   null-terminated C-strings instead, and `strlen()` is used.
+/// - Patterns must not be empty. Duplicate patterns are allowed, and are each reported.
+/// - With `case_insensitive`, the case of ASCII letters is ignored.
+/// Memory use is about `4 * num_classes * (total length of all patterns)` bytes, where
+/// `num_classes` is 1 + the number of distinct chars in the patterns (case-folded, for a
+/// case-insensitive matcher).
+/// Returns NULL if there are no patterns, a pattern is empty, the automaton would be too big
+/// (> 2^31 table entries), or memory allocation fails.
+str_matcher_t* str_matcher_create(const char* const* patterns, const size_t* pattern_lens,
+    size_t num_patterns, bool case_insensitive);
+
+/// Free a matcher created by `str_matcher_create()`. Does nothing if `matcher` is NULL.
+void str_matcher_destroy(str_matcher_t* matcher);
+
+/// Get the number of states in the matcher's automaton; for stats.
+size_t str_matcher_get_num_states(const str_matcher_t* matcher);
+
+/// Scan `text` for all occurrences of all patterns, including overlapping ones, in a single pass,
+/// and call `callback` once for each one, in order of their end positions. For matches which end at
+/// the same position, the longest one is reported first.
+/// - `callback` may be NULL, to just count the matches.
+/// Returns the number of matches reported.
+size_t str_matcher_scan(const str_matcher_t* matcher, const char* text, size_t text_len,
+    str_match_callback_t callback, void* user_data);
@@ -0,0 +1,961 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Test and benchmark "string_search_lib.h" on a log file.
+
+1. First, check `str_search()`, `str_search_ci()`, and `str_search_two_way()` against a simple
+   brute-force search, on many random haystacks and needles made of just a few different chars (so
+   that there are lots of partial and overlapping matches, and periodic needles), and check the
+   `str_matcher_t` Aho-Corasick matcher against a brute-force search for each of its patterns.
+2. Then, load the log file into one contiguous buffer, the same way `file_load()` does in
+   "read_file_into_c_string_and_array_of_lines.c", and measure the search throughput, in GB/sec of
+   log text scanned, when counting all occurrences of:
+   1. one pattern: `str_search()` vs. `memmem()`, `strstr()`, and (in C++) `std::string::find()`
+   2. one pattern, ignoring case: `str_search_ci()` vs. `strcasestr()`
+   3. 1 to 1000 patterns at once: one `str_matcher_scan()` pass vs. one `str_search()` or
+      `std::string::find()` pass per pattern
+3. Finally, use a matcher to print the first few log lines which contain any of a few keywords.
+
+If no log file is given, a ~32 MiB log of random, but realistic-looking, lines is generated in
+memory instead.
+
+STATUS: works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C:
+```bash
+gcc -Wall -Wextra -Werror -O3 -std=c17 string_search_lib_benchmark.c string_search_lib.c timinglib.c -o bin/a -pthread && bin/a
+```
+2. In C++
+```bash
+g++ -Wall -Wextra -Werror -O3 -std=c++17 string_search_lib_benchmark.c string_search_lib.c timinglib.c -o bin/a -pthread && bin/a
+```
+3. Optionally pass in the path to any log file to benchmark on it instead. Ex:
+```bash
+bin/a /var/log/syslog
+```
+
+References:
+1. string_search_lib.h
+1. https://man7.org/linux/man-pages/man3/memmem.3.html
+1. https://man7.org/linux/man-pages/man3/strstr.3.html - for `strstr()` and `strcasestr()`
+1. https://en.cppreference.com/w/cpp/string/basic_string/find
+
+*/
+
+// Required for `memmem()` and `strcasestr()` with `-std=c17`
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+// Local includes
+#include "string_search_lib.h"
+#include "timinglib.h"
+
+// C includes
+#include <ctype.h>   // For `tolower()`
+#include <errno.h>   // For `errno`
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+#include <stdio.h>   // For `printf()`
+#include <stdlib.h>  // For `malloc()`, `exit()`
+#include <string.h>  // For `memmem()`, `strstr()`, `strcasestr()`
+
+#ifdef __cplusplus
+// C++ includes
+#include <string>
+#endif
+
+/// Size of the generated log, if no log file is given
+#define GENERATED_LOG_SIZE (32*1024*1024)
+/// Number of random test cases for each of the single-pattern search functions
+#define NUM_RANDOM_SEARCH_TESTS 200000
+/// Number of random matchers to test, each on a few random texts
+#define NUM_RANDOM_MATCHER_TESTS 2000
+/// Run each benchmark at least this many times, and for at least this long, and report the fastest
+/// run
+#define MIN_BENCHMARK_RUNS 3
+#define MIN_BENCHMARK_TIME_NS (250*1000*1000ULL)
+/// The most patterns to search for with one pass per pattern, which takes (number of patterns)
+/// times longer than one pass
+#define MAX_PATTERNS_ONE_PASS_EACH 100
+
+/// A simple xorshift pseudo-random number generator, so that runs are repeatable
+static uint64_t random_state = 0x2545F4914F6CDD1DULL;
+
+static uint32_t random_u32()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return (uint32_t)(random_state >> 32);
+}
+
+// ============================================= Tests =============================================
+
+/// The brute-force reference search: compare the needle at every position.
+static const char* naive_search(const char* haystack, size_t haystack_len, const char* needle,
+    size_t needle_len, bool case_insensitive)
+{
+    if (needle_len > haystack_len)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i <= haystack_len - needle_len; i++)
+    {
+        size_t j = 0;
+        while (j < needle_len && (case_insensitive
+            ? tolower((uint8_t)haystack[i + j]) == tolower((uint8_t)needle[j])
+            : haystack[i + j] == needle[j]))
+        {
+            j++;
+        }
+        if (j == needle_len)
+        {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+/// Fill `buf` with `len` random chars from `alphabet`.
+static void random_fill(char* buf, size_t len, const char* alphabet)
+{
+    size_t alphabet_len = strlen(alphabet);
+    for (size_t i = 0; i < len; i++)
+    {
+        buf[i] = alphabet[random_u32() % alphabet_len];
+    }
+}
+
+/// Check one search function result against the reference. Returns true if they agree.
+static bool check_result(const char* func_name, const char* result, const char* expected,
+    const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    if (result == expected)
+    {
+        return true;
+    }
+    printf("FAILED: %s(\"%.*s\", \"%.*s\") returned index %ld, but expected %ld\n", func_name,
+        (int)haystack_len, haystack, (int)needle_len, needle,
+        result ? (long)(result - haystack) : -1L, expected ? (long)(expected - haystack) : -1L);
+    return false;
+}
+
+/// Check all single-pattern search functions against the reference on random inputs.
+static bool test_search_random()
+{
+    // Few distinct chars, including upper and lower case versions, and a null char
+    static const char* const ALPHABETS[] = {"ab", "aAb", "abcB", "aA\xC1\xE1", "abcdefgh"};
+    const size_t NUM_ALPHABETS = sizeof(ALPHABETS) / sizeof(ALPHABETS[0]);
+    char haystack[600];
+    char needle[40];
+    bool passed = true;
+
+    for (size_t i_test = 0; i_test < NUM_RANDOM_SEARCH_TESTS && passed; i_test++)
+    {
+        const char* alphabet = ALPHABETS[i_test % NUM_ALPHABETS];
+        size_t haystack_len = random_u32() % sizeof(haystack);
+        size_t needle_len = random_u32() % 3 == 0 ? random_u32() % sizeof(needle)
+            : random_u32() % 6;
+        random_fill(haystack, haystack_len, alphabet);
+        if (needle_len <= haystack_len && random_u32() % 2 == 0)
+        {
+            // Take the needle from the haystack, so that it is found
+            memcpy(needle, haystack + random_u32() % (haystack_len - needle_len + 1), needle_len);
+        }
+        else
+        {
+            random_fill(needle, needle_len, alphabet);
+        }
+        if (needle_len > 0 && random_u32() % 4 == 0)
+        {
+            needle[random_u32() % needle_len] = '\0';
+        }
+
+        const char* expected = naive_search(haystack, haystack_len, needle, needle_len, false);
+        const char* expected_ci = naive_search(haystack, haystack_len, needle, needle_len, true);
+        passed &= check_result("str_search", str_search(haystack, haystack_len, needle,
+            needle_len), expected, haystack, haystack_len, needle, needle_len);
+        passed &= check_result("str_search_ci", str_search_ci(haystack, haystack_len, needle,
+            needle_len), expected_ci, haystack, haystack_len, needle, needle_len);
+        passed &= check_result("str_search_two_way", str_search_two_way(haystack, haystack_len,
+            needle, needle_len, false), expected, haystack, haystack_len, needle, needle_len);
+        passed &= check_result("str_search_two_way(ci)", str_search_two_way(haystack,
+            haystack_len, needle, needle_len, true), expected_ci, haystack, haystack_len, needle,
+            needle_len);
+    }
+    return passed;
+}
+
+/// Check the SIMD filter's worst case: a haystack where every position is a candidate, which makes
+/// it switch to Two-Way partway through.
+static bool test_search_worst_case()
+{
+    const size_t HAYSTACK_LEN = 1000000;
+    char* haystack = (char*)malloc(HAYSTACK_LEN);
+    if (haystack == NULL)
+    {
+        return false;
+    }
+    memset(haystack, 'a', HAYSTACK_LEN);
+    haystack[HAYSTACK_LEN - 3] = 'b';
+    // First and last chars match everywhere; the match is at the very end
+    const char NEEDLE[] = "aaaaaaaaaaaaaaaaaaaaaaabaa";
+    const size_t NEEDLE_LEN = sizeof(NEEDLE) - 1;
+    const char* expected = haystack + HAYSTACK_LEN - NEEDLE_LEN;
+
+    uint64_t start_ns = nanos();
+    bool passed = check_result("str_search", str_search(haystack, HAYSTACK_LEN, NEEDLE,
+        NEEDLE_LEN), expected, haystack, 0, NEEDLE, NEEDLE_LEN);
+    passed &= check_result("str_search_ci", str_search_ci(haystack, HAYSTACK_LEN, "AAB", 3),
+        haystack + HAYSTACK_LEN - 5, haystack, 0, "AAB", 3);
+    uint64_t duration_ns = nanos() - start_ns;
+    printf("  worst case: 2 x 1M chars searched in %.3f ms\n", NS_TO_MS((double)duration_ns));
+
+    free(haystack);
+    return passed;
+}
+
+/// A match found by the reference matcher or by the matcher under test
+typedef struct test_match_s
+{
+    size_t pattern_index;
+    size_t start;
+} test_match_t;
+
+typedef struct test_matches_s
+{
+    test_match_t* matches;
+    size_t num_matches;
+    size_t capacity;
+} test_matches_t;
+
+static bool test_match_append(test_matches_t* matches, size_t pattern_index, size_t start)
+{
+    if (matches->num_matches == matches->capacity)
+    {
+        matches->capacity = matches->capacity ? 2 * matches->capacity : 64;
+        matches->matches = (test_match_t*)realloc(matches->matches,
+            matches->capacity * sizeof(test_match_t));
+        if (matches->matches == NULL)
+        {
+            printf("Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    test_match_t match = {pattern_index, start};
+    matches->matches[matches->num_matches++] = match;
+    return true;
+}
+
+static bool test_match_callback(const str_match_t* match, void* user_data)
+{
+    return test_match_append((test_matches_t*)user_data, match->pattern_index, match->start);
+}
+
+/// Sort matches in the order `str_matcher_scan()` reports them: by end position, then longest
+/// first, then by pattern index.
+static int test_match_compare(const void* a, const void* b, void* pattern_lens)
+{
+    const test_match_t* match_a = (const test_match_t*)a;
+    const test_match_t* match_b = (const test_match_t*)b;
+    const size_t* lens = (const size_t*)pattern_lens;
+    size_t end_a = match_a->start + lens[match_a->pattern_index];
+    size_t end_b = match_b->start + lens[match_b->pattern_index];
+    if (end_a != end_b)
+    {
+        return end_a < end_b ? -1 : 1;
+    }
+    if (match_a->start != match_b->start)
+    {
+        return match_a->start < match_b->start ? -1 : 1;
+    }
+    return match_a->pattern_index < match_b->pattern_index ? -1
+        : match_a->pattern_index > match_b->pattern_index;
+}
+
+/// Check the matcher against a brute-force search for each pattern on random inputs.
+static bool test_matcher_random()
+{
+    static const char* const ALPHABETS[] = {"ab", "aAbB", "abcdef\n", "\x00\x01\xFF"};
+    const size_t NUM_ALPHABETS = sizeof(ALPHABETS) / sizeof(ALPHABETS[0]);
+    const size_t MAX_PATTERNS = 20;
+    char pattern_bufs[20][8];
+    const char* patterns[20];
+    size_t pattern_lens[20];
+    char text[500];
+    test_matches_t expected = {NULL, 0, 0};
+    test_matches_t actual = {NULL, 0, 0};
+    bool passed = true;
+
+    for (size_t i_test = 0; i_test < NUM_RANDOM_MATCHER_TESTS && passed; i_test++)
+    {
+        const char* alphabet = ALPHABETS[i_test % NUM_ALPHABETS];
+        // "\x00..." has a null char first, which `strlen()` can't count
+        size_t alphabet_len = alphabet[0] == '\0' ? 3 : strlen(alphabet);
+        bool case_insensitive = i_test % 2;
+        size_t num_patterns = 1 + random_u32() % MAX_PATTERNS;
+        for (size_t i = 0; i < num_patterns; i++)
+        {
+            pattern_lens[i] = 1 + random_u32() % sizeof(pattern_bufs[0]);
+            for (size_t j = 0; j < pattern_lens[i]; j++)
+            {
+                pattern_bufs[i][j] = alphabet[random_u32() % alphabet_len];
+            }
+            patterns[i] = pattern_bufs[i];
+        }
+        str_matcher_t* matcher = str_matcher_create(patterns, pattern_lens, num_patterns,
+            case_insensitive);
+        if (matcher == NULL)
+        {
+            printf("FAILED: str_matcher_create() returned NULL\n");
+            return false;
+        }
+
+        for (size_t i_text = 0; i_text < 4 && passed; i_text++)
+        {
+            size_t text_len = random_u32() % sizeof(text);
+            for (size_t i = 0; i < text_len; i++)
+            {
+                text[i] = alphabet[random_u32() % alphabet_len];
+            }
+
+            expected.num_matches = 0;
+            for (size_t i_pattern = 0; i_pattern < num_patterns; i_pattern++)
+            {
+                size_t start = 0;
+                const char* match;
+                while ((match = naive_search(text + start, text_len - start, patterns[i_pattern],
+                    pattern_lens[i_pattern], case_insensitive)) != NULL)
+                {
+                    test_match_append(&expected, i_pattern, (size_t)(match - text));
+                    start = (size_t)(match - text) + 1;
+                }
+            }
+            qsort_r(expected.matches, expected.num_matches, sizeof(test_match_t),
+                test_match_compare, pattern_lens);
+
+            actual.num_matches = 0;
+            size_t num_matches = str_matcher_scan(matcher, text, text_len, test_match_callback,
+                &actual);
+            passed = num_matches == expected.num_matches
+                && actual.num_matches == expected.num_matches
+                && (expected.num_matches == 0 || memcmp(actual.matches, expected.matches,
+                    expected.num_matches * sizeof(test_match_t)) == 0);
+            if (!passed)
+            {
+                printf("FAILED: str_matcher_scan() found %zu matches, but expected %zu\n",
+                    num_matches, expected.num_matches);
+            }
+        }
+        str_matcher_destroy(matcher);
+    }
+
+    free(expected.matches);
+    free(actual.matches);
+    return passed;
+}
+
+/// Stop after the first match
+static bool stop_callback(const str_match_t* match, void* user_data)
+{
+    (void)match;
+    (void)user_data;
+    return false;
+}
+
+/// Check the matcher's error and early stop handling.
+static bool test_matcher_edge_cases()
+{
+    bool passed = true;
+    const char* const EMPTY_PATTERN[] = {"abc", ""};
+    passed &= str_matcher_create(EMPTY_PATTERN, NULL, 2, false) == NULL;
+    passed &= str_matcher_create(EMPTY_PATTERN, NULL, 0, false) == NULL;
+
+    // Every possible char, so that there is no class for unused chars
+    char all_chars[256];
+    for (size_t i = 0; i < 256; i++)
+    {
+        all_chars[i] = (char)i;
+    }
+    const char* const ALL_CHARS_PATTERN[] = {all_chars};
+    const size_t ALL_CHARS_LEN[] = {256};
+    str_matcher_t* matcher = str_matcher_create(ALL_CHARS_PATTERN, ALL_CHARS_LEN, 1, false);
+    passed &= matcher != NULL
+        && str_matcher_scan(matcher, all_chars, sizeof(all_chars), NULL, NULL) == 1
+        && str_matcher_scan(matcher, all_chars + 1, sizeof(all_chars) - 1, NULL, NULL) == 0;
+    str_matcher_destroy(matcher);
+
+    const char* const PATTERNS[] = {"he", "she", "his", "hers"};
+    matcher = str_matcher_create(PATTERNS, NULL, 4, false);
+    const char TEXT[] = "ushers";
+    passed &= matcher != NULL
+        && str_matcher_scan(matcher, TEXT, strlen(TEXT), NULL, NULL) == 3
+        && str_matcher_scan(matcher, TEXT, strlen(TEXT), stop_callback, NULL) == 1;
+    str_matcher_destroy(matcher);
+
+    if (!passed)
+    {
+        printf("FAILED: str_matcher edge cases\n");
+    }
+    return passed;
+}
+
+// ============================================ Log file ============================================
+
+/// A whole log file in 1 null-terminated buffer
+typedef struct log_s
+{
+    char* data;
+    size_t len;
+    size_t num_lines;
+} log_t;
+
+/// Read a whole file into a null-terminated buffer, like `file_load()` in
+/// "read_file_into_c_string_and_array_of_lines.c" does. Returns false on error.
+static bool log_load(log_t* log, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        printf("Failed to open \"%s\": %s\n", path, strerror(errno));
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    log->data = (char*)malloc((size_t)(size > 0 ? size : 0) + 1);
+    if (size < 0 || log->data == NULL)
+    {
+        printf("Failed to allocate memory for \"%s\"\n", path);
+        fclose(file);
+        return false;
+    }
+    log->len = fread(log->data, 1, (size_t)size, file);
+    log->data[log->len] = '\0';
+    fclose(file);
+    return true;
+}
+
+/// Generate a log of about `len` chars of realistic-looking lines.
+static bool log_generate(log_t* log, size_t len)
+{
+    static const char* const LEVELS[] = {"INFO", "INFO", "INFO", "INFO", "INFO", "INFO", "DEBUG",
+        "DEBUG", "WARN", "ERROR"};
+    static const char* const COMPONENTS[] = {"http", "db", "cache", "auth", "scheduler",
+        "worker-1", "worker-2", "worker-3"};
+
+    const size_t MAX_LINE_LEN = 200;
+    log->data = (char*)malloc(len + MAX_LINE_LEN + 1);
+    if (log->data == NULL)
+    {
+        printf("Failed to allocate memory for the log\n");
+        return false;
+    }
+
+    size_t i = 0;
+    for (uint32_t i_line = 0; i < len; i_line++)
+    {
+        char* line = log->data + i;
+        int n = sprintf(line, "2026-10-17T%02u:%02u:%02u.%03uZ %-5s [%s] ", (i_line / 3600000) % 24,
+            (i_line / 60000) % 60, (i_line / 1000) % 60, i_line % 1000, LEVELS[random_u32() % 10],
+            COMPONENTS[random_u32() % 8]);
+        uint32_t r = random_u32() % 1000;
+        if (r < 600)
+        {
+            n += sprintf(line + n, "request id=%u path=/api/v1/items/%u status=%u latency_ms=%u\n",
+                random_u32(), random_u32() % 100000, r < 590 ? 200 : 500, random_u32() % 2000);
+        }
+        else if (r < 900)
+        {
+            n += sprintf(line + n, "cache miss key=user:%u\n", random_u32() % 1000000);
+        }
+        else if (r < 990)
+        {
+            n += sprintf(line + n, "retrying operation after error, attempt=%u\n",
+                random_u32() % 5);
+        }
+        else if (r < 995)
+        {
+            n += sprintf(line + n, "%s waiting for upstream after %u ms\n",
+                random_u32() % 2 ? "Timeout" : "TIMEOUT", random_u32() % 30000);
+        }
+        else
+        {
+            n += sprintf(line + n, "connection reset by peer ip=10.0.%u.%u\n", random_u32() % 256,
+                random_u32() % 256);
+        }
+        i += (size_t)n;
+    }
+    log->len = i;
+    return true;
+}
+
+static size_t count_lines(const char* data, size_t len)
+{
+    size_t num_lines = 0;
+    const char* end = data + len;
+    for (const char* p = data; (p = (const char*)memchr(p, '\n', (size_t)(end - p))) != NULL; p++)
+    {
+        num_lines++;
+    }
+    return num_lines;
+}
+
+// =========================================== Benchmarks ==========================================
+
+/// Count all (overlapping) occurrences of one pattern, with a given search function.
+typedef size_t (*count_func_t)(const log_t* log, const char* pattern, size_t pattern_len);
+
+static size_t count_str_search(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    size_t count = 0;
+    const char* end = log->data + log->len;
+    for (const char* p = log->data;
+        (p = str_search(p, (size_t)(end - p), pattern, pattern_len)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_str_search_two_way(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    size_t count = 0;
+    const char* end = log->data + log->len;
+    for (const char* p = log->data;
+        (p = str_search_two_way(p, (size_t)(end - p), pattern, pattern_len, false)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_memmem(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    size_t count = 0;
+    const char* end = log->data + log->len;
+    for (const char* p = log->data;
+        (p = (const char*)memmem(p, (size_t)(end - p), pattern, pattern_len)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_strstr(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    (void)pattern_len;
+    size_t count = 0;
+    for (const char* p = log->data; (p = strstr(p, pattern)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_str_search_ci(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    size_t count = 0;
+    const char* end = log->data + log->len;
+    for (const char* p = log->data;
+        (p = str_search_ci(p, (size_t)(end - p), pattern, pattern_len)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_str_search_two_way_ci(const log_t* log, const char* pattern,
+    size_t pattern_len)
+{
+    size_t count = 0;
+    const char* end = log->data + log->len;
+    for (const char* p = log->data;
+        (p = str_search_two_way(p, (size_t)(end - p), pattern, pattern_len, true)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t count_strcasestr(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    (void)pattern_len;
+    size_t count = 0;
+    for (const char* p = log->data; (p = strcasestr(p, pattern)) != NULL; p++)
+    {
+        count++;
+    }
+    return count;
+}
+
+#ifdef __cplusplus
+/// The log as a `std::string`, for `std::string::find()`. Copied once, outside of the timing.
+static std::string log_string;
+
+static size_t count_std_string_find(const log_t* log, const char* pattern, size_t pattern_len)
+{
+    (void)log;
+    size_t count = 0;
+    for (size_t pos = log_string.find(pattern, 0, pattern_len); pos != std::string::npos;
+        pos = log_string.find(pattern, pos + 1, pattern_len))
+    {
+        count++;
+    }
+    return count;
+}
+#endif
+
+/// A set of patterns, and what to count them with
+typedef struct multi_search_s
+{
+    const char* const* patterns;
+    size_t num_patterns;
+    /// Count with a matcher, if not NULL; otherwise with one `count_func` pass per pattern
+    const str_matcher_t* matcher;
+    count_func_t count_func;
+} multi_search_t;
+
+static size_t count_multi_search(const log_t* log, const multi_search_t* search)
+{
+    if (search->matcher != NULL)
+    {
+        return str_matcher_scan(search->matcher, log->data, log->len, NULL, NULL);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < search->num_patterns; i++)
+    {
+        count += search->count_func(log, search->patterns[i], strlen(search->patterns[i]));
+    }
+    return count;
+}
+
+/// Time `count_multi_search()` repeatedly, and return the fastest run's throughput, in GB/sec of
+/// log text. Also returns the number of matches found in `*count`.
+static double benchmark_gb_per_sec(const log_t* log, const multi_search_t* search, size_t* count)
+{
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t total_ns = 0;
+    for (size_t run = 0; run < MIN_BENCHMARK_RUNS || total_ns < MIN_BENCHMARK_TIME_NS; run++)
+    {
+        uint64_t start_ns = nanos();
+        *count = count_multi_search(log, search);
+        uint64_t duration_ns = nanos() - start_ns;
+        best_ns = duration_ns < best_ns ? duration_ns : best_ns;
+        total_ns += duration_ns;
+    }
+    return (double)log->len / (double)best_ns;
+}
+
+/// A single-pattern search function to benchmark
+typedef struct search_method_s
+{
+    const char* name;
+    count_func_t count_func;
+} search_method_t;
+
+/// Benchmark each method on 1 pattern, and check that they all find the same number of matches.
+static void benchmark_single_pattern(const log_t* log, const char* pattern,
+    const search_method_t* methods, size_t num_methods)
+{
+    printf("\nSearch for all occurrences of \"%s\":\n", pattern);
+    printf("  %-24s %10s %10s\n", "method", "GB/sec", "matches");
+    size_t expected_count = 0;
+    for (size_t i = 0; i < num_methods; i++)
+    {
+        multi_search_t search = {&pattern, 1, NULL, methods[i].count_func};
+        size_t count;
+        double gb_per_sec = benchmark_gb_per_sec(log, &search, &count);
+        expected_count = i == 0 ? count : expected_count;
+        printf("  %-24s %10.2f %10zu%s\n", methods[i].name, gb_per_sec, count,
+            count == expected_count ? "" : "  <== MISMATCH!");
+    }
+}
+
+/// Make up `num_patterns` patterns to search for: a few keywords which are in the log, and then
+/// keywords which are rarely or never in it.
+static char** patterns_create(size_t num_patterns)
+{
+    static const char* const KEYWORDS[] = {"ERROR", "status=500", "connection reset", "Timeout",
+        "TIMEOUT", "attempt=4", "[auth]", "user:4242"};
+    const size_t NUM_KEYWORDS = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+    char** patterns = (char**)malloc(num_patterns * sizeof(char*));
+    if (patterns == NULL)
+    {
+        printf("Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < num_patterns; i++)
+    {
+        patterns[i] = (char*)malloc(32);
+        if (patterns[i] == NULL)
+        {
+            printf("Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        if (i < NUM_KEYWORDS)
+        {
+            strcpy(patterns[i], KEYWORDS[i]);
+        }
+        else if (i % 2 == 0)
+        {
+            sprintf(patterns[i], "items/%u ", random_u32() % 100000);
+        }
+        else
+        {
+            sprintf(patterns[i], "session=%08x", random_u32());
+        }
+    }
+    return patterns;
+}
+
+static void patterns_destroy(char** patterns, size_t num_patterns)
+{
+    for (size_t i = 0; i < num_patterns; i++)
+    {
+        free(patterns[i]);
+    }
+    free(patterns);
+}
+
+/// Benchmark 1 matcher pass vs. 1 pass per pattern, for many numbers of patterns.
+static void benchmark_multi_pattern(const log_t* log)
+{
+    static const size_t NUM_PATTERNS[] = {1, 10, 100, 1000};
+
+    printf("\nSearch for all occurrences of N patterns at once (GB/sec; \"-\" = skipped, since it "
+        "would take too long):\n");
+    printf("  %6s %7s %12s %12s %12s", "N", "states", "matcher", "matcher(ci)", "N x search");
+#ifdef __cplusplus
+    printf(" %12s", "N x find");
+#endif
+    printf(" %10s\n", "matches");
+
+    for (size_t i = 0; i < sizeof(NUM_PATTERNS) / sizeof(NUM_PATTERNS[0]); i++)
+    {
+        size_t num_patterns = NUM_PATTERNS[i];
+        char** patterns = patterns_create(num_patterns);
+        const char* const* const_patterns = (const char* const*)patterns;
+        str_matcher_t* matcher = str_matcher_create(const_patterns, NULL, num_patterns, false);
+        str_matcher_t* matcher_ci = str_matcher_create(const_patterns, NULL, num_patterns, true);
+        if (matcher == NULL || matcher_ci == NULL)
+        {
+            printf("Failed to create the matchers\n");
+            exit(EXIT_FAILURE);
+        }
+
+        size_t count;
+        size_t count_ci;
+        multi_search_t search = {const_patterns, num_patterns, matcher, NULL};
+        multi_search_t search_ci = {const_patterns, num_patterns, matcher_ci, NULL};
+        double gb_per_sec = benchmark_gb_per_sec(log, &search, &count);
+        double gb_per_sec_ci = benchmark_gb_per_sec(log, &search_ci, &count_ci);
+        printf("  %6zu %7zu %12.2f %12.2f", num_patterns, str_matcher_get_num_states(matcher),
+            gb_per_sec, gb_per_sec_ci);
+
+        bool mismatch = false;
+        count_func_t one_pass_funcs[] = {
+            count_str_search,
+#ifdef __cplusplus
+            count_std_string_find,
+#endif
+        };
+        for (size_t j = 0; j < sizeof(one_pass_funcs) / sizeof(one_pass_funcs[0]); j++)
+        {
+            if (num_patterns > MAX_PATTERNS_ONE_PASS_EACH)
+            {
+                printf(" %12s", "-");
+                continue;
+            }
+            size_t one_pass_count;
+            multi_search_t one_pass_search = {const_patterns, num_patterns, NULL,
+                one_pass_funcs[j]};
+            printf(" %12.2f", benchmark_gb_per_sec(log, &one_pass_search, &one_pass_count));
+            mismatch |= one_pass_count != count;
+        }
+        printf(" %10zu%s\n", count, mismatch ? "  <== MISMATCH!" : "");
+
+        str_matcher_destroy(matcher);
+        str_matcher_destroy(matcher_ci);
+        patterns_destroy(patterns, num_patterns);
+    }
+}
+
+/// The state for `print_line_callback()`
+typedef struct print_lines_s
+{
+    const log_t* log;
+    const char* const* patterns;
+    /// Index of the char just past the last line printed, so that each line is printed only once
+    size_t i_printed_end;
+    size_t num_lines_printed;
+    size_t max_lines_to_print;
+} print_lines_t;
+
+/// Print the whole log line which contains a match, once per line.
+static bool print_line_callback(const str_match_t* match, void* user_data)
+{
+    print_lines_t* state = (print_lines_t*)user_data;
+    if (match->start < state->i_printed_end)
+    {
+        // Already printed this line
+        return true;
+    }
+    const char* data = state->log->data;
+    size_t i_line_start = match->start;
+    while (i_line_start > 0 && data[i_line_start - 1] != '\n')
+    {
+        i_line_start--;
+    }
+    const char* line_end = (const char*)memchr(data + match->start, '\n',
+        state->log->len - match->start);
+    size_t i_line_end = line_end ? (size_t)(line_end - data) : state->log->len;
+    printf("  [%-16s] %.*s\n", state->patterns[match->pattern_index],
+        (int)(i_line_end - i_line_start), data + i_line_start);
+
+    state->i_printed_end = i_line_end;
+    state->num_lines_printed++;
+    return state->num_lines_printed < state->max_lines_to_print;
+}
+
+int main(int argc, char *argv[])
+{
+    printf("Testing...\n");
+    bool passed = test_search_random();
+    passed &= test_search_worst_case();
+    passed &= test_matcher_random();
+    passed &= test_matcher_edge_cases();
+    if (!passed)
+    {
+        printf("TESTS FAILED!\n");
+        return EXIT_FAILURE;
+    }
+    printf("All tests passed!\n\n");
+
+    log_t log;
+    if (argc > 1)
+    {
+        if (!log_load(&log, argv[1]))
+        {
+            return EXIT_FAILURE;
+        }
+        printf("Log file: \"%s\"", argv[1]);
+    }
+    else
+    {
+        if (!log_generate(&log, GENERATED_LOG_SIZE))
+        {
+            return EXIT_FAILURE;
+        }
+        printf("Log file: (generated)");
+    }
+    log.num_lines = count_lines(log.data, log.len);
+    printf(": %zu bytes, %zu lines\n", log.len, log.num_lines);
+#ifdef __cplusplus
+    log_string.assign(log.data, log.len);
+#endif
+
+    const search_method_t METHODS[] = {
+        {"str_search", count_str_search},
+        {"str_search_two_way", count_str_search_two_way},
+        {"memmem", count_memmem},
+        {"strstr", count_strstr},
+#ifdef __cplusplus
+        {"std::string::find", count_std_string_find},
+#endif
+    };
+    const search_method_t METHODS_CI[] = {
+        {"str_search_ci", count_str_search_ci},
+        {"str_search_two_way(ci)", count_str_search_two_way_ci},
+        {"strcasestr", count_strcasestr},
+    };
+    const size_t NUM_METHODS = sizeof(METHODS) / sizeof(METHODS[0]);
+    benchmark_single_pattern(&log, "connection reset", METHODS, NUM_METHODS);
+    benchmark_single_pattern(&log, "status=500", METHODS, NUM_METHODS);
+    benchmark_single_pattern(&log, "timeout", METHODS_CI,
+        sizeof(METHODS_CI) / sizeof(METHODS_CI[0]));
+    benchmark_multi_pattern(&log);
+
+    const char* const KEYWORDS[] = {"ERROR", "connection reset", "timeout"};
+    str_matcher_t* matcher = str_matcher_create(KEYWORDS, NULL, 3, true);
+    if (matcher == NULL)
+    {
+        printf("Failed to create the matcher\n");
+        return EXIT_FAILURE;
+    }
+    printf("\nThe first few lines with any of the keywords \"ERROR\", \"connection reset\", or "
+        "\"timeout\" (ignoring case):\n");
+    print_lines_t print_lines = {&log, KEYWORDS, 0, 0, 8};
+    str_matcher_scan(matcher, log.data, log.len, print_line_callback, &print_lines);
+    str_matcher_destroy(matcher);
+
+    free(log.data);
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT:
+
+In C++, on a 1-core 2 GHz VM. Note that a DFA scan (the "matcher" column) is limited by the latency
+of its chain of table lookups, not by the number of patterns, so its speed barely changes from 10
+to 1000 patterns, while one search per pattern gets N times slower. With 1 pattern, the matcher
+spends nearly all of its time skipping ahead to the next 'E' with `memchr()`. Case-insensitively,
+it must stop at every 'e' too, which is much more common in the text.
+
+    eRCaGuy_hello_world/c$ g++ -Wall -Wextra -Werror -O3 -std=c++17 string_search_lib_benchmark.c string_search_lib.c timinglib.c -o bin/a -pthread && bin/a
+    Testing...
+      worst case: 2 x 1M chars searched in 2.884 ms
+    All tests passed!
+
+    Log file: (generated): 33554505 bytes, 349005 lines
+
+    Search for all occurrences of "connection reset":
+      method                       GB/sec    matches
+      str_search                     7.70       1793
+      str_search_two_way             0.59       1793
+      memmem                         3.87       1793
+      strstr                         9.91       1793
+      std::string::find              2.46       1793
+
+    Search for all occurrences of "status=500":
+      method                       GB/sec    matches
+      str_search                     3.36       3521
+      str_search_two_way             0.55       3521
+      memmem                         2.44       3521
+      strstr                         4.34       3521
+      std::string::find              1.60       3521
+
+    Search for all occurrences of "timeout":
+      method                       GB/sec    matches
+      str_search_ci                  4.28       1839
+      str_search_two_way(ci)         0.24       1839
+      strcasestr                     0.73       1839
+
+    Search for all occurrences of N patterns at once (GB/sec; "-" = skipped, since it would take too long):
+           N  states      matcher  matcher(ci)   N x search     N x find    matches
+           1       6         4.05         0.60         5.20         4.40      34890
+          10      96         0.34         0.21         0.39         0.21      92063
+         100     635         0.32         0.22         0.04         0.02      92165
+        1000    5152         0.31         0.17            -            -      93091
+
+    The first few lines with any of the keywords "ERROR", "connection reset", or "timeout" (ignoring case):
+      [ERROR           ] 2026-10-17T00:00:00.011Z INFO  [worker-3] retrying operation after error, attempt=3
+      [ERROR           ] 2026-10-17T00:00:00.015Z INFO  [cache] retrying operation after error, attempt=0
+      [ERROR           ] 2026-10-17T00:00:00.027Z INFO  [cache] retrying operation after error, attempt=3
+      [ERROR           ] 2026-10-17T00:00:00.030Z ERROR [worker-3] cache miss key=user:846846
+      [ERROR           ] 2026-10-17T00:00:00.031Z ERROR [auth] cache miss key=user:470159
+      [ERROR           ] 2026-10-17T00:00:00.035Z ERROR [worker-1] request id=1789807144 path=/api/v1/items/89261 status=200 latency_ms=1274
+      [ERROR           ] 2026-10-17T00:00:00.036Z ERROR [worker-2] cache miss key=user:864494
+      [ERROR           ] 2026-10-17T00:00:00.041Z ERROR [auth] request id=2292356863 path=/api/v1/items/14773 status=200 latency_ms=322
+
+
+In C:
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 string_search_lib_benchmark.c string_search_lib.c timinglib.c -o bin/a -pthread && bin/a
+    [SAME AS THE C++ OUTPUT, BUT WITHOUT THE `std::string::find` ROW AND "N x find" COLUMN]
+
+
+*/
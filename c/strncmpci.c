@@ -14,27 +14,52 @@ Written: 21 Mar. 2019
 Updated: 21 Oct. 2020
 - moved to this git repo; see `git log` history after that
 
+- `strncmpci_sse2()` and `strncmpci_avx2()` are vectorized versions of `strncmpci()`, which
+compare 16 or 32 chars per loop iteration, and `strncmpci_fast()` calls the fastest one this CPU
+supports. They fold ASCII case only, which matches `tolower()` in the default "C" locale, and they
+return exactly the same values as `strncmpci()`, including `INT_MIN` for NULL ptrs. Since they
+must not read past the null terminator into an unmapped page, they fall back to 1 char at a time
+whenever a full vector load would cross a 4 KiB page boundary.
+
 To compile and run:
 
-    gcc -Wall -Wextra -Werror -ggdb -std=c11 -o ./bin/tmp strncmpci.c && ./bin/tmp
+    gcc -Wall -Wextra -Werror -ggdb -O3 -std=c11 -o ./bin/tmp strncmpci.c && ./bin/tmp
 
 
 References:
 1. [my own answer] https://stackoverflow.com/questions/5820810/case-insensitive-string-comp-in-c/55293507#55293507
 2. https://en.cppreference.com/w/cpp/string/byte/strncmp
 3. http://www.cplusplus.com/reference/cstring/strncmp/
+4. https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
 
 STATUS:
 IT WORKS! ALL UNIT TESTS PASS!
 
 */
 
+// Required for `clock_gettime()`, `mmap()`, and `MAP_ANONYMOUS` with `-std=c11`
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
 #include <assert.h>
 #include <stdbool.h>
 #include <ctype.h> // for `tolower()`
 #include <limits.h> // for `INT_MIN`
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h> // for `strncasecmp()`
+#include <sys/mman.h> // for `mmap()`
+#include <time.h> // for `clock_gettime()`
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define STRNCMPCI_X86 1
+    #include <immintrin.h>
+#else
+    #define STRNCMPCI_X86 0
+#endif
 
 // For ANSI color codes in a terminal, see my notes to self in my file here:
 // https://github.com/ElectricRCAircraftGuy/eRCaGuy_dotfiles/blob/master/useful_scripts/git-diffn.sh
@@ -178,6 +203,205 @@ done:
     return ret_code;
 }
 
+/// The page size which vector loads must not cross: 4 KiB, the smallest page size on x86
+#define STRNCMPCI_PAGE_SIZE 4096
+
+/// The vectorized versions read up to a whole vector at a time, which may include bytes past the
+/// null terminator or past `num`, but only ever within the same page as valid bytes, which can't
+/// fault. AddressSanitizer doesn't know that, so exclude these functions from it.
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+    #define STRNCMPCI_NO_ASAN __attribute__((no_sanitize("address")))
+#else
+    #define STRNCMPCI_NO_ASAN
+#endif
+
+/// Get the number of bytes from `ptr` to the end of its page.
+static inline size_t bytes_left_in_page(const char * ptr)
+{
+    return STRNCMPCI_PAGE_SIZE - ((uintptr_t)ptr & (STRNCMPCI_PAGE_SIZE - 1));
+}
+
+/// Get the index just past the last full vector of `vec_size` bytes which can be loaded from both
+/// `&str1[i]` and `&str2[i]` onward without crossing into either string's next page.
+static inline size_t vector_run_end(const char * str1, const char * str2, size_t i,
+    size_t vec_size)
+{
+    size_t bytes_left1 = bytes_left_in_page(&str1[i]);
+    size_t bytes_left2 = bytes_left_in_page(&str2[i]);
+    size_t bytes_left = bytes_left1 < bytes_left2 ? bytes_left1 : bytes_left2;
+    return i + bytes_left - bytes_left % vec_size;
+}
+
+/// Get the `strncmpci()` return value for chars `c1` and `c2`, the first pair which either differ
+/// (ignoring case) or are both the null terminator.
+static inline int strncmpci_result(char c1, char c2)
+{
+    return tolower((int)c1) - tolower((int)c2);
+}
+
+/// Do one step of `strncmpci()`, 1 char at a time, for when a vector load would cross a page.
+/// Returns true, with the final `*ret_code`, if the comparison is done.
+static inline bool strncmpci_step(const char * str1, const char * str2, int * ret_code)
+{
+    *ret_code = strncmpci_result(*str1, *str2);
+    return *ret_code != 0 || *str1 == '\0';
+}
+
+#if STRNCMPCI_X86
+
+/// Fold the uppercase ASCII letters 'A' to 'Z' in `chars` to lowercase, by setting bit 5 (0x20) in
+/// just those bytes. SSE2 only has signed byte compares, so shift the range 'A' to 'Z' down to
+/// -128 to -103, below which a single signed compare can check it.
+__attribute__((target("sse2")))
+static inline __m128i fold_case_sse2(__m128i chars)
+{
+    __m128i shifted = _mm_sub_epi8(chars, _mm_set1_epi8((char)('A' + 128)));
+    __m128i is_upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+    return _mm_or_si128(chars, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+
+/// \brief      Identical to `strncmpci()`, but compares 16 chars per loop iteration with SSE2.
+///             SSE2 is part of every x86-64 CPU.
+__attribute__((target("sse2"))) STRNCMPCI_NO_ASAN
+int strncmpci_sse2(const char * str1, const char * str2, size_t num)
+{
+    const size_t VEC_SIZE = 16;
+    int ret_code = 0;
+
+    if (!str1 || !str2)
+    {
+        return INT_MIN;
+    }
+
+    size_t i = 0;
+    while (i < num)
+    {
+        // Compare 1 char at a time until a full vector can be loaded from both strings without
+        // crossing into either one's next page, and then a vector at a time up to the first page
+        // end
+        size_t run_end = vector_run_end(str1, str2, i, VEC_SIZE);
+        if (run_end == i)
+        {
+            if (strncmpci_step(&str1[i], &str2[i], &ret_code))
+            {
+                return ret_code;
+            }
+            i++;
+            continue;
+        }
+
+        for (; i < run_end && i < num; i += VEC_SIZE)
+        {
+            __m128i chars1 = _mm_loadu_si128((const __m128i*)&str1[i]);
+            __m128i chars2 = _mm_loadu_si128((const __m128i*)&str2[i]);
+            // A bit is set for each char which differs (ignoring case), or is the null terminator
+            __m128i equal = _mm_cmpeq_epi8(fold_case_sse2(chars1), fold_case_sse2(chars2));
+            __m128i is_null = _mm_cmpeq_epi8(chars1, _mm_setzero_si128());
+            uint32_t stop_mask = ((uint32_t)_mm_movemask_epi8(equal) ^ 0xFFFF)
+                | (uint32_t)_mm_movemask_epi8(is_null);
+            if (num - i < VEC_SIZE)
+            {
+                // Ignore the chars past `num`
+                stop_mask &= (1U << (num - i)) - 1;
+            }
+            if (stop_mask != 0)
+            {
+                size_t j = i + __builtin_ctz(stop_mask);
+                return strncmpci_result(str1[j], str2[j]);
+            }
+        }
+    }
+
+    return ret_code;
+}
+
+/// \brief      Identical to `strncmpci()`, but compares 32 chars per loop iteration with AVX2.
+__attribute__((target("avx2"))) STRNCMPCI_NO_ASAN
+int strncmpci_avx2(const char * str1, const char * str2, size_t num)
+{
+    const size_t VEC_SIZE = 32;
+    int ret_code = 0;
+
+    if (!str1 || !str2)
+    {
+        return INT_MIN;
+    }
+
+    const __m256i OFFSET = _mm256_set1_epi8((char)('A' + 128));
+    const __m256i UPPER_LIMIT = _mm256_set1_epi8(-128 + 26);
+    const __m256i CASE_BIT = _mm256_set1_epi8(0x20);
+
+    size_t i = 0;
+    while (i < num)
+    {
+        // Same as in `strncmpci_sse2()`
+        size_t run_end = vector_run_end(str1, str2, i, VEC_SIZE);
+        if (run_end == i)
+        {
+            if (strncmpci_step(&str1[i], &str2[i], &ret_code))
+            {
+                return ret_code;
+            }
+            i++;
+            continue;
+        }
+
+        for (; i < run_end && i < num; i += VEC_SIZE)
+        {
+            __m256i chars1 = _mm256_loadu_si256((const __m256i*)&str1[i]);
+            __m256i chars2 = _mm256_loadu_si256((const __m256i*)&str2[i]);
+            // Same case folding as `fold_case_sse2()`; AVX2 has no unsigned byte compare either
+            __m256i folded1 = _mm256_or_si256(chars1, _mm256_and_si256(CASE_BIT,
+                _mm256_cmpgt_epi8(UPPER_LIMIT, _mm256_sub_epi8(chars1, OFFSET))));
+            __m256i folded2 = _mm256_or_si256(chars2, _mm256_and_si256(CASE_BIT,
+                _mm256_cmpgt_epi8(UPPER_LIMIT, _mm256_sub_epi8(chars2, OFFSET))));
+            uint32_t equal_mask =
+                (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded1, folded2));
+            uint32_t null_mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(chars1, _mm256_setzero_si256()));
+            uint32_t stop_mask = ~equal_mask | null_mask;
+            if (num - i < VEC_SIZE)
+            {
+                // Ignore the chars past `num`
+                stop_mask &= (1U << (num - i)) - 1;
+            }
+            if (stop_mask != 0)
+            {
+                size_t j = i + __builtin_ctz(stop_mask);
+                return strncmpci_result(str1[j], str2[j]);
+            }
+        }
+    }
+
+    return ret_code;
+}
+
+#endif // #if STRNCMPCI_X86
+
+/// A function with the same signature as `strncmpci()`
+typedef int (*strncmpci_func_t)(const char * str1, const char * str2, size_t num);
+
+/// \brief      Identical to `strncmpci()`, but uses the fastest vectorized version this CPU
+///             supports, chosen at run-time on the first call. Thread-safe: threads which make
+///             their first calls at the same time may each choose the version, but they all choose
+///             the same one, and `func` is only accessed atomically.
+int strncmpci_fast(const char * str1, const char * str2, size_t num)
+{
+    static strncmpci_func_t func = NULL;
+    strncmpci_func_t func_local = __atomic_load_n(&func, __ATOMIC_RELAXED);
+    if (func_local == NULL)
+    {
+#if STRNCMPCI_X86
+        __builtin_cpu_init();
+        func_local = __builtin_cpu_supports("avx2") ? strncmpci_avx2 : strncmpci_sse2;
+#else
+        func_local = strncmpci;
+#endif
+        __atomic_store_n(&func, func_local, __ATOMIC_RELAXED);
+    }
+    return func_local(str1, str2, num);
+}
+
 // TODO: ADD IN Unit tests to test this function too! Ex: `EXPECT_EQUALS(strcicmp(str1, str2), 0);`
 
 // /// \brief      Alternative approach to test and compare results from.
@@ -250,132 +474,301 @@ bool expect_equals(int a, int b, int * error_count, char * a_str, char * b_str,
     return false;
 }
 
-int main()
+/// \brief      Run the unit test table on one `strncmpci()` implementation.
+void test_strncmpci_func(strncmpci_func_t func)
 {
-    printf("-----------------------\n"
-           "String Comparison Tests\n"
-           "-----------------------\n\n");
-
-    int num_failures_expected = 0;
-
-    printf("INTENTIONAL UNIT TEST FAILURE to show what a unit test failure looks like!\n");
-    EXPECT_EQUALS(strncmpci("hey", "HEY", 3), 'h' - 'H');
-    num_failures_expected++;
-    printf("------ beginning ------\n\n");
-
-
     const char * str1;
     const char * str2;
     size_t n;
 
     // NULL ptr checks
-    EXPECT_EQUALS(strncmpci(NULL, "", 0), INT_MIN);
-    EXPECT_EQUALS(strncmpci("", NULL, 0), INT_MIN);
-    EXPECT_EQUALS(strncmpci(NULL, NULL, 0), INT_MIN);
-    EXPECT_EQUALS(strncmpci(NULL, "", 10), INT_MIN);
-    EXPECT_EQUALS(strncmpci("", NULL, 10), INT_MIN);
-    EXPECT_EQUALS(strncmpci(NULL, NULL, 10), INT_MIN);
-
-    EXPECT_EQUALS(strncmpci("", "", 0), 0);
+    EXPECT_EQUALS(func(NULL, "", 0), INT_MIN);
+    EXPECT_EQUALS(func("", NULL, 0), INT_MIN);
+    EXPECT_EQUALS(func(NULL, NULL, 0), INT_MIN);
+    EXPECT_EQUALS(func(NULL, "", 10), INT_MIN);
+    EXPECT_EQUALS(func("", NULL, 10), INT_MIN);
+    EXPECT_EQUALS(func(NULL, NULL, 10), INT_MIN);
+
+    EXPECT_EQUALS(func("", "", 0), 0);
     EXPECT_EQUALS(strncmp("", "", 0), 0);
 
     str1 = "";
     str2 = "";
     n = 0;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 0);
 
     str1 = "hey";
     str2 = "HEY";
     n = 0;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 0);
 
     str1 = "hey";
     str2 = "HEY";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 'h' - 'H');
 
     str1 = "heY";
     str2 = "HeY";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 'h' - 'H');
 
     str1 = "hey";
     str2 = "HEdY";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 'y' - 'd');
+    EXPECT_EQUALS(func(str1, str2, n), 'y' - 'd');
     EXPECT_EQUALS(strncmp(str1, str2, n), 'h' - 'H');
 
     str1 = "heY";
     str2 = "hEYd";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 'e' - 'E');
 
     str1 = "heY";
     str2 = "heyd";
     n = 6;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), -'d');
+    EXPECT_EQUALS(func(str1, str2, n), -'d');
     EXPECT_EQUALS(strncmp(str1, str2, n), 'Y' - 'y');
 
     str1 = "hey";
     str2 = "hey";
     n = 6;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 0);
 
     str1 = "hey";
     str2 = "heyd";
     n = 6;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), -'d');
+    EXPECT_EQUALS(func(str1, str2, n), -'d');
     EXPECT_EQUALS(strncmp(str1, str2, n), -'d');
 
     str1 = "hey";
     str2 = "heyd";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 0);
 
     str1 = "hEY";
     str2 = "heyYOU";
     n = 3;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 0);
+    EXPECT_EQUALS(func(str1, str2, n), 0);
     EXPECT_EQUALS(strncmp(str1, str2, n), 'E' - 'e');
 
     str1 = "hEY";
     str2 = "heyYOU";
     n = 10;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), -'y');
+    EXPECT_EQUALS(func(str1, str2, n), -'y');
     EXPECT_EQUALS(strncmp(str1, str2, n), 'E' - 'e');
 
     str1 = "hEYHowAre";
     str2 = "heyYOU";
     n = 10;
-    EXPECT_EQUALS(strncmpci(str1, str2, n), 'h' - 'y');
+    EXPECT_EQUALS(func(str1, str2, n), 'h' - 'y');
     EXPECT_EQUALS(strncmp(str1, str2, n), 'E' - 'e');
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "NICE TO MEET YOU.,;", 100), 0);
+    EXPECT_EQUALS(func("nice to meet you.,;", "NICE TO MEET YOU.,;", 100), 0);
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "NICE TO MEET YOU.,;", 100), 'n' - 'N');
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice to meet you.,;", 100), 0);
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "NICE TO UEET YOU.,;", 100), 'm' - 'u');
+    EXPECT_EQUALS(func("nice to meet you.,;", "NICE TO UEET YOU.,;", 100), 'm' - 'u');
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice to uEET YOU.,;", 100), 'm' - 'u');
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice to UEET YOU.,;", 100), 'm' - 'U');
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "NICE TO MEET YOU.,;", 5), 0);
+    EXPECT_EQUALS(func("nice to meet you.,;", "NICE TO MEET YOU.,;", 5), 0);
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "NICE TO MEET YOU.,;", 5), 'n' - 'N');
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "NICE eo UEET YOU.,;", 5), 0);
+    EXPECT_EQUALS(func("nice to meet you.,;", "NICE eo UEET YOU.,;", 5), 0);
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice eo uEET YOU.,;", 5), 0);
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "NICE eo UEET YOU.,;", 100), 't' - 'e');
+    EXPECT_EQUALS(func("nice to meet you.,;", "NICE eo UEET YOU.,;", 100), 't' - 'e');
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice eo uEET YOU.,;", 100), 't' - 'e');
 
-    EXPECT_EQUALS(strncmpci("nice to meet you.,;", "nice-eo UEET YOU.,;", 5), ' ' - '-');
+    EXPECT_EQUALS(func("nice to meet you.,;", "nice-eo UEET YOU.,;", 5), ' ' - '-');
     EXPECT_EQUALS(strncmp(  "nice to meet you.,;", "nice-eo UEET YOU.,;", 5), ' ' - '-');
+}
+
+/// \brief      Fill `str` with `len` random chars, followed by a null terminator. The chars are
+///             mostly letters of both cases, plus the chars just outside of the 'A' to 'Z' and
+///             'a' to 'z' ranges, and some non-ASCII chars, to test the case folding edge cases.
+void random_string(char * str, size_t len, unsigned int * seed)
+{
+    const char CHARS[] = "aAbBzZyY@[`{ -9\x80\xc1\xe1\xff";
+    for (size_t i = 0; i < len; i++)
+    {
+        str[i] = CHARS[rand_r(seed) % (sizeof(CHARS) - 1)];
+    }
+    str[len] = '\0';
+}
+
+/// \brief      Check that `func` returns exactly the same values as `strncmpci()` for many random
+///             pairs of strings, which each end right before an unreadable guard page, so that any
+///             read past a null terminator into the next page crashes the test.
+void test_strncmpci_func_random(strncmpci_func_t func)
+{
+    const size_t MAX_LEN = 300;
+    const size_t NUM_TESTS = 200000;
+    const size_t PAGE_SIZE = 4096;
+
+    // 2 buffers, each 1 page followed by a guard page
+    char * mem = (char *)mmap(NULL, 4*PAGE_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(mem != MAP_FAILED);
+    mprotect(mem + PAGE_SIZE, PAGE_SIZE, PROT_NONE);
+    mprotect(mem + 3*PAGE_SIZE, PAGE_SIZE, PROT_NONE);
+    char * page1_end = mem + PAGE_SIZE;
+    char * page2_end = mem + 3*PAGE_SIZE;
+
+    unsigned int seed = 1;
+    for (size_t i_test = 0; i_test < NUM_TESTS; i_test++)
+    {
+        size_t len1 = rand_r(&seed) % MAX_LEN;
+        char * str1 = page1_end - len1 - 1;
+        random_string(str1, len1, &seed);
+
+        // Make `str2` the same as `str1`, but with the case of some letters flipped, maybe 1 char
+        // changed, and maybe a different length
+        size_t len2 = rand_r(&seed) % 4 == 0 ? rand_r(&seed) % MAX_LEN : len1;
+        char * str2 = page2_end - len2 - 1;
+        random_string(str2, len2, &seed);
+        memcpy(str2, str1, len1 < len2 ? len1 : len2);
+        for (size_t i = 0; i < len2; i++)
+        {
+            if (isalpha((unsigned char)str2[i]) && rand_r(&seed) % 2)
+            {
+                str2[i] ^= 0x20;
+            }
+        }
+        if (len2 > 0 && rand_r(&seed) % 2)
+        {
+            str2[rand_r(&seed) % len2] = (char)(' ' + rand_r(&seed) % 95);
+        }
+
+        const size_t NUMS[] = {0, rand_r(&seed) % (MAX_LEN + 1), len1, len2, len1 + 10, SIZE_MAX};
+        for (size_t i = 0; i < sizeof(NUMS)/sizeof(NUMS[0]); i++)
+        {
+            int expected = strncmpci(str1, str2, NUMS[i]);
+            int actual = func(str1, str2, NUMS[i]);
+            if (actual != expected)
+            {
+                EXPECT_EQUALS(actual, expected);
+                printf("  str1 = \"%s\"; str2 = \"%s\"; num = %zu\n\n", str1, str2, NUMS[i]);
+            }
+        }
+    }
+
+    munmap(mem, 4*PAGE_SIZE);
+}
+
+/// \brief      Get a monotonic time stamp in nanoseconds.
+uint64_t nanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/// \brief      Print the speed, in bytes/ns, of comparing 2 strings of each of several lengths,
+///             which are equal except for their case, so that every char must be compared.
+void benchmark_strncmpci_func(const char * name, strncmpci_func_t func)
+{
+    const size_t LENS[] = {8, 16, 32, 64, 256, 4096};
+    const size_t TOTAL_BYTES = 200*1000*1000;
+    char str1[4096 + 1];
+    char str2[4096 + 1];
+    for (size_t i = 0; i < 4096; i++)
+    {
+        str1[i] = 'a' + i % 26;
+        str2[i] = 'A' + i % 26;
+    }
+
+    printf("  %-18s", name);
+    for (size_t i_len = 0; i_len < sizeof(LENS)/sizeof(LENS[0]); i_len++)
+    {
+        size_t len = LENS[i_len];
+        str1[len] = '\0';
+        str2[len] = '\0';
+        size_t num_reps = TOTAL_BYTES/len;
+        volatile int sink = 0;
+        uint64_t t_start_ns = nanos();
+        for (size_t i = 0; i < num_reps; i++)
+        {
+            sink += func(str1, str2, len + 1);
+        }
+        uint64_t t_elapsed_ns = nanos() - t_start_ns;
+        str1[len] = 'a' + len % 26;
+        str2[len] = 'A' + len % 26;
+        (void)sink;
+        printf("  %9.2f", (double)(len*num_reps)/t_elapsed_ns);
+    }
+    printf("\n");
+}
+
+int main()
+{
+    printf("-----------------------\n"
+           "String Comparison Tests\n"
+           "-----------------------\n\n");
+
+    int num_failures_expected = 0;
+
+    printf("INTENTIONAL UNIT TEST FAILURE to show what a unit test failure looks like!\n");
+    EXPECT_EQUALS(strncmpci("hey", "HEY", 3), 'h' - 'H');
+    num_failures_expected++;
+    printf("------ beginning ------\n\n");
+
+
+    typedef struct strncmpci_impl_s
+    {
+        const char * name;
+        strncmpci_func_t func;
+        bool supported;
+    } strncmpci_impl_t;
+#if STRNCMPCI_X86
+    __builtin_cpu_init();
+#endif
+    const strncmpci_impl_t IMPLS[] =
+    {
+        {"strncmpci", strncmpci, true},
+        {"strncmpci2", strncmpci2, true},
+#if STRNCMPCI_X86
+        {"strncmpci_sse2", strncmpci_sse2, true},
+        {"strncmpci_avx2", strncmpci_avx2, __builtin_cpu_supports("avx2")},
+#endif
+        {"strncmpci_fast", strncmpci_fast, true},
+        // The C library's (POSIX) version, for comparison in the benchmark only
+        {"strncasecmp", strncasecmp, false},
+    };
+    const size_t NUM_IMPLS = sizeof(IMPLS)/sizeof(IMPLS[0]);
+
+    for (size_t i = 0; i < NUM_IMPLS; i++)
+    {
+        if (IMPLS[i].supported)
+        {
+            printf("Testing %s()...\n", IMPLS[i].name);
+            test_strncmpci_func(IMPLS[i].func);
+            if (IMPLS[i].func != strncmpci)
+            {
+                test_strncmpci_func_random(IMPLS[i].func);
+            }
+        }
+    }
+    printf("\n");
+
+    printf("Speed, in bytes/ns, for strings of each length which differ only in case:\n");
+    printf("  %-18s  %9s  %9s  %9s  %9s  %9s  %9s\n", "string length:", "8", "16", "32", "64",
+        "256", "4096");
+    for (size_t i = 0; i < NUM_IMPLS; i++)
+    {
+        if (IMPLS[i].supported || IMPLS[i].func == strncasecmp)
+        {
+            benchmark_strncmpci_func(IMPLS[i].name, IMPLS[i].func);
+        }
+    }
+    printf("\n");
 
 
     if (globals.error_count == num_failures_expected)
@@ -395,22 +788,34 @@ int main()
 /*
 Sample output:
 
-    $ gcc -Wall -Wextra -Werror -ggdb -std=c11 -o ./bin/tmp strncmpci.c && ./bin/tmp
+    $ gcc -Wall -Wextra -Werror -ggdb -O3 -std=c11 -o ./bin/tmp strncmpci.c && ./bin/tmp
     -----------------------
     String Comparison Tests
     -----------------------
 
     INTENTIONAL UNIT TEST FAILURE to show what a unit test failure looks like!
-    FAILED at line 191 in function main! strncmpci("hey", "HEY", 3) != 'h' - 'H'
+    FAILED at line 715 in function main! strncmpci("hey", "HEY", 3) != 'h' - 'H'
       a: strncmpci("hey", "HEY", 3) is 0
       b: 'h' - 'H' is 32
 
     ------ beginning ------
 
+    Testing strncmpci()...
+    Testing strncmpci2()...
+    Testing strncmpci_sse2()...
+    Testing strncmpci_avx2()...
+    Testing strncmpci_fast()...
+
+    Speed, in bytes/ns, for strings of each length which differ only in case:
+      string length:              8         16         32         64        256       4096
+      strncmpci                0.26       0.25       0.24       0.27       0.27       0.30
+      strncmpci2               0.27       0.27       0.30       0.27       0.30       0.30
+      strncmpci_sse2           0.59       0.83       1.33       2.10       4.07       5.10
+      strncmpci_avx2           0.48       1.01       2.39       3.89       8.98      10.73
+      strncmpci_fast           0.65       0.94       1.58       3.05       6.75       8.50
+      strncasecmp              0.96       1.99       3.55       5.93       8.48      16.52
+
     All unit tests passed!
 
 
 */
-
-
-
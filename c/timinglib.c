@@ -32,6 +32,15 @@ References:
 /// `CLOCK_MONOTONIC_RAW` clock over the `CLOCK_MONOTONIC` clock.
 #define CLOCK_TYPE CLOCK_MONOTONIC
 
+/// How long to spend calibrating the TSC against `CLOCK_MONOTONIC` in `timinglib_init()`. Longer
+/// calibration times produce a more-accurate TSC frequency estimate, and hence less drift. 50 ms
+/// gives a frequency error of well under 1 ppm on my system.
+#define TSC_CALIBRATION_TIME_MS 50
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define TSC_SUPPORTED
+#endif
+
 #ifdef USE_CLOCK_GETTIME
     // This line **must** come **before** including <time.h> in order to bring in
     // the POSIX functions such as `clock_gettime()`, `nanosleep()`, etc., from
@@ -43,23 +52,223 @@ References:
     #define GET_TIME(timespec_ptr) timespec_get((timespec_ptr), TIME_UTC)
 #endif
 
+// Required for `pthread_setaffinity_np()`, `CPU_SET()`, and `sched_getcpu()`. See:
+// https://man7.org/linux/man-pages/man3/pthread_setaffinity_np.3.html
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
 // Local includes
 #include "timinglib.h"
 
 // Linux includes
+#include <alloca.h>    // `alloca()`
+#include <malloc.h>    // `mallopt()`
 #include <pthread.h>
-#include <sys/mman.h> // `mlockall()` https://man7.org/linux/man-pages/man2/mlock.2.html
+#include <sched.h>     // `SCHED_RR`, `cpu_set_t`, `sched_getcpu()`
+#include <sys/mman.h>  // `mlockall()` https://man7.org/linux/man-pages/man2/mlock.2.html
+#include <sys/prctl.h> // `prctl()` https://man7.org/linux/man-pages/man2/prctl.2.html
+#include <sys/syscall.h> // `SYS_prctl`
+#include <unistd.h>    // `sysconf()`, `syscall()`
 
 // C includes
 #include <errno.h>  // `errno`
 #include <stdint.h> // `UINT64_MAX`
 #include <stdio.h>  // `printf()`
+#include <stdlib.h> // `malloc()`, `free()`
 #include <string.h> // `strerror(errno)`
 #include <time.h>   // `clock_gettime()` and `timespec_get()`
 
+#ifdef TSC_SUPPORTED
+    #include <cpuid.h>      // `__get_cpuid()`
+    #include <x86intrin.h>  // `__rdtsc()`, `_mm_pause()`
+#endif
+
+/// Tell the CPU we are in a spin-wait loop, to reduce its power usage and to avoid a pipeline flush
+/// when the loop exits. See: https://www.felixcloutier.com/x86/pause
+#if defined(TSC_SUPPORTED)
+    #define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+    #define CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define CPU_RELAX()
+#endif
+
+
+/// The time source currently backing `millis()`, `micros()`, and `nanos()`.
+static timinglib_clock_source_t clock_source = TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME;
+
+/// TSC calibration data. A timestamp in ns is obtained from a TSC reading as follows:
+/// `ns = base_ns + (((tsc - base_ticks) * mult) >> TSC_MULT_SHIFT)`
+/// - `mult` is the number of nanoseconds per TSC tick, as a fixed-point number with
+///   `TSC_MULT_SHIFT` fractional bits, so that no division is needed per timestamp.
+#define TSC_MULT_SHIFT 32
+static struct
+{
+    uint64_t base_ticks;
+    uint64_t base_ns;
+    uint64_t mult;
+    uint64_t frequency_hz;
+} tsc_calibration;
+
+static inline uint64_t timespec_to_ns(const struct timespec* ts)
+{
+    return SEC_TO_NS((uint64_t)ts->tv_sec) + (uint64_t)ts->tv_nsec;
+}
+
+static inline uint64_t read_tsc()
+{
+#ifdef TSC_SUPPORTED
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+bool timinglib_tsc_is_available()
+{
+#ifdef TSC_SUPPORTED
+    unsigned int eax, ebx, ecx, edx;
+    // Make sure the extended CPUID leaf exists before reading it.
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+    {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    // The invariant TSC bit, which Linux reports as "constant_tsc" + "nonstop_tsc".
+    return (edx & (1U << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+/// Take a simultaneous reading of the TSC and `CLOCK_TYPE`. The TSC is read on both sides of
+/// the `clock_gettime()` call and the midpoint is used, and the reading with the smallest
+/// bracketing window out of several attempts is kept, to minimize the error due to the call itself
+/// and to any interrupts or preemption.
+static void read_tsc_and_monotonic(uint64_t* ticks, uint64_t* ns)
+{
+    uint64_t best_window = UINT64_MAX;
+    for (size_t i = 0; i < 10; i++)
+    {
+        struct timespec ts;
+        uint64_t t1 = read_tsc();
+        clock_gettime(CLOCK_TYPE, &ts);
+        uint64_t t2 = read_tsc();
+
+        if (t2 - t1 < best_window)
+        {
+            best_window = t2 - t1;
+            *ticks = t1 + (t2 - t1)/2;
+            *ns = timespec_to_ns(&ts);
+        }
+    }
+}
+
+/// Calibrate the TSC against `CLOCK_TYPE` (`CLOCK_MONOTONIC`), so that TSC timestamps share the
+/// same epoch and can still be passed to `clock_nanosleep()`. Return true if successful.
+static bool calibrate_tsc()
+{
+    uint64_t ticks_start = 0, ns_start = 0;
+    uint64_t ticks_end = 0, ns_end = 0;
+
+    read_tsc_and_monotonic(&ticks_start, &ns_start);
+    sleep_ms(TSC_CALIBRATION_TIME_MS);
+    read_tsc_and_monotonic(&ticks_end, &ns_end);
+
+    uint64_t d_ticks = ticks_end - ticks_start;
+    uint64_t d_ns = ns_end - ns_start;
+    if (d_ticks == 0 || d_ns == 0)
+    {
+        return false;
+    }
+
+    tsc_calibration.base_ticks = ticks_end;
+    tsc_calibration.base_ns = ns_end;
+    tsc_calibration.mult = (uint64_t)(((unsigned __int128)d_ns << TSC_MULT_SHIFT) / d_ticks);
+    tsc_calibration.frequency_hz = (uint64_t)((unsigned __int128)d_ticks * NS_PER_SEC / d_ns);
+    return true;
+}
+
+timinglib_clock_source_t timinglib_init(timinglib_clock_source_t requested_source)
+{
+    clock_source = TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME;
+
+    if (requested_source == TIMINGLIB_CLOCK_SOURCE_TSC)
+    {
+        if (!timinglib_tsc_is_available())
+        {
+            printf("WARNING: no invariant TSC on this CPU; falling back to `clock_gettime()`.\n");
+        }
+        else if (!calibrate_tsc())
+        {
+            printf("WARNING: TSC calibration failed; falling back to `clock_gettime()`.\n");
+        }
+        else
+        {
+            clock_source = TIMINGLIB_CLOCK_SOURCE_TSC;
+        }
+    }
+
+    return clock_source;
+}
+
+timinglib_clock_source_t timinglib_get_clock_source()
+{
+    return clock_source;
+}
+
+const char* timinglib_clock_source_get_name(timinglib_clock_source_t source)
+{
+    const char* name = "UNKNOWN";
+
+    switch (source)
+    {
+    case TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME:
+        name = "clock_gettime";
+        break;
+    case TIMINGLIB_CLOCK_SOURCE_TSC:
+        name = "TSC";
+        break;
+    }
+
+    return name;
+}
+
+uint64_t timinglib_get_tsc_frequency_hz()
+{
+    return tsc_calibration.frequency_hz;
+}
+
+uint64_t nanos_clock_gettime()
+{
+    struct timespec ts;
+    GET_TIME(&ts);
+    return timespec_to_ns(&ts);
+}
+
+uint64_t nanos_tsc()
+{
+    if (tsc_calibration.mult == 0)
+    {
+        return 0;
+    }
+
+    // Note: the delta ticks are signed since another core's TSC may read very slightly behind the
+    // core which did the calibration.
+    int64_t d_ticks = (int64_t)(read_tsc() - tsc_calibration.base_ticks);
+    int64_t d_ns = (int64_t)(((__int128)d_ticks * tsc_calibration.mult) >> TSC_MULT_SHIFT);
+    return tsc_calibration.base_ns + (uint64_t)d_ns;
+}
+
 
 uint64_t millis()
 {
+    if (clock_source == TIMINGLIB_CLOCK_SOURCE_TSC)
+    {
+        return NS_TO_MS(nanos_tsc());
+    }
+
     struct timespec ts;
     GET_TIME(&ts);
     uint64_t ms = SEC_TO_MS((uint64_t)ts.tv_sec) + NS_TO_MS((uint64_t)ts.tv_nsec);
@@ -68,6 +277,11 @@ uint64_t millis()
 
 uint64_t micros()
 {
+    if (clock_source == TIMINGLIB_CLOCK_SOURCE_TSC)
+    {
+        return NS_TO_US(nanos_tsc());
+    }
+
     struct timespec ts;
     GET_TIME(&ts);
     uint64_t us = SEC_TO_US((uint64_t)ts.tv_sec) + NS_TO_US((uint64_t)ts.tv_nsec);
@@ -76,6 +290,11 @@ uint64_t micros()
 
 uint64_t nanos()
 {
+    if (clock_source == TIMINGLIB_CLOCK_SOURCE_TSC)
+    {
+        return nanos_tsc();
+    }
+
     struct timespec ts;
     GET_TIME(&ts);
     uint64_t ns = SEC_TO_NS((uint64_t)ts.tv_sec) + (uint64_t)ts.tv_nsec;
@@ -276,55 +495,480 @@ void sleep_until_ns(uint64_t * previous_wake_time_ns, uint64_t period_ns)
     }
 }
 
-// NB: for implementation details, see my examples inside the `set_scheduler()` func
-// in "sleep_nanosleep_minimum_time_interval.c"
-void use_realtime_scheduler()
+void sleep_until_hybrid_init(sleep_until_hybrid_t* hybrid, uint64_t initial_guard_band_ns,
+    bool adaptive)
 {
-    int retcode;
+    if (hybrid == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
 
-    pthread_t this_thread = pthread_self();
-    const struct sched_param priority_param =
+    hybrid->guard_band_ns = initial_guard_band_ns;
+    hybrid->guard_band_min_ns = SLEEP_UNTIL_HYBRID_GUARD_BAND_MIN_NS;
+    hybrid->guard_band_max_ns = SLEEP_UNTIL_HYBRID_GUARD_BAND_MAX_NS;
+    hybrid->adaptive = adaptive;
+    hybrid->oversleep_estimate_ns = 0;
+    hybrid->missed_guard_band_cnt = 0;
+}
+
+/// Update the guard band from the oversleep measured in the latest cycle.
+static void sleep_until_hybrid_adapt(sleep_until_hybrid_t* hybrid, uint64_t oversleep_ns)
+{
+    // Decaying maximum: jump up immediately on a large oversleep, but decay slowly (by 1/64 per
+    // cycle) so that a single lucky cycle doesn't shrink the guard band.
+    uint64_t decayed_estimate_ns = hybrid->oversleep_estimate_ns - hybrid->oversleep_estimate_ns/64;
+    hybrid->oversleep_estimate_ns =
+        oversleep_ns > decayed_estimate_ns ? oversleep_ns : decayed_estimate_ns;
+
+    // Add a 25% safety margin.
+    uint64_t guard_band_ns = hybrid->oversleep_estimate_ns + hybrid->oversleep_estimate_ns/4;
+    if (guard_band_ns < hybrid->guard_band_min_ns)
+    {
+        guard_band_ns = hybrid->guard_band_min_ns;
+    }
+    else if (guard_band_ns > hybrid->guard_band_max_ns)
+    {
+        guard_band_ns = hybrid->guard_band_max_ns;
+    }
+    hybrid->guard_band_ns = guard_band_ns;
+}
+
+void sleep_until_ns_hybrid(sleep_until_hybrid_t* hybrid, uint64_t * previous_wake_time_ns,
+    uint64_t period_ns)
+{
+    if (hybrid == NULL || previous_wake_time_ns == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    uint64_t time_wakeup_ns = *previous_wake_time_ns + period_ns;
+    *previous_wake_time_ns = time_wakeup_ns; // update the user's input variable
+
+    // 1. Sleep until the start of the guard band, if it hasn't already been reached.
+    uint64_t time_sleep_until_ns = time_wakeup_ns - hybrid->guard_band_ns;
+    if (time_wakeup_ns > hybrid->guard_band_ns && nanos() < time_sleep_until_ns)
+    {
+        const struct timespec TS_SLEEP_UNTIL =
+        {
+            .tv_sec = (__time_t)(time_sleep_until_ns / NS_PER_SEC),
+            .tv_nsec = (__syscall_slong_t)(time_sleep_until_ns % NS_PER_SEC),
+        };
+
+        int retcode = EINTR; // force to run once
+        while (retcode == EINTR)
+        {
+            retcode = clock_nanosleep(CLOCK_TYPE, TIMER_ABSTIME, &TS_SLEEP_UNTIL, NULL);
+            if (retcode != 0)
+            {
+                print_nanosleep_failed(retcode);
+            }
+        }
+
+        uint64_t time_now_ns = nanos();
+        if (time_now_ns >= time_wakeup_ns)
+        {
+            hybrid->missed_guard_band_cnt++;
+        }
+        if (hybrid->adaptive)
+        {
+            uint64_t oversleep_ns =
+                time_now_ns > time_sleep_until_ns ? time_now_ns - time_sleep_until_ns : 0;
+            sleep_until_hybrid_adapt(hybrid, oversleep_ns);
+        }
+    }
+
+    // 2. Spin for the rest of the time.
+    while (nanos() < time_wakeup_ns)
+    {
+        CPU_RELAX();
+    }
+}
+
+void latency_histogram_init(latency_histogram_t* hist)
+{
+    if (hist == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    memset(hist, 0, sizeof(*hist));
+    hist->min_ns = UINT64_MAX;
+}
+
+/// Get the index of the bucket into which `value_ns` is recorded.
+static inline size_t latency_histogram_get_bucket_index(uint64_t value_ns)
+{
+    if (value_ns < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return (size_t)value_ns;
+    }
+
+    // Index of the most-significant set bit; >= `LATENCY_HISTOGRAM_SUB_BUCKET_BITS` here
+    unsigned int msb = 63 - (unsigned int)__builtin_clzll(value_ns);
+    unsigned int shift = msb - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+    // `value_ns >> shift` is in the range [SUB_BUCKET_COUNT, 2*SUB_BUCKET_COUNT)
+    size_t sub_bucket = (size_t)(value_ns >> shift) - LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+    return (size_t)(shift + 1)*LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + sub_bucket;
+}
+
+/// Get the largest value which is recorded into bucket `index`. This is the inverse of
+/// `latency_histogram_get_bucket_index()`.
+static inline uint64_t latency_histogram_get_bucket_upper_bound(size_t index)
+{
+    if (index < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return (uint64_t)index;
+    }
+
+    unsigned int shift = (unsigned int)(index/LATENCY_HISTOGRAM_SUB_BUCKET_COUNT) - 1;
+    uint64_t sub_bucket = index % LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+    uint64_t lower_bound = (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + sub_bucket) << shift;
+    return lower_bound + ((UINT64_C(1) << shift) - 1);
+}
+
+void latency_histogram_record(latency_histogram_t* hist, uint64_t value_ns)
+{
+    // Note: no NULL ptr check here, since this is called in the timing-critical path.
+    hist->counts[latency_histogram_get_bucket_index(value_ns)]++;
+    hist->total_count++;
+    hist->sum_ns += value_ns;
+
+    if (value_ns < hist->min_ns)
+    {
+        hist->min_ns = value_ns;
+    }
+
+    if (value_ns > hist->max_ns)
+    {
+        hist->max_ns = value_ns;
+    }
+}
+
+void latency_histogram_merge(latency_histogram_t* dest, const latency_histogram_t* src)
+{
+    if (dest == NULL || src == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    for (size_t i = 0; i < ARRAY_LEN(dest->counts); i++)
+    {
+        dest->counts[i] += src->counts[i];
+    }
+    dest->total_count += src->total_count;
+    dest->sum_ns += src->sum_ns;
+
+    if (src->min_ns < dest->min_ns)
+    {
+        dest->min_ns = src->min_ns;
+    }
+
+    if (src->max_ns > dest->max_ns)
+    {
+        dest->max_ns = src->max_ns;
+    }
+}
+
+uint64_t latency_histogram_get_percentile(const latency_histogram_t* hist, double percentile)
+{
+    if (hist == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return 0;
+    }
+
+    if (hist->total_count == 0)
+    {
+        return 0;
+    }
+
+    if (percentile < 0.0)
+    {
+        percentile = 0.0;
+    }
+    else if (percentile > 100.0)
+    {
+        percentile = 100.0;
+    }
+
+    // The number of values which must be at or below the returned value; at least 1.
+    uint64_t target_count = (uint64_t)(percentile/100.0*(double)hist->total_count + 0.5);
+    if (target_count == 0)
+    {
+        target_count = 1;
+    }
+
+    uint64_t cumulative_count = 0;
+    for (size_t i = 0; i < ARRAY_LEN(hist->counts); i++)
+    {
+        cumulative_count += hist->counts[i];
+        if (cumulative_count >= target_count)
+        {
+            uint64_t value_ns = latency_histogram_get_bucket_upper_bound(i);
+            return value_ns < hist->max_ns ? value_ns : hist->max_ns;
+        }
+    }
+
+    return hist->max_ns;
+}
+
+void latency_histogram_print(const latency_histogram_t* hist, const char* name)
+{
+    if (hist == NULL || name == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    printf("%s:\n", name);
+    if (hist->total_count == 0)
+    {
+        printf("  (no values recorded)\n");
+        return;
+    }
+
+    printf("  count = %lu\n", hist->total_count);
+    printf("  min   = %12lu ns\n", hist->min_ns);
+    printf("  p50   = %12lu ns\n", latency_histogram_get_percentile(hist, 50.0));
+    printf("  p90   = %12lu ns\n", latency_histogram_get_percentile(hist, 90.0));
+    printf("  p99   = %12lu ns\n", latency_histogram_get_percentile(hist, 99.0));
+    printf("  p99.9 = %12lu ns\n", latency_histogram_get_percentile(hist, 99.9));
+    printf("  max   = %12lu ns\n", hist->max_ns);
+}
+
+/// Print the standard hint for errors caused by not running as root.
+static void print_permissions_hint(int error_code)
+{
+    if (error_code == EPERM)  // Error: Permissions
+    {
+        printf("  You must use `sudo` or run this program as root to "
+               "have proper privileges!\n");
+    }
+}
+
+/// Touch `size` bytes of the calling thread's stack so that those pages are already mapped (and,
+/// after `mlockall()`, locked) before any time-critical code runs.
+/// - `noinline` so that the stack space used here is actually below the caller's stack frame.
+__attribute__((noinline)) static void prefault_stack(size_t size)
+{
+    volatile uint8_t* stack_bytes = (volatile uint8_t*)alloca(size);
+    const long PAGE_SIZE_BYTES = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < size; i += (size_t)PAGE_SIZE_BYTES)
     {
-        // the priority must be from 1 (lowest priority) to 99
-        // (highest priority) for the `SCHED_FIFO` AND `SCHED_RR`
-        // (round robin) scheduler policies; see:
-        // https://man7.org/linux/man-pages/man7/sched.7.html
+        stack_bytes[i] = 0;
+    }
+}
+
+/// Touch `size` bytes of heap, and keep them in the process for future `malloc()` calls. Return
+/// true if successful.
+static bool prefault_heap(size_t size)
+{
+    // Don't give freed memory back to the OS, and don't use `mmap()` for large allocations, since
+    // `mmap()`ed memory is unmapped again when freed. See:
+    // https://man7.org/linux/man-pages/man3/mallopt.3.html
+    if (mallopt(M_TRIM_THRESHOLD, -1) == 0 || mallopt(M_MMAP_MAX, 0) == 0)
+    {
+        printf("ERROR: in file %s: %i: `mallopt()` failed.\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    uint8_t* heap_bytes = (uint8_t*)malloc(size);
+    if (heap_bytes == NULL)
+    {
+        printf("ERROR: in file %s: %i: out of memory.\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    const long PAGE_SIZE_BYTES = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < size; i += (size_t)PAGE_SIZE_BYTES)
+    {
+        ((volatile uint8_t*)heap_bytes)[i] = 0;
+    }
+    free(heap_bytes);
+
+    return true;
+}
+
+realtime_config_t realtime_config_get_default()
+{
+    realtime_config_t config =
+    {
+        .sched_policy = SCHED_RR,
         .sched_priority = REALTIME_SCHEDULER_PRIORITY_LOWEST,
+        .cpu = -1,
+        .lock_memory = true,
+        .prefault_stack_size = 0,
+        .prefault_heap_size = 0,
+        .timer_slack_ns = 0,
     };
-    retcode = pthread_setschedparam(this_thread, SCHED_RR, &priority_param);
-    if (retcode != 0)
+    return config;
+}
+
+realtime_status_t realtime_setup(const realtime_config_t* config)
+{
+    realtime_status_t status;
+    memset(&status, 0, sizeof(status));
+
+    if (config == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return status;
+    }
+
+    int retcode;
+    pthread_t this_thread = pthread_self();
+
+    // 1. Scheduler policy and priority
+    if (config->sched_policy != -1)
     {
-        printf("ERROR: in file %s: %i: Failed to set pthread scheduler. "
-               "retcode = %i: %s.\n",
-                __FILE__, __LINE__, retcode, strerror(retcode));
-        if (retcode == EPERM)  // Error: Permissions
+        const struct sched_param priority_param =
         {
-            printf("  You must use `sudo` or run this program as root to "
-                   "have proper privileges!\n");
+            // the priority must be from 1 (lowest priority) to 99
+            // (highest priority) for the `SCHED_FIFO` AND `SCHED_RR`
+            // (round robin) scheduler policies; see:
+            // https://man7.org/linux/man-pages/man7/sched.7.html
+            .sched_priority = config->sched_priority,
+        };
+        retcode = pthread_setschedparam(this_thread, config->sched_policy, &priority_param);
+        if (retcode != 0)
+        {
+            printf("ERROR: in file %s: %i: Failed to set pthread scheduler. "
+                   "retcode = %i: %s.\n",
+                    __FILE__, __LINE__, retcode, strerror(retcode));
+            print_permissions_hint(retcode);
+        }
+        else
+        {
+            status.sched_set = true;
         }
     }
-    else
+
+    // 2. CPU affinity: pin this thread to one core so that it never migrates, keeping its caches
+    // warm. See: https://man7.org/linux/man-pages/man3/pthread_setaffinity_np.3.html
+    if (config->cpu >= 0)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(config->cpu, &cpu_set);
+        retcode = pthread_setaffinity_np(this_thread, sizeof(cpu_set), &cpu_set);
+        if (retcode != 0)
+        {
+            printf("ERROR: in file %s: %i: Failed to set CPU affinity to CPU %i. "
+                   "retcode = %i: %s.\n",
+                    __FILE__, __LINE__, config->cpu, retcode, strerror(retcode));
+        }
+        else
+        {
+            status.cpu_affinity_set = true;
+        }
+    }
+
+    // 3. Memory lock: lock the memory into RAM to prevent slow operations
+    // where the kernel puts it into swap space. With `MCL_ONFAULT`, pages are
+    // locked as they are first touched, which is what the prefaulting below
+    // is for.
+    if (config->lock_memory)
     {
-        // printf("`pthread_setschedparam()` successful.\n");
+        retcode = mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT);
+        if (retcode == -1)
+        {
+            int error_code = errno;
+            printf("ERROR: in file %s: %i: Failed to lock memory into RAM. "
+                   "errno = %i: %s.\n",
+                __FILE__, __LINE__, error_code, strerror(error_code));
+            print_permissions_hint(error_code);
+        }
+        else
+        {
+            status.memory_locked = true;
+        }
     }
 
-    // Memory lock: also lock the memory into RAM to prevent slow operations
-    // where the kernel puts it into swap space. See notes above.
-    retcode = mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT);
-    if (retcode == -1)
+    // 4. Prefault the stack and the heap, to avoid page faults later.
+    if (config->prefault_stack_size > 0)
     {
-        printf("ERROR: in file %s: %i: Failed to lock memory into RAM. "
-               "errno = %i: %s.\n",
-            __FILE__, __LINE__, errno, strerror(errno));
-        if (errno == EPERM)  // Error: Permissions
+        prefault_stack(config->prefault_stack_size);
+        status.stack_prefaulted = true;
+    }
+
+    if (config->prefault_heap_size > 0)
+    {
+        status.heap_prefaulted = prefault_heap(config->prefault_heap_size);
+    }
+
+    // 5. Timer slack: by how much the kernel may delay our timer wake-ups in order to group them
+    // with other wake-ups. See: https://man7.org/linux/man-pages/man2/prctl.2.html
+    if (config->timer_slack_ns > 0)
+    {
+        retcode = prctl(PR_SET_TIMERSLACK, (unsigned long)config->timer_slack_ns, 0, 0, 0);
+        if (retcode == -1)
+        {
+            printf("ERROR: in file %s: %i: Failed to set timer slack. "
+                   "errno = %i: %s.\n",
+                __FILE__, __LINE__, errno, strerror(errno));
+        }
+        else
         {
-            printf("  You must use `sudo` or run this program as root to "
-                   "have proper privileges!\n");
+            status.timer_slack_set = true;
         }
     }
-    else
+
+    // Read back what is actually in effect now.
+    struct sched_param priority_param;
+    retcode = pthread_getschedparam(this_thread, &status.sched_policy, &priority_param);
+    status.sched_priority = retcode == 0 ? priority_param.sched_priority : -1;
+    status.cpu = sched_getcpu();
+    // `PR_GET_TIMERSLACK` returns the slack itself, as a `long`, but the glibc `prctl()` wrapper
+    // returns an `int`, which would cut off slack values above `INT_MAX` (~2.1 sec). So call the
+    // syscall directly, to get the whole `long`.
+    long timer_slack_ns = syscall(SYS_prctl, PR_GET_TIMERSLACK, 0, 0, 0, 0);
+    status.timer_slack_ns = timer_slack_ns == -1 ? 0 : (uint64_t)(unsigned long)timer_slack_ns;
+
+    return status;
+}
+
+void realtime_status_print(const realtime_status_t* status)
+{
+    if (status == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    const char* policy_name = "OTHER";
+    switch (status->sched_policy)
     {
-        // printf("`mlockall()` successful.\n");
+    case SCHED_FIFO:
+        policy_name = "SCHED_FIFO";
+        break;
+    case SCHED_RR:
+        policy_name = "SCHED_RR";
+        break;
+    case SCHED_OTHER:
+        policy_name = "SCHED_OTHER";
+        break;
     }
 
+    printf("Real-time setup status:\n");
+    printf("  scheduler set       = %s (now: %s, priority %i)\n",
+        status->sched_set ? "yes" : "no", policy_name, status->sched_priority);
+    printf("  CPU affinity set    = %s (now running on CPU %i)\n",
+        status->cpu_affinity_set ? "yes" : "no", status->cpu);
+    printf("  memory locked       = %s\n", status->memory_locked ? "yes" : "no");
+    printf("  stack prefaulted    = %s\n", status->stack_prefaulted ? "yes" : "no");
+    printf("  heap prefaulted     = %s\n", status->heap_prefaulted ? "yes" : "no");
+    printf("  timer slack set     = %s (now: %lu ns)\n",
+        status->timer_slack_set ? "yes" : "no", status->timer_slack_ns);
+}
+
+// NB: for implementation details, see my examples inside the `set_scheduler()` func
+// in "sleep_nanosleep_minimum_time_interval.c"
+void use_realtime_scheduler()
+{
+    realtime_config_t config = realtime_config_get_default();
+    realtime_setup(&config);
 }
@@ -7,6 +7,12 @@ TODO: add:
 1. [x] sleep_ms(), sleep_us(), sleep_ns()
 1. [x] sleep_until_ms(), sleep_until_us(), sleep_until_ns()
     1. Similar to: https://www.freertos.org/vtaskdelayuntil.html
+1. [x] an optional calibrated invariant-TSC (`rdtsc`) time source for `nanos()`, `micros()`, and
+   `millis()`, selected at init time via `timinglib_init()`
+1. [x] a fixed-memory, log-bucketed latency histogram to measure jitter percentiles
+1. [x] a hybrid sleep-then-spin `sleep_until_ns_hybrid()` for us-level accuracy without root
+1. [x] a configurable real-time setup, `realtime_setup()`: scheduler policy and priority, CPU
+   affinity, memory locking, stack and heap prefaulting, and timer slack
 
 STATUS: works!
 
@@ -34,6 +40,8 @@ scheduler:
 #pragma once
 
 #include <assert.h>
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stddef.h>  // For `size_t`
 #include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
 
 
@@ -102,6 +110,58 @@ uint64_t get_estimated_resolution();
 uint64_t get_specified_resolution();
 
 
+// Time sources
+//
+// By default, all of the timestamp functions above use `clock_gettime()` (see `CLOCK_TYPE` in the
+// .c file). Optionally, call `timinglib_init(TIMINGLIB_CLOCK_SOURCE_TSC)` once at the start of your
+// program, before spawning any threads, to back them instead with the x86 invariant Time Stamp
+// Counter (TSC), read directly via the `rdtsc` instruction and calibrated once against
+// `CLOCK_MONOTONIC`. This avoids the vDSO `clock_gettime()` call and the `timespec` math on every
+// timestamp. If the CPU does not have an invariant ("constant_tsc" and "nonstop_tsc" in
+// `/proc/cpuinfo`) TSC, or this is not an x86 system, `timinglib_init()` automatically falls back to
+// `clock_gettime()`.
+// - Run "timinglib_timestamps_rapid.c" with the `benchmark` argument to compare the per-call cost
+//   and drift of each time source on your system.
+
+/// The time sources which can back the `millis()`, `micros()`, and `nanos()` timestamps.
+typedef enum timinglib_clock_source_e
+{
+    /// `clock_gettime(CLOCK_TYPE, ...)`; this is the default
+    TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME = 0,
+    /// The x86 invariant Time Stamp Counter, calibrated against `CLOCK_MONOTONIC`
+    TIMINGLIB_CLOCK_SOURCE_TSC,
+} timinglib_clock_source_t;
+
+/// Select the time source for all timestamps, and calibrate it if necessary. The calibration of the
+/// TSC takes ~`TSC_CALIBRATION_TIME_MS` milliseconds (see the .c file).
+/// - Returns the time source actually in use, which will be
+///   `TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME` if the requested source is not available.
+/// - This function is NOT thread-safe. Call it once at startup before any other threads are
+///   taking timestamps.
+timinglib_clock_source_t timinglib_init(timinglib_clock_source_t requested_source);
+
+/// Get the time source currently in use.
+timinglib_clock_source_t timinglib_get_clock_source();
+
+/// Get a human-readable name for a time source.
+const char* timinglib_clock_source_get_name(timinglib_clock_source_t source);
+
+/// Return true if this CPU has an invariant TSC which runs at a constant rate in all power
+/// states, and can therefore be used as a time source.
+bool timinglib_tsc_is_available();
+
+/// Get the calibrated TSC frequency, in Hz, or 0 if the TSC has not been calibrated.
+uint64_t timinglib_get_tsc_frequency_hz();
+
+/// Get a monotonic time stamp in nanoseconds from `clock_gettime()`, regardless of the time source
+/// selected via `timinglib_init()`.
+uint64_t nanos_clock_gettime();
+
+/// Get a monotonic time stamp in nanoseconds from the calibrated TSC, regardless of the time source
+/// selected via `timinglib_init()`. Returns 0 if the TSC has not been calibrated.
+uint64_t nanos_tsc();
+
+
 /// Sleep for `sleep_time_ms` milliseconds.
 /// - Testing on my x86-64 Linux Ubuntu system via "sleep_nanosleep_minimum_time_interval.c"
 ///   shows that my system has a minimum sleep resolution of ~55000 ns (< 1 ms), so any ms sleep
@@ -170,6 +230,128 @@ void sleep_until_us(uint64_t * previous_wake_time_us, uint64_t period_us);
 void sleep_until_ns(uint64_t * previous_wake_time_ns, uint64_t period_ns);
 
 
+// Hybrid sleep-then-spin "sleep until"
+//
+// Under the default `SCHED_OTHER` scheduler, `clock_nanosleep()` wakes up ~55 us late on average,
+// and much later in the worst case, and `use_realtime_scheduler()` requires root. So, for precise
+// wake-ups without root, `sleep_until_ns_hybrid()` instead sleeps with `clock_nanosleep()` only
+// until a "guard band" before the deadline, then busy-polls `nanos()`, with a CPU "pause"
+// instruction between polls, for the remainder of the time. This trades some CPU usage for
+// accuracy: the CPU is busy for about `guard_band_ns` per cycle.
+// - When `adaptive` is true, the guard band adapts automatically to this system: it tracks a
+//   slowly-decaying maximum of the wake-up error (oversleep) of `clock_nanosleep()` measured in
+//   earlier cycles, plus a safety margin, clamped to [`guard_band_min_ns`, `guard_band_max_ns`].
+// - Use one `sleep_until_hybrid_t` per periodic loop (thread).
+//
+// Example usage:
+//
+//      sleep_until_hybrid_t hybrid;
+//      sleep_until_hybrid_init(&hybrid, US_TO_NS(100), true);
+//      uint64_t last_wake_time_ns = nanos();
+//      while (true)
+//      {
+//          sleep_until_ns_hybrid(&hybrid, &last_wake_time_ns, US_TO_NS(100)); // 10 kHz
+//          // Perform whatever action you want here at this fixed interval.
+//      }
+
+/// Default limits for the adaptive guard band
+#define SLEEP_UNTIL_HYBRID_GUARD_BAND_MIN_NS US_TO_NS(5)
+#define SLEEP_UNTIL_HYBRID_GUARD_BAND_MAX_NS MS_TO_NS(2)
+
+/// State for `sleep_until_ns_hybrid()`
+typedef struct sleep_until_hybrid_s
+{
+    /// Current guard band before the deadline during which to spin rather than sleep
+    uint64_t guard_band_ns;
+    /// Limits for the guard band when adaptive
+    uint64_t guard_band_min_ns;
+    uint64_t guard_band_max_ns;
+    /// Set to true to adapt `guard_band_ns` from the measured wake-up errors
+    bool adaptive;
+    /// Decaying maximum of the measured `clock_nanosleep()` oversleep, in ns
+    uint64_t oversleep_estimate_ns;
+    /// Number of cycles in which the deadline had already passed when we woke from
+    /// `clock_nanosleep()`, meaning that the guard band was too small for that cycle
+    uint64_t missed_guard_band_cnt;
+} sleep_until_hybrid_t;
+
+/// Initialize the hybrid "sleep until" state with a starting guard band of
+/// `initial_guard_band_ns`, and the default adaptive guard band limits.
+void sleep_until_hybrid_init(sleep_until_hybrid_t* hybrid, uint64_t initial_guard_band_ns,
+    bool adaptive);
+
+/// Sleep (delay) until the absolute timestamp of `previous_wake_time_ns` + `period_ns`, in
+/// nanoseconds, has been reached, using the hybrid sleep-then-spin technique described above.
+/// - Like `sleep_until_ns()`, `previous_wake_time_ns` is an in/out parameter, and will be read and
+///   then modified by the function.
+void sleep_until_ns_hybrid(sleep_until_hybrid_t* hybrid, uint64_t * previous_wake_time_ns,
+    uint64_t period_ns);
+
+
+// Latency histograms
+//
+// To measure timing jitter, averages and min/max values aren't enough: what matters in production
+// are the tail latencies, such as the 99th and 99.9th percentiles. A `latency_histogram_t` records
+// any number of latency values, in ns, into a fixed-size array of log-bucketed counters, similar to
+// an HDR Histogram (http://hdrhistogram.org/):
+// - Values < `LATENCY_HISTOGRAM_SUB_BUCKET_COUNT` are recorded exactly. Larger values are recorded
+//   into one of `LATENCY_HISTOGRAM_SUB_BUCKET_COUNT` linear sub-buckets per power of 2, giving a
+//   worst-case relative error of 1/`LATENCY_HISTOGRAM_SUB_BUCKET_COUNT` (~3%) over the whole
+//   `uint64_t` range.
+// - Recording a value is O(1) and never allocates memory.
+// - A histogram is NOT thread-safe. Give each thread its own histogram so that recording needs no
+//   locks or atomics, then once the threads are done, combine them with `latency_histogram_merge()`.
+//
+// Example usage:
+//
+//      static latency_histogram_t hist; // ~15 KB, so keep it off the stack if needed
+//      latency_histogram_init(&hist);
+//      for (size_t i = 0; i < 1000; i++)
+//      {
+//          uint64_t t_start_ns = nanos();
+//          do_something();
+//          latency_histogram_record(&hist, nanos() - t_start_ns);
+//      }
+//      latency_histogram_print(&hist, "do_something() run time");
+
+/// log2 of the number of linear sub-buckets per power of 2
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+/// Number of linear sub-buckets per power of 2
+#define LATENCY_HISTOGRAM_SUB_BUCKET_COUNT (1U << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+/// Total number of buckets required to cover all `uint64_t` values
+#define LATENCY_HISTOGRAM_BUCKET_COUNT \
+    ((64 - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+
+typedef struct latency_histogram_s
+{
+    /// Number of values recorded into each bucket
+    uint64_t counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    /// Total number of values recorded
+    uint64_t total_count;
+    /// Exact sum, minimum, and maximum of all values recorded
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} latency_histogram_t;
+
+/// Initialize (or reset) a histogram so that it contains no values.
+void latency_histogram_init(latency_histogram_t* hist);
+
+/// Record a single latency value, in ns, into a histogram.
+void latency_histogram_record(latency_histogram_t* hist, uint64_t value_ns);
+
+/// Add all of the values recorded in histogram `src` into histogram `dest`.
+void latency_histogram_merge(latency_histogram_t* dest, const latency_histogram_t* src);
+
+/// Get the latency value, in ns, at or below which `percentile` percent (0.0 to 100.0) of all
+/// recorded values fall. The result is the upper bound of the bucket containing that percentile,
+/// but never more than the exact recorded maximum. Returns 0 if the histogram is empty.
+uint64_t latency_histogram_get_percentile(const latency_histogram_t* hist, double percentile);
+
+/// Print the count, min, p50, p90, p99, p99.9 and max of a histogram, with a `name` label.
+void latency_histogram_print(const latency_histogram_t* hist, const char* name);
+
+
 // Real-time scheduler settings
 // See `set_scheduler()` in "sleep_nanosleep_minimum_time_interval.c"
 
@@ -186,4 +368,83 @@ void sleep_until_ns(uint64_t * previous_wake_time_ns, uint64_t period_ns);
 // default minimum sleep time of ~55 us with worst-case results being ~8000 us
 // (8 ms)! Calling this function allows for much better sleep resolutions and
 // timing accuracies than the default `SCHED_OTHER` scheduler can provide!
+// - This is the same as calling `realtime_setup()` with the config from
+//   `realtime_config_get_default()`: `SCHED_RR` at the lowest priority, plus `mlockall()`.
 void use_realtime_scheduler();
+
+// Configurable real-time setup
+//
+// Beyond the scheduler itself, the main sources of jitter spikes are page faults (the first touch
+// of a stack or heap page, or a page swapped out) and the thread migrating between CPU cores.
+// `realtime_setup()` applies any combination of the following "knobs" to the calling thread (or,
+// for the memory settings, to the whole process), and reports which of them actually took effect,
+// since most of them require root.
+// - See "sleep_nanosleep_minimum_time_interval.c" (run with the `knobs` argument) to measure the
+//   effect of each knob separately.
+//
+// Example usage:
+//
+//      realtime_config_t config = realtime_config_get_default();
+//      config.cpu = 3;
+//      config.prefault_stack_size = 512*1024;
+//      config.timer_slack_ns = 1;
+//      realtime_status_t status = realtime_setup(&config);
+//      realtime_status_print(&status);
+
+/// Which real-time settings to apply in `realtime_setup()`
+typedef struct realtime_config_s
+{
+    /// Scheduler policy for the calling thread: `SCHED_RR` or `SCHED_FIFO` (from <sched.h>), or
+    /// -1 to leave the scheduler unchanged
+    int sched_policy;
+    /// Scheduler priority, from `REALTIME_SCHEDULER_PRIORITY_LOWEST` to
+    /// `REALTIME_SCHEDULER_PRIORITY_HIGHEST`
+    int sched_priority;
+    /// CPU core to pin the calling thread to, or -1 to leave the CPU affinity unchanged. Pair this
+    /// with the `isolcpus=` kernel boot parameter to keep other processes off of that core.
+    int cpu;
+    /// Set to true to lock all current and future memory pages into RAM via `mlockall()`
+    bool lock_memory;
+    /// Number of bytes of the calling thread's stack to touch now so that they are already paged
+    /// in, or 0 for none. Must be less than the thread's stack size.
+    size_t prefault_stack_size;
+    /// Number of bytes of heap to touch now, and to then keep in the process (by disabling
+    /// `malloc()` trimming and `mmap()`-based allocations), so that later `malloc()` calls of up
+    /// to about this size don't page fault. 0 for none.
+    size_t prefault_heap_size;
+    /// Timer slack for the calling thread, in ns, set via `prctl(PR_SET_TIMERSLACK)`, or 0 to
+    /// leave it unchanged. The default timer slack is 50 us for `SCHED_OTHER` threads; use 1 for
+    /// the smallest slack. It must fit in an `unsigned long`, and values from `ULONG_MAX - 4094`
+    /// up can't be read back into `realtime_status_t::timer_slack_ns`, since they look like an
+    /// error code.
+    uint64_t timer_slack_ns;
+} realtime_config_t;
+
+/// Which real-time settings actually took effect in `realtime_setup()`
+typedef struct realtime_status_s
+{
+    bool sched_set;
+    bool cpu_affinity_set;
+    bool memory_locked;
+    bool stack_prefaulted;
+    bool heap_prefaulted;
+    bool timer_slack_set;
+
+    /// The calling thread's scheduler policy, priority, CPU, and timer slack (in ns) after the setup,
+    /// read back from the system. `timer_slack_ns` is 0 if it couldn't be read.
+    int sched_policy;
+    int sched_priority;
+    int cpu;
+    uint64_t timer_slack_ns;
+} realtime_status_t;
+
+/// Get the config used by `use_realtime_scheduler()`: `SCHED_RR` at the lowest priority, and
+/// `mlockall()`, with all other knobs off.
+realtime_config_t realtime_config_get_default();
+
+/// Apply the real-time settings in `config` to the calling thread and process, printing an error
+/// for each setting which fails, and return which settings took effect.
+realtime_status_t realtime_setup(const realtime_config_t* config);
+
+/// Print which real-time settings took effect, and the resulting thread settings.
+void realtime_status_print(const realtime_status_t* status);
@@ -4,12 +4,19 @@ This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftG
 Show how to use the timinglib "sleep until" functions in a pthread (POSIX thread) thread. Let's run
 the loop really fast (ex: 100 Hz ~ 1000 Hz), and analyze the time errors!
 
+The loop is run once per "sleep mode", to compare the plain `sleep_until_ns()` against the hybrid
+sleep-then-spin `sleep_until_ns_hybrid()`. The hybrid mode is meant to give us-level accuracy even
+when NOT running as root (without `sudo`), in which case `use_realtime_scheduler()` fails and the
+default `SCHED_OTHER` scheduler is used.
+
 STATUS: works!
 
 To compile and run (assuming you've already `cd`ed into this dir):
 ```bash
 # 1. In C:
 gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_pthread_periodic_loop.c timinglib.c -o bin/a -pthread && time sudo bin/a
+# withOUT root, so with the default `SCHED_OTHER` scheduler
+gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_pthread_periodic_loop.c timinglib.c -o bin/a -pthread && time bin/a
 
 # 2. In C++
 g++ -Wall -Wextra -Werror -O3 -std=c++17 timinglib_pthread_periodic_loop.c timinglib.c -o bin/a -pthread && time sudo bin/a
@@ -39,6 +46,30 @@ References:
 
 // TODO: consider passing in the period to the `pthread_task()` function, and spawning multiple
 // threads at once.
+// - Note: to run many periodic tasks at different periods WITHOUT one thread per task, see the
+//   periodic scheduler in "timinglib_scheduler.h" and its demo in
+//   "timinglib_scheduler_many_periodic_tasks.c".
+
+/// Which timinglib function to use to wait for the next cycle
+typedef enum sleep_mode_e
+{
+    /// `sleep_until_ns()`
+    SLEEP_MODE_SLEEP_UNTIL = 0,
+    /// `sleep_until_ns_hybrid()`, with an adaptive guard band
+    SLEEP_MODE_HYBRID,
+} sleep_mode_t;
+
+/// The arguments passed to each `pthread_task()` thread.
+typedef struct pthread_task_args_s
+{
+    /// Any name, for printing
+    const char* thread_name;
+    /// How to wait for the next cycle
+    sleep_mode_t sleep_mode;
+    /// This thread's own histogram of the absolute period error (jitter), in ns. Each thread
+    /// records into its own histogram, and `main()` merges them all once the threads are done.
+    latency_histogram_t jitter_hist;
+} pthread_task_args_t;
 
 // Perform an action at the period specified below.
 // - Start `pthread_task` as its own thread, using a library such as
@@ -48,7 +79,9 @@ References:
 //   and nanosecond delays: https://stackoverflow.com/a/71790209/4561887
 void * pthread_task(void * argument)
 {
-    const char* thread_name = (const char*)argument;
+    pthread_task_args_t* args = (pthread_task_args_t*)argument;
+    const char* thread_name = args->thread_name;
+    latency_histogram_init(&args->jitter_hist);
 
     // =============================================================================================
     // SET LOOP PERIOD (FREQUENCY) HERE!
@@ -59,7 +92,10 @@ void * pthread_task(void * argument)
     const uint64_t PERIOD_US = 100;
     // =============================================================================================
     // Seed the last wake time with the current time.
-    uint64_t last_wake_time_us = micros();
+    uint64_t last_wake_time_ns = nanos();
+
+    sleep_until_hybrid_t hybrid;
+    sleep_until_hybrid_init(&hybrid, US_TO_NS(PERIOD_US)/2, true);
 
     printf("thread_name = %s\n", thread_name);
     printf("loop period = %lu ns (%lu us); freq = %.1f Hz\n",
@@ -73,7 +109,14 @@ void * pthread_task(void * argument)
     for (size_t i = 0; i < NUM_ITERATIONS; i++)
     {
         // Wait for the next cycle.
-        sleep_until_us(&last_wake_time_us, PERIOD_US);
+        if (args->sleep_mode == SLEEP_MODE_HYBRID)
+        {
+            sleep_until_ns_hybrid(&hybrid, &last_wake_time_ns, US_TO_NS(PERIOD_US));
+        }
+        else
+        {
+            sleep_until_ns(&last_wake_time_ns, US_TO_NS(PERIOD_US));
+        }
 
         // -----------------------------------------------------------------------------------------
         // Perform whatever action you want here at this fixed interval.
@@ -98,6 +141,8 @@ void * pthread_task(void * argument)
         // }
 
         time_error_sum_ns += time_period_error_ns;
+        latency_histogram_record(&args->jitter_hist, (uint64_t)(time_period_error_ns < 0 ?
+            -time_period_error_ns : time_period_error_ns));
 
         if (time_period_error_ns > time_error_max_ns)
         {
@@ -121,6 +166,11 @@ void * pthread_task(void * argument)
         time_error_min_ns, time_error_min_pct);
     printf("maximum time error per iteration = %8li     ns (%7.3f%%)\n",
         time_error_max_ns, time_error_max_pct);
+    if (args->sleep_mode == SLEEP_MODE_HYBRID)
+    {
+        printf("final hybrid guard band = %lu ns; missed guard band count = %lu\n",
+            hybrid.guard_band_ns, hybrid.missed_guard_band_cnt);
+    }
 
     return (void*)"Done!";
 }
@@ -131,25 +181,53 @@ int main()
     printf("Activating realtime scheduler.\n");
     use_realtime_scheduler();
 
-    printf("Starting pthread at fixed interval using `sleep_until_us()`.\n\n");
+    // static to keep the histograms off the stack
+    static pthread_task_args_t args_array[] =
+    {
+        {.thread_name = "sleep_until_ns() thread", .sleep_mode = SLEEP_MODE_SLEEP_UNTIL, {}},
+        {.thread_name = "sleep_until_ns_hybrid() thread", .sleep_mode = SLEEP_MODE_HYBRID, {}},
+    };
 
-    pthread_t thread;
-    const char thread_name[] = "some thread name"; // this can really be ANY argument
-    int retcode = pthread_create(&thread, NULL, pthread_task, (void*)thread_name);
-    if (retcode != 0)
+    // Run one sleep mode at a time, so that the threads don't disturb each other's timing.
+    for (size_t i = 0; i < ARRAY_LEN(args_array); i++)
     {
-        printf("Failed to create pthread. retcode = %i: %s\n", retcode, strerror(retcode));
+        printf("Starting pthread \"%s\" at a fixed interval.\n\n", args_array[i].thread_name);
+
+        pthread_t thread;
+        int retcode = pthread_create(&thread, NULL, pthread_task, (void*)&args_array[i]);
+        if (retcode != 0)
+        {
+            printf("Failed to create pthread. retcode = %i: %s\n", retcode, strerror(retcode));
+        }
+
+        const char * return_message;
+        retcode = pthread_join(thread, (void**)&return_message);
+        if (retcode != 0)
+        {
+            printf("Failed to join (terminate) pthread. retcode = %i: %s\n",
+                retcode, strerror(retcode));
+        }
+
+        printf("\nFinal message from thread = %s\n\n", return_message);
     }
 
-    const char * return_message;
-    retcode = pthread_join(thread, (void**)&return_message);
-    if (retcode != 0)
+    // Compare the jitter percentiles of each sleep mode.
+    printf("===== Sleep mode comparison =====\n");
+    for (size_t i = 0; i < ARRAY_LEN(args_array); i++)
     {
-        printf("Failed to join (terminate) pthread. retcode = %i: %s\n",
-            retcode, strerror(retcode));
+        latency_histogram_print(&args_array[i].jitter_hist, args_array[i].thread_name);
     }
 
-    printf("\nFinal message from thread = %s\n", return_message);
+    // Merge the per-thread histograms to get the jitter percentiles across all threads.
+    static latency_histogram_t jitter_hist_all_threads;
+    latency_histogram_init(&jitter_hist_all_threads);
+    for (size_t i = 0; i < ARRAY_LEN(args_array); i++)
+    {
+        latency_histogram_merge(&jitter_hist_all_threads, &args_array[i].jitter_hist);
+    }
+    printf("\n");
+    latency_histogram_print(&jitter_hist_all_threads,
+        "absolute time error per iteration (jitter) percentiles, all threads");
 
     return 0;
 }
@@ -159,6 +237,42 @@ SAMPLE OUTPUT:
 
 In C:
 
+NEWEST: comparing `sleep_until_ns()` against `sleep_until_ns_hybrid()`, run WITHOUT `sudo` (so the
+default `SCHED_OTHER` scheduler is used), on a 1-core x86-64 VM (end of the output only):
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_pthread_periodic_loop.c timinglib.c -o bin/a -pthread && time bin/a
+    ...
+    final hybrid guard band = 16292 ns; missed guard band count = 4
+
+    Final message from thread = Done!
+
+    ===== Sleep mode comparison =====
+    sleep_until_ns() thread:
+      count = 200
+      min   =            0 ns
+      p50   =          375 ns
+      p90   =        94207 ns
+      p99   =        94207 ns
+      p99.9 =      2163964 ns
+      max   =      2163964 ns
+    sleep_until_ns_hybrid() thread:
+      count = 200
+      min   =            0 ns
+      p50   =           22 ns
+      p90   =           67 ns
+      p99   =        17919 ns
+      p99.9 =        28495 ns
+      max   =        28495 ns
+
+    absolute time error per iteration (jitter) percentiles, all threads:
+      count = 400
+      min   =            0 ns
+      p50   =           45 ns
+      p90   =         9471 ns
+      p99   =        94207 ns
+      p99.9 =      2163964 ns
+      max   =      2163964 ns
+
 NEW: using the realtime scheduler!--via a call to `use_realtime_scheduler()`:
 
     eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_pthread_periodic_loop.c timinglib.c -o bin/a -pthread && time sudo bin/a
@@ -0,0 +1,476 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+*/
+
+// Local includes
+#include "timinglib_scheduler.h"
+
+// Linux includes
+#include <pthread.h>
+
+// C includes
+#include <stdio.h>  // `printf()`
+#include <stdlib.h> // `calloc()`, `free()`
+#include <string.h> // `strerror()`
+
+#define WHEEL_MASK ((uint64_t)PERIODIC_SCHEDULER_WHEEL_SIZE - 1)
+/// Number of ticks covered by one slot of the top timer wheel level. Periods and phases must be
+/// shorter than this so that a task never wraps all the way around the top level.
+#define TOP_LEVEL_SLOT_TICKS \
+    (UINT64_C(1) << (PERIODIC_SCHEDULER_WHEEL_BITS*(PERIODIC_SCHEDULER_WHEEL_LEVELS - 1)))
+
+/// A hierarchical timer wheel. Level `k` slot `s` holds the tasks whose deadline tick is in the
+/// same level `k+1` block as `current_tick`, and in slot `s` of level `k`. So, level 0 holds the
+/// tasks due within the next <= 64 ticks, level 1 those due within the next <= 64^2 ticks, etc.
+/// Only the top level may wrap around.
+typedef struct timer_wheel_s
+{
+    /// Singly-linked list of tasks in each slot
+    periodic_task_t* slots[PERIODIC_SCHEDULER_WHEEL_LEVELS][PERIODIC_SCHEDULER_WHEEL_SIZE];
+    /// Bit `s` of `occupied[k]` is set if `slots[k][s]` is non-empty
+    uint64_t occupied[PERIODIC_SCHEDULER_WHEEL_LEVELS];
+    /// The tick currently being processed, counted from `start_ns`
+    uint64_t current_tick;
+    uint64_t start_ns;
+    uint64_t tick_ns;
+} timer_wheel_t;
+
+/// One worker thread, which runs its own shard of the tasks from its own timer wheel
+typedef struct worker_s
+{
+    periodic_scheduler_t* sched;
+    timer_wheel_t wheel;
+    sleep_until_hybrid_t hybrid;
+    pthread_t thread;
+    uint64_t wakeup_cnt;
+} worker_t;
+
+struct periodic_scheduler_s
+{
+    periodic_task_t* tasks;
+    size_t max_tasks;
+    size_t num_tasks;
+
+    worker_t* workers;
+    size_t num_workers;
+
+    uint64_t tick_ns;
+    bool use_hybrid_sleep;
+
+    /// Absolute time at which to stop, or 0 to run until stopped
+    uint64_t end_ns;
+    /// Set to true by `periodic_scheduler_stop()`; accessed atomically
+    bool stop_requested;
+};
+
+
+/// Convert an absolute deadline into a tick number of the wheel.
+static inline uint64_t wheel_get_tick(const timer_wheel_t* wheel, uint64_t deadline_ns)
+{
+    if (deadline_ns <= wheel->start_ns)
+    {
+        return 0;
+    }
+    return (deadline_ns - wheel->start_ns)/wheel->tick_ns;
+}
+
+static void wheel_insert(timer_wheel_t* wheel, periodic_task_t* task)
+{
+    uint64_t tick = wheel_get_tick(wheel, task->deadline_ns);
+    // A late task is due now.
+    if (tick < wheel->current_tick)
+    {
+        tick = wheel->current_tick;
+    }
+
+    // Find the lowest level whose next-higher block contains both the current tick and this tick.
+    // Fall back to the top level, which is allowed to wrap.
+    size_t level = PERIODIC_SCHEDULER_WHEEL_LEVELS - 1;
+    for (size_t k = 0; k < PERIODIC_SCHEDULER_WHEEL_LEVELS - 1; k++)
+    {
+        unsigned int block_shift = PERIODIC_SCHEDULER_WHEEL_BITS*(k + 1);
+        if ((tick >> block_shift) == (wheel->current_tick >> block_shift))
+        {
+            level = k;
+            break;
+        }
+    }
+
+    size_t slot = (size_t)((tick >> (PERIODIC_SCHEDULER_WHEEL_BITS*level)) & WHEEL_MASK);
+    task->next = wheel->slots[level][slot];
+    wheel->slots[level][slot] = task;
+    wheel->occupied[level] |= UINT64_C(1) << slot;
+}
+
+/// Remove and return the whole list of tasks in a slot.
+static periodic_task_t* wheel_detach_slot(timer_wheel_t* wheel, size_t level, size_t slot)
+{
+    periodic_task_t* list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(UINT64_C(1) << slot);
+    return list;
+}
+
+/// Advance `current_tick` to the next tick which has tasks in it, cascading tasks from higher
+/// levels down into lower levels as needed. This does NOT wait: it just skips over empty ticks.
+/// Returns false if the wheel is empty.
+static bool wheel_advance_to_next_tasks(timer_wheel_t* wheel)
+{
+    while (true)
+    {
+        size_t level;
+        uint64_t slot_start_tick = 0;
+        size_t slot = 0;
+
+        // The lowest level with any tasks at or after the current tick has the earliest tasks.
+        for (level = 0; level < PERIODIC_SCHEDULER_WHEEL_LEVELS; level++)
+        {
+            unsigned int shift = PERIODIC_SCHEDULER_WHEEL_BITS*level;
+            unsigned int block_shift = shift + PERIODIC_SCHEDULER_WHEEL_BITS;
+            uint64_t current_slot = (wheel->current_tick >> shift) & WHEEL_MASK;
+            uint64_t block_start_tick = (wheel->current_tick >> block_shift) << block_shift;
+
+            uint64_t occupied_after = wheel->occupied[level] & (~UINT64_C(0) << current_slot);
+            if (occupied_after != 0)
+            {
+                slot = (size_t)__builtin_ctzll(occupied_after);
+            }
+            else if (level == PERIODIC_SCHEDULER_WHEEL_LEVELS - 1 && wheel->occupied[level] != 0)
+            {
+                // The top level wraps around into the next top-level block.
+                slot = (size_t)__builtin_ctzll(wheel->occupied[level]);
+                block_start_tick += UINT64_C(1) << block_shift;
+            }
+            else
+            {
+                continue;
+            }
+
+            slot_start_tick = block_start_tick + ((uint64_t)slot << shift);
+            break;
+        }
+
+        if (level == PERIODIC_SCHEDULER_WHEEL_LEVELS)
+        {
+            return false;
+        }
+
+        if (slot_start_tick > wheel->current_tick)
+        {
+            wheel->current_tick = slot_start_tick;
+        }
+
+        if (level == 0)
+        {
+            return true;
+        }
+
+        // Cascade: now that the current tick is inside this higher-level slot, re-insert its tasks,
+        // which puts them into lower levels.
+        periodic_task_t* task = wheel_detach_slot(wheel, level, slot);
+        while (task != NULL)
+        {
+            periodic_task_t* next = task->next;
+            wheel_insert(wheel, task);
+            task = next;
+        }
+    }
+}
+
+/// Wait until `wake_time_ns`, using the worker's selected sleep mode.
+static void worker_sleep_until(worker_t* worker, uint64_t wake_time_ns)
+{
+    if (worker->sched->use_hybrid_sleep)
+    {
+        sleep_until_ns_hybrid(&worker->hybrid, &wake_time_ns, 0);
+    }
+    else
+    {
+        sleep_until_ns(&wake_time_ns, 0);
+    }
+}
+
+/// Run a single task which is due, and schedule its next deadline.
+static void run_task(periodic_task_t* task)
+{
+    uint64_t t_start_ns = nanos();
+    latency_histogram_record(&task->jitter_hist, t_start_ns - task->deadline_ns);
+    task->func(task->user_data);
+    task->run_cnt++;
+
+    // If the next deadline has already passed, skip the periods we missed rather than running the
+    // task back-to-back to "catch up".
+    uint64_t next_deadline_ns = task->deadline_ns + task->period_ns;
+    uint64_t t_end_ns = nanos();
+    if (next_deadline_ns <= t_end_ns)
+    {
+        uint64_t num_missed = (t_end_ns - next_deadline_ns)/task->period_ns + 1;
+        task->overrun_cnt += num_missed;
+        next_deadline_ns += num_missed*task->period_ns;
+    }
+    task->deadline_ns = next_deadline_ns;
+}
+
+static void* worker_run(void* argument)
+{
+    worker_t* worker = (worker_t*)argument;
+    periodic_scheduler_t* sched = worker->sched;
+    timer_wheel_t* wheel = &worker->wheel;
+
+    while (!__atomic_load_n(&sched->stop_requested, __ATOMIC_RELAXED))
+    {
+        if (!wheel_advance_to_next_tasks(wheel))
+        {
+            break; // no tasks
+        }
+
+        // Sleep exactly once, until the earliest deadline among the tasks in this tick.
+        size_t slot = (size_t)(wheel->current_tick & WHEEL_MASK);
+        uint64_t earliest_deadline_ns = UINT64_MAX;
+        for (periodic_task_t* task = wheel->slots[0][slot]; task != NULL; task = task->next)
+        {
+            if (task->deadline_ns < earliest_deadline_ns)
+            {
+                earliest_deadline_ns = task->deadline_ns;
+            }
+        }
+
+        if (sched->end_ns != 0 && earliest_deadline_ns > sched->end_ns)
+        {
+            break;
+        }
+
+        worker_sleep_until(worker, earliest_deadline_ns);
+        worker->wakeup_cnt++;
+
+        // Run every task in this tick which is now due, and re-insert all of them.
+        uint64_t time_now_ns = nanos();
+        periodic_task_t* task = wheel_detach_slot(wheel, 0, slot);
+        while (task != NULL)
+        {
+            periodic_task_t* next = task->next;
+            if (task->deadline_ns <= time_now_ns)
+            {
+                run_task(task);
+            }
+            wheel_insert(wheel, task);
+            task = next;
+        }
+    }
+
+    return NULL;
+}
+
+periodic_scheduler_t* periodic_scheduler_create(size_t max_tasks, uint64_t tick_ns,
+    size_t num_workers, bool use_hybrid_sleep)
+{
+    if (max_tasks == 0 || tick_ns == 0 || num_workers == 0)
+    {
+        printf("ERROR: invalid argument.\n");
+        return NULL;
+    }
+
+    periodic_scheduler_t* sched = (periodic_scheduler_t*)calloc(1, sizeof(*sched));
+    if (sched == NULL)
+    {
+        printf("ERROR: out of memory\n");
+        return NULL;
+    }
+
+    sched->tasks = (periodic_task_t*)calloc(max_tasks, sizeof(*sched->tasks));
+    sched->workers = (worker_t*)calloc(num_workers, sizeof(*sched->workers));
+    if (sched->tasks == NULL || sched->workers == NULL)
+    {
+        printf("ERROR: out of memory\n");
+        periodic_scheduler_destroy(sched);
+        return NULL;
+    }
+
+    sched->max_tasks = max_tasks;
+    sched->num_workers = num_workers;
+    sched->tick_ns = tick_ns;
+    sched->use_hybrid_sleep = use_hybrid_sleep;
+
+    return sched;
+}
+
+void periodic_scheduler_destroy(periodic_scheduler_t* sched)
+{
+    // Only free it if it's a valid pointer.
+    if (sched)
+    {
+        free(sched->tasks);
+        free(sched->workers);
+        free(sched);
+    }
+}
+
+periodic_task_t* periodic_scheduler_add_task(periodic_scheduler_t* sched, const char* name,
+    periodic_task_func_t func, void* user_data, uint64_t period_ns, uint64_t phase_ns)
+{
+    if (sched == NULL || func == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return NULL;
+    }
+
+    if (sched->num_tasks >= sched->max_tasks)
+    {
+        printf("ERROR: scheduler is full (max_tasks = %zu).\n", sched->max_tasks);
+        return NULL;
+    }
+
+    uint64_t max_period_ns = TOP_LEVEL_SLOT_TICKS*sched->tick_ns;
+    if (period_ns == 0 || period_ns >= max_period_ns || phase_ns >= max_period_ns)
+    {
+        printf("ERROR: period_ns (%lu) and phase_ns (%lu) must be < %lu ns, and period_ns must "
+               "be > 0.\n", period_ns, phase_ns, max_period_ns);
+        return NULL;
+    }
+
+    periodic_task_t* task = &sched->tasks[sched->num_tasks];
+    task->name = name != NULL ? name : "";
+    task->func = func;
+    task->user_data = user_data;
+    task->period_ns = period_ns;
+    task->phase_ns = phase_ns;
+    task->run_cnt = 0;
+    task->overrun_cnt = 0;
+    latency_histogram_init(&task->jitter_hist);
+    task->worker_index = sched->num_tasks % sched->num_workers;
+    task->next = NULL;
+    sched->num_tasks++;
+
+    return task;
+}
+
+bool periodic_scheduler_run(periodic_scheduler_t* sched, uint64_t run_time_ns)
+{
+    if (sched == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return false;
+    }
+
+    __atomic_store_n(&sched->stop_requested, false, __ATOMIC_RELAXED);
+
+    uint64_t start_ns = nanos();
+    sched->end_ns = run_time_ns == 0 ? 0 : start_ns + run_time_ns;
+
+    for (size_t i = 0; i < sched->num_workers; i++)
+    {
+        worker_t* worker = &sched->workers[i];
+        memset(&worker->wheel, 0, sizeof(worker->wheel));
+        worker->wheel.start_ns = start_ns;
+        worker->wheel.tick_ns = sched->tick_ns;
+        worker->sched = sched;
+        worker->wakeup_cnt = 0;
+        sleep_until_hybrid_init(&worker->hybrid, US_TO_NS(50), true);
+    }
+
+    for (size_t i = 0; i < sched->num_tasks; i++)
+    {
+        periodic_task_t* task = &sched->tasks[i];
+        task->deadline_ns = start_ns + task->phase_ns;
+        wheel_insert(&sched->workers[task->worker_index].wheel, task);
+    }
+
+    // With 1 worker, just run in this thread.
+    if (sched->num_workers == 1)
+    {
+        worker_run(&sched->workers[0]);
+        return true;
+    }
+
+    size_t num_workers_started = 0;
+    for (; num_workers_started < sched->num_workers; num_workers_started++)
+    {
+        int retcode = pthread_create(&sched->workers[num_workers_started].thread, NULL,
+            worker_run, &sched->workers[num_workers_started]);
+        if (retcode != 0)
+        {
+            printf("ERROR: failed to create worker pthread %zu of %zu. retcode = %i: %s\n",
+                num_workers_started, sched->num_workers, retcode, strerror(retcode));
+            // Don't run only some of the tasks: stop the workers which did start. Each one
+            // stops after its current sleep; see `periodic_scheduler_stop()`.
+            __atomic_store_n(&sched->stop_requested, true, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < num_workers_started; i++)
+    {
+        int retcode = pthread_join(sched->workers[i].thread, NULL);
+        if (retcode != 0)
+        {
+            printf("ERROR: failed to join worker pthread %zu. retcode = %i: %s\n",
+                i, retcode, strerror(retcode));
+        }
+    }
+
+    return num_workers_started == sched->num_workers;
+}
+
+void periodic_scheduler_stop(periodic_scheduler_t* sched)
+{
+    if (sched == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    __atomic_store_n(&sched->stop_requested, true, __ATOMIC_RELAXED);
+}
+
+size_t periodic_scheduler_get_num_tasks(const periodic_scheduler_t* sched)
+{
+    return sched == NULL ? 0 : sched->num_tasks;
+}
+
+periodic_task_t* periodic_scheduler_get_task(periodic_scheduler_t* sched, size_t index)
+{
+    if (sched == NULL || index >= sched->num_tasks)
+    {
+        return NULL;
+    }
+    return &sched->tasks[index];
+}
+
+uint64_t periodic_scheduler_get_wakeup_cnt(const periodic_scheduler_t* sched)
+{
+    if (sched == NULL)
+    {
+        return 0;
+    }
+
+    uint64_t wakeup_cnt = 0;
+    for (size_t i = 0; i < sched->num_workers; i++)
+    {
+        wakeup_cnt += sched->workers[i].wakeup_cnt;
+    }
+    return wakeup_cnt;
+}
+
+void periodic_scheduler_print_stats(const periodic_scheduler_t* sched)
+{
+    if (sched == NULL)
+    {
+        printf("ERROR: NULL ptr.\n");
+        return;
+    }
+
+    printf("%-20s %12s %10s %10s %12s %12s %12s\n",
+        "task", "period_ns", "run_cnt", "overruns", "jitter_p50", "jitter_p99", "jitter_max");
+    for (size_t i = 0; i < sched->num_tasks; i++)
+    {
+        const periodic_task_t* task = &sched->tasks[i];
+        printf("%-20s %12lu %10lu %10lu %9lu ns %9lu ns %9lu ns\n",
+            task->name, task->period_ns, task->run_cnt, task->overrun_cnt,
+            latency_histogram_get_percentile(&task->jitter_hist, 50.0),
+            latency_histogram_get_percentile(&task->jitter_hist, 99.0),
+            task->jitter_hist.max_ns);
+    }
+}
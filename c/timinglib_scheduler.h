@@ -0,0 +1,142 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A periodic task scheduler built on top of timinglib. It runs many periodic tasks, each with its own
+period and phase, in a single thread (or optionally sharded across N worker threads), rather than
+burning one thread per task as in "timinglib_pthread_periodic_loop.c".
+
+How it works:
+1. All tasks are kept in a hierarchical timer wheel, by the "tick" in which their next deadline
+   falls. Each wheel level has 64 slots, and an occupancy bitmap, so that the next non-empty slot
+   can be found with a single "count trailing zeros" instruction, and a long run of empty ticks is
+   skipped without visiting each tick. Tasks in higher levels are "cascaded" down into lower
+   levels as their deadlines get closer. Registering, finding the next deadline, and rescheduling
+   a task are all O(1).
+2. The scheduler then sleeps exactly once, until the precise (ns) deadline of the earliest task
+   (not just until the start of its tick), runs all of the tasks due at that time, reschedules
+   them, and repeats.
+3. Each task keeps its own statistics: run count, overrun count (the number of its periods which
+   were skipped because it, or the tasks before it, ran too long), and a histogram of its start
+   time jitter (actual start time - deadline).
+
+STATUS: works!
+
+To compile and run:
+- See "timinglib_scheduler_many_periodic_tasks.c" as an example.
+
+References:
+1. George Varghese and Tony Lauck, "Hashed and Hierarchical Timing Wheels: Data Structures for the
+   Efficient Implementation of a Timer Facility", 1987:
+   http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf
+1. The Linux kernel timer wheel: https://lwn.net/Articles/646950/
+
+*/
+
+#pragma once
+
+// Local includes
+#include "timinglib.h"
+
+// C includes
+#include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
+#include <stddef.h>  // For `size_t`
+#include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
+
+
+/// log2 of the number of slots per timer wheel level
+#define PERIODIC_SCHEDULER_WHEEL_BITS 6
+/// Number of slots per timer wheel level; 64, so that each level's occupancy fits in a `uint64_t`
+#define PERIODIC_SCHEDULER_WHEEL_SIZE (1U << PERIODIC_SCHEDULER_WHEEL_BITS)
+/// Number of timer wheel levels. Periods and phases must be shorter than one slot of the top level,
+/// which is 64^4 ticks, or ~28 minutes with the default 100 us tick.
+#define PERIODIC_SCHEDULER_WHEEL_LEVELS 5
+/// The default time covered by each tick of the lowest timer wheel level
+#define PERIODIC_SCHEDULER_DEFAULT_TICK_NS US_TO_NS(100)
+
+/// A periodic task function, called once per period with the `user_data` it was registered with
+typedef void (*periodic_task_func_t)(void* user_data);
+
+/// A periodic task and its statistics
+typedef struct periodic_task_s
+{
+    /// Any name, for printing
+    const char* name;
+    periodic_task_func_t func;
+    void* user_data;
+
+    /// Period, and phase (offset of the first deadline from the scheduler start time)
+    uint64_t period_ns;
+    uint64_t phase_ns;
+
+    /// Absolute time of the next deadline, in the same `nanos()` time base
+    uint64_t deadline_ns;
+
+    /// Number of times the task has run
+    uint64_t run_cnt;
+    /// Number of periods which were skipped because the task could not run in time
+    uint64_t overrun_cnt;
+    /// Histogram of the start time jitter (actual start time - deadline), in ns
+    latency_histogram_t jitter_hist;
+
+    /// Index of the worker (thread) which runs this task
+    size_t worker_index;
+    /// Next task in the same timer wheel slot
+    struct periodic_task_s* next;
+} periodic_task_t;
+
+/// Opaque periodic scheduler object
+typedef struct periodic_scheduler_s periodic_scheduler_t;
+
+/// A "factory" function to create a periodic scheduler which can hold up to `max_tasks` tasks.
+/// - `tick_ns` is the time covered by each slot of the lowest timer wheel level; use
+///   `PERIODIC_SCHEDULER_DEFAULT_TICK_NS` if unsure. It only affects how tasks are bucketed; tasks
+///   are still woken up at their exact deadlines.
+/// - `num_workers` is the number of threads to run the tasks in. With 1 worker, all tasks run in
+///   the thread which calls `periodic_scheduler_run()`. With N > 1 workers, the tasks are sharded
+///   round-robin across N threads, each with its own timer wheel, so that no locks are needed.
+/// - `use_hybrid_sleep` makes each worker wait with `sleep_until_ns_hybrid()` instead of
+///   `sleep_until_ns()`, for us-level accuracy without a real-time scheduler, at the cost of some
+///   spinning.
+/// Returns NULL if out of memory or if an argument is invalid.
+periodic_scheduler_t* periodic_scheduler_create(size_t max_tasks, uint64_t tick_ns,
+    size_t num_workers, bool use_hybrid_sleep);
+
+/// "Destroy" the scheduler object by `free`ing its dynamically-allocated memory, including all of
+/// its tasks.
+void periodic_scheduler_destroy(periodic_scheduler_t* sched);
+
+/// Register a new periodic task. Its first deadline is `phase_ns` after the scheduler starts.
+/// - Tasks must be added before calling `periodic_scheduler_run()`.
+/// - Returns a ptr to the task, which is owned by the scheduler, so you can read its statistics
+///   later, or NULL if the scheduler is full or an argument is invalid.
+periodic_task_t* periodic_scheduler_add_task(periodic_scheduler_t* sched, const char* name,
+    periodic_task_func_t func, void* user_data, uint64_t period_ns, uint64_t phase_ns);
+
+/// Run all tasks for `run_time_ns` nanoseconds, or until `periodic_scheduler_stop()` is called if
+/// `run_time_ns` is 0. This blocks until all workers are done.
+/// Returns false if `sched` is NULL, or if a worker thread could not be created, in which case
+/// the workers which were already started are stopped, just as by `periodic_scheduler_stop()`,
+/// and this returns once they have all stopped.
+bool periodic_scheduler_run(periodic_scheduler_t* sched, uint64_t run_time_ns);
+
+/// Ask a running scheduler to stop. This is safe to call from within a task, or from any thread.
+/// It does NOT interrupt anything: each worker only checks for the stop request between ticks, so
+/// it first finishes its current sleep, until the next deadline among its tasks, and then runs
+/// every task which is due at that deadline. So `periodic_scheduler_run()` returns up to the
+/// longest of those sleeps (at most the shortest period among each worker's tasks, or their
+/// `phase_ns` before their first run) plus the run time of one tick's worth of tasks after this is
+/// called.
+void periodic_scheduler_stop(periodic_scheduler_t* sched);
+
+/// Get the number of tasks registered.
+size_t periodic_scheduler_get_num_tasks(const periodic_scheduler_t* sched);
+
+/// Get a registered task by index, or NULL if `index` is out of range.
+periodic_task_t* periodic_scheduler_get_task(periodic_scheduler_t* sched, size_t index);
+
+/// Get the number of times the scheduler's workers have woken up, in total, to run tasks. Since
+/// tasks with the same deadline run in the same wake-up, this is at most the total task run count.
+uint64_t periodic_scheduler_get_wakeup_cnt(const periodic_scheduler_t* sched);
+
+/// Print a one-line summary of each task's run count, overrun count, and p50/p99/max jitter.
+void periodic_scheduler_print_stats(const periodic_scheduler_t* sched);
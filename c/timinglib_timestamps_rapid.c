@@ -4,15 +4,23 @@ This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftG
 Rapidly do `nanos()` calls and load the results into an array, and print it out to see how fast
 the time samples could be taken.
 
+Benchmark mode: pass `benchmark` as the first argument to instead compare the per-call cost of
+`nanos()` when backed by each of the timinglib time sources (`clock_gettime()` vs the calibrated
+TSC), and to measure how far the TSC time source drifts from `clock_gettime()` over time.
+
 STATUS: done
 
 To compile and run (assuming you've already `cd`ed into this dir):
 ```bash
 # 1. In C:
 gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_timestamps_rapid.c timinglib.c -o bin/a && bin/a
+# benchmark mode
+gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_timestamps_rapid.c timinglib.c -o bin/a && bin/a benchmark
 
 # 2. In C++
 g++ -Wall -Wextra -Werror -O3 -std=c++17 timinglib_timestamps_rapid.c timinglib.c -o bin/a && bin/a
+# benchmark mode
+g++ -Wall -Wextra -Werror -O3 -std=c++17 timinglib_timestamps_rapid.c timinglib.c -o bin/a && bin/a benchmark
 ```
 
 References:
@@ -29,13 +37,94 @@ References:
 #include <stdbool.h> // For `true` (`1`) and `false` (`0`) macros in C
 #include <stdint.h>  // For `uint8_t`, `int8_t`, etc.
 #include <stdio.h>   // For `printf()`
+#include <string.h>  // For `strcmp()`
 
 #define NUM_MEASUREMENTS 10000
 
+/// Number of `nanos()` calls to time per time source in benchmark mode
+#define NUM_BENCHMARK_CALLS 10000000
+/// Number of drift samples to take, and the time between them, in benchmark mode
+#define NUM_DRIFT_SAMPLES 10
+#define DRIFT_SAMPLE_PERIOD_MS 500
+
+
+/// Measure the average cost of a single `nanos()` call with the currently-selected time source.
+/// The total time is always measured with `nanos_clock_gettime()` so that both time sources are
+/// judged by the same clock.
+static double measure_nanos_call_cost_ns()
+{
+    // `volatile` so that the compiler can't optimize away the calls
+    volatile uint64_t sink = 0;
+
+    uint64_t t_start_ns = nanos_clock_gettime();
+    for (size_t i = 0; i < NUM_BENCHMARK_CALLS; i++)
+    {
+        sink = nanos();
+    }
+    uint64_t t_end_ns = nanos_clock_gettime();
+    (void)sink;
+
+    return (double)(t_end_ns - t_start_ns)/NUM_BENCHMARK_CALLS;
+}
 
-// int main(int argc, char *argv[])  // alternative prototype
-int main()
+/// Compare the per-call cost and the drift of the timinglib time sources.
+static void run_benchmark()
 {
+    printf("Benchmark: `nanos()` per-call cost, %u calls per time source.\n\n",
+        NUM_BENCHMARK_CALLS);
+
+    timinglib_clock_source_t sources[] =
+    {
+        TIMINGLIB_CLOCK_SOURCE_CLOCK_GETTIME,
+        TIMINGLIB_CLOCK_SOURCE_TSC,
+    };
+    for (size_t i = 0; i < ARRAY_LEN(sources); i++)
+    {
+        timinglib_clock_source_t source = timinglib_init(sources[i]);
+        if (source != sources[i])
+        {
+            printf("%-15s: not available on this system\n",
+                timinglib_clock_source_get_name(sources[i]));
+            continue;
+        }
+        printf("%-15s: %8.3f ns per call\n", timinglib_clock_source_get_name(source),
+            measure_nanos_call_cost_ns());
+    }
+
+    if (timinglib_get_clock_source() != TIMINGLIB_CLOCK_SOURCE_TSC)
+    {
+        return;
+    }
+
+    printf("\nCalibrated TSC frequency = %lu Hz\n", timinglib_get_tsc_frequency_hz());
+    printf("\nDrift of TSC timestamps relative to `clock_gettime()` timestamps:\n");
+    uint64_t t_start_ns = nanos_clock_gettime();
+    for (size_t i = 0; i < NUM_DRIFT_SAMPLES; i++)
+    {
+        sleep_ms(DRIFT_SAMPLE_PERIOD_MS);
+
+        // Bracket the TSC reading with two `clock_gettime()` readings and use their midpoint, to
+        // remove the cost of the calls themselves from the comparison.
+        uint64_t t1_ns = nanos_clock_gettime();
+        uint64_t tsc_ns = nanos_tsc();
+        uint64_t t2_ns = nanos_clock_gettime();
+        uint64_t clock_gettime_ns = t1_ns + (t2_ns - t1_ns)/2;
+
+        int64_t drift_ns = (int64_t)(tsc_ns - clock_gettime_ns);
+        double elapsed_sec = NS_TO_SEC((double)(clock_gettime_ns - t_start_ns));
+        printf("  t = %6.3f sec: drift = %6li ns (%8.3f ppm)\n", elapsed_sec, drift_ns,
+            (double)drift_ns/(clock_gettime_ns - t_start_ns)*1e6);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "benchmark") == 0)
+    {
+        run_benchmark();
+        return 0;
+    }
+
     printf("Rapid timestamps.\n\n");
 
     static uint64_t nanos_array[NUM_MEASUREMENTS];
@@ -110,5 +199,26 @@ OR, in C++:
 
 
 
+Benchmark mode (in C), on a 1-core x86-64 VM:
+
+    eRCaGuy_hello_world/c$ gcc -Wall -Wextra -Werror -O3 -std=c17 timinglib_timestamps_rapid.c timinglib.c -o bin/a && bin/a benchmark
+    Benchmark: `nanos()` per-call cost, 10000000 calls per time source.
+
+    clock_gettime  :   42.836 ns per call
+    TSC            :   25.044 ns per call
+
+    Calibrated TSC frequency = 2000000079 Hz
+
+    Drift of TSC timestamps relative to `clock_gettime()` timestamps:
+      t =  0.500 sec: drift =   -390 ns (  -0.780 ppm)
+      t =  1.000 sec: drift =   -421 ns (  -0.421 ppm)
+      t =  1.501 sec: drift =   -359 ns (  -0.239 ppm)
+      t =  2.001 sec: drift =   -387 ns (  -0.193 ppm)
+      t =  2.501 sec: drift =   -458 ns (  -0.183 ppm)
+      t =  3.001 sec: drift =   -444 ns (  -0.148 ppm)
+      t =  3.501 sec: drift =   -372 ns (  -0.106 ppm)
+      t =  4.001 sec: drift =   -422 ns (  -0.105 ppm)
+      t =  4.502 sec: drift =   -477 ns (  -0.106 ppm)
+      t =  5.002 sec: drift =   -476 ns (  -0.095 ppm)
 
 */
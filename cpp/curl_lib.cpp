@@ -0,0 +1,608 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+References:
+1. "eRCaGuy_hello_world/c/curl_rest_api_http_post_and_get.c"
+1. https://curl.se/libcurl/c/curl_global_init.html
+1. https://curl.se/libcurl/c/CURLOPT_WRITEFUNCTION.html
+1. https://curl.se/libcurl/c/CURLOPT_ERRORBUFFER.html
+1. https://curl.se/libcurl/c/CURLOPT_NOSIGNAL.html
+1. https://curl.se/libcurl/c/CURLOPT_HTTPHEADER.html - see the `Expect:` header notes
+1. https://curl.se/libcurl/c/CURLINFO_RESPONSE_CODE.html
+1. For `BatchClient`:
+    1. https://curl.se/libcurl/c/multi-app.html
+    1. https://curl.se/libcurl/c/curl_multi_poll.html
+    1. https://curl.se/libcurl/c/curl_multi_wakeup.html
+    1. https://curl.se/libcurl/c/CURLINFO_NUM_CONNECTS.html
+    1. https://curl.se/libcurl/c/CURLMOPT_MAX_TOTAL_CONNECTIONS.html
+    1. https://curl.se/libcurl/c/CURLOPT_CAINFO.html
+
+*/
+
+
+// Local includes
+#include "curl_lib.h"
+
+// 3rd-party library includes
+#include <curl/curl.h>
+#include <fmt/format.h>
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <condition_variable>
+#include <cstring>  // For `strlen()`
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+namespace curl_lib
+{
+
+/// This thread's curl easy handle, cleaned up when the thread exits. NB: a curl easy handle can
+/// only be used by one thread at a time, so each thread gets its own.
+/// See: https://curl.se/libcurl/c/curl_easy_perform.html
+/// > If you want parallel transfers, you must use several curl easy_handles.
+struct ThreadHandle
+{
+    CURL* curl = nullptr;
+    /// Request headers to send with every POST
+    struct curl_slist* post_headers = nullptr;
+
+    ~ThreadHandle()
+    {
+        // this also closes the handle's open connections
+        curl_easy_cleanup(curl);
+        curl_slist_free_all(post_headers);
+    }
+};
+
+/// Get this thread's curl easy handle, creating it if this is the thread's first request.
+/// Returns `ERROR_OK`, or an error string if curl could not be set up.
+static std::string get_thread_handle(ThreadHandle** handle_out)
+{
+    // `curl_global_init()` must be called once, before any other curl function, and (before
+    // libcurl 7.84.0) NOT while any other thread is using curl. A function-local static is
+    // initialized exactly once, even if several threads get here at the same time, and the other
+    // threads wait until it is done. It is never undone with `curl_global_cleanup()`, since other
+    // threads may still be using their handles when `main()` returns; the OS cleans up.
+    static const CURLcode global_init_code = curl_global_init(CURL_GLOBAL_DEFAULT);
+    if (global_init_code != CURLE_OK)
+    {
+        return fmt::format(FMT_STRING("curl_global_init() failed. curl_code = {}: {}"),
+            global_init_code, curl_easy_strerror(global_init_code));
+    }
+
+    thread_local ThreadHandle handle;
+    if (handle.curl == nullptr)
+    {
+        handle.curl = curl_easy_init();
+        if (handle.curl == nullptr)
+        {
+            return "curl_easy_init() failed.";
+        }
+        // For POSTs bigger than 1 KiB, libcurl sends `Expect: 100-continue` by default, and then
+        // waits for the server to say "go ahead" before sending the body, which costs an extra
+        // round trip, or a whole second for servers which ignore it. An empty `Expect:` header
+        // turns that off.
+        handle.post_headers = curl_slist_append(nullptr, "Expect:");
+    }
+    *handle_out = &handle;
+    return ERROR_OK;
+}
+
+/// \brief          The `CURLOPT_WRITEFUNCTION` callback, which curl calls with each piece of the
+///     response as it arrives.
+/// \param[in]      received_data   The received piece of the response.
+/// \param[in]      size            Always 1. See "curl_rest_api_http_post_and_get.c".
+/// \param[in]      count           The number of bytes in `received_data`.
+/// \param[in,out]  user_data       The `std::string*` to append the response to, set with
+///                     `CURLOPT_WRITEDATA`, or `nullptr` to discard the response.
+/// \return         The number of bytes handled; anything other than `count` aborts the transfer.
+static size_t write_callback(const char* received_data, size_t size, size_t count,
+    void* user_data)
+{
+    (void)size;
+    std::string* response_str = (std::string*)user_data;
+    if (response_str != nullptr)
+    {
+        response_str->append(received_data, count);
+    }
+    return count;
+}
+
+/// Do the request which has been set up in `handle`, to `url`. Then reset all of the handle's
+/// options, ready for the next request, whatever happens; that keeps its open connections and DNS
+/// cache, though.
+static std::string perform(ThreadHandle* handle, const char* url, std::string* response_str,
+    long* http_status_code)
+{
+    std::string error = ERROR_OK;
+    CURL* curl = handle->curl;
+
+    // more detail on any error than `curl_easy_strerror()` gives
+    char error_buf[CURL_ERROR_SIZE] = "";
+    CURLcode curl_code;
+
+    // None of these can fail, except for `CURLOPT_URL`, if out of memory
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error_buf);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, response_str);
+    // Don't use signals for timeouts; required for using curl from multiple threads
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    // Have the OS probe idle connections, so a kept-alive connection which silently died is
+    // noticed
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_code = curl_easy_setopt(curl, CURLOPT_URL, url);
+    if (curl_code != CURLE_OK)
+    {
+        error = fmt::format(FMT_STRING("curl_easy_setopt() failed on `CURLOPT_URL`. "
+            "curl_code = {}: {}"), curl_code, curl_easy_strerror(curl_code));
+        goto cleanup;
+    }
+
+    if (response_str != nullptr)
+    {
+        response_str->clear();
+        // curl passes the response to `write_callback()` in pieces of up to this size, so this
+        // is enough for small responses to need only this one allocation
+        response_str->reserve(CURL_MAX_WRITE_SIZE);
+    }
+
+    curl_code = curl_easy_perform(curl);
+    if (curl_code != CURLE_OK)
+    {
+        error = fmt::format(FMT_STRING("curl_easy_perform() failed. curl_code = {}: {}: {}"),
+            curl_code, curl_easy_strerror(curl_code), error_buf);
+        goto cleanup;
+    }
+
+    if (http_status_code != nullptr)
+    {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, http_status_code);
+    }
+
+cleanup:
+    // Reset all of the options set above, so that the next request starts fresh, and doesn't
+    // write into `error_buf` or `response_str`, which will be gone by then. See
+    // "curl_rest_api_http_post_and_get.c" for more on this.
+    curl_easy_reset(curl); // Note: no return code to check
+    return error;
+}
+
+std::string http_get(const char* url, std::string* response_str, long* http_status_code)
+{
+    std::string error = ERROR_OK;
+
+    if (url == nullptr)
+    {
+        error = "INVALID ARGUMENT: nullptr";
+        return error;
+    }
+
+    ThreadHandle* handle;
+    error = get_thread_handle(&handle);
+    if (error != ERROR_OK)
+    {
+        return error;
+    }
+
+    return perform(handle, url, response_str, http_status_code);
+}
+
+std::string http_post(const char* url, const char* post_str, std::string* response_str,
+    long* http_status_code)
+{
+    std::string error = ERROR_OK;
+
+    if (url == nullptr || post_str == nullptr)
+    {
+        error = "INVALID ARGUMENT: nullptr";
+        return error;
+    }
+
+    ThreadHandle* handle;
+    error = get_thread_handle(&handle);
+    if (error != ERROR_OK)
+    {
+        return error;
+    }
+
+    // NB: curl does NOT copy `post_str`; it just points to it, which is fine, since it's only
+    // used until `perform()` returns
+    curl_easy_setopt(handle->curl, CURLOPT_POSTFIELDS, post_str);
+    curl_easy_setopt(handle->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)strlen(post_str));
+    curl_easy_setopt(handle->curl, CURLOPT_HTTPHEADER, handle->post_headers);
+
+    return perform(handle, url, response_str, http_status_code);
+}
+
+/// All of the state of a `BatchClient`, kept out of the header so that it needn't include
+/// "curl/curl.h".
+class BatchClient::Impl
+{
+public:
+    Impl(size_t max_num_in_flight, bool http2_prior_knowledge, std::string&& ca_info);
+    ~Impl();
+
+    /// Queue up a request whose result goes to `callback`
+    void submit(std::string&& url, bool is_post, std::string&& post_str, Callback&& callback);
+    /// Queue up a request whose result goes to the returned future
+    std::future<HttpResult> submit(std::string&& url, bool is_post, std::string&& post_str);
+    void wait_all();
+
+private:
+    /// One request, queued or in flight, and where to deliver its result: to `callback`, or, if
+    /// it has none, to `promise`
+    struct Transfer
+    {
+        std::string url;
+        bool is_post = false;
+        std::string post_str;
+        Callback callback;
+        std::optional<std::promise<HttpResult>> promise;
+        HttpResult result;
+        char error_buf[CURL_ERROR_SIZE] = "";
+    };
+
+    std::unique_ptr<Transfer> make_transfer(std::string&& url, bool is_post,
+        std::string&& post_str);
+    void enqueue(std::unique_ptr<Transfer> transfer);
+    void run_loop();
+    void start_queued_transfers();
+    void finish_transfer(CURL* curl, CURLcode curl_code);
+    void deliver(std::unique_ptr<Transfer> transfer);
+
+    const size_t max_num_in_flight_;
+    const bool http2_prior_knowledge_;
+    /// Empty to use the system's CA certificates
+    const std::string ca_info_;
+    /// `ERROR_OK`, or why curl could not be set up, in which case every request fails with this
+    /// error
+    std::string init_error_ = ERROR_OK;
+    CURLM* multi_ = nullptr;
+    /// Request headers to send with every POST
+    struct curl_slist* post_headers_ = nullptr;
+
+    // Shared by the submitting threads and the loop thread, under `mutex_`
+    std::mutex mutex_;
+    /// Requests waiting for a free spot among the `max_num_in_flight_`
+    std::deque<std::unique_ptr<Transfer>> queue_;
+    /// Requests whose results haven't been delivered yet: queued, in flight, or in their callback
+    size_t num_pending_ = 0;
+    /// Notified when `num_pending_` drops to 0, for `wait_all()`
+    std::condition_variable none_pending_cv_;
+    /// Set by the destructor to end the loop thread
+    bool shutting_down_ = false;
+
+    // Only used by the loop thread
+    size_t num_in_flight_ = 0;
+    /// Finished easy handles, to reuse for the next requests rather than creating new ones
+    std::vector<CURL*> idle_handles_;
+
+    std::thread loop_thread_;
+};
+
+BatchClient::Impl::Impl(size_t max_num_in_flight, bool http2_prior_knowledge,
+    std::string&& ca_info)
+    : max_num_in_flight_(max_num_in_flight > 0 ? max_num_in_flight : 1),
+    http2_prior_knowledge_(http2_prior_knowledge), ca_info_(std::move(ca_info))
+{
+    // Set up curl, if this is the first use of it; see `get_thread_handle()`
+    ThreadHandle* handle;
+    init_error_ = get_thread_handle(&handle);
+    if (init_error_ != ERROR_OK)
+    {
+        return;
+    }
+
+    multi_ = curl_multi_init();
+    if (multi_ == nullptr)
+    {
+        init_error_ = "curl_multi_init() failed.";
+        return;
+    }
+    // Many requests to the same HTTP/2 server share one connection. This is the default since
+    // libcurl 7.62.0.
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    // Keep one idle connection open per request in flight, for the next requests to reuse. The
+    // default limit is 4x the number of transfers in flight right now, so it would close idle
+    // connections whenever there's a lull in requests.
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, (long)max_num_in_flight_);
+    // And never have more connections open than that, idle or not, so never more than
+    // `max_num_in_flight_` sockets' worth of fds: a request to a new server closes the oldest idle
+    // connection to make room, rather than opening one more. By default, there's no limit.
+    curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)max_num_in_flight_);
+    // See `get_thread_handle()`
+    post_headers_ = curl_slist_append(nullptr, "Expect:");
+
+    loop_thread_ = std::thread(&Impl::run_loop, this);
+}
+
+BatchClient::Impl::~Impl()
+{
+    wait_all();
+    if (loop_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutting_down_ = true;
+        }
+        curl_multi_wakeup(multi_);
+        loop_thread_.join();
+    }
+    for (CURL* curl : idle_handles_)
+    {
+        curl_easy_cleanup(curl);
+    }
+    // this also closes all of the open connections
+    curl_multi_cleanup(multi_);
+    curl_slist_free_all(post_headers_);
+}
+
+void BatchClient::Impl::submit(std::string&& url, bool is_post, std::string&& post_str,
+    Callback&& callback)
+{
+    std::unique_ptr<Transfer> transfer = make_transfer(std::move(url), is_post,
+        std::move(post_str));
+    transfer->callback = std::move(callback);
+    enqueue(std::move(transfer));
+}
+
+std::future<HttpResult> BatchClient::Impl::submit(std::string&& url, bool is_post,
+    std::string&& post_str)
+{
+    std::unique_ptr<Transfer> transfer = make_transfer(std::move(url), is_post,
+        std::move(post_str));
+    transfer->promise.emplace();
+    std::future<HttpResult> future = transfer->promise->get_future();
+    enqueue(std::move(transfer));
+    return future;
+}
+
+std::unique_ptr<BatchClient::Impl::Transfer> BatchClient::Impl::make_transfer(std::string&& url,
+    bool is_post, std::string&& post_str)
+{
+    auto transfer = std::make_unique<Transfer>();
+    transfer->url = std::move(url);
+    transfer->is_post = is_post;
+    transfer->post_str = std::move(post_str);
+    return transfer;
+}
+
+/// Hand `transfer` to the loop thread, or, if curl could not be set up, fail it right away, from
+/// this thread
+void BatchClient::Impl::enqueue(std::unique_ptr<Transfer> transfer)
+{
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_pending_++;
+        if (init_error_ == ERROR_OK)
+        {
+            queue_.push_back(std::move(transfer));
+            queued = true;
+        }
+    }
+    if (!queued)
+    {
+        transfer->result.error = init_error_;
+        deliver(std::move(transfer));
+        return;
+    }
+    // Make the loop thread's `curl_multi_poll()` return, to start the request
+    curl_multi_wakeup(multi_);
+}
+
+void BatchClient::Impl::wait_all()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    none_pending_cv_.wait(lock, [this]() { return num_pending_ == 0; });
+}
+
+void BatchClient::Impl::run_loop()
+{
+    while (true)
+    {
+        start_queued_transfers();
+        {
+            // The destructor only sets this after `wait_all()`, so nothing is queued or in
+            // flight by then
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutting_down_)
+            {
+                break;
+            }
+        }
+
+        int num_running;
+        curl_multi_perform(multi_, &num_running);
+
+        bool finished_any = false;
+        CURLMsg* msg;
+        int num_msgs_left;
+        while ((msg = curl_multi_info_read(multi_, &num_msgs_left)) != nullptr)
+        {
+            if (msg->msg == CURLMSG_DONE)
+            {
+                finish_transfer(msg->easy_handle, msg->data.result);
+                finished_any = true;
+            }
+        }
+
+        if (!finished_any)
+        {
+            // Sleep until a socket is ready, curl has a timeout to handle, or `submit()` or the
+            // destructor calls `curl_multi_wakeup()`. The 1 sec timeout is just a backstop; curl
+            // shortens it to its own next timeout.
+            curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+        }
+        // else: go start the next queued requests right away
+    }
+}
+
+void BatchClient::Impl::start_queued_transfers()
+{
+    while (num_in_flight_ < max_num_in_flight_)
+    {
+        std::unique_ptr<Transfer> transfer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty())
+            {
+                return;
+            }
+            transfer = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        CURL* curl;
+        if (!idle_handles_.empty())
+        {
+            curl = idle_handles_.back();
+            idle_handles_.pop_back();
+        }
+        else
+        {
+            curl = curl_easy_init();
+            if (curl == nullptr)
+            {
+                transfer->result.error = "curl_easy_init() failed.";
+                deliver(std::move(transfer));
+                continue;
+            }
+        }
+
+        // Just like in `perform()`
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, transfer->error_buf);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->result.response_str);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_URL, transfer->url.c_str());
+        if (transfer->is_post)
+        {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, transfer->post_str.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE,
+                (curl_off_t)transfer->post_str.size());
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, post_headers_);
+        }
+        if (http2_prior_knowledge_)
+        {
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+        }
+        if (!ca_info_.empty())
+        {
+            curl_easy_setopt(curl, CURLOPT_CAINFO, ca_info_.c_str());
+        }
+        // When there's no connection to the server yet, and one is being opened, wait to see if
+        // it is HTTP/2 and can be shared, rather than opening another connection right away
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+        // The transfer is owned by the handle until `finish_transfer()`
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer.get());
+
+        CURLMcode multi_code = curl_multi_add_handle(multi_, curl);
+        if (multi_code != CURLM_OK)
+        {
+            transfer->result.error = fmt::format(FMT_STRING("curl_multi_add_handle() failed. "
+                "multi_code = {}: {}"), multi_code, curl_multi_strerror(multi_code));
+            curl_easy_reset(curl);
+            idle_handles_.push_back(curl);
+            deliver(std::move(transfer));
+            continue;
+        }
+        transfer.release();
+        num_in_flight_++;
+    }
+}
+
+void BatchClient::Impl::finish_transfer(CURL* curl, CURLcode curl_code)
+{
+    Transfer* transfer_ptr;
+    curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&transfer_ptr);
+    std::unique_ptr<Transfer> transfer(transfer_ptr);
+
+    if (curl_code != CURLE_OK)
+    {
+        transfer->result.error = fmt::format(FMT_STRING("curl transfer failed. "
+            "curl_code = {}: {}: {}"), curl_code, curl_easy_strerror(curl_code),
+            transfer->error_buf);
+    }
+    else
+    {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer->result.http_status_code);
+    }
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &transfer->result.num_new_connections);
+
+    curl_multi_remove_handle(multi_, curl);
+    // Clear its options, ready for its next request; see `perform()`
+    curl_easy_reset(curl);
+    idle_handles_.push_back(curl);
+    num_in_flight_--;
+
+    deliver(std::move(transfer));
+}
+
+/// Pass `transfer`'s result to its callback or future, and count it as delivered
+void BatchClient::Impl::deliver(std::unique_ptr<Transfer> transfer)
+{
+    if (transfer->callback)
+    {
+        transfer->callback(std::move(transfer->result));
+    }
+    else
+    {
+        transfer->promise->set_value(std::move(transfer->result));
+    }
+    // Free the transfer, and anything its callback captured, before `wait_all()` may return, so
+    // that nothing in it outlives the client
+    transfer.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_pending_--;
+    if (num_pending_ == 0)
+    {
+        none_pending_cv_.notify_all();
+    }
+}
+
+BatchClient::BatchClient(size_t max_num_in_flight, bool http2_prior_knowledge,
+    std::string ca_info)
+    : impl_(std::make_unique<Impl>(max_num_in_flight, http2_prior_knowledge, std::move(ca_info)))
+{
+}
+
+BatchClient::~BatchClient() = default;
+
+std::future<HttpResult> BatchClient::http_get(std::string url)
+{
+    return impl_->submit(std::move(url), false, "");
+}
+
+void BatchClient::http_get(std::string url, Callback callback)
+{
+    impl_->submit(std::move(url), false, "", std::move(callback));
+}
+
+std::future<HttpResult> BatchClient::http_post(std::string url, std::string post_str)
+{
+    return impl_->submit(std::move(url), true, std::move(post_str));
+}
+
+void BatchClient::http_post(std::string url, std::string post_str, Callback callback)
+{
+    impl_->submit(std::move(url), true, std::move(post_str), std::move(callback));
+}
+
+void BatchClient::wait_all()
+{
+    impl_->wait_all();
+}
+
+} // namespace curl_lib
@@ -0,0 +1,194 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A basic Linux C++ library to make HTTP REST API GET and POST calls with the libcurl C library,
+rather than with the command-line `curl` program like "curl_systemcall_lib.h" does, so the two
+can be compared, including speed! See "curl_lib_benchmark.cpp".
+
+`curl_systemcall::http_post()` starts a `/bin/sh` process, which starts a `curl` process, which
+opens a new TCP connection (plus TLS session, for https) to the server, for every single request.
+This library, instead, keeps one libcurl "easy" handle per thread, and reuses it for every request
+that thread makes. A curl handle keeps its connections open after each request (HTTP/1.1
+keep-alive), so the next request to the same server skips the process creation, the TCP
+handshake, and the TLS setup, and just sends the request.
+
+To make many requests at once, from one thread, use `BatchClient`, which uses the libcurl "multi"
+interface, and can share one HTTP/2 connection among many requests. See
+"curl_lib_batch_benchmark.cpp".
+
+STATUS: done and works!
+
+To compile and run:
+- See a file which includes this header file, as an example.
+- Link with `-lcurl`. See "eRCaGuy_hello_world/cpp/README.md" for how to install libcurl, or use
+  your distro's package (ex: `sudo apt install libcurl4-openssl-dev`).
+
+References:
+1. "eRCaGuy_hello_world/c/curl_rest_api_http_post_and_get.c" - the same thing, in C, with a fixed
+   size response buffer, `buffer_t`, which this library replaces with a `std::string`, as that
+   file's own notes recommend for C++
+1. "curl_systemcall_lib.h"
+1. https://curl.se/libcurl/c/libcurl-tutorial.html - see "Persistence Is The Way to Happiness"
+1. https://curl.se/libcurl/c/curl_easy_reset.html - it keeps live connections, and the DNS cache
+1. https://curl.se/libcurl/c/threadsafe.html
+1. For `BatchClient`:
+    1. https://curl.se/libcurl/c/libcurl-multi.html
+    1. https://curl.se/libcurl/c/CURLMOPT_PIPELINING.html
+    1. https://curl.se/libcurl/c/CURLOPT_PIPEWAIT.html
+
+*/
+
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+
+namespace curl_lib
+{
+
+/// error code indicating no error
+constexpr char ERROR_OK[] = "OK";
+
+/// \brief          Send an HTTP REST API GET command.
+/// \details        This is essentially equivalent to the following command-line command:
+///     `curl "url"`. It uses this thread's own reusable curl handle, so it's thread-safe, and a
+///     connection opened to a server by one call is reused by later calls from the same thread.
+/// \param[in]      url             A null-terminated URL to send the GET command to.
+/// \param[out]     response_str    (Optional) A string to receive the response back, if desired.
+///     It grows as needed to hold the whole response. If `nullptr`, the response is discarded.
+/// \param[out]     http_status_code    (Optional) A pointer to receive the HTTP status code of
+///     the response back, if desired, ex: 200 or 404. Just like for the `curl` command, an error
+///     status code is NOT treated as an error, so check it here if needed.
+/// \return         An error string to describe the error if there is an error, or
+///                 `ERROR_OK` otherwise.
+std::string http_get(const char* url, std::string* response_str = nullptr,
+   long* http_status_code = nullptr);
+
+/// \brief          Send an HTTP REST API POST command.
+/// \details        This is essentially equivalent to the following command-line command:
+///     `curl --data "post_str" -X POST "url"`. Ex:
+///     `curl --data "name=Gabe&project=curl" -X POST "https://example.com"`. Like `http_get()`,
+///     it uses this thread's own reusable curl handle.
+/// \param[in]      url             A null-terminated URL to send the POST command to.
+/// \param[in]      post_str        A null-terminated string containing the data to post, or send
+///     to the URL.
+/// \param[out]     response_str    (Optional) A string to receive the response back, if desired.
+/// \param[out]     http_status_code    (Optional) A pointer to receive the HTTP status code back.
+/// \return         An error string to describe the error if there is an error, or
+///                 `ERROR_OK` otherwise.
+std::string http_post(const char* url, const char* post_str, std::string* response_str = nullptr,
+   long* http_status_code = nullptr);
+
+/// The result of one request made by a `BatchClient`
+struct HttpResult
+{
+   /// `ERROR_OK`, or an error string to describe the error, just like `http_get()` returns
+   std::string error = ERROR_OK;
+   std::string response_str;
+   /// The HTTP status code of the response, ex: 200 or 404, or 0 if there was no response
+   long http_status_code = 0;
+   /// The number of new connections this request had to open: 0 if it reused a kept-alive
+   /// connection, or shared an HTTP/2 connection with other requests
+   long num_new_connections = 0;
+};
+
+/// \brief          Make many HTTP requests at once from one thread, with the libcurl "multi"
+///     interface, keeping up to `max_num_in_flight` requests in flight at a time.
+/// \details        A single background thread drives all of the requests, with one curl multi
+///     handle, whose connection cache and DNS cache are shared by all of its requests, so
+///     connections are kept alive and reused from one request to the next, just like with
+///     `http_get()`. Requests beyond `max_num_in_flight` wait in a queue, and each is started as
+///     soon as another one finishes.
+///
+///     HTTP/2 multiplexing is on: many requests in flight to the same HTTP/2 server share one
+///     connection, as separate streams, rather than each needing its own connection. libcurl uses
+///     HTTP/2 for `https` URLs whenever the server supports it; for plain `http` URLs, the server
+///     must be known to support HTTP/2 ahead of time; see `http2_prior_knowledge`. Meanwhile, an
+///     HTTP/1.1 server needs one connection per request in flight.
+///
+///     Each connection is a socket, which costs one fd, so the client keeps up to
+///     `max_num_in_flight` fds open for its connections, idle or not, plus a few of its own (ex:
+///     for DNS lookups). That's on top of whatever else the process has open, and a server in the
+///     same process, like in "curl_lib_batch_benchmark.cpp", needs another fd for its end of each
+///     connection. So with hundreds of requests in flight, check `ulimit -n`, which is often just
+///     1024: once the process is out of fds, new connections fail with "Couldn't connect to
+///     server".
+///
+///     Ex:
+///     ```
+///     curl_lib::BatchClient client(100);
+///     std::vector<std::future<curl_lib::HttpResult>> futures;
+///     for (const std::string& url : urls)
+///     {
+///         futures.push_back(client.http_get(url));
+///     }
+///     for (auto& future : futures)
+///     {
+///         curl_lib::HttpResult result = future.get();
+///         // use `result.response_str`, etc.
+///     }
+///     ```
+///     Destroying the client first waits for every request it was given, including any that
+///     callbacks are still adding, and then closes all of its connections.
+class BatchClient
+{
+public:
+   /// Receives a request's result. It runs on the client's one thread, which also does all of
+   /// the sending and receiving for every other request, so all of them stall until it returns:
+   /// hand any slow work off to another thread. Results come in the order the responses arrive,
+   /// which may differ from the order the requests were made in. A callback may make more
+   /// requests, ex: to keep N in flight, but it must not throw, and must not call `wait_all()` or
+   /// destroy the client, both of which would wait for the callback itself to return.
+   using Callback = std::function<void(HttpResult&& result)>;
+
+   /// \param[in]      max_num_in_flight   The max number of requests in flight at once. 0 is
+   ///                     treated as 1.
+   /// \param[in]      http2_prior_knowledge   If `true`, use HTTP/2 for plain `http` URLs too,
+   ///                     without first asking the server if it supports it. Only use this if it
+   ///                     does!
+   /// \param[in]      ca_info     (Optional) The path to a PEM file of the CA certificates to
+   ///                     trust for `https` URLs, instead of the system's, just like `curl
+   ///                     --cacert`. Ex: a local test server's self-signed certificate.
+   explicit BatchClient(size_t max_num_in_flight, bool http2_prior_knowledge = false,
+      std::string ca_info = "");
+   ~BatchClient();
+
+   BatchClient(const BatchClient&) = delete;
+   BatchClient& operator=(const BatchClient&) = delete;
+
+   /// Queue up an HTTP GET request, just like `http_get()`, returning a future which receives the
+   /// result once the response has arrived, or the request has failed.
+   std::future<HttpResult> http_get(std::string url);
+   /// Same as above, but pass the result to `callback` instead.
+   void http_get(std::string url, Callback callback);
+
+   /// Queue up an HTTP POST request, just like `http_post()`, returning a future which receives
+   /// the result once the response has arrived, or the request has failed.
+   std::future<HttpResult> http_post(std::string url, std::string post_str);
+   /// Same as above, but pass the result to `callback` instead.
+   void http_post(std::string url, std::string post_str, Callback callback);
+
+   /// Block until the result of every request made so far, including any made by callbacks in
+   /// the meantime, has been delivered: its future is ready, or its callback has returned.
+   void wait_all();
+
+private:
+   class Impl;
+   std::unique_ptr<Impl> impl_;
+};
+
+} // namespace curl_lib
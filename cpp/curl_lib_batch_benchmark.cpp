@@ -0,0 +1,352 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark the throughput and the p50/p99 latency of HTTP GET requests made with
+`curl_lib::BatchClient`, at 1 to 1000 requests in flight at once, against the `curl_lib::http_get()`
+baseline, which makes one request at a time.
+
+Each concurrency level is a closed loop: it starts `concurrency` requests, and each request's
+callback starts the next one, until `NUM_REQUESTS_PER_LEVEL` have finished. A request's latency
+is the time from its submission to its callback. It also prints how many new connections were
+opened per request, to show that they are kept alive and reused.
+
+By default, the requests go to a local HTTP/1.1 server, "http_test_server.h", so each request in
+flight needs its own connection, and each connection needs 2 fds in this process: one for the
+client's end, and one for the server's. 1000 in flight is too many for the usual `ulimit -n` of
+1024, so this raises it to its hard limit, and skips any concurrency level which still doesn't fit.
+
+To see HTTP/2 multiplexing, where the requests in flight share one connection, pass the URL of an
+HTTP/2 server instead, plus `--http2` to skip the `curl_lib::http_get()` baseline, which only speaks
+HTTP/1.1. Ex: `bin/a https://example.com/ --http2`.
+For a plain `http` URL, `--http2` also makes it use HTTP/2 without asking the server first. NB: with
+libcurl 7.88.1, though, every request after the first one on such an HTTP/2-without-TLS connection
+failed with "Error in the HTTP2 framing layer", even with the `curl` program itself (`curl
+--http2-prior-knowledge url url`), so use an `https` URL.
+
+To use a local HTTP/2 test server over TLS, with a self-signed certificate, pass that certificate
+with `--cacert`, just like for the `curl` program. Ex: with nghttp2's `nghttpd` server
+(`sudo apt install nghttp2-server`):
+```bash
+mkdir -p /tmp/h2 && cd /tmp/h2
+openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem -out cert.pem -days 30 \
+    -subj "/CN=127.0.0.1" -addext "subjectAltName=IP:127.0.0.1"
+echo "Hello, World!" > index.html
+nghttpd -d /tmp/h2 18443 key.pem cert.pem &
+cd -
+bin/a https://127.0.0.1:18443/index.html --http2 --cacert /tmp/h2/cert.pem
+```
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the steps in "eRCaGuy_hello_world/cpp/README.md" to install the fmt and curl
+# libraries.
+# 2. THEN:
+time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING \
+    curl_lib_batch_benchmark.cpp curl_lib.cpp http_test_server.cpp ../c/timinglib.c \
+    -lfmt -lcurl -o bin/a && bin/a
+```
+
+References:
+1. "curl_lib.h"
+1. "curl_lib_benchmark.cpp"
+1. "http_test_server.h"
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "curl_lib.h"
+#include "http_test_server.h"
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+#include <sys/resource.h>  // For `getrlimit()`, `setrlimit()`
+
+// C and C++ includes
+#include <algorithm>  // For `std::sort()`
+#include <atomic>
+#include <cstdint>    // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>     // For `printf()`
+#include <cstring>    // For `strcmp()`
+#include <functional>
+#include <string>
+#include <vector>
+
+/// The number of requests to make at each concurrency level
+constexpr size_t NUM_REQUESTS_PER_LEVEL = 20000;
+const size_t CONCURRENCY_LEVELS[] = {1, 10, 100, 1000};
+/// fds to leave for everything but the connections: stdio, the client's and server's own fds, etc.
+constexpr size_t NUM_SPARE_FDS = 64;
+
+struct Stats
+{
+    double requests_per_sec = 0;
+    double p50_latency_us = 0;
+    double p99_latency_us = 0;
+    double connections_per_request = 0;
+    bool all_ok = true;
+};
+
+/// Raise this process's soft limit on open fds (`ulimit -n`, often just 1024) as high as it may go,
+/// which is to its hard limit, since at 1000 requests in flight, the client and the local server
+/// need 2 fds per connection between them. Returns the new limit.
+size_t RaiseFdLimit()
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+    {
+        // Assume the usual default
+        return 1024;
+    }
+    if (limit.rlim_cur < limit.rlim_max)
+    {
+        rlim_t old_limit = limit.rlim_cur;
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &limit) == -1)
+        {
+            limit.rlim_cur = old_limit;
+        }
+    }
+    return limit.rlim_cur == RLIM_INFINITY ? SIZE_MAX : (size_t)limit.rlim_cur;
+}
+
+/// Fill in `stats` from each request's latency and the total time taken
+void CalculateStats(std::vector<uint64_t>* latencies_ns, uint64_t elapsed_ns, Stats* stats)
+{
+    std::sort(latencies_ns->begin(), latencies_ns->end());
+    size_t num_requests = latencies_ns->size();
+    stats->requests_per_sec = (double)num_requests * 1e9 / (double)elapsed_ns;
+    stats->p50_latency_us = (double)(*latencies_ns)[num_requests*50/100] / 1000;
+    stats->p99_latency_us = (double)(*latencies_ns)[num_requests*99/100] / 1000;
+}
+
+/// The baseline: make the requests one at a time, with `curl_lib::http_get()`
+Stats BenchmarkSerial(const std::string& url, const std::string& expected_response)
+{
+    Stats stats;
+    std::vector<uint64_t> latencies_ns;
+    latencies_ns.reserve(NUM_REQUESTS_PER_LEVEL);
+    std::string response_str;
+    uint64_t start_ns = nanos();
+    for (size_t i = 0; i < NUM_REQUESTS_PER_LEVEL; i++)
+    {
+        uint64_t request_start_ns = nanos();
+        std::string error = curl_lib::http_get(url.c_str(), &response_str);
+        latencies_ns.push_back(nanos() - request_start_ns);
+        if ((error != curl_lib::ERROR_OK
+            || (!expected_response.empty() && response_str != expected_response))
+            && stats.all_ok)
+        {
+            // only print the first error
+            printf("ERROR requesting \"%s\": %s\n", url.c_str(), error.c_str());
+            stats.all_ok = false;
+        }
+    }
+    CalculateStats(&latencies_ns, nanos() - start_ns, &stats);
+    // `curl_lib::http_get()` doesn't report this; it's 0 after the first request, though
+    stats.connections_per_request = -1;
+    return stats;
+}
+
+/// Keep `concurrency` requests in flight at once with a `curl_lib::BatchClient`
+Stats BenchmarkBatch(const std::string& url, const std::string& expected_response,
+    size_t concurrency, bool http2_prior_knowledge, const std::string& ca_info)
+{
+    Stats stats;
+    std::vector<uint64_t> latencies_ns;
+    latencies_ns.reserve(NUM_REQUESTS_PER_LEVEL);
+    long num_new_connections = 0;
+    // Counts the first `concurrency` requests up front, since their callbacks may start running
+    // on the client's thread before they have all been submitted
+    std::atomic<size_t> num_submitted{concurrency};
+
+    uint64_t start_ns = nanos();
+    {
+        curl_lib::BatchClient client(concurrency, http2_prior_knowledge, ca_info);
+        std::function<void()> submit_one = [&]()
+        {
+            uint64_t request_start_ns = nanos();
+            client.http_get(url, [&, request_start_ns](curl_lib::HttpResult&& result)
+            {
+                latencies_ns.push_back(nanos() - request_start_ns);
+                num_new_connections += result.num_new_connections;
+                if ((result.error != curl_lib::ERROR_OK
+                    || (!expected_response.empty() && result.response_str != expected_response))
+                    && stats.all_ok)
+                {
+                    printf("ERROR requesting \"%s\": %s\n", url.c_str(), result.error.c_str());
+                    stats.all_ok = false;
+                }
+                // Replace this request with the next one
+                if (num_submitted++ < NUM_REQUESTS_PER_LEVEL)
+                {
+                    submit_one();
+                }
+            });
+        };
+        for (size_t i = 0; i < concurrency; i++)
+        {
+            submit_one();
+        }
+        client.wait_all();
+    }
+    CalculateStats(&latencies_ns, nanos() - start_ns, &stats);
+    stats.connections_per_request = (double)num_new_connections / (double)latencies_ns.size();
+    return stats;
+}
+
+void PrintStats(const char* method, size_t concurrency, const Stats& stats)
+{
+    printf("  %-12s %11zu %15.1f %12.1f %12.1f", method, concurrency, stats.requests_per_sec,
+        stats.p50_latency_us, stats.p99_latency_us);
+    if (stats.connections_per_request >= 0)
+    {
+        printf(" %20.4f\n", stats.connections_per_request);
+    }
+    else
+    {
+        printf(" %20s\n", "-");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    // Optional args: `[url [--http2] [--cacert ca.pem]]`
+    std::string url;
+    std::string expected_response;
+    bool http2_prior_knowledge = false;
+    std::string ca_info;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--http2") == 0)
+        {
+            http2_prior_knowledge = true;
+        }
+        else if (strcmp(argv[i], "--cacert") == 0 && i + 1 < argc)
+        {
+            i++;
+            ca_info = argv[i];
+        }
+        else
+        {
+            printf("ERROR: invalid argument \"%s\". Usage: %s [url [--http2] [--cacert ca.pem]]\n",
+                argv[i], argv[0]);
+            return 1;
+        }
+    }
+    http_test_server::HttpTestServer server;
+    if (argc > 1)
+    {
+        // Any response is fine from another server
+        url = argv[1];
+    }
+    else
+    {
+        if (server.get_error() != http_test_server::ERROR_OK)
+        {
+            printf("ERROR: failed to start the test server: %s\n", server.get_error().c_str());
+            return 1;
+        }
+        url = server.get_url("/");
+        expected_response = "Hello, World!\n";
+    }
+
+    printf("%zu GET requests to %s%s, at each concurrency level:\n", NUM_REQUESTS_PER_LEVEL,
+        url.c_str(), http2_prior_knowledge ? ", with HTTP/2 prior knowledge" : "");
+    printf("  %-12s %11s %15s %12s %12s %20s\n", "method", "concurrency", "requests/sec",
+        "p50 (us)", "p99 (us)", "new conns/request");
+
+    // Each request in flight needs a connection, and each connection needs a fd in the client,
+    // plus one in the server, if it's the local one
+    size_t fd_limit = RaiseFdLimit();
+    size_t fds_per_connection = argc > 1 ? 1 : 2;
+    size_t max_concurrency = fd_limit > NUM_SPARE_FDS ?
+        (fd_limit - NUM_SPARE_FDS) / fds_per_connection : 0;
+
+    bool all_ok = true;
+    Stats stats;
+    // `curl_lib::http_get()` only speaks HTTP/1.1, and only trusts the system's CA certificates
+    if (!http2_prior_knowledge && ca_info.empty())
+    {
+        stats = BenchmarkSerial(url, expected_response);
+        all_ok &= stats.all_ok;
+        PrintStats("http_get()", 1, stats);
+    }
+    for (size_t concurrency : CONCURRENCY_LEVELS)
+    {
+        if (concurrency > max_concurrency)
+        {
+            printf("  %-12s %11zu   skipped: needs about %zu fds, but `ulimit -n` is only %zu\n",
+                "BatchClient", concurrency, concurrency*fds_per_connection + NUM_SPARE_FDS,
+                fd_limit);
+            continue;
+        }
+        stats = BenchmarkBatch(url, expected_response, concurrency, http2_prior_knowledge,
+            ca_info);
+        all_ok &= stats.all_ok;
+        PrintStats("BatchClient", concurrency, stats);
+    }
+
+    if (!all_ok)
+    {
+        printf("\nFAILED: some requests failed or gave the wrong response!\n");
+        return 1;
+    }
+    printf("\nAll responses are correct.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM, where the client and the server share the one CPU core, so
+more requests in flight can't make more requests per second; the numbers vary quite a bit from run
+to run). On a real network, with a round trip of milliseconds per request, the requests per second
+would grow with the number in flight instead, until the server or the network can't keep up.
+Throughput falls at 1000 in flight, where the one core also juggles hundreds of connections:
+
+    eRCaGuy_hello_world/cpp$ time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING curl_lib_batch_benchmark.cpp curl_lib.cpp http_test_server.cpp ../c/timinglib.c -lfmt -lcurl -o bin/a && bin/a
+    20000 GET requests to http://127.0.0.1:43287/, at each concurrency level:
+      method       concurrency    requests/sec     p50 (us)     p99 (us)    new conns/request
+      http_get()             1         30878.1         29.7         55.8                    -
+      BatchClient            1         32519.3         29.9         55.6               0.0001
+      BatchClient           10         43459.1        205.1        425.5               0.0005
+      BatchClient          100         36717.3       2463.1       6085.6               0.0050
+      BatchClient         1000         21557.1      42628.9      99044.2               0.0244
+
+    All responses are correct.
+
+With a hard limit of 1024 fds, 1000 in flight is skipped:
+
+    eRCaGuy_hello_world/cpp$ (ulimit -n 1024; bin/a)
+    20000 GET requests to http://127.0.0.1:41801/, at each concurrency level:
+      method       concurrency    requests/sec     p50 (us)     p99 (us)    new conns/request
+      http_get()             1         29596.5         33.1         60.5                    -
+      BatchClient            1         27945.7         35.0         50.4               0.0001
+      BatchClient           10         30419.8        334.1        821.1               0.0005
+      BatchClient          100         34430.0       2438.4       6392.2               0.0050
+      BatchClient         1000   skipped: needs about 2064 fds, but `ulimit -n` is only 1024
+
+    All responses are correct.
+
+With HTTP/2 over TLS, to nghttp2's `nghttpd` test server on this same VM, set up as shown at the
+top of this file. Up to 100 requests in flight share ONE connection: 0.0001 new connections per
+request is 1 of 20000, rounded. At 1000 in flight, curl opens more connections, since `nghttpd`
+allows only 100 requests in flight per connection:
+
+    eRCaGuy_hello_world/cpp$ bin/a https://127.0.0.1:18443/index.html --http2 --cacert /tmp/h2/cert.pem
+    20000 GET requests to https://127.0.0.1:18443/index.html, with HTTP/2 prior knowledge, at each concurrency level:
+      method       concurrency    requests/sec     p50 (us)     p99 (us)    new conns/request
+      BatchClient            1         11115.9         70.6        209.5               0.0001
+      BatchClient           10         12699.6        735.1       1595.7               0.0001
+      BatchClient          100         12127.6       7859.2      23988.5               0.0001
+      BatchClient         1000          2814.6      94363.8    5029837.1               0.0450
+
+    All responses are correct.
+
+*/
@@ -0,0 +1,221 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark HTTP GET and POST requests per second against a local HTTP server,
+"http_test_server.h", with:
+1. `curl_systemcall::http_get()`/`http_post()` - runs the `curl` program, through `/bin/sh`, for
+   each request, so each request also makes a new TCP connection
+2. libcurl, with a new curl easy handle for each request: no new processes, but still a new TCP
+   connection for each request
+3. `curl_lib::http_get()`/`http_post()` - libcurl, reusing this thread's curl easy handle, and
+   therefore its kept-alive connection
+
+...for a small GET response, a small POST, and a 1 MiB GET response. It also prints how many new
+connections the server saw per request. Each response is checked.
+
+Since the server is on the loopback interface, with no TLS, this is the best case for making new
+connections: over a real network, each new connection costs at least one more round trip to the
+server, plus more round trips and a lot more CPU for TLS with https, which the kept-alive
+connections of `curl_lib` don't pay.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the steps in "eRCaGuy_hello_world/cpp/README.md" to install the fmt and curl
+# libraries.
+# 2. THEN:
+time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING \
+    curl_lib_benchmark.cpp curl_lib.cpp curl_systemcall_lib.cpp http_test_server.cpp \
+    systemcall_lib.cpp ../c/timinglib.c -lfmt -lcurl -o bin/a && bin/a
+```
+
+References:
+1. "curl_lib.h"
+1. "curl_systemcall_lib.h"
+1. "http_test_server.h"
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "curl_lib.h"
+#include "curl_systemcall_lib.h"
+#include "http_test_server.h"
+
+// 3rd-party library includes
+#include <curl/curl.h>
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+#include <cstring>  // For `strlen()`
+#include <functional>
+#include <string>
+
+/// Run each request at least this many times, and for at least this long
+constexpr size_t MIN_RUNS = 20;
+constexpr uint64_t MIN_TIME_NS = 2000*1000*1000ULL;
+
+/// One way to make a request: a POST of `post_str` if it's not `nullptr`, or else a GET
+using RequestFunc = std::function<std::string(const char* url, const char* post_str,
+    std::string* response_str)>;
+
+/// A `CURLOPT_WRITEFUNCTION` callback to append the response to a `std::string`
+size_t AppendToString(const char* data, size_t size, size_t count, void* user_data)
+{
+    (void)size;
+    ((std::string*)user_data)->append(data, count);
+    return count;
+}
+
+/// Make a request with a brand new curl easy handle, the way most simple libcurl examples do
+std::string RequestWithNewHandle(const char* url, const char* post_str, std::string* response_str)
+{
+    CURL* curl = curl_easy_init();
+    if (curl == nullptr)
+    {
+        return "curl_easy_init() failed.";
+    }
+    response_str->clear();
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, AppendToString);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, response_str);
+    if (post_str != nullptr)
+    {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_str);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)strlen(post_str));
+    }
+    CURLcode curl_code = curl_easy_perform(curl);
+    // this also closes the connection
+    curl_easy_cleanup(curl);
+    return curl_code == CURLE_OK ? curl_lib::ERROR_OK : curl_easy_strerror(curl_code);
+}
+
+/// \brief      Make a request over and over with `request`, checking each response.
+/// \return     The number of requests made per second, or a negative number if any response was
+///             wrong. `*connections_per_request` receives the number of new connections the server
+///             saw per request.
+double BenchmarkRequest(const RequestFunc& request, const http_test_server::HttpTestServer& server,
+    const std::string& url, const char* post_str, const std::string& expected_response,
+    double* connections_per_request)
+{
+    std::string response_str;
+    size_t num_connections_before = server.get_num_connections();
+    size_t num_runs = 0;
+    uint64_t start_ns = nanos();
+    uint64_t elapsed_ns = 0;
+    while (num_runs < MIN_RUNS || elapsed_ns < MIN_TIME_NS)
+    {
+        std::string error = request(url.c_str(), post_str, &response_str);
+        if (error != curl_lib::ERROR_OK || response_str != expected_response)
+        {
+            printf("ERROR requesting \"%s\": %s\n", url.c_str(), error.c_str());
+            return -1;
+        }
+        num_runs++;
+        elapsed_ns = nanos() - start_ns;
+    }
+    *connections_per_request =
+        (double)(server.get_num_connections() - num_connections_before) / num_runs;
+    return (double)num_runs * 1e9 / (double)elapsed_ns;
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    http_test_server::HttpTestServer server;
+    if (server.get_error() != http_test_server::ERROR_OK)
+    {
+        printf("ERROR: failed to start the test server: %s\n", server.get_error().c_str());
+        return 1;
+    }
+
+    struct Request
+    {
+        const char* name;
+        std::string url;
+        const char* post_str;
+        std::string expected_response;
+    };
+    const Request REQUESTS[] = {
+        {"GET /", server.get_url("/"), nullptr, "Hello, World!\n"},
+        {"POST 22 bytes", server.get_url("/"), "name=Gabe&project=curl",
+            "name=Gabe&project=curl"},
+        {"GET /bytes/1048576", server.get_url("/bytes/1048576"), nullptr,
+            std::string(1048576, 'x')},
+    };
+
+    struct Method
+    {
+        const char* name;
+        RequestFunc request;
+    };
+    const Method METHODS[] = {
+        {"curl_systemcall", [](const char* url, const char* post_str, std::string* response_str)
+        {
+            return post_str == nullptr ? curl_systemcall::http_get(url, response_str)
+                : curl_systemcall::http_post(url, post_str, response_str);
+        }},
+        {"libcurl, new handle", RequestWithNewHandle},
+        {"curl_lib", [](const char* url, const char* post_str, std::string* response_str)
+        {
+            return post_str == nullptr ? curl_lib::http_get(url, response_str)
+                : curl_lib::http_post(url, post_str, response_str);
+        }},
+    };
+
+    printf("Requests per second (new connections per request):\n");
+    printf("  %-20s", "method");
+    for (const Request& request : REQUESTS)
+    {
+        printf(" %26s", request.name);
+    }
+    printf("\n");
+
+    bool all_ok = true;
+    for (const Method& method : METHODS)
+    {
+        printf("  %-20s", method.name);
+        fflush(stdout);
+        for (const Request& request : REQUESTS)
+        {
+            double connections_per_request = 0;
+            double requests_per_sec = BenchmarkRequest(method.request, server, request.url,
+                request.post_str, request.expected_response, &connections_per_request);
+            all_ok &= requests_per_sec >= 0;
+            printf(" %18.1f (%5.3f)", requests_per_sec, connections_per_request);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    if (!all_ok)
+    {
+        printf("\nFAILED: some requests failed or gave the wrong response!\n");
+        return 1;
+    }
+    printf("\nAll responses are correct.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM; the numbers vary quite a bit from run to run). `curl_lib` is
+~500x faster than `curl_systemcall` for small requests, and ~6x faster than libcurl with a new
+handle (and therefore a new connection) per request:
+
+    eRCaGuy_hello_world/cpp$ time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING curl_lib_benchmark.cpp curl_lib.cpp curl_systemcall_lib.cpp http_test_server.cpp systemcall_lib.cpp ../c/timinglib.c -lfmt -lcurl -o bin/a && bin/a
+    Requests per second (new connections per request):
+      method                                    GET /              POST 22 bytes         GET /bytes/1048576
+      curl_systemcall                    87.8 (1.000)               85.4 (1.000)               69.8 (1.000)
+      libcurl, new handle              6729.4 (1.000)             6725.5 (1.000)             1030.9 (1.000)
+      curl_lib                        43303.2 (0.000)            41070.7 (0.000)             1611.6 (0.000)
+
+    All responses are correct.
+
+*/
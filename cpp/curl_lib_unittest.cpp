@@ -0,0 +1,405 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Googletest (gtest) unit tests for curl_lib.h/.cpp, run against a local HTTP server,
+"http_test_server.h", so they need no internet.
+
+STATUS: done & works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the detailed clone and build steps in "eRCaGuy_hello_world/cpp/README.md" in
+# order to prepare to use the following libraries:
+#   1. gtest
+#   1. fmt - use `-lfmt` AND `-DFMT_ENFORCE_COMPILE_STRING` below. See "fmt_lib_demo.cpp"
+#   1. libcurl - use `-lcurl` below
+
+# 2. THEN, build and run this unit test with this command!:
+# NB: the libgtest*.a files MUST come at the end like this!
+time ( \
+    time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread \
+    -I"googletest/googletest/include" -I"googletest/googlemock/include" \
+    -DFMT_ENFORCE_COMPILE_STRING \
+    curl_lib_unittest.cpp \
+    curl_lib.cpp \
+    http_test_server.cpp \
+    bin/libgtest.a bin/libgtest_main.a \
+    -o bin/a \
+    -lfmt -lcurl \
+    && time bin/a \
+)
+```
+
+References:
+1. gtest:
+    1. https://github.com/google/googletest
+        1. https://github.com/google/googletest/blob/main/docs/reference/assertions.md - for
+           `EXPECT_EQ()`, `EXPECT_STREQ()`--for C-strings only, etc.!
+    1. [my answer on how to build gtest with gcc] https://stackoverflow.com/a/72108315/4561887
+1. "curl_systemcall_lib_unittest.cpp"
+
+*/
+
+
+// Local includes
+#include "curl_lib.h"
+#include "http_test_server.h"
+
+// 3rd-party library includes
+// #include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+// Linux includes
+#include <arpa/inet.h>      // For `htonl()`, `htons()`
+#include <fcntl.h>          // For `open()`
+#include <netinet/in.h>     // For `struct sockaddr_in`
+#include <sys/resource.h>   // For `getrlimit()`, `setrlimit()`
+#include <sys/socket.h>
+#include <sys/time.h>       // For `struct timeval`
+#include <unistd.h>         // For `close()`
+
+// C and C++ includes
+#include <atomic>
+#include <cerrno>
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// anonymous namespace
+namespace
+{
+
+using http_test_server::HttpTestServer;
+
+TEST(CurlLibTest, HttpGet)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    std::string response_str;
+    long http_status_code = 0;
+    std::string error = curl_lib::http_get(server.get_url("/").c_str(), &response_str,
+        &http_status_code);
+    EXPECT_EQ(error, curl_lib::ERROR_OK);
+    EXPECT_EQ(response_str, "Hello, World!\n");
+    EXPECT_EQ(http_status_code, 200);
+
+    // Without reading back the response
+    error = curl_lib::http_get(server.get_url("/").c_str());
+    EXPECT_EQ(error, curl_lib::ERROR_OK);
+}
+
+TEST(CurlLibTest, HttpPost)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    std::string response_str = "old contents";
+    std::string error = curl_lib::http_post(server.get_url("/echo").c_str(),
+        "name=Gabe&project=curl", &response_str);
+    EXPECT_EQ(error, curl_lib::ERROR_OK);
+    // The test server echoes back what was posted
+    EXPECT_EQ(response_str, "name=Gabe&project=curl");
+
+    // A body much bigger than 1 KiB, which curl would otherwise hold back until the server
+    // answers `Expect: 100-continue`
+    std::string big_post_str(100000, 'p');
+    error = curl_lib::http_post(server.get_url("/echo").c_str(), big_post_str.c_str(),
+        &response_str);
+    EXPECT_EQ(error, curl_lib::ERROR_OK);
+    EXPECT_EQ(response_str, big_post_str);
+}
+
+/// The response string grows to hold a response of any size
+TEST(CurlLibTest, LargeResponse)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    constexpr size_t NUM_BYTES = 10*1024*1024;
+    std::string response_str;
+    std::string error = curl_lib::http_get(
+        server.get_url(("/bytes/" + std::to_string(NUM_BYTES)).c_str()).c_str(), &response_str);
+    EXPECT_EQ(error, curl_lib::ERROR_OK);
+    EXPECT_EQ(response_str, std::string(NUM_BYTES, 'x'));
+}
+
+/// All requests from one thread to one server go over one kept-alive connection, and each
+/// request's options don't leak into the next
+TEST(CurlLibTest, ReusesTheConnection)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    for (size_t i = 0; i < 20; i++)
+    {
+        std::string response_str;
+        std::string post_str = std::to_string(i);
+        std::string error = curl_lib::http_post(server.get_url("/echo").c_str(),
+            post_str.c_str(), &response_str);
+        EXPECT_EQ(error, curl_lib::ERROR_OK);
+        EXPECT_EQ(response_str, post_str);
+
+        // A GET right after a POST must not still be a POST
+        error = curl_lib::http_get(server.get_url("/").c_str(), &response_str);
+        EXPECT_EQ(error, curl_lib::ERROR_OK);
+        EXPECT_EQ(response_str, "Hello, World!\n");
+    }
+    EXPECT_EQ(server.get_num_requests(), 40U);
+    EXPECT_EQ(server.get_num_connections(), 1U);
+}
+
+/// Each thread has its own handle, and therefore its own connection
+TEST(CurlLibTest, OneConnectionPerThread)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_REQUESTS_PER_THREAD = 50;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NUM_THREADS; i++)
+    {
+        threads.emplace_back([&server, i]()
+        {
+            for (size_t j = 0; j < NUM_REQUESTS_PER_THREAD; j++)
+            {
+                std::string response_str;
+                std::string post_str = std::to_string(i) + "-" + std::to_string(j);
+                std::string error = curl_lib::http_post(server.get_url("/").c_str(),
+                    post_str.c_str(), &response_str);
+                EXPECT_EQ(error, curl_lib::ERROR_OK);
+                EXPECT_EQ(response_str, post_str);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(server.get_num_requests(), NUM_THREADS*NUM_REQUESTS_PER_THREAD);
+    EXPECT_EQ(server.get_num_connections(), NUM_THREADS);
+}
+
+TEST(CurlLibTest, Errors)
+{
+    std::string error = curl_lib::http_get(nullptr);
+    EXPECT_EQ(error, "INVALID ARGUMENT: nullptr");
+    error = curl_lib::http_post("http://127.0.0.1/", nullptr);
+    EXPECT_EQ(error, "INVALID ARGUMENT: nullptr");
+
+    // Nothing is listening on the port of a server which has been stopped
+    std::string url;
+    {
+        HttpTestServer server;
+        ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+        url = server.get_url("/");
+    }
+    std::string response_str;
+    error = curl_lib::http_get(url.c_str(), &response_str);
+    EXPECT_NE(error.find("Couldn't connect to server"), std::string::npos) << error;
+
+    error = curl_lib::http_get("not a url", &response_str);
+    EXPECT_NE(error, curl_lib::ERROR_OK);
+}
+
+TEST(BatchClientTest, ManyRequestsWithFutures)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    constexpr size_t NUM_REQUESTS = 200;
+    curl_lib::BatchClient client(10);
+    std::vector<std::future<curl_lib::HttpResult>> futures;
+    for (size_t i = 0; i < NUM_REQUESTS; i++)
+    {
+        if (i % 2 == 0)
+        {
+            futures.push_back(client.http_post(server.get_url("/echo"), std::to_string(i)));
+        }
+        else
+        {
+            futures.push_back(client.http_get(server.get_url(
+                ("/bytes/" + std::to_string(i)).c_str())));
+        }
+    }
+    for (size_t i = 0; i < NUM_REQUESTS; i++)
+    {
+        curl_lib::HttpResult result = futures[i].get();
+        EXPECT_EQ(result.error, curl_lib::ERROR_OK);
+        EXPECT_EQ(result.http_status_code, 200);
+        EXPECT_EQ(result.response_str, i % 2 == 0 ? std::to_string(i) : std::string(i, 'x'));
+    }
+    EXPECT_EQ(server.get_num_requests(), NUM_REQUESTS);
+    // The connections are kept alive and reused, and there are never more of them than requests
+    // in flight
+    EXPECT_LE(server.get_num_connections(), 10U);
+}
+
+TEST(BatchClientTest, Callbacks)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    constexpr size_t NUM_REQUESTS = 100;
+    std::atomic<size_t> num_ok{0};
+    std::atomic<long> num_new_connections{0};
+    curl_lib::BatchClient client(4);
+    for (size_t i = 0; i < NUM_REQUESTS; i++)
+    {
+        std::string post_str = std::to_string(i);
+        client.http_post(server.get_url("/echo"), post_str,
+            [&, post_str](curl_lib::HttpResult&& result)
+        {
+            if (result.error == curl_lib::ERROR_OK && result.response_str == post_str)
+            {
+                num_ok++;
+            }
+            num_new_connections += result.num_new_connections;
+        });
+    }
+    client.wait_all();
+    EXPECT_EQ(num_ok, NUM_REQUESTS);
+    EXPECT_EQ(num_new_connections, (long)server.get_num_connections());
+    EXPECT_LE(server.get_num_connections(), 4U);
+
+    // Big POSTs, which curl would otherwise hold back until the server answers
+    // `Expect: 100-continue`
+    std::string big_post_str(100000, 'p');
+    curl_lib::HttpResult result = client.http_post(server.get_url("/echo"), big_post_str).get();
+    EXPECT_EQ(result.error, curl_lib::ERROR_OK);
+    EXPECT_EQ(result.response_str, big_post_str);
+}
+
+/// A callback may submit more requests, ex: to keep a fixed number of requests in flight
+TEST(BatchClientTest, CallbackSubmitsMore)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    constexpr size_t NUM_REQUESTS = 50;
+    size_t num_done = 0;  // only used by the client's thread
+    {
+        // Declared before the client, so that it outlives the client's destructor, which waits
+        // for the last callbacks
+        std::function<void(curl_lib::HttpResult&&)> on_done;
+        curl_lib::BatchClient client(1);
+        on_done = [&](curl_lib::HttpResult&& result)
+        {
+            EXPECT_EQ(result.error, curl_lib::ERROR_OK);
+            EXPECT_EQ(result.response_str, "Hello, World!\n");
+            num_done++;
+            if (num_done < NUM_REQUESTS)
+            {
+                client.http_get(server.get_url("/"), on_done);
+            }
+        };
+        client.http_get(server.get_url("/"), on_done);
+        // The destructor waits for all of them, including those submitted by callbacks
+    }
+    EXPECT_EQ(num_done, NUM_REQUESTS);
+    EXPECT_EQ(server.get_num_connections(), 1U);
+}
+
+TEST(BatchClientTest, Errors)
+{
+    // Nothing is listening on the port of a server which has been stopped
+    std::string url;
+    {
+        HttpTestServer server;
+        ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+        url = server.get_url("/");
+    }
+
+    curl_lib::BatchClient client(0);
+    std::future<curl_lib::HttpResult> future1 = client.http_get(url);
+    std::future<curl_lib::HttpResult> future2 = client.http_post("not a url", "data");
+    std::future<curl_lib::HttpResult> future3 = client.http_get("");
+
+    curl_lib::HttpResult result = future1.get();
+    EXPECT_NE(result.error.find("Couldn't connect to server"), std::string::npos)
+        << result.error;
+    EXPECT_EQ(result.http_status_code, 0);
+    EXPECT_NE(future2.get().error, curl_lib::ERROR_OK);
+    EXPECT_NE(future3.get().error, curl_lib::ERROR_OK);
+
+    // The client still works after errors
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+    result = client.http_get(server.get_url("/")).get();
+    EXPECT_EQ(result.error, curl_lib::ERROR_OK);
+    EXPECT_EQ(result.response_str, "Hello, World!\n");
+}
+
+/// When this process is out of fds, the server closes each new connection right away, rather than
+/// leaving it waiting, unanswered, forever, while its thread busy-loops on the listen socket
+TEST(HttpTestServerTest, DropsConnectionsWhenOutOfFds)
+{
+    HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    // Create the client sockets now, but connect them only once there are no fds left
+    constexpr size_t NUM_CLIENTS = 5;
+    int client_fds[NUM_CLIENTS];
+    for (int& client_fd : client_fds)
+    {
+        client_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ASSERT_GE(client_fd, 0);
+        // Don't wait forever on the server, if it's broken
+        struct timeval timeout = {10, 0};
+        setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    // Use up every fd: lower the limit to just above the fds open now, and fill in the rest
+    struct rlimit old_limit;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &old_limit), 0);
+    struct rlimit limit = old_limit;
+    limit.rlim_cur = (rlim_t)client_fds[NUM_CLIENTS - 1] + 16;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limit), 0);
+    std::vector<int> filler_fds;
+    int fd;
+    while ((fd = open("/dev/null", O_RDONLY | O_CLOEXEC)) >= 0)
+    {
+        filler_fds.push_back(fd);
+    }
+    EXPECT_EQ(errno, EMFILE);
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(server.get_port());
+    for (int client_fd : client_fds)
+    {
+        // The kernel completes the connection, into the listen queue, whether or not the server
+        // can accept it
+        EXPECT_EQ(connect(client_fd, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    }
+    for (int client_fd : client_fds)
+    {
+        char c;
+        ssize_t num_bytes_read = recv(client_fd, &c, 1, 0);
+        // Closed by the server, rather than timing out
+        EXPECT_TRUE(num_bytes_read == 0 || (num_bytes_read == -1 && errno == ECONNRESET))
+            << "num_bytes_read = " << num_bytes_read << ", errno = " << errno;
+        close(client_fd);
+    }
+
+    for (int filler_fd : filler_fds)
+    {
+        close(filler_fd);
+    }
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &old_limit), 0);
+    EXPECT_EQ(server.get_num_dropped_connections(), NUM_CLIENTS);
+    EXPECT_EQ(server.get_num_connections(), 0U);
+
+    // The server still works, with fds to spare again
+    std::string response_str;
+    EXPECT_EQ(curl_lib::http_get(server.get_url("/").c_str(), &response_str), curl_lib::ERROR_OK);
+    EXPECT_EQ(response_str, "Hello, World!\n");
+}
+
+} // anonymous namespace
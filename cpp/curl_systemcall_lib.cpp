@@ -28,6 +28,30 @@ References:
 namespace curl_systemcall
 {
 
+std::string http_get(const char* url, std::string* response_str)
+{
+    std::string error = ERROR_OK;
+
+    if (url == nullptr)
+    {
+        error = "INVALID ARGUMENT: nullptr";
+        return error;
+    }
+
+    int cmd_return_code;
+    // `--silent --show-error`: no progress meter on `stderr`, but still print any errors there
+    std::string cmd = fmt::format(FMT_STRING("curl --silent --show-error \"{}\""), url);
+
+    error = systemcall::system_call(cmd.c_str(), response_str, &cmd_return_code);
+    if (error != ERROR_OK)
+    {
+        error = fmt::format(FMT_STRING("Curl system call failed: error msg: \"{}\"; "
+            "cmd_return_code: {}."), error, cmd_return_code);
+    }
+
+    return error;
+}
+
 std::string http_post(const char* url, const char* post_str, std::string* response_str)
 {
     std::string error = ERROR_OK;
@@ -39,7 +63,9 @@ std::string http_post(const char* url, const char* post_str, std::string* respon
     }
 
     int cmd_return_code;
-    std::string cmd = fmt::format(FMT_STRING("curl --data \"{}\" -X POST \"{}\""), post_str, url);
+    // `--silent --show-error`: see `http_get()`
+    std::string cmd = fmt::format(FMT_STRING("curl --silent --show-error --data \"{}\" -X POST "
+        "\"{}\""), post_str, url);
 
     error = systemcall::system_call(cmd.c_str(), response_str, &cmd_return_code);
     if (error != ERROR_OK)
@@ -8,7 +8,8 @@ This is a basic Linux C++ library to wrap the command-line `curl` call into a C+
 system call via a pipe (with `popen()`) so I can read back the response.
 
 NB: an alternative would be to write a C++ wrapper around the C library, `libcurl`, but I'll do that
-in another file and example instead, so I can compare the two options, including speed!
+in another file and example instead, so I can compare the two options, including speed! See
+"curl_lib.h" and "curl_lib_benchmark.cpp".
 
 TODO:
 1.
@@ -22,6 +23,7 @@ References:
 1. "eRCaGuy_hello_world/cpp/curl_rest_api_http_post_and_get.c" - great example of the
    libcurl C library
 1. "systemcall_lib.h/.cpp"
+1. "curl_lib.h" - the same thing, using the libcurl C library, which is much faster
 
 */
 
@@ -47,8 +49,14 @@ namespace curl_systemcall
 /// error code indicating no error
 constexpr char ERROR_OK[] = "OK";
 
-/// TODO: add this
-// std::string http_get(const char* url, std::string* response_str = nullptr);
+/// \brief          Send an HTTP REST API GET command.
+/// \details        This is essentially equivalent to the following command-line command:
+///     `curl "url"`. Ex: `curl "https://example.com"`.
+/// \param[in]      url             A null-terminated URL to send the GET command to.
+/// \param[out]     response_str    (Optional) A string to receive the response back, if desired.
+/// \return         An error string to describe the error if there is an error, or
+///                 `ERROR_OK` otherwise.
+std::string http_get(const char* url, std::string* response_str = nullptr);
 
 /// \brief          Send an HTTP REST API POST command.
 /// \details        This is essentially equivalent to the following command-line command:
@@ -23,6 +23,7 @@ time ( \
     -DFMT_ENFORCE_COMPILE_STRING \
     curl_systemcall_lib_unittest.cpp \
     curl_systemcall_lib.cpp \
+    http_test_server.cpp \
     systemcall_lib.cpp \
     bin/libgtest.a bin/libgtest_main.a \
     -o bin/a \
@@ -44,6 +45,7 @@ References:
 
 // Local includes
 #include "curl_systemcall_lib.h"
+#include "http_test_server.h"
 
 // 3rd-party library includes
 // #include "gmock/gmock.h"
@@ -76,6 +78,30 @@ TEST(CurlSystemCallTest, PostToPublicRestApiServer)
     EXPECT_EQ(response_str, EXPECTED_RESPONSE_STR);
 }
 
+/// GET and POST against a local server, "http_test_server.h", which needs no internet
+TEST(CurlSystemCallTest, GetAndPostToLocalServer)
+{
+    http_test_server::HttpTestServer server;
+    ASSERT_EQ(server.get_error(), http_test_server::ERROR_OK);
+
+    std::string response_str;
+    std::string error = curl_systemcall::http_get(server.get_url("/").c_str(), &response_str);
+    EXPECT_EQ(error, curl_systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, "Hello, World!\n");
+
+    // The test server echoes back what was posted
+    error = curl_systemcall::http_post(server.get_url("/").c_str(), "name=Gabe&project=curl",
+        &response_str);
+    EXPECT_EQ(error, curl_systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, "name=Gabe&project=curl");
+
+    // Each call is a new `curl` process, so it makes a new connection
+    EXPECT_EQ(server.get_num_connections(), 2U);
+
+    error = curl_systemcall::http_get(nullptr);
+    EXPECT_EQ(error, "INVALID ARGUMENT: nullptr");
+}
+
 } // anonymous namespace
 
 
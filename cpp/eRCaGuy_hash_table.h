@@ -0,0 +1,579 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+eRCaGuy_hash_table: a fast, cache-friendly hash table with string keys. It maps a string key to a
+value of any type `T`, and is meant as a drop-in replacement for the common
+`std::unordered_map<std::string, T>` use case, where speed matters.
+
+How it differs from `std::unordered_map<std::string, T>`:
+1. Open addressing, SwissTable-style: instead of a linked list of heap-allocated nodes per bucket,
+   all slots live in one flat array, and each slot has a 1-byte "control byte" in a separate array,
+   which holds either EMPTY, DELETED (a tombstone), or the low 7 bits of the key's hash. A lookup
+   loads 16 control bytes at once and compares them all to the key's 7 hash bits with 2 SSE2
+   instructions, so it only has to compare the actual key in slots which are ~99% (127/128)
+   likely to hold it. Most lookups touch just 1 cache line of control bytes and 1 slot.
+2. The key chars are stored in an arena (big blocks of chars) owned by the table, not in one
+   `std::string` per key, so inserting a key with more chars than fit in `std::string`'s
+   small-string buffer doesn't need its own heap allocation. The arena is compacted whenever the
+   table is rehashed, so the chars of erased keys don't pile up forever.
+3. Heterogeneous lookup: `Find()`, `Insert()`, `Erase()`, etc. take a `std::string_view`, so you can
+   look up a key from a C-string, a `std::string`, or a slice of a bigger buffer without building a
+   temporary `std::string` just for the lookup. (`std::unordered_map` only gets this in C++20.)
+4. The capacity is always a power of 2, and the table grows 2x when it becomes 7/8 full.
+
+Limitations:
+1. `T` must be default-constructible and move-assignable, since every slot holds a `T`, even
+   empty slots.
+2. Pointers to values, and `std::string_view`s of keys from `ForEach()`, are invalidated by any
+   insert which grows the table, and by `Reserve()`, `Rehash()`, and `Clear()`.
+3. NOT thread-safe.
+
+STATUS: done and works!
+
+To compile and run:
+- See "eRCaGuy_hash_table_unittest.cpp" and "eRCaGuy_hash_table_benchmark.cpp" as examples.
+
+References:
+1. "c/TODO/string_literals_test_for_eRCaGuy_hash_table.c" - where I first planned this library
+1. Matt Kulukundis, "Designing a Fast, Efficient, Cache-friendly Hash Table, Step by Step",
+   CppCon 2017: https://www.youtube.com/watch?v=ncHmEUmJZf4
+1. Abseil's SwissTable design notes: https://abseil.io/about/design/swisstables
+1. Wang Yi's wyhash, which the string hash function here is based on:
+   https://github.com/wangyi-fudan/wyhash
+
+*/
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstddef>  // For `size_t`
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstring>  // For `memcpy()`
+#include <memory>   // For `std::unique_ptr`
+#include <string_view>
+#include <utility>  // For `std::move()`, `std::pair`
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hash_table
+{
+
+/// \brief      Hash `len` chars at `data` into a 64-bit hash, a few chars at a time. A simplified
+///             version of wyhash: fast for both short and long keys, and good enough that all 64
+///             bits are usable, so the table can use the low 7 bits as the control byte hash and
+///             the high bits to pick the slot.
+inline uint64_t HashString(const char* data, size_t len)
+{
+    constexpr uint64_t P0 = 0xa0761d6478bd642fULL;
+    constexpr uint64_t P1 = 0xe7037ed1a0b428dbULL;
+    constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+
+    // Multiply 2 64-bit numbers into a 128-bit product, and fold it back into 64 bits.
+    auto mix = [](uint64_t a, uint64_t b)
+    {
+        __uint128_t product = (__uint128_t)a * b;
+        return (uint64_t)product ^ (uint64_t)(product >> 64);
+    };
+    auto read64 = [](const char* p)
+    {
+        uint64_t val;
+        memcpy(&val, p, sizeof(val));
+        return val;
+    };
+    auto read32 = [](const char* p)
+    {
+        uint32_t val;
+        memcpy(&val, p, sizeof(val));
+        return (uint64_t)val;
+    };
+
+    uint64_t hash = P0 ^ mix(len ^ P1, P2);
+    const char* p = data;
+    size_t remaining = len;
+    while (remaining > 16)
+    {
+        hash = mix(read64(p) ^ P1, read64(p + 8) ^ hash);
+        p += 16;
+        remaining -= 16;
+    }
+
+    // Read the last 1 to 16 chars as 2 (possibly overlapping) words
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (remaining >= 8)
+    {
+        a = read64(p);
+        b = read64(p + remaining - 8);
+    }
+    else if (remaining >= 4)
+    {
+        a = read32(p);
+        b = read32(p + remaining - 4);
+    }
+    else if (remaining > 0)
+    {
+        a = ((uint64_t)(uint8_t)p[0] << 16) | ((uint64_t)(uint8_t)p[remaining / 2] << 8)
+            | (uint64_t)(uint8_t)p[remaining - 1];
+    }
+    return mix(mix(a ^ P1, b ^ hash) ^ len, P0);
+}
+
+/// Stores the chars of many strings in big blocks, so each string doesn't need its own heap
+/// allocation. Strings can only be added, never removed one at a time; only all at once, by
+/// destroying or `Clear()`ing the arena.
+class StringArena
+{
+public:
+    /// \brief      Copy `str`'s chars into the arena.
+    /// \return     A view of the copy, which stays valid until the arena is cleared or destroyed
+    std::string_view Store(std::string_view str)
+    {
+        if (str.size() > BLOCK_SIZE / 4)
+        {
+            // Give big strings their own block, so they don't waste the rest of the current one
+            blocks_.push_back(std::make_unique<char[]>(str.size()));
+            memcpy(blocks_.back().get(), str.data(), str.size());
+            num_bytes_ += str.size();
+            return std::string_view(blocks_.back().get(), str.size());
+        }
+        if (str.size() > BLOCK_SIZE - block_used_ || current_block_ == nullptr)
+        {
+            blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            current_block_ = blocks_.back().get();
+            block_used_ = 0;
+        }
+        char* dest = current_block_ + block_used_;
+        // `memcpy()` with a null `str.data()` is undefined, even for 0 chars
+        if (!str.empty())
+        {
+            memcpy(dest, str.data(), str.size());
+        }
+        block_used_ += str.size();
+        num_bytes_ += str.size();
+        return std::string_view(dest, str.size());
+    }
+
+    /// Free all of the strings.
+    void Clear()
+    {
+        blocks_.clear();
+        current_block_ = nullptr;
+        block_used_ = 0;
+        num_bytes_ = 0;
+    }
+
+    /// Get the total number of chars stored, including those of strings no longer in use.
+    size_t NumBytes() const
+    {
+        return num_bytes_;
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 16*1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    /// The block which small strings are currently added to
+    char* current_block_ = nullptr;
+    size_t block_used_ = 0;
+    size_t num_bytes_ = 0;
+};
+
+/// An open-addressing hash table from string keys to values of type `T`. See the top of this file
+/// for details.
+template <typename T>
+class StringHashTable
+{
+public:
+    StringHashTable() = default;
+
+    /// A table with room for at least `num_keys` keys without growing
+    explicit StringHashTable(size_t num_keys)
+    {
+        Reserve(num_keys);
+    }
+
+    /// Moving a table is cheap: it moves the arrays. The moved-from table is left empty.
+    StringHashTable(StringHashTable&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    StringHashTable& operator=(StringHashTable&& other) noexcept
+    {
+        ctrl_ = std::move(other.ctrl_);
+        slots_ = std::move(other.slots_);
+        arena_ = std::move(other.arena_);
+        mask_ = other.mask_;
+        size_ = other.size_;
+        growth_left_ = other.growth_left_;
+        other.ctrl_.clear();
+        other.slots_.clear();
+        other.arena_.Clear();
+        other.mask_ = 0;
+        other.size_ = 0;
+        other.growth_left_ = 0;
+        return *this;
+    }
+
+    // Copying is not supported, since the keys' views point into the table's own arena
+    StringHashTable(const StringHashTable&) = delete;
+    StringHashTable& operator=(const StringHashTable&) = delete;
+
+    /// \brief      Find `key`.
+    /// \return     A pointer to its value, or `nullptr` if it isn't in the table
+    T* Find(std::string_view key)
+    {
+        size_t i = FindSlot(key, HashString(key.data(), key.size()));
+        return i == NOT_FOUND ? nullptr : &slots_[i].value;
+    }
+
+    const T* Find(std::string_view key) const
+    {
+        return const_cast<StringHashTable*>(this)->Find(key);
+    }
+
+    bool Contains(std::string_view key) const
+    {
+        return Find(key) != nullptr;
+    }
+
+    /// \brief      Insert `key` with `value`, unless `key` is already in the table, in which case
+    ///             its value is left as-is.
+    /// \return     A pointer to the key's value, and whether or not it was inserted
+    std::pair<T*, bool> Insert(std::string_view key, T value)
+    {
+        std::pair<T*, bool> result = FindOrPrepareInsert(key);
+        if (result.second)
+        {
+            *result.first = std::move(value);
+        }
+        return result;
+    }
+
+    /// \brief      Insert `key` with `value`, or, if `key` is already in the table, replace its
+    ///             value with `value`.
+    /// \return     A pointer to the key's value, and whether or not it was inserted
+    std::pair<T*, bool> InsertOrAssign(std::string_view key, T value)
+    {
+        std::pair<T*, bool> result = FindOrPrepareInsert(key);
+        *result.first = std::move(value);
+        return result;
+    }
+
+    /// Same as `std::unordered_map::operator[]`: get a reference to `key`'s value, first inserting
+    /// `key` with a default-constructed value if it isn't already in the table.
+    T& operator[](std::string_view key)
+    {
+        return *FindOrPrepareInsert(key).first;
+    }
+
+    /// \brief      Remove `key` and its value from the table.
+    /// \return     Whether or not `key` was in the table
+    bool Erase(std::string_view key)
+    {
+        size_t i = FindSlot(key, HashString(key.data(), key.size()));
+        if (i == NOT_FOUND)
+        {
+            return false;
+        }
+        // Leave a tombstone, not an EMPTY control byte, so lookups of keys which probed past this
+        // slot when they were inserted don't stop here. Tombstones are reused by inserts, and
+        // cleared by the next rehash.
+        SetCtrl(i, DELETED);
+        slots_[i].key = std::string_view();
+        // Release whatever the value holds now (ex: a `std::string`'s heap buffer)
+        slots_[i].value = T();
+        size_--;
+        return true;
+    }
+
+    /// Call `func(std::string_view key, T& value)` for each key in the table, in no particular
+    /// order. Don't insert or erase keys from within `func`.
+    template <typename Func>
+    void ForEach(Func func)
+    {
+        for (size_t i = 0; i < slots_.size(); i++)
+        {
+            if (IsFull(ctrl_[i]))
+            {
+                func(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+    /// Remove all keys, and free all memory.
+    void Clear()
+    {
+        ctrl_.clear();
+        slots_.clear();
+        arena_.Clear();
+        mask_ = 0;
+        size_ = 0;
+        growth_left_ = 0;
+    }
+
+    /// Make room for at least `num_keys` keys, so inserting up to that many won't need a rehash.
+    void Reserve(size_t num_keys)
+    {
+        size_t capacity = CapacityFor(num_keys);
+        if (capacity > Capacity())
+        {
+            Rehash(capacity);
+        }
+    }
+
+    size_t Size() const
+    {
+        return size_;
+    }
+
+    bool Empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// Get the number of slots (a power of 2, or 0 before the first insert).
+    size_t Capacity() const
+    {
+        return slots_.size();
+    }
+
+private:
+    /// Control bytes: EMPTY and DELETED have bit 7 set; a full slot's control byte is the low 7
+    /// bits of its key's hash (0 to 127).
+    static constexpr int8_t EMPTY = -128;  // 0x80
+    static constexpr int8_t DELETED = -2;  // 0xFE
+    static constexpr size_t GROUP_SIZE = 16;
+    static constexpr size_t MIN_CAPACITY = GROUP_SIZE;
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    struct Slot
+    {
+        std::string_view key;
+        T value = T();
+    };
+
+    static bool IsFull(int8_t ctrl)
+    {
+        return ctrl >= 0;
+    }
+
+    /// The 7 bits of the hash stored in a full slot's control byte
+    static int8_t H2(uint64_t hash)
+    {
+        return (int8_t)(hash & 0x7F);
+    }
+
+    /// The hash bits which pick the first group to probe: the rest of the hash, so they are
+    /// independent of `H2()`'s bits
+    static size_t H1(uint64_t hash)
+    {
+        return (size_t)(hash >> 7);
+    }
+
+    /// Get the smallest capacity with room for `num_keys` keys at a max load factor of 7/8.
+    static size_t CapacityFor(size_t num_keys)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity - capacity / 8 < num_keys)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    /// A bit mask with bit `j` set for each control byte `ctrl_[pos + j]` (for `j` = 0 to 15) which
+    /// matches `h2`, or, with `MatchEmpty()`, which is EMPTY. This reads past the end of the
+    /// table for `pos` > `Capacity() - 16`, which is what the `GROUP_SIZE` extra cloned control
+    /// bytes at the end are for.
+    uint32_t Match(size_t pos, int8_t h2) const
+    {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128((const __m128i*)&ctrl_[pos]);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#else
+        uint32_t mask = 0;
+        for (size_t j = 0; j < GROUP_SIZE; j++)
+        {
+            mask |= (uint32_t)(ctrl_[pos + j] == h2) << j;
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t MatchEmpty(size_t pos) const
+    {
+        return Match(pos, EMPTY);
+    }
+
+    /// A bit mask with bit `j` set for each control byte `ctrl_[pos + j]` which is EMPTY or DELETED
+    uint32_t MatchEmptyOrDeleted(size_t pos) const
+    {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128((const __m128i*)&ctrl_[pos]);
+        // EMPTY and DELETED are the only control bytes with bit 7 set
+        return (uint32_t)_mm_movemask_epi8(group);
+#else
+        uint32_t mask = 0;
+        for (size_t j = 0; j < GROUP_SIZE; j++)
+        {
+            mask |= (uint32_t)!IsFull(ctrl_[pos + j]) << j;
+        }
+        return mask;
+#endif
+    }
+
+    /// Set slot `i`'s control byte, and its clone at the end of the table, if it has one.
+    void SetCtrl(size_t i, int8_t ctrl)
+    {
+        ctrl_[i] = ctrl;
+        if (i < GROUP_SIZE)
+        {
+            ctrl_[Capacity() + i] = ctrl;
+        }
+    }
+
+    /// \brief      Find the slot of `key`, which has hash `hash`.
+    /// \details    Probe groups of 16 slots, starting at `H1(hash)`, and then at offsets of 16, 48,
+    ///             96, ... slots (triangular numbers times 16) from it, which visits every slot
+    ///             once the capacity is a power of 2. Stop at the first group with an EMPTY slot,
+    ///             since an insert of `key` would have stopped there too.
+    /// \return     The slot index, or `NOT_FOUND`
+    size_t FindSlot(std::string_view key, uint64_t hash) const
+    {
+        if (size_ == 0)
+        {
+            return NOT_FOUND;
+        }
+        const int8_t h2 = H2(hash);
+        size_t pos = H1(hash) & mask_;
+        for (size_t step = GROUP_SIZE; ; step += GROUP_SIZE)
+        {
+            for (uint32_t match = Match(pos, h2); match != 0; match &= match - 1)
+            {
+                size_t i = (pos + __builtin_ctz(match)) & mask_;
+                if (slots_[i].key == key)
+                {
+                    return i;
+                }
+            }
+            if (MatchEmpty(pos) != 0)
+            {
+                return NOT_FOUND;
+            }
+            pos = (pos + step) & mask_;
+        }
+    }
+
+    /// Find the first EMPTY or DELETED slot in `hash`'s probe sequence. There always is one, since
+    /// the table is never more than 7/8 full.
+    size_t FindFirstNonFull(uint64_t hash) const
+    {
+        size_t pos = H1(hash) & mask_;
+        for (size_t step = GROUP_SIZE; ; step += GROUP_SIZE)
+        {
+            uint32_t match = MatchEmptyOrDeleted(pos);
+            if (match != 0)
+            {
+                return (pos + __builtin_ctz(match)) & mask_;
+            }
+            pos = (pos + step) & mask_;
+        }
+    }
+
+    /// \brief      Find `key`, or if it isn't in the table, insert it with a default-constructed
+    ///             value, growing or cleaning up the table first if needed.
+    /// \return     A pointer to the key's value, and whether or not it was inserted
+    std::pair<T*, bool> FindOrPrepareInsert(std::string_view key)
+    {
+        const uint64_t hash = HashString(key.data(), key.size());
+        size_t i = FindSlot(key, hash);
+        if (i != NOT_FOUND)
+        {
+            return {&slots_[i].value, false};
+        }
+
+        i = Capacity() == 0 ? NOT_FOUND : FindFirstNonFull(hash);
+        // Reusing a tombstone doesn't use up any more of the table, but filling an EMPTY slot does
+        if (i == NOT_FOUND || (ctrl_[i] == EMPTY && growth_left_ == 0))
+        {
+            // If at least half of the used-up room is tombstones, rehash at the same capacity to
+            // clear them out, else grow
+            size_t capacity = Capacity();
+            if (capacity == 0)
+            {
+                capacity = MIN_CAPACITY;
+            }
+            else if (size_ >= (capacity - capacity / 8) / 2)
+            {
+                capacity *= 2;
+            }
+            Rehash(capacity);
+            i = FindFirstNonFull(hash);
+        }
+
+        if (ctrl_[i] == EMPTY)
+        {
+            growth_left_--;
+        }
+        SetCtrl(i, H2(hash));
+        slots_[i].key = arena_.Store(key);
+        size_++;
+        return {&slots_[i].value, true};
+    }
+
+    /// Move all keys and values into a new table with `capacity` slots (a power of 2), which
+    /// clears out all tombstones, and copy the keys into a new arena, which drops the chars of all
+    /// erased keys.
+    void Rehash(size_t capacity)
+    {
+        std::vector<int8_t> old_ctrl = std::move(ctrl_);
+        std::vector<Slot> old_slots = std::move(slots_);
+        StringArena old_arena = std::move(arena_);
+
+        ctrl_.assign(capacity + GROUP_SIZE, EMPTY);
+        slots_ = std::vector<Slot>(capacity);
+        arena_ = StringArena();
+        mask_ = capacity - 1;
+        growth_left_ = capacity - capacity / 8 - size_;
+
+        for (size_t i = 0; i < old_slots.size(); i++)
+        {
+            if (!IsFull(old_ctrl[i]))
+            {
+                continue;
+            }
+            std::string_view key = old_slots[i].key;
+            uint64_t hash = HashString(key.data(), key.size());
+            size_t new_i = FindFirstNonFull(hash);
+            SetCtrl(new_i, H2(hash));
+            slots_[new_i].key = arena_.Store(key);
+            slots_[new_i].value = std::move(old_slots[i].value);
+        }
+    }
+
+    /// `Capacity() + GROUP_SIZE` control bytes, one per slot, and then clones of the first
+    /// `GROUP_SIZE` ones, so a group of 16 can be loaded from any slot without wrapping around
+    std::vector<int8_t> ctrl_;
+    std::vector<Slot> slots_;
+    StringArena arena_;
+    /// `Capacity() - 1`, to wrap a slot index around the table with a bitwise AND
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    /// How many more EMPTY slots can be filled before the table is 7/8 full
+    size_t growth_left_ = 0;
+};
+
+} // namespace hash_table
@@ -0,0 +1,354 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark `hash_table::StringHashTable` from "eRCaGuy_hash_table.h" against
+`std::unordered_map<std::string, uint64_t>`, for these operations, in ns per operation:
+1. insert: insert N new keys into an empty table, letting it grow as needed
+2. lookup-hit: look up each of the N keys, in a random order
+3. lookup-miss: look up N other keys, which are not in the table
+4. erase: erase each of the N keys, in a random order
+
+The keys are `std::string_view`s into one big buffer of chars, which is how keys usually arrive
+when parsing a file or a network packet. So, `std::unordered_map` is tested 2 ways:
+1. "unordered_map (temp string)": each key is first copied into a temporary `std::string`, since
+   C++17's `std::unordered_map<std::string, T>::find()` can only take a `std::string`
+2. "unordered_map (std::string)": the keys are all converted to `std::string`s ahead of time,
+   outside of the timing, to measure the table itself
+
+...for short keys (6 to 15 chars; they fit in `std::string`'s small-string buffer) and long keys
+(32 to 63 chars), and for 1000, 100k, and 1M keys. Each result is checked, and each timing is the
+fastest of a few runs.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C++
+```bash
+g++ -Wall -Wextra -Werror -O3 -std=c++17 eRCaGuy_hash_table_benchmark.cpp ../c/timinglib.c \
+    -o bin/a && bin/a
+```
+
+References:
+1. "eRCaGuy_hash_table.h"
+1. https://en.cppreference.com/w/cpp/container/unordered_map/find - see overloads (3) and (4),
+   which were added in C++20 for heterogeneous lookup
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "eRCaGuy_hash_table.h"
+
+// C++ includes
+#include <algorithm>  // For `std::shuffle()`
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// C includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+
+/// Run each test at least this many times, and for at least this long, and report the fastest run
+constexpr size_t MIN_RUNS = 3;
+constexpr uint64_t MIN_TIME_NS = 300*1000*1000ULL;
+
+/// The keys for one test: `N` keys to insert, and `N` other keys to look up as misses, all stored
+/// in `chars`
+struct KeySet
+{
+    std::string chars;
+    std::vector<std::string_view> keys;
+    std::vector<std::string_view> missing_keys;
+    /// The keys in a random order, to look up and erase in
+    std::vector<std::string_view> shuffled_keys;
+};
+
+/// Make `2*num_keys` unique random keys of `min_len` to `max_len` chars: letters, digits, '_',
+/// '/', and '.', like identifiers, paths, or URLs
+KeySet MakeKeys(size_t num_keys, size_t min_len, size_t max_len, std::mt19937_64* rng)
+{
+    static const char CHARS[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_/.";
+    std::uniform_int_distribution<size_t> len_dist(min_len, max_len);
+
+    // Each key ends in '-' and its own unique number, so all keys are unique
+    std::vector<std::pair<size_t, size_t>> offsets_and_lens;
+    KeySet key_set;
+    for (size_t i = 0; i < 2*num_keys; i++)
+    {
+        std::string suffix = "-" + std::to_string(i);
+        size_t len = std::max(len_dist(*rng), suffix.size() + 1);
+        offsets_and_lens.push_back({key_set.chars.size(), len});
+        for (size_t j = 0; j < len - suffix.size(); j++)
+        {
+            key_set.chars += CHARS[(*rng)() % (sizeof(CHARS) - 1)];
+        }
+        key_set.chars += suffix;
+    }
+    // Only make the views once `chars` is done growing
+    for (size_t i = 0; i < offsets_and_lens.size(); i++)
+    {
+        std::string_view key(key_set.chars.data() + offsets_and_lens[i].first,
+            offsets_and_lens[i].second);
+        (i % 2 == 0 ? key_set.keys : key_set.missing_keys).push_back(key);
+    }
+    key_set.shuffled_keys = key_set.keys;
+    std::shuffle(key_set.shuffled_keys.begin(), key_set.shuffled_keys.end(), *rng);
+    return key_set;
+}
+
+/// The best time, in ns, of each operation, for `N` keys
+struct Results
+{
+    uint64_t insert_ns = UINT64_MAX;
+    uint64_t lookup_hit_ns = UINT64_MAX;
+    uint64_t lookup_miss_ns = UINT64_MAX;
+    uint64_t erase_ns = UINT64_MAX;
+    /// Set to false if any operation gave a wrong result
+    bool ok = true;
+};
+
+/// Adapts a table type to the 4 operations, and getting its size
+struct HashTableOps
+{
+    using Table = hash_table::StringHashTable<uint64_t>;
+    static void Insert(Table* table, std::string_view key, uint64_t value)
+    {
+        table->Insert(key, value);
+    }
+    static const uint64_t* Find(const Table& table, std::string_view key)
+    {
+        return table.Find(key);
+    }
+    static bool Erase(Table* table, std::string_view key)
+    {
+        return table->Erase(key);
+    }
+    static size_t Size(const Table& table)
+    {
+        return table.Size();
+    }
+};
+
+struct UnorderedMapTempStringOps
+{
+    using Table = std::unordered_map<std::string, uint64_t>;
+    static void Insert(Table* table, std::string_view key, uint64_t value)
+    {
+        table->emplace(key, value);
+    }
+    static const uint64_t* Find(const Table& table, std::string_view key)
+    {
+        auto it = table.find(std::string(key));
+        return it == table.end() ? nullptr : &it->second;
+    }
+    static bool Erase(Table* table, std::string_view key)
+    {
+        return table->erase(std::string(key)) == 1;
+    }
+    static size_t Size(const Table& table)
+    {
+        return table.size();
+    }
+};
+
+struct UnorderedMapStringOps
+{
+    using Table = std::unordered_map<std::string, uint64_t>;
+    static void Insert(Table* table, const std::string& key, uint64_t value)
+    {
+        table->emplace(key, value);
+    }
+    static const uint64_t* Find(const Table& table, const std::string& key)
+    {
+        auto it = table.find(key);
+        return it == table.end() ? nullptr : &it->second;
+    }
+    static bool Erase(Table* table, const std::string& key)
+    {
+        return table->erase(key) == 1;
+    }
+    static size_t Size(const Table& table)
+    {
+        return table.size();
+    }
+};
+
+/// Time the 4 operations for one table type, with `Key` keys (each `keys[i]` has value `i`).
+template <typename Ops, typename Key>
+Results RunBenchmark(const std::vector<Key>& keys, const std::vector<Key>& missing_keys,
+    const std::vector<Key>& shuffled_keys)
+{
+    // The sum of the values of the `shuffled_keys`, to check the lookups with
+    uint64_t expected_sum = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        expected_sum += i;
+    }
+
+    Results results;
+    uint64_t total_ns = 0;
+    for (size_t run = 0; run < MIN_RUNS || total_ns < MIN_TIME_NS; run++)
+    {
+        typename Ops::Table table;
+
+        uint64_t start_ns = nanos();
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            Ops::Insert(&table, keys[i], i);
+        }
+        uint64_t insert_ns = nanos() - start_ns;
+
+        start_ns = nanos();
+        uint64_t sum = 0;
+        for (const Key& key : shuffled_keys)
+        {
+            const uint64_t* value = Ops::Find(table, key);
+            sum += value == nullptr ? UINT64_MAX / 2 : *value;
+        }
+        uint64_t lookup_hit_ns = nanos() - start_ns;
+        results.ok &= sum == expected_sum;
+
+        start_ns = nanos();
+        size_t num_found = 0;
+        for (const Key& key : missing_keys)
+        {
+            num_found += Ops::Find(table, key) != nullptr;
+        }
+        uint64_t lookup_miss_ns = nanos() - start_ns;
+        results.ok &= num_found == 0;
+
+        start_ns = nanos();
+        size_t num_erased = 0;
+        for (const Key& key : shuffled_keys)
+        {
+            num_erased += Ops::Erase(&table, key);
+        }
+        uint64_t erase_ns = nanos() - start_ns;
+        results.ok &= num_erased == keys.size() && Ops::Size(table) == 0;
+
+        results.insert_ns = std::min(results.insert_ns, insert_ns);
+        results.lookup_hit_ns = std::min(results.lookup_hit_ns, lookup_hit_ns);
+        results.lookup_miss_ns = std::min(results.lookup_miss_ns, lookup_miss_ns);
+        results.erase_ns = std::min(results.erase_ns, erase_ns);
+        total_ns += insert_ns + lookup_hit_ns + lookup_miss_ns + erase_ns;
+    }
+    return results;
+}
+
+void PrintResults(const char* name, const Results& results, size_t num_keys)
+{
+    auto ns_per_op = [num_keys](uint64_t ns) { return (double)ns / (double)num_keys; };
+    printf("  %-28s %9.1f %11.1f %12.1f %9.1f%s\n", name, ns_per_op(results.insert_ns),
+        ns_per_op(results.lookup_hit_ns), ns_per_op(results.lookup_miss_ns),
+        ns_per_op(results.erase_ns), results.ok ? "" : "   <== WRONG RESULTS!");
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    struct KeyLengths
+    {
+        const char* description;
+        size_t min_len;
+        size_t max_len;
+    };
+    const KeyLengths KEY_LENGTHS[] = {
+        {"short keys (6 to 15 chars)", 6, 15},
+        {"long keys (32 to 63 chars)", 32, 63},
+    };
+    const size_t NUMS_OF_KEYS[] = {1000, 100*1000, 1000*1000};
+
+    printf("String hash table benchmark, in ns per operation.\n");
+
+    std::mt19937_64 rng(1234);
+    bool all_ok = true;
+    for (const KeyLengths& key_lengths : KEY_LENGTHS)
+    {
+        for (size_t num_keys : NUMS_OF_KEYS)
+        {
+            KeySet key_set = MakeKeys(num_keys, key_lengths.min_len, key_lengths.max_len, &rng);
+            std::vector<std::string> keys(key_set.keys.begin(), key_set.keys.end());
+            std::vector<std::string> missing_keys(key_set.missing_keys.begin(),
+                key_set.missing_keys.end());
+            std::vector<std::string> shuffled_keys(key_set.shuffled_keys.begin(),
+                key_set.shuffled_keys.end());
+
+            printf("\n%s, N = %zu:\n", key_lengths.description, num_keys);
+            printf("  %-28s %9s %11s %12s %9s\n", "table", "insert", "lookup-hit", "lookup-miss",
+                "erase");
+
+            Results results = RunBenchmark<HashTableOps>(key_set.keys,
+                key_set.missing_keys, key_set.shuffled_keys);
+            PrintResults("StringHashTable", results, num_keys);
+            all_ok &= results.ok;
+
+            results = RunBenchmark<UnorderedMapTempStringOps>(key_set.keys,
+                key_set.missing_keys, key_set.shuffled_keys);
+            PrintResults("unordered_map (temp string)", results, num_keys);
+            all_ok &= results.ok;
+
+            results = RunBenchmark<UnorderedMapStringOps>(keys, missing_keys, shuffled_keys);
+            PrintResults("unordered_map (std::string)", results, num_keys);
+            all_ok &= results.ok;
+        }
+    }
+
+    if (!all_ok)
+    {
+        printf("\nFAILED: some results were wrong!\n");
+        return 1;
+    }
+    printf("\nAll results are correct.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM; the numbers vary from run to run):
+
+    eRCaGuy_hello_world/cpp$ g++ -Wall -Wextra -Werror -O3 -std=c++17 eRCaGuy_hash_table_benchmark.cpp ../c/timinglib.c -o bin/a && bin/a
+    String hash table benchmark, in ns per operation.
+
+    short keys (6 to 15 chars), N = 1000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                   45.5         9.5          4.9       9.8
+      unordered_map (temp string)       74.5        49.0         44.7      61.7
+      unordered_map (std::string)       73.6        27.5         23.4      43.2
+
+    short keys (6 to 15 chars), N = 100000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                   52.2        38.4         16.2      37.1
+      unordered_map (temp string)      185.9       292.5        226.9     465.8
+      unordered_map (std::string)      241.6       168.3        146.4     293.3
+
+    short keys (6 to 15 chars), N = 1000000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                  183.4       169.9         24.5     161.3
+      unordered_map (temp string)      604.9       569.4        457.0     824.6
+      unordered_map (std::string)      619.6       218.5        200.7     419.1
+
+    long keys (32 to 63 chars), N = 1000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                   81.0        17.2          9.6      18.2
+      unordered_map (temp string)      106.3        76.8         74.8     101.0
+      unordered_map (std::string)      120.4        50.4         46.9      84.3
+
+    long keys (32 to 63 chars), N = 100000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                  132.4       191.0         48.4     190.3
+      unordered_map (temp string)      423.2       643.0        390.0     713.4
+      unordered_map (std::string)      384.1       245.7        201.0     480.0
+
+    long keys (32 to 63 chars), N = 1000000:
+      table                           insert  lookup-hit  lookup-miss     erase
+      StringHashTable                  284.2       266.5         51.8     238.1
+      unordered_map (temp string)      727.6       701.6        495.2     965.1
+      unordered_map (std::string)      640.9       299.6        235.3     573.2
+
+    All results are correct.
+
+*/
@@ -0,0 +1,317 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Googletest (gtest) unit tests for eRCaGuy_hash_table.h.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the detailed clone and build steps here to clone the googletest repo and manually
+# build the necessary *.a static library files for gtest and gmock:
+# "eRCaGuy_hello_world/cpp/README.md"
+
+# 2. THEN, build and run this unit test with this command!:
+time ( \
+    time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread \
+    -I"googletest/googletest/include" -I"googletest/googlemock/include" \
+    eRCaGuy_hash_table_unittest.cpp \
+    bin/libgtest.a bin/libgtest_main.a \
+    -o bin/a \
+    && time bin/a \
+)
+```
+
+References:
+1. https://github.com/google/googletest
+    1. https://github.com/google/googletest/blob/main/docs/reference/assertions.md
+
+*/
+
+
+// Local includes
+#include "eRCaGuy_hash_table.h"
+
+// 3rd-party library includes
+// #include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using hash_table::StringHashTable;
+
+TEST(StringHashTable, EmptyTable)
+{
+    StringHashTable<int> table;
+    EXPECT_EQ(table.Size(), 0U);
+    EXPECT_TRUE(table.Empty());
+    EXPECT_EQ(table.Capacity(), 0U);
+    EXPECT_EQ(table.Find("key"), nullptr);
+    EXPECT_FALSE(table.Contains(""));
+    EXPECT_FALSE(table.Erase("key"));
+}
+
+TEST(StringHashTable, InsertAndFind)
+{
+    StringHashTable<int> table;
+    std::pair<int*, bool> result = table.Insert("one", 1);
+    ASSERT_NE(result.first, nullptr);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(*result.first, 1);
+    table.Insert("two", 2);
+    table.Insert("three", 3);
+
+    EXPECT_EQ(table.Size(), 3U);
+    ASSERT_NE(table.Find("one"), nullptr);
+    EXPECT_EQ(*table.Find("one"), 1);
+    EXPECT_EQ(*table.Find("two"), 2);
+    EXPECT_EQ(*table.Find("three"), 3);
+    EXPECT_EQ(table.Find("four"), nullptr);
+    // A prefix of a key, or a key plus more chars, is a different key
+    EXPECT_EQ(table.Find("on"), nullptr);
+    EXPECT_EQ(table.Find("one "), nullptr);
+}
+
+TEST(StringHashTable, InsertDoesNotOverwrite)
+{
+    StringHashTable<int> table;
+    table.Insert("key", 1);
+    std::pair<int*, bool> result = table.Insert("key", 2);
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(*result.first, 1);
+    EXPECT_EQ(table.Size(), 1U);
+
+    result = table.InsertOrAssign("key", 3);
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(*table.Find("key"), 3);
+    EXPECT_EQ(table.Size(), 1U);
+}
+
+TEST(StringHashTable, OperatorSquareBrackets)
+{
+    StringHashTable<int> table;
+    // Like `std::unordered_map`, this inserts a default value if the key isn't there yet
+    EXPECT_EQ(table["new key"], 0);
+    EXPECT_EQ(table.Size(), 1U);
+    table["new key"] += 5;
+    table["new key"] += 5;
+    EXPECT_EQ(*table.Find("new key"), 10);
+}
+
+TEST(StringHashTable, HeterogeneousLookup)
+{
+    StringHashTable<std::string> table;
+    table.Insert(std::string("hello"), "world");
+
+    const char* c_str = "hello";
+    std::string cpp_str = "hello";
+    // A key that is just a slice of a bigger buffer, with no null terminator after it
+    const char buffer[] = "say hello there";
+    std::string_view slice(buffer + 4, 5);
+
+    ASSERT_NE(table.Find(c_str), nullptr);
+    EXPECT_EQ(*table.Find(c_str), "world");
+    EXPECT_EQ(table.Find(cpp_str), table.Find(c_str));
+    EXPECT_EQ(table.Find(slice), table.Find(c_str));
+    EXPECT_TRUE(table.Erase(slice));
+    EXPECT_EQ(table.Find(cpp_str), nullptr);
+}
+
+TEST(StringHashTable, KeysAreCopiedIntoTheTable)
+{
+    StringHashTable<int> table;
+    {
+        std::string temporary_key = "a key which is too long for the small-string buffer";
+        table.Insert(temporary_key, 42);
+        temporary_key.assign(temporary_key.size(), 'x');
+    }
+    ASSERT_NE(table.Find("a key which is too long for the small-string buffer"), nullptr);
+    EXPECT_EQ(*table.Find("a key which is too long for the small-string buffer"), 42);
+}
+
+TEST(StringHashTable, SpecialKeys)
+{
+    StringHashTable<int> table;
+    table.Insert("", 1);
+    table.Insert(std::string_view("a\0b", 3), 2);
+    table.Insert(std::string_view("a\0c", 3), 3);
+    std::string big_key(100000, 'k');
+    table.Insert(big_key, 4);
+
+    EXPECT_EQ(*table.Find(""), 1);
+    EXPECT_EQ(*table.Find(std::string_view("a\0b", 3)), 2);
+    EXPECT_EQ(*table.Find(std::string_view("a\0c", 3)), 3);
+    EXPECT_EQ(table.Find("a"), nullptr);
+    EXPECT_EQ(*table.Find(big_key), 4);
+    big_key.back() = 'K';
+    EXPECT_EQ(table.Find(big_key), nullptr);
+}
+
+TEST(StringHashTable, EraseAndReinsert)
+{
+    StringHashTable<std::string> table;
+    table.Insert("key", std::string(1000, 'v'));
+    EXPECT_TRUE(table.Erase("key"));
+    EXPECT_FALSE(table.Erase("key"));
+    EXPECT_EQ(table.Find("key"), nullptr);
+    EXPECT_EQ(table.Size(), 0U);
+
+    std::pair<std::string*, bool> result = table.Insert("key", "new value");
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(*table.Find("key"), "new value");
+}
+
+TEST(StringHashTable, GrowKeepsAllKeys)
+{
+    StringHashTable<size_t> table;
+    constexpr size_t NUM_KEYS = 100000;
+    for (size_t i = 0; i < NUM_KEYS; i++)
+    {
+        table.Insert("key_" + std::to_string(i), i);
+    }
+    EXPECT_EQ(table.Size(), NUM_KEYS);
+    // A power of 2, with a load factor of no more than 7/8
+    EXPECT_EQ(table.Capacity() & (table.Capacity() - 1), 0U);
+    EXPECT_LE(table.Size(), table.Capacity() - table.Capacity() / 8);
+
+    for (size_t i = 0; i < NUM_KEYS; i++)
+    {
+        const size_t* value = table.Find("key_" + std::to_string(i));
+        ASSERT_NE(value, nullptr) << "i = " << i;
+        EXPECT_EQ(*value, i);
+    }
+    EXPECT_EQ(table.Find("key_" + std::to_string(NUM_KEYS)), nullptr);
+}
+
+TEST(StringHashTable, ReserveAvoidsRehash)
+{
+    StringHashTable<int> table(1000);
+    size_t capacity = table.Capacity();
+    EXPECT_GE(capacity - capacity / 8, 1000U);
+    for (int i = 0; i < 1000; i++)
+    {
+        table.Insert(std::to_string(i), i);
+    }
+    EXPECT_EQ(table.Capacity(), capacity);
+}
+
+TEST(StringHashTable, ChurnDoesNotGrowTheTable)
+{
+    // Inserting and erasing keys, with only a few in the table at any time, must clean up the
+    // tombstones with same-size rehashes, not grow the table forever
+    StringHashTable<int> table;
+    for (int i = 0; i < 100000; i++)
+    {
+        table.Insert(std::to_string(i), i);
+        if (i >= 8)
+        {
+            EXPECT_TRUE(table.Erase(std::to_string(i - 8)));
+        }
+    }
+    EXPECT_EQ(table.Size(), 8U);
+    EXPECT_LE(table.Capacity(), 32U);
+}
+
+TEST(StringHashTable, ForEach)
+{
+    StringHashTable<int> table;
+    table.Insert("a", 1);
+    table.Insert("b", 2);
+    table.Insert("c", 3);
+    table.Erase("b");
+
+    std::unordered_map<std::string, int> seen;
+    table.ForEach([&seen](std::string_view key, int& value)
+    {
+        seen[std::string(key)] = value;
+        value *= 10;
+    });
+    EXPECT_EQ(seen, (std::unordered_map<std::string, int>{{"a", 1}, {"c", 3}}));
+    EXPECT_EQ(*table.Find("a"), 10);
+    EXPECT_EQ(*table.Find("c"), 30);
+}
+
+TEST(StringHashTable, MoveAndClear)
+{
+    StringHashTable<int> table;
+    table.Insert("key", 1);
+    StringHashTable<int> other(std::move(table));
+    EXPECT_EQ(table.Size(), 0U);
+    EXPECT_EQ(table.Find("key"), nullptr);
+    EXPECT_EQ(*other.Find("key"), 1);
+
+    // The moved-from table is still usable
+    table.Insert("key", 2);
+    EXPECT_EQ(*table.Find("key"), 2);
+
+    other.Clear();
+    EXPECT_EQ(other.Size(), 0U);
+    EXPECT_EQ(other.Find("key"), nullptr);
+    other.Insert("key", 3);
+    EXPECT_EQ(*other.Find("key"), 3);
+}
+
+TEST(StringHashTable, RandomOpsMatchUnorderedMap)
+{
+    // Do the same random inserts, erases, and lookups on a `StringHashTable` and an
+    // `std::unordered_map`, from a small pool of keys, so there are lots of hits, misses, erases,
+    // and tombstone reuses, and check that they always agree.
+    StringHashTable<int> table;
+    std::unordered_map<std::string, int> reference;
+    std::mt19937 rng(12345);
+    for (int i = 0; i < 200000; i++)
+    {
+        std::string key = "k" + std::to_string(rng() % 2000);
+        switch (rng() % 4)
+        {
+            case 0:
+            case 1:
+            {
+                bool inserted = table.Insert(key, i).second;
+                EXPECT_EQ(inserted, reference.emplace(key, i).second);
+                break;
+            }
+            case 2:
+            {
+                EXPECT_EQ(table.Erase(key), reference.erase(key) == 1);
+                break;
+            }
+            case 3:
+            {
+                const int* value = table.Find(key);
+                auto it = reference.find(key);
+                ASSERT_EQ(value != nullptr, it != reference.end());
+                if (value != nullptr)
+                {
+                    EXPECT_EQ(*value, it->second);
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(table.Size(), reference.size());
+    }
+}
+
+TEST(HashString, DependsOnAllChars)
+{
+    // Changing any one char, or the length, of a key changes its hash
+    std::string key(40, 'a');
+    const uint64_t hash = hash_table::HashString(key.data(), key.size());
+    for (size_t i = 0; i < key.size(); i++)
+    {
+        std::string changed = key;
+        changed[i] = 'b';
+        EXPECT_NE(hash_table::HashString(changed.data(), changed.size()), hash) << "i = " << i;
+    }
+    for (size_t len = 0; len < key.size(); len++)
+    {
+        EXPECT_NE(hash_table::HashString(key.data(), len), hash) << "len = " << len;
+    }
+}
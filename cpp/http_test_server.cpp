@@ -0,0 +1,394 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+References:
+1. https://man7.org/linux/man-pages/man2/accept.2.html - for `accept4()`
+1. https://man7.org/linux/man-pages/man7/tcp.7.html - for `TCP_NODELAY`
+
+*/
+
+
+// Local includes
+#include "http_test_server.h"
+
+// 3rd-party library includes
+#include <fmt/format.h>
+
+// Linux includes
+#include <arpa/inet.h>    // For `htonl()`, `htons()`, `ntohs()`
+#include <fcntl.h>        // For `open()`
+#include <netinet/in.h>   // For `struct sockaddr_in`
+#include <netinet/tcp.h>  // For `TCP_NODELAY`
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>       // For `read()`, `close()`
+
+// C and C++ includes
+#include <cctype>   // For `tolower()`
+#include <cerrno>
+#include <cstdlib>  // For `strtoull()`
+#include <cstring>  // For `strerror()`
+#include <memory>
+#include <unordered_map>
+
+
+namespace http_test_server
+{
+
+/// One client connection, and its partly-received requests and partly-sent responses
+struct HttpTestServer::Connection
+{
+    int fd = -1;
+    /// Received bytes not yet handled: the start of the next request(s)
+    std::string in;
+    /// Response bytes not yet sent, starting at `out_offset`
+    std::string out;
+    size_t out_offset = 0;
+    /// Whether `EPOLLOUT` is on for this connection, because `out` didn't all fit in the socket
+    bool waiting_to_write = false;
+    /// Whether the client asked to close the connection after this response
+    bool close_after_write = false;
+    /// Whether `100 Continue` was sent already for the request at the start of `in`
+    bool sent_continue = false;
+};
+
+/// Return the value of header `name` (which must be lower-case, and end with `:`) in `headers`
+/// (which must be lower-case too), or an empty string if it's not there.
+static std::string find_header(const std::string& headers, const char* name)
+{
+    size_t i = headers.find(std::string("\r\n") + name);
+    if (i == std::string::npos)
+    {
+        return "";
+    }
+    i += 2 + strlen(name);
+    size_t end = headers.find("\r\n", i);
+    while (i < end && headers[i] == ' ')
+    {
+        i++;
+    }
+    return headers.substr(i, end - i);
+}
+
+HttpTestServer::HttpTestServer()
+{
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ == -1)
+    {
+        error_ = fmt::format(FMT_STRING("Failed to create socket. errno = {}: {}"),
+            errno, strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    // Port 0 lets the kernel pick a free port
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(0);
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) == -1
+        || listen(listen_fd_, SOMAXCONN) == -1
+        || getsockname(listen_fd_, (struct sockaddr*)&addr, &addr_len) == -1)
+    {
+        error_ = fmt::format(FMT_STRING("Failed to listen on 127.0.0.1. errno = {}: {}"),
+            errno, strerror(errno));
+        return;
+    }
+    port_ = ntohs(addr.sin_port);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    // Kept in reserve for when we run out of fds; see `drop_pending_connections()`
+    spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (epoll_fd_ == -1 || stop_fd_ == -1 || spare_fd_ == -1)
+    {
+        error_ = fmt::format(FMT_STRING("Failed to create the epoll instance, eventfd, or spare "
+            "fd. errno = {}: {}"), errno, strerror(errno));
+        return;
+    }
+    for (int fd : {listen_fd_, stop_fd_})
+    {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1)
+        {
+            error_ = fmt::format(FMT_STRING("Failed to add a fd to the epoll set. errno = {}: {}"),
+                errno, strerror(errno));
+            return;
+        }
+    }
+
+    thread_ = std::thread(&HttpTestServer::run_loop, this);
+}
+
+HttpTestServer::~HttpTestServer()
+{
+    if (thread_.joinable())
+    {
+        uint64_t one = 1;
+        ssize_t retval = write(stop_fd_, &one, sizeof(one));
+        (void)retval;
+        thread_.join();
+    }
+    for (int fd : {listen_fd_, epoll_fd_, stop_fd_, spare_fd_})
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+}
+
+std::string HttpTestServer::get_url(const char* path) const
+{
+    return fmt::format(FMT_STRING("http://127.0.0.1:{}{}"), port_, path);
+}
+
+void HttpTestServer::run_loop()
+{
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    auto close_connection = [&connections](Connection* connection)
+    {
+        // closing the fd also removes it from the `epoll` set
+        int fd = connection->fd;
+        close(fd);
+        connections.erase(fd);
+    };
+
+    constexpr int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+    while (true)
+    {
+        int num_events = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if (num_events == -1 && errno != EINTR)
+        {
+            break;
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == stop_fd_)
+            {
+                for (auto& pair : connections)
+                {
+                    close(pair.first);
+                }
+                return;
+            }
+
+            if (fd == listen_fd_)
+            {
+                int client_fd;
+                while ((client_fd = accept4(listen_fd_, nullptr, nullptr,
+                    SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0 || errno == EINTR)
+                {
+                    if (client_fd < 0)
+                    {
+                        continue;
+                    }
+                    // Send each response right away, rather than letting Nagle's algorithm hold
+                    // it back waiting for the client's delayed ACK of the last one
+                    int one = 1;
+                    setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    struct epoll_event event = {};
+                    event.events = EPOLLIN;
+                    event.data.fd = client_fd;
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &event);
+                    auto connection = std::make_unique<Connection>();
+                    connection->fd = client_fd;
+                    connections[client_fd] = std::move(connection);
+                    num_connections_++;
+                }
+                if (errno == EMFILE || errno == ENFILE)
+                {
+                    drop_pending_connections();
+                }
+                continue;
+            }
+
+            // A connection closed earlier in this batch of events may have had more events
+            auto it = connections.find(fd);
+            if (it == connections.end())
+            {
+                continue;
+            }
+            Connection* connection = it->second.get();
+            bool keep_open = true;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                keep_open = handle_readable(connection);
+            }
+            if (keep_open && (events[i].events & EPOLLOUT))
+            {
+                keep_open = handle_writable(connection);
+            }
+            if (!keep_open)
+            {
+                close_connection(connection);
+            }
+        }
+    }
+}
+
+/// Out of fds, so `accept4()` fails, but the pending connections stay in the listen queue, so
+/// `listen_fd_` stays readable, and `epoll_wait()` would keep returning it right away: a busy loop.
+/// So, instead, free up the spare fd, and use it to accept and close each pending connection,
+/// which the client sees as the server closing the connection. Then take the spare fd back.
+void HttpTestServer::drop_pending_connections()
+{
+    close(spare_fd_);
+    int client_fd;
+    while ((client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC)) >= 0
+        || errno == EINTR)
+    {
+        if (client_fd >= 0)
+        {
+            close(client_fd);
+            num_dropped_connections_++;
+        }
+    }
+    // If another thread took the freed fd in the meantime, this fails, and the next call tries
+    // to get one again
+    spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+/// Read what the client sent, and queue up a response to each complete request in it.
+/// Returns `false` if the connection should be closed.
+bool HttpTestServer::handle_readable(Connection* connection)
+{
+    char buf[64*1024];
+    ssize_t num_bytes_read = read(connection->fd, buf, sizeof(buf));
+    if (num_bytes_read == 0)
+    {
+        // the client closed the connection
+        return false;
+    }
+    if (num_bytes_read == -1)
+    {
+        return errno == EAGAIN || errno == EINTR;
+    }
+    connection->in.append(buf, (size_t)num_bytes_read);
+
+    // Handle every complete request received so far; clients may send several at once
+    // (pipelining)
+    while (true)
+    {
+        size_t headers_end = connection->in.find("\r\n\r\n");
+        if (headers_end == std::string::npos)
+        {
+            break;
+        }
+        std::string headers = connection->in.substr(0, headers_end + 2);
+        for (char& c : headers)
+        {
+            c = (char)tolower((unsigned char)c);
+        }
+        size_t body_len = strtoull(find_header(headers, "content-length:").c_str(), nullptr, 10);
+        size_t request_len = headers_end + 4 + body_len;
+        if (connection->in.size() < request_len)
+        {
+            // Still waiting for (the rest of) the body. curl asks for permission to send big
+            // bodies first, with `Expect: 100-continue`.
+            if (!connection->sent_continue && find_header(headers, "expect:") == "100-continue")
+            {
+                connection->out += "HTTP/1.1 100 Continue\r\n\r\n";
+                connection->sent_continue = true;
+            }
+            break;
+        }
+
+        // The request line. Ex: `GET /bytes/10 HTTP/1.1`
+        const std::string& in = connection->in;
+        size_t method_end = in.find(' ');
+        size_t path_end = in.find(' ', method_end + 1);
+        std::string method = in.substr(0, method_end);
+        std::string path = in.substr(method_end + 1, path_end - method_end - 1);
+
+        std::string body;
+        if (method == "POST")
+        {
+            body = in.substr(headers_end + 4, body_len);
+        }
+        else if (path.rfind("/bytes/", 0) == 0)
+        {
+            body.assign(strtoull(path.c_str() + strlen("/bytes/"), nullptr, 10), 'x');
+        }
+        else
+        {
+            body = "Hello, World!\n";
+        }
+        connection->out += fmt::format(FMT_STRING("HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain\r\nContent-Length: {}\r\n\r\n"), body.size());
+        connection->out += body;
+        num_requests_++;
+
+        if (find_header(headers, "connection:") == "close")
+        {
+            connection->close_after_write = true;
+        }
+        connection->in.erase(0, request_len);
+        connection->sent_continue = false;
+    }
+
+    return handle_writable(connection);
+}
+
+/// Send as much of the queued response bytes as fit in the socket now, and watch for it to be
+/// writable again if they don't all fit.
+/// Returns `false` if the connection should be closed.
+bool HttpTestServer::handle_writable(Connection* connection)
+{
+    while (connection->out_offset < connection->out.size())
+    {
+        // `MSG_NOSIGNAL`: get `EPIPE` rather than a `SIGPIPE` if the client has gone away
+        ssize_t num_bytes_sent = send(connection->fd,
+            connection->out.data() + connection->out_offset,
+            connection->out.size() - connection->out_offset, MSG_NOSIGNAL);
+        if (num_bytes_sent == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN)
+            {
+                return false;
+            }
+            if (!connection->waiting_to_write)
+            {
+                struct epoll_event event = {};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.fd = connection->fd;
+                epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection->fd, &event);
+                connection->waiting_to_write = true;
+            }
+            return true;
+        }
+        connection->out_offset += (size_t)num_bytes_sent;
+    }
+
+    connection->out.clear();
+    connection->out_offset = 0;
+    if (connection->close_after_write)
+    {
+        return false;
+    }
+    if (connection->waiting_to_write)
+    {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = connection->fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->waiting_to_write = false;
+    }
+    return true;
+}
+
+} // namespace http_test_server
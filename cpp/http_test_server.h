@@ -0,0 +1,106 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A tiny local HTTP/1.1 server, listening only on the loopback interface (127.0.0.1), on a free
+port, to test and benchmark HTTP clients against, such as "curl_lib.h" and
+"curl_systemcall_lib.h", without needing the internet, and without the speed of some remote server
+getting in the way of the measurements.
+
+It runs in its own thread, serving all connections from one `epoll` loop. Connections are kept
+alive (HTTP/1.1 persistent connections), so clients can reuse them, and it counts how many
+connections and requests it has had, so tests can check whether a client reused its connections.
+
+It answers:
+1. `GET /bytes/N`: with `N` bytes of `x`
+2. any other `GET`: with `Hello, World!\n`
+3. `POST` (to any path): with the request's body, echoed back
+
+...all with status `200 OK`. It is NOT a real web server: it only does what the above needs, and
+assumes a well-behaved client (ex: no chunked request bodies).
+
+STATUS: done and works!
+
+To compile and run:
+- See a file which includes this header file, as an example.
+
+References:
+1. https://man7.org/linux/man-pages/man7/epoll.7.html
+1. https://developer.mozilla.org/en-US/docs/Web/HTTP/Messages
+1. https://datatracker.ietf.org/doc/html/rfc9112 - HTTP/1.1
+
+*/
+
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+
+namespace http_test_server
+{
+
+/// error code indicating no error
+constexpr char ERROR_OK[] = "OK";
+
+class HttpTestServer
+{
+public:
+    /// Start the server, on a free port on 127.0.0.1. Check `get_error()` to see if it started.
+    HttpTestServer();
+    /// Stop the server, closing all of its connections.
+    ~HttpTestServer();
+
+    HttpTestServer(const HttpTestServer&) = delete;
+    HttpTestServer& operator=(const HttpTestServer&) = delete;
+
+    /// `ERROR_OK`, or an error string to describe why the server could not be started
+    const std::string& get_error() const { return error_; }
+
+    uint16_t get_port() const { return port_; }
+
+    /// The full URL of `path` on this server. Ex: `get_url("/bytes/10")` returns
+    /// `"http://127.0.0.1:12345/bytes/10"`.
+    std::string get_url(const char* path) const;
+
+    /// The total number of connections accepted so far
+    size_t get_num_connections() const { return num_connections_; }
+    /// The total number of requests answered so far
+    size_t get_num_requests() const { return num_requests_; }
+    /// The total number of connections closed right away, unanswered, since this process was out
+    /// of fds to accept them with. A client sees these as the server closing the connection.
+    size_t get_num_dropped_connections() const { return num_dropped_connections_; }
+
+private:
+    struct Connection;
+
+    void run_loop();
+    bool handle_readable(Connection* connection);
+    bool handle_writable(Connection* connection);
+    void drop_pending_connections();
+
+    std::string error_ = ERROR_OK;
+    uint16_t port_ = 0;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int stop_fd_ = -1;
+    int spare_fd_ = -1;
+    std::atomic<size_t> num_connections_{0};
+    std::atomic<size_t> num_requests_{0};
+    std::atomic<size_t> num_dropped_connections_{0};
+    std::thread thread_;
+};
+
+} // namespace http_test_server
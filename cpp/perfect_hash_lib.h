@@ -0,0 +1,341 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A compile-time minimal perfect hash for fixed sets of string keys, such as command names, or the
+names of the values of an enum (ex: to parse "ARROW_UP" back into `ARROW_UP`: the reverse of
+`arrowKeyGetName()` in "c/read_system_call_via_pipe__arrow_keypresses.c", or of
+`endianness_get_name()` in "swap_bytes_lib.h").
+
+Give `MakePerfectHash()` a `constexpr` array of `N` unique keys, and it builds, entirely at compile
+time, a table which maps each key to its index in the array, with 1 hash of the key, 2 array
+lookups, and 1 string compare, and no branches except for the final string compare. "Minimal"
+means the table has exactly `N` slots: one per key. It is a plain `constexpr` object made of
+arrays, so there is no runtime construction and no heap use at all, and lookups of constant
+keys can even be done at compile time, ex: in a `static_assert()`.
+
+Example:
+```cpp
+constexpr std::string_view COMMANDS[] = {"start", "stop", "pause", "resume"};
+constexpr auto COMMAND_HASH = perfect_hash::MakePerfectHash(COMMANDS);
+
+size_t i = COMMAND_HASH.IndexOf(cmd);  // `COMMANDS[i] == cmd`, or `i == perfect_hash::NOT_FOUND`
+static_assert(COMMAND_HASH.IndexOf("stop") == 1);
+```
+
+How it works ("hash, displace, and compress", simplified; see the references):
+1. Each key gets one 64-bit hash of its chars. All other hashes are cheap mixes of that hash with a
+   seed.
+2. The keys are split into `N` buckets by their hash. Some buckets get 0 keys, most get 1 to 3.
+3. Going from the biggest bucket to the smallest, each bucket with 2 or more keys gets a
+   "displacement" seed `d`: the first seed which sends all of its keys to slots which are still
+   free. Then, each bucket with 1 key just takes any free slot, and stores that slot directly as
+   `-slot - 1`, which is negative, to tell it apart from a seed.
+4. A lookup hashes the key, reads its bucket's displacement, picks the slot with a conditional move,
+   and then compares the key in that slot to the key being looked up, since a key which is NOT
+   in the set lands in some slot too.
+
+Lookups are about as fast as in a good runtime hash table, such as `hash_table::StringHashTable`
+in "eRCaGuy_hash_table.h". They are faster than `std::unordered_map` at every size, and than
+if-else chains of string compares from about 100 keys on. See "perfect_hash_lib_benchmark.cpp".
+What you gain over a runtime table is that there is nothing to build or allocate at startup.
+
+Building the table takes roughly O(N) steps, but they are constant-evaluation steps in the
+compiler, which are slow: about 2 seconds of compile time per 10k keys with gcc. With gcc's default
+`-fconstexpr-ops-limit`, it can build tables of up to about 20k keys; raise that limit for more.
+
+STATUS: done and works!
+
+To compile and run:
+- See "perfect_hash_lib_benchmark.cpp" as an example.
+
+References:
+1. Steve Hanov, "Throw away the keys: Easy, Minimal Perfect Hashing":
+   http://stevehanov.ca/blog/?id=119 - this is the algorithm used here
+1. Belazzougui, Botelho, and Dietzfelbinger, "Hash, displace, and compress" (the CHD algorithm):
+   https://cmph.sourceforge.net/papers/esa09.pdf
+1. GNU gperf, which generates perfect hash functions as C code, with an external tool, instead of
+   at compile time: https://www.gnu.org/software/gperf/
+1. "eRCaGuy_hash_table.h" - for when the keys are only known at runtime
+
+*/
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstddef>  // For `size_t`
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <stdexcept>  // For `std::invalid_argument`
+#include <string_view>
+
+namespace perfect_hash
+{
+
+/// Returned by `PerfectHash::IndexOf()` for a key which is not in the set
+constexpr size_t NOT_FOUND = SIZE_MAX;
+
+/// Multiply 2 64-bit numbers into a 128-bit product, and fold it back into 64 bits.
+constexpr uint64_t MultiplyAndFold(uint64_t a, uint64_t b)
+{
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+/// Read the 4 chars at `p` as a little-endian integer. `memcpy()` can't be used at compile time,
+/// but gcc and clang turn this into a single load at runtime anyway.
+constexpr uint64_t Read32(const char* p)
+{
+    return (uint64_t)(uint8_t)p[0] | ((uint64_t)(uint8_t)p[1] << 8)
+        | ((uint64_t)(uint8_t)p[2] << 16) | ((uint64_t)(uint8_t)p[3] << 24);
+}
+
+/// Read the 8 chars at `p` as a little-endian integer
+constexpr uint64_t Read64(const char* p)
+{
+    return Read32(p) | (Read32(p + 4) << 32);
+}
+
+/// The 64-bit hash of a key's chars, which all other hashes are derived from. It reads the key 8
+/// chars at a time, like wyhash (and `hash_table::HashString()` in "eRCaGuy_hash_table.h"), but
+/// it is `constexpr`.
+constexpr uint64_t HashKey(std::string_view key)
+{
+    constexpr uint64_t P0 = 0xa0761d6478bd642fULL;
+    constexpr uint64_t P1 = 0xe7037ed1a0b428dbULL;
+    constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+
+    const char* p = key.data();
+    size_t remaining = key.size();
+    uint64_t hash = P0 ^ key.size();
+    while (remaining > 16)
+    {
+        hash = MultiplyAndFold(Read64(p) ^ P1, Read64(p + 8) ^ hash);
+        p += 16;
+        remaining -= 16;
+    }
+
+    // Read the last 1 to 16 chars as 2 (possibly overlapping) words
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (remaining >= 8)
+    {
+        a = Read64(p);
+        b = Read64(p + remaining - 8);
+    }
+    else if (remaining >= 4)
+    {
+        a = Read32(p);
+        b = Read32(p + remaining - 4);
+    }
+    else if (remaining > 0)
+    {
+        a = ((uint64_t)(uint8_t)p[0] << 16) | ((uint64_t)(uint8_t)p[remaining / 2] << 8)
+            | (uint64_t)(uint8_t)p[remaining - 1];
+    }
+    return MultiplyAndFold(MultiplyAndFold(a ^ P1, b ^ hash) ^ key.size(), P2);
+}
+
+/// Mix `hash` with `seed` into a new, independent-looking hash, with 1 multiply
+constexpr uint64_t MixHash(uint64_t hash, uint64_t seed)
+{
+    return MultiplyAndFold(hash ^ (seed * 0x9e3779b97f4a7c15ULL), 0xc4ceb9fe1a85ec53ULL);
+}
+
+/// Map `hash` to the range 0 to `n - 1`, with a multiply and a shift instead of a slow `%`
+constexpr size_t Reduce(uint64_t hash, size_t n)
+{
+    return (size_t)(((hash >> 32) * (uint64_t)n) >> 32);
+}
+
+/// A minimal perfect hash table of `N` string keys. Make one with `MakePerfectHash()`.
+template <size_t N>
+class PerfectHash
+{
+public:
+    /// \brief      Look up `key`.
+    /// \return     The index of `key` in the array of keys the table was made from, or
+    ///             `NOT_FOUND` if it isn't one of them
+    constexpr size_t IndexOf(std::string_view key) const
+    {
+        const uint64_t hash = HashKey(key);
+        const int32_t displacement = displacements_[Reduce(hash, N)];
+        const size_t displaced_slot = Reduce(MixHash(hash, (uint64_t)displacement), N);
+        // A negative displacement is a slot (a bucket with just 1 key)
+        const size_t slot = displacement < 0 ? (size_t)(-displacement - 1) : displaced_slot;
+        const Slot& found = slots_[slot];
+        return std::string_view(found.key, found.key_len) == key ? found.index : NOT_FOUND;
+    }
+
+    constexpr bool Contains(std::string_view key) const
+    {
+        return IndexOf(key) != NOT_FOUND;
+    }
+
+    static constexpr size_t Size()
+    {
+        return N;
+    }
+
+private:
+    template <size_t M>
+    friend constexpr PerfectHash<M> MakePerfectHash(const std::string_view (&keys)[M]);
+
+    /// For each bucket, the seed to hash its keys into their slots with, or, if it is negative,
+    /// `-slot - 1` for the slot of its only key
+    int32_t displacements_[N] = {};
+    /// A key, and its index in the original array of keys, packed into 16 bytes so a lookup only
+    /// touches 1 cache line of them
+    struct alignas(16) Slot
+    {
+        const char* key = nullptr;
+        uint32_t key_len = 0;
+        uint32_t index = 0;
+    };
+
+    Slot slots_[N] = {};
+};
+
+/// \brief      Build a `PerfectHash` of `keys`. Call it in a `constexpr` context, so it runs at
+///             compile time, ex: `constexpr auto HASH = MakePerfectHash(KEYS);`.
+/// \note       `keys` must not have any duplicates. If it does, this fails to compile, with an error
+///             about the `throw` in here not being a constant expression.
+/// \param[in]  keys    The keys; `keys[i]` is looked up as index `i`
+/// \return     The table
+template <size_t N>
+constexpr PerfectHash<N> MakePerfectHash(const std::string_view (&keys)[N])
+{
+    static_assert(N > 0, "A perfect hash needs at least 1 key.");
+    static_assert(N <= INT32_MAX, "Too many keys.");
+
+    // Give up after trying this many seeds for one bucket. It never happens in practice, since
+    // the buckets are placed while there is still plenty of room.
+    constexpr int32_t MAX_DISPLACEMENT = 1000000;
+
+    PerfectHash<N> table;
+    uint64_t hashes[N] = {};
+    size_t bucket_of_key[N] = {};
+    for (size_t i = 0; i < N; i++)
+    {
+        hashes[i] = HashKey(keys[i]);
+        bucket_of_key[i] = Reduce(hashes[i], N);
+    }
+
+    // Group the keys by bucket (a counting sort): the keys of bucket `b` are
+    // `keys_by_bucket[bucket_starts[b]]` to `keys_by_bucket[bucket_starts[b + 1] - 1]`
+    size_t bucket_starts[N + 1] = {};
+    for (size_t i = 0; i < N; i++)
+    {
+        bucket_starts[bucket_of_key[i] + 1]++;
+    }
+    size_t max_bucket_size = 0;
+    for (size_t b = 0; b < N; b++)
+    {
+        max_bucket_size = bucket_starts[b + 1] > max_bucket_size ?
+            bucket_starts[b + 1] : max_bucket_size;
+        bucket_starts[b + 1] += bucket_starts[b];
+    }
+    size_t keys_by_bucket[N] = {};
+    size_t next_in_bucket[N] = {};
+    for (size_t b = 0; b < N; b++)
+    {
+        next_in_bucket[b] = bucket_starts[b];
+    }
+    for (size_t i = 0; i < N; i++)
+    {
+        keys_by_bucket[next_in_bucket[bucket_of_key[i]]++] = i;
+    }
+
+    bool slot_used[N] = {};
+    // The slots which the keys of the current bucket would go to
+    size_t candidate_slots[N] = {};
+
+    // Place the buckets with 2 or more keys, biggest first, while there's the most room
+    for (size_t bucket_size = max_bucket_size; bucket_size >= 2; bucket_size--)
+    {
+        for (size_t b = 0; b < N; b++)
+        {
+            const size_t start = bucket_starts[b];
+            if (bucket_starts[b + 1] - start != bucket_size)
+            {
+                continue;
+            }
+            // Keys with the same `HashKey()` always land in the same slot, whatever the seed, so
+            // they can never be separated. That means duplicate keys, or (extremely rarely) 2
+            // different keys whose 64-bit hashes collide.
+            for (size_t k = 1; k < bucket_size; k++)
+            {
+                for (size_t j = 0; j < k; j++)
+                {
+                    if (hashes[keys_by_bucket[start + j]] == hashes[keys_by_bucket[start + k]])
+                    {
+                        throw std::invalid_argument("Duplicate keys");
+                    }
+                }
+            }
+            for (int32_t displacement = 1; ; displacement++)
+            {
+                if (displacement > MAX_DISPLACEMENT)
+                {
+                    throw std::invalid_argument("Could not place a bucket");
+                }
+                bool fits = true;
+                for (size_t k = 0; k < bucket_size && fits; k++)
+                {
+                    size_t slot = Reduce(MixHash(hashes[keys_by_bucket[start + k]],
+                        (uint64_t)displacement), N);
+                    fits = !slot_used[slot];
+                    // The bucket's own keys must not collide with each other either
+                    for (size_t j = 0; j < k && fits; j++)
+                    {
+                        fits = candidate_slots[j] != slot;
+                    }
+                    candidate_slots[k] = slot;
+                }
+                if (!fits)
+                {
+                    continue;
+                }
+                for (size_t k = 0; k < bucket_size; k++)
+                {
+                    size_t key_index = keys_by_bucket[start + k];
+                    slot_used[candidate_slots[k]] = true;
+                    table.slots_[candidate_slots[k]] = {keys[key_index].data(),
+                        (uint32_t)keys[key_index].size(), (uint32_t)key_index};
+                }
+                table.displacements_[b] = displacement;
+                break;
+            }
+        }
+    }
+
+    // Then, give each bucket with just 1 key the next free slot
+    size_t free_slot = 0;
+    for (size_t b = 0; b < N; b++)
+    {
+        if (bucket_starts[b + 1] - bucket_starts[b] != 1)
+        {
+            continue;
+        }
+        while (slot_used[free_slot])
+        {
+            free_slot++;
+        }
+        size_t key_index = keys_by_bucket[bucket_starts[b]];
+        slot_used[free_slot] = true;
+        table.slots_[free_slot] = {keys[key_index].data(), (uint32_t)keys[key_index].size(),
+            (uint32_t)key_index};
+        table.displacements_[b] = -(int32_t)free_slot - 1;
+    }
+
+    return table;
+}
+
+} // namespace perfect_hash
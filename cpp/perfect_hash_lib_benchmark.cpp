@@ -0,0 +1,436 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark string-to-index lookups in a fixed set of N keys, with the compile-time minimal perfect
+hash from "perfect_hash_lib.h", against the other usual ways to do it, for N = 10, 100, 1000, and
+10000 keys, in ns per lookup, for both hits (keys in the set) and misses (keys not in the set):
+1. `perfect_hash::PerfectHash`: built at compile time
+2. "if-else chain": `if (key == "key0") {...} else if (key == "key1") {...} ...`, which is what a
+   hand-written command parser usually looks like. Generated here with a fold expression.
+3. "switch + if-else chains": `switch (key.size())`, and then an if-else chain of only the keys of
+   that length, each compared with a `memcmp()` of that constant length, which the compiler
+   inlines
+4. `std::unordered_map<std::string_view, size_t>`: built at runtime, with heap allocations
+5. `hash_table::StringHashTable<size_t>` from "eRCaGuy_hash_table.h": built at runtime
+
+The keys are made up at compile time: identifiers of 4 to 19 chars, like "kq_7". Each result is
+checked against the index it should be.
+
+Note that this program takes a while to compile (~3.5 minutes on a 2 GHz VM), mostly because of
+the 10000-key if-else chains.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C++
+```bash
+time g++ -Wall -Wextra -Werror -O3 -std=c++17 perfect_hash_lib_benchmark.cpp ../c/timinglib.c \
+    -o bin/a && bin/a
+```
+
+References:
+1. "perfect_hash_lib.h"
+1. https://en.cppreference.com/w/cpp/language/fold - for the generated if-else chains
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "eRCaGuy_hash_table.h"
+#include "perfect_hash_lib.h"
+
+// C++ includes
+#include <algorithm>  // For `std::shuffle()`
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>  // For `std::index_sequence`
+#include <vector>
+
+// C includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+#include <cstring>  // For `memcmp()`
+
+using perfect_hash::NOT_FOUND;
+
+/// Run each lookup test for at least this long, and report the fastest pass over the queries
+constexpr uint64_t MIN_TIME_NS = 200*1000*1000ULL;
+constexpr size_t MIN_KEY_LEN = 4;
+constexpr size_t MAX_KEY_LEN = 19;
+
+/// The chars of `N` keys, all in one array
+template <size_t N>
+struct KeyChars
+{
+    char chars[N*MAX_KEY_LEN] = {};
+    size_t offsets[N] = {};
+    size_t lens[N] = {};
+};
+
+/// Append `n` in base 36 to `chars` at `*len`.
+constexpr void AppendBase36(size_t n, char* chars, size_t* len)
+{
+    char digits[16] = {};
+    size_t num_digits = 0;
+    do
+    {
+        size_t digit = n % 36;
+        digits[num_digits++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        n /= 36;
+    } while (n > 0);
+    while (num_digits > 0)
+    {
+        chars[(*len)++] = digits[--num_digits];
+    }
+}
+
+/// \brief      Make `N` unique keys: some random letters, then '_' and a unique number, so that
+///             all keys are unique, for key `i` = `first_key` to `first_key + N - 1`.
+/// \details    Passing a different `first_key` makes a different set of keys, of the same kind,
+///             to look up as misses.
+template <size_t N>
+constexpr KeyChars<N> MakeKeyChars(size_t first_key)
+{
+    KeyChars<N> key_chars;
+    uint64_t random = 0x123456789ULL + first_key;
+    size_t offset = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        random = random*6364136223846793005ULL + 1442695040888963407ULL;
+        char suffix[32] = {};
+        size_t suffix_len = 0;
+        suffix[suffix_len++] = '_';
+        AppendBase36(first_key + i, suffix, &suffix_len);
+        size_t len = MIN_KEY_LEN + (size_t)(random >> 33) % (MAX_KEY_LEN - MIN_KEY_LEN + 1);
+        len = len < suffix_len + 1 ? suffix_len + 1 : len;
+
+        key_chars.offsets[i] = offset;
+        key_chars.lens[i] = len;
+        for (size_t j = 0; j < len - suffix_len; j++)
+        {
+            random = random*6364136223846793005ULL + 1442695040888963407ULL;
+            key_chars.chars[offset++] = (char)('a' + (random >> 33) % 26);
+        }
+        for (size_t j = 0; j < suffix_len; j++)
+        {
+            key_chars.chars[offset++] = suffix[j];
+        }
+    }
+    return key_chars;
+}
+
+template <size_t N>
+struct KeyViews
+{
+    std::string_view keys[N] = {};
+};
+
+template <size_t N>
+constexpr KeyViews<N> MakeKeyViews(const KeyChars<N>& key_chars)
+{
+    KeyViews<N> views;
+    for (size_t i = 0; i < N; i++)
+    {
+        views.keys[i] = std::string_view(&key_chars.chars[key_chars.offsets[i]], key_chars.lens[i]);
+    }
+    return views;
+}
+
+/// The `N` keys, and their perfect hash, all made at compile time
+template <size_t N>
+struct Keys
+{
+    static constexpr KeyChars<N> CHARS = MakeKeyChars<N>(0);
+    static constexpr KeyViews<N> VIEWS = MakeKeyViews(CHARS);
+    static constexpr perfect_hash::PerfectHash<N> HASH = perfect_hash::MakePerfectHash(VIEWS.keys);
+};
+
+template <size_t N, size_t... Is>
+size_t IfElseChainLookup(std::string_view key, std::index_sequence<Is...>)
+{
+    size_t index = NOT_FOUND;
+    // `if (key == keys[0]) {index = 0;} else if (key == keys[1]) {index = 1;} else if ...`
+    (void)((key == Keys<N>::VIEWS.keys[Is] ? (index = Is, true) : false) || ...);
+    return index;
+}
+
+/// The indices of the keys which are `LEN` chars long
+template <size_t N, size_t LEN>
+struct KeysOfLength
+{
+    static constexpr size_t Count()
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            count += Keys<N>::VIEWS.keys[i].size() == LEN;
+        }
+        return count;
+    }
+
+    static constexpr size_t COUNT = Count();
+
+    struct Indices
+    {
+        size_t indices[COUNT + 1] = {};
+    };
+
+    static constexpr Indices MakeIndices()
+    {
+        Indices indices;
+        size_t count = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            if (Keys<N>::VIEWS.keys[i].size() == LEN)
+            {
+                indices.indices[count++] = i;
+            }
+        }
+        return indices;
+    }
+
+    static constexpr Indices INDICES = MakeIndices();
+};
+
+template <size_t N, size_t LEN, size_t... Js>
+size_t SameLengthChainLookup(const char* key, std::index_sequence<Js...>)
+{
+    using KeysOfLen = KeysOfLength<N, LEN>;
+    // Unused if there are no keys of this length
+    (void)key;
+    size_t index = NOT_FOUND;
+    (void)((memcmp(key, Keys<N>::VIEWS.keys[KeysOfLen::INDICES.indices[Js]].data(), LEN) == 0 ?
+        (index = KeysOfLen::INDICES.indices[Js], true) : false) || ...);
+    return index;
+}
+
+template <size_t N>
+size_t SwitchLookup(std::string_view key)
+{
+#define LENGTH_CASE(len) \
+    case len: \
+        return SameLengthChainLookup<N, len>(key.data(), \
+            std::make_index_sequence<KeysOfLength<N, len>::COUNT>());
+
+    switch (key.size())
+    {
+        LENGTH_CASE(4)
+        LENGTH_CASE(5)
+        LENGTH_CASE(6)
+        LENGTH_CASE(7)
+        LENGTH_CASE(8)
+        LENGTH_CASE(9)
+        LENGTH_CASE(10)
+        LENGTH_CASE(11)
+        LENGTH_CASE(12)
+        LENGTH_CASE(13)
+        LENGTH_CASE(14)
+        LENGTH_CASE(15)
+        LENGTH_CASE(16)
+        LENGTH_CASE(17)
+        LENGTH_CASE(18)
+        LENGTH_CASE(19)
+        default:
+            return NOT_FOUND;
+    }
+
+#undef LENGTH_CASE
+}
+static_assert(MIN_KEY_LEN == 4 && MAX_KEY_LEN == 19, "Update the `switch` cases above.");
+
+/// The fastest time, in ns, of one lookup of each of the queries
+struct Result
+{
+    double hit_ns = 0;
+    double miss_ns = 0;
+    bool ok = true;
+};
+
+/// Time `lookup(key)` for all of the `hits`, whose `i`th key should be found at `hit_indices[i]`,
+/// and then for all of the `misses`.
+template <typename Lookup>
+Result TimeLookups(Lookup lookup, const std::vector<std::string_view>& hits,
+    const std::vector<size_t>& hit_indices, const std::vector<std::string_view>& misses)
+{
+    Result result;
+    auto time_queries = [&lookup, &result](const std::vector<std::string_view>& queries,
+        const std::vector<size_t>* expected_indices)
+    {
+        uint64_t best_ns = UINT64_MAX;
+        uint64_t total_ns = 0;
+        do
+        {
+            uint64_t start_ns = nanos();
+            size_t num_wrong = 0;
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                size_t index = lookup(queries[i]);
+                num_wrong += index != (expected_indices ? (*expected_indices)[i] : NOT_FOUND);
+            }
+            uint64_t duration_ns = nanos() - start_ns;
+            result.ok &= num_wrong == 0;
+            best_ns = std::min(best_ns, duration_ns);
+            total_ns += duration_ns;
+        } while (total_ns < MIN_TIME_NS);
+        return (double)best_ns / (double)queries.size();
+    };
+    result.hit_ns = time_queries(hits, &hit_indices);
+    result.miss_ns = time_queries(misses, nullptr);
+    return result;
+}
+
+void PrintResult(const char* name, const Result& result, bool* all_ok)
+{
+    printf("  %-28s %10.1f %10.1f%s\n", name, result.hit_ns, result.miss_ns,
+        result.ok ? "" : "   <== WRONG RESULTS!");
+    *all_ok &= result.ok;
+}
+
+template <size_t N>
+void RunBenchmark(bool* all_ok)
+{
+    // Queries: every key, a few times over, in a random order, and as many keys NOT in the set.
+    // They are copied into their own strings, so the keys' chars aren't already known to the
+    // compiler.
+    constexpr size_t NUM_QUERIES = N < 10000 ? 10000 : N;
+    std::mt19937_64 rng(N);
+    std::vector<size_t> hit_indices;
+    for (size_t i = 0; i < NUM_QUERIES; i++)
+    {
+        hit_indices.push_back(i % N);
+    }
+    std::shuffle(hit_indices.begin(), hit_indices.end(), rng);
+    std::string hit_chars;
+    std::vector<size_t> hit_offsets;
+    for (size_t index : hit_indices)
+    {
+        hit_offsets.push_back(hit_chars.size());
+        hit_chars += Keys<N>::VIEWS.keys[index];
+    }
+    std::vector<std::string_view> hits;
+    for (size_t i = 0; i < NUM_QUERIES; i++)
+    {
+        hits.push_back(std::string_view(hit_chars.data() + hit_offsets[i],
+            Keys<N>::VIEWS.keys[hit_indices[i]].size()));
+    }
+
+    // Keys of the same kind as the real ones, but numbered after them, so none of them are in the
+    // set
+    static constexpr KeyChars<NUM_QUERIES> MISS_CHARS = MakeKeyChars<NUM_QUERIES>(N);
+    std::vector<std::string_view> misses;
+    for (size_t i = 0; i < NUM_QUERIES; i++)
+    {
+        misses.push_back(std::string_view(&MISS_CHARS.chars[MISS_CHARS.offsets[i]],
+            MISS_CHARS.lens[i]));
+    }
+
+    printf("\nN = %zu keys:\n", N);
+    printf("  %-28s %10s %10s\n", "method", "hit", "miss");
+
+    PrintResult("PerfectHash", TimeLookups([](std::string_view key)
+    {
+        return Keys<N>::HASH.IndexOf(key);
+    }, hits, hit_indices, misses), all_ok);
+
+    PrintResult("if-else chain", TimeLookups([](std::string_view key)
+    {
+        return IfElseChainLookup<N>(key, std::make_index_sequence<N>());
+    }, hits, hit_indices, misses), all_ok);
+
+    PrintResult("switch + if-else chains", TimeLookups(SwitchLookup<N>, hits, hit_indices,
+        misses), all_ok);
+
+    std::unordered_map<std::string_view, size_t> unordered_map;
+    hash_table::StringHashTable<size_t> string_hash_table;
+    for (size_t i = 0; i < N; i++)
+    {
+        unordered_map[Keys<N>::VIEWS.keys[i]] = i;
+        string_hash_table.Insert(Keys<N>::VIEWS.keys[i], i);
+    }
+
+    PrintResult("std::unordered_map", TimeLookups([&unordered_map](std::string_view key)
+    {
+        auto it = unordered_map.find(key);
+        return it == unordered_map.end() ? NOT_FOUND : it->second;
+    }, hits, hit_indices, misses), all_ok);
+
+    PrintResult("StringHashTable", TimeLookups([&string_hash_table](std::string_view key)
+    {
+        const size_t* index = string_hash_table.Find(key);
+        return index == nullptr ? NOT_FOUND : *index;
+    }, hits, hit_indices, misses), all_ok);
+}
+
+// Lookups of constant keys are done entirely at compile time
+static_assert(Keys<10>::HASH.IndexOf(Keys<10>::VIEWS.keys[7]) == 7);
+static_assert(Keys<10>::HASH.IndexOf("not a key") == NOT_FOUND);
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    printf("Look up a string in a fixed set of N strings, in ns per lookup.\n");
+
+    bool all_ok = true;
+    RunBenchmark<10>(&all_ok);
+    RunBenchmark<100>(&all_ok);
+    RunBenchmark<1000>(&all_ok);
+    RunBenchmark<10000>(&all_ok);
+
+    if (!all_ok)
+    {
+        printf("\nFAILED: some lookups returned the wrong index!\n");
+        return 1;
+    }
+    printf("\nAll lookups returned the right index.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM; the numbers vary from run to run):
+
+    eRCaGuy_hello_world/cpp$ time g++ -Wall -Wextra -Werror -O3 -std=c++17 perfect_hash_lib_benchmark.cpp ../c/timinglib.c -o bin/a && bin/a
+
+    real	3m19.017s
+    user	3m14.237s
+    sys	0m1.836s
+    Look up a string in a fixed set of N strings, in ns per lookup.
+
+    N = 10 keys:
+      method                              hit       miss
+      PerfectHash                        14.0       11.3
+      if-else chain                       9.8        7.7
+      switch + if-else chains            18.9       14.2
+      std::unordered_map                 28.8       27.0
+      StringHashTable                    16.5       10.2
+
+    N = 100 keys:
+      method                              hit       miss
+      PerfectHash                        21.2       17.0
+      if-else chain                      57.9       81.8
+      switch + if-else chains            25.5       24.1
+      std::unordered_map                 41.1       48.9
+      StringHashTable                    17.8       23.0
+
+    N = 1000 keys:
+      method                              hit       miss
+      PerfectHash                        23.9       17.2
+      if-else chain                     632.3     1444.6
+      switch + if-else chains           178.6      337.2
+      std::unordered_map                 57.7       62.0
+      StringHashTable                    20.2       11.5
+
+    N = 10000 keys:
+      method                              hit       miss
+      PerfectHash                        27.6       22.0
+      if-else chain                   12900.0    29472.9
+      switch + if-else chains          5607.7    12475.8
+      std::unordered_map                 62.8       69.9
+      StringHashTable                    24.4       13.6
+
+    All lookups returned the right index.
+
+*/
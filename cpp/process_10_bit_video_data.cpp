@@ -3,9 +3,12 @@
 GS
 17 Mar. 2021
 
+Process packed 10-bit video data: test and benchmark `ProcessPGroup()` and the bulk
+`ProcessPGroups()` SIMD kernels from "process_10_bit_video_data_lib.h".
+
 To compile and run (assuming you've already `cd`ed into this dir):
-    mkdir -p bin && g++ -Wall -Wextra -Werror -ggdb -std=c++17 -o bin/process_10_bit_video_data \
-    process_10_bit_video_data.cpp && bin/process_10_bit_video_data
+    mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -ggdb -std=c++17 -pthread -o bin/process_10_bit_video_data \
+    process_10_bit_video_data.cpp process_10_bit_video_data_lib.cpp && bin/process_10_bit_video_data
 
 
 References:
@@ -13,11 +16,18 @@ References:
 
 */
 
+// Local includes
+#include "process_10_bit_video_data_lib.h"
+
+// C and C++ includes
 #include <bitset>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <random>
+#include <vector>
 
 // enum class PGroupErrorType
 // {
@@ -30,26 +40,6 @@ References:
 //   https://arduino.stackexchange.com/questions/80236/initializing-array-of-structs/80289#80289
 #define ARRAY_LEN(array) (sizeof(array)/sizeof(array[0]))
 
-/// \brief      Process a packed video P group, which is 4 pixels of 10 bits each (exactly 5 uint8_t
-///             bytes) into a uint16_t 4-element array (1 element per pixel).
-/// \details    Each group of 10-bits for a pixel will be placed into a 16-bit word, with all 10
-///             bits left-shifted to the far left edge, leaving 6 empty (zero) bits in the right
-///             side of the word.
-/// \param[in]  byteArrayIn  5 bytes of 10-bit pixel data for exactly 4 pixels; any array size < 5
-///                        will result in undefined behavior! So, ensure you pass the proper array
-///                        size in!
-/// \param[out] twoByteArrayOut  The output array into which the 4 pixels will be packed, 10 bits per
-///                        16-bit word, all 10 bits shifted to the left edge; any array size < 4
-///                        will result in undefined behavior!
-/// \return     None
-void ProcessPGroup(const uint8_t byteArrayIn[5], uint16_t twoByteArrayOut[4])
-{
-    twoByteArrayOut[0] = (((uint16_t)byteArrayIn[0] & 0b11111111u) << (0 + 8)) | (((uint16_t)byteArrayIn[1] & 0b11000000u) << 0);
-    twoByteArrayOut[1] = (((uint16_t)byteArrayIn[1] & 0b00111111u) << (2 + 8)) | (((uint16_t)byteArrayIn[2] & 0b11110000u) << 2);
-    twoByteArrayOut[2] = (((uint16_t)byteArrayIn[2] & 0b00001111u) << (4 + 8)) | (((uint16_t)byteArrayIn[3] & 0b11111100u) << 4);
-    twoByteArrayOut[3] = (((uint16_t)byteArrayIn[3] & 0b00000011u) << (6 + 8)) | (((uint16_t)byteArrayIn[4] & 0b11111111u) << 6);
-}
-
 // Reference: https://stackoverflow.com/questions/7349689/how-to-print-using-cout-a-number-in-binary-form/7349767
 void PrintArrayAsBinary(const uint16_t* twoByteArray, size_t len)
 {
@@ -66,6 +56,109 @@ void PrintArrayAsBinary(const uint16_t* twoByteArray, size_t len)
     std::cout << "}\n";
 }
 
+/// One `ProcessPGroups*()` implementation to test and benchmark
+struct PGroupsImpl
+{
+    const char* name;
+    ProcessPGroupsFunc func;
+    bool supported;
+};
+
+/// Get all implementations, and whether or not this CPU supports each one
+std::vector<PGroupsImpl> GetPGroupsImpls()
+{
+    std::vector<PGroupsImpl> impls = {{"scalar", ProcessPGroupsScalar, true}};
+#if PGROUP_X86
+    __builtin_cpu_init();
+    impls.push_back({"ssse3", ProcessPGroupsSsse3, (bool)__builtin_cpu_supports("ssse3")});
+    impls.push_back({"avx2", ProcessPGroupsAvx2, (bool)__builtin_cpu_supports("avx2")});
+#endif
+    return impls;
+}
+
+/// \brief      Check that `func` matches `ProcessPGroup()` bit for bit, on random data, for every
+///             P group count from 0 to 100 (to cover all vector loop + tail combinations), with
+///             the input and output at every alignment offset from 0 to 31 bytes, and without
+///             writing past the end of the output.
+/// \return     true if all checks pass, and false otherwise
+bool TestProcessPGroups(ProcessPGroupsFunc func)
+{
+    constexpr size_t MAX_GROUPS = 100;
+    constexpr uint16_t GUARD = 0xBEEF;
+
+    std::mt19937 rng(12345);
+    std::vector<uint8_t> in_buf(MAX_GROUPS*PGROUP_NUM_BYTES + 32);
+    std::vector<uint16_t> expected(MAX_GROUPS*PGROUP_NUM_PIXELS);
+    std::vector<uint16_t> out_buf(MAX_GROUPS*PGROUP_NUM_PIXELS + 32);
+
+    for (size_t offset = 0; offset < 32; offset++)
+    {
+        for (size_t n_groups = 0; n_groups <= MAX_GROUPS; n_groups++)
+        {
+            uint8_t* in = &in_buf[offset];
+            uint16_t* out = &out_buf[offset/2];
+            for (uint8_t& byte : in_buf)
+            {
+                byte = (uint8_t)rng();
+            }
+            for (uint16_t& word : out_buf)
+            {
+                word = GUARD;
+            }
+
+            ProcessPGroupsScalar(in, n_groups, expected.data());
+            func(in, n_groups, out);
+
+            size_t n_pixels = n_groups*PGROUP_NUM_PIXELS;
+            if (std::memcmp(out, expected.data(), n_pixels*sizeof(uint16_t)) != 0
+                || out[n_pixels] != GUARD)
+            {
+                printf("  mismatch at offset = %zu, n_groups = %zu\n", offset, n_groups);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/// \brief      Benchmark `func` on one 4K (3840 x 2160) frame of 10-bit pixels (~10.4 MB), and
+///             print its throughput in GB/s of packed input and in frames per second.
+/// \return     The throughput, in GB/s of packed input
+double BenchmarkProcessPGroups(const char* name, ProcessPGroupsFunc func)
+{
+    constexpr size_t NUM_PIXELS = 3840*2160;
+    constexpr size_t NUM_GROUPS = NUM_PIXELS/PGROUP_NUM_PIXELS;
+    constexpr size_t NUM_FRAMES = 100;
+
+    std::vector<uint8_t> in(NUM_GROUPS*PGROUP_NUM_BYTES);
+    std::vector<uint16_t> out(NUM_PIXELS);
+    std::mt19937 rng(12345);
+    for (uint8_t& byte : in)
+    {
+        byte = (uint8_t)rng();
+    }
+
+    // Warm up: fault in the output pages and fill the caches
+    func(in.data(), NUM_GROUPS, out.data());
+
+    auto t_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_FRAMES; i++)
+    {
+        func(in.data(), NUM_GROUPS, out.data());
+    }
+    auto t_end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(t_end - t_start).count();
+    double gb_per_sec = (double)(in.size()*NUM_FRAMES)/seconds/1e9;
+    double frames_per_sec = NUM_FRAMES/seconds;
+    printf("  %-7s %7.2f GB/s in (%7.2f GB/s out), %8.1f 4K frames/sec, %6.3f ms/frame\n",
+        name, gb_per_sec, gb_per_sec*(sizeof(uint16_t)*PGROUP_NUM_PIXELS)/PGROUP_NUM_BYTES,
+        frames_per_sec, 1000.0/frames_per_sec);
+
+    return gb_per_sec;
+}
+
 int main()
 {
     printf("Processing 10-bit video data example\n");
@@ -92,14 +185,65 @@ int main()
         PrintArrayAsBinary(twoByteArrayOut, ARRAY_LEN(twoByteArrayOut));
     }
 
+    const char* func_name;
+    GetProcessPGroupsFunc(&func_name);
+    printf("\nProcessPGroups() uses the \"%s\" kernel on this CPU.\n", func_name);
+
+    std::vector<PGroupsImpl> impls = GetPGroupsImpls();
+
+    printf("\nBulk ProcessPGroups*() tests against ProcessPGroup():\n");
+    for (const PGroupsImpl& impl : impls)
+    {
+        if (!impl.supported)
+        {
+            printf("  %-7s skipped (not supported by this CPU)\n", impl.name);
+            continue;
+        }
+        printf("  %-7s %s\n", impl.name,
+            TestProcessPGroups(impl.func) ? "TEST PASSED!" : "TEST ==FAILED!==");
+    }
+
+    printf("\nBulk ProcessPGroups*() benchmark (1 4K frame, 10-bit):\n");
+    double scalar_gb_per_sec = 0;
+    for (const PGroupsImpl& impl : impls)
+    {
+        if (!impl.supported)
+        {
+            continue;
+        }
+        double gb_per_sec = BenchmarkProcessPGroups(impl.name, impl.func);
+        if (impl.func == ProcessPGroupsScalar)
+        {
+            scalar_gb_per_sec = gb_per_sec;
+        }
+        else
+        {
+            printf("          = %.2fx the scalar loop\n", gb_per_sec/scalar_gb_per_sec);
+        }
+    }
+
     return 0;
 }
 
 /*
 SAMPLE OUTPUT:
 
-    $ g++ -Wall -Wextra -Werror -ggdb -std=c++17 -o bin/process_10_bit_video_data     process_10_bit_video_data.cpp && bin/process_10_bit_video_data
+    $ g++ -Wall -Wextra -Werror -O3 -ggdb -std=c++17 -pthread -o bin/process_10_bit_video_data     process_10_bit_video_data.cpp process_10_bit_video_data_lib.cpp && bin/process_10_bit_video_data
     Processing 10-bit video data example
     TEST PASSED!
 
+    ProcessPGroups() uses the "avx2" kernel on this CPU.
+
+    Bulk ProcessPGroups*() tests against ProcessPGroup():
+      scalar  TEST PASSED!
+      ssse3   TEST PASSED!
+      avx2    TEST PASSED!
+
+    Bulk ProcessPGroups*() benchmark (1 4K frame, 10-bit):
+      scalar     1.54 GB/s in (   2.46 GB/s out),    148.4 4K frames/sec,  6.737 ms/frame
+      ssse3      3.31 GB/s in (   5.29 GB/s out),    318.9 4K frames/sec,  3.136 ms/frame
+              = 2.15x the scalar loop
+      avx2       4.43 GB/s in (   7.08 GB/s out),    426.9 4K frames/sec,  2.342 ms/frame
+              = 2.88x the scalar loop
+
 */
@@ -0,0 +1,596 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+References:
+1. https://en.cppreference.com/w/cpp/thread/condition_variable
+
+*/
+
+// Local includes
+#include "process_10_bit_video_data_lib.h"
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#if PGROUP_X86
+#include <algorithm>  // For `std::min()`
+#include <immintrin.h>
+#endif
+
+void ProcessPGroup(const uint8_t byteArrayIn[5], uint16_t twoByteArrayOut[4])
+{
+    twoByteArrayOut[0] = (((uint16_t)byteArrayIn[0] & 0b11111111u) << (0 + 8)) | (((uint16_t)byteArrayIn[1] & 0b11000000u) << 0);
+    twoByteArrayOut[1] = (((uint16_t)byteArrayIn[1] & 0b00111111u) << (2 + 8)) | (((uint16_t)byteArrayIn[2] & 0b11110000u) << 2);
+    twoByteArrayOut[2] = (((uint16_t)byteArrayIn[2] & 0b00001111u) << (4 + 8)) | (((uint16_t)byteArrayIn[3] & 0b11111100u) << 4);
+    twoByteArrayOut[3] = (((uint16_t)byteArrayIn[3] & 0b00000011u) << (6 + 8)) | (((uint16_t)byteArrayIn[4] & 0b11111111u) << 6);
+}
+
+void ProcessPGroupsScalar(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    for (size_t i = 0; i < n_groups; i++)
+    {
+        ProcessPGroup(&in[i*PGROUP_NUM_BYTES], &out[i*PGROUP_NUM_PIXELS]);
+    }
+}
+
+#if PGROUP_X86
+
+// Each 16-byte load only uses its first 10 bytes, so the vector loop stops while at least 16 input
+// bytes (4 P groups) remain, and leaves the rest to the scalar tail.
+__attribute__((target("ssse3")))
+void ProcessPGroupsSsse3(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    // For each output word, the indices of its {low, high} bytes: {byte[k + 1], byte[k]}, for
+    // pixel `k` of P group 0 (bytes 0-4) and then P group 1 (bytes 5-9)
+    const __m128i shuffle = _mm_setr_epi8(
+        1, 0, 2, 1, 3, 2, 4, 3,
+        6, 5, 7, 6, 8, 7, 9, 8);
+    // Multipliers to left-shift pixel `k` by `2*k` bits
+    const __m128i shift = _mm_setr_epi16(1, 4, 16, 64, 1, 4, 16, 64);
+    const __m128i mask = _mm_set1_epi16((short)0xFFC0);
+
+    size_t i = 0;
+    for (; i + 4 <= n_groups; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)&in[i*PGROUP_NUM_BYTES]);
+        v = _mm_shuffle_epi8(v, shuffle);
+        v = _mm_and_si128(_mm_mullo_epi16(v, shift), mask);
+        _mm_storeu_si128((__m128i*)&out[i*PGROUP_NUM_PIXELS], v);
+    }
+
+    ProcessPGroupsScalar(&in[i*PGROUP_NUM_BYTES], n_groups - i, &out[i*PGROUP_NUM_PIXELS]);
+}
+
+/// Load 4 P groups starting at `p`: groups 0-1 into the low 128-bit lane and groups 2-3 into the
+/// high lane, for the AVX2 kernel
+__attribute__((target("avx2")))
+static inline __m256i LoadPGroupsx4(const uint8_t* p)
+{
+    __m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p));
+    return _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i*)(p + 2*PGROUP_NUM_BYTES)), 1);
+}
+
+// `vpshufb` can't move bytes across 128-bit lanes, so each lane gets its own 16-byte load of 2 P
+// groups, and then uses the same shuffle as the SSSE3 kernel. Each loop iteration does 2
+// independent vectors (8 P groups); its last load starts 30 bytes in, so the vector loop stops
+// while at least 46 input bytes (10 P groups) remain.
+__attribute__((target("avx2")))
+void ProcessPGroupsAvx2(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 3, 2, 4, 3,
+        6, 5, 7, 6, 8, 7, 9, 8,
+        1, 0, 2, 1, 3, 2, 4, 3,
+        6, 5, 7, 6, 8, 7, 9, 8);
+    const __m256i shift = _mm256_setr_epi16(
+        1, 4, 16, 64, 1, 4, 16, 64,
+        1, 4, 16, 64, 1, 4, 16, 64);
+    const __m256i mask = _mm256_set1_epi16((short)0xFFC0);
+
+    size_t i = 0;
+    for (; i + 10 <= n_groups; i += 8)
+    {
+        const uint8_t* p = &in[i*PGROUP_NUM_BYTES];
+        __m256i v0 = LoadPGroupsx4(p);
+        __m256i v1 = LoadPGroupsx4(p + 4*PGROUP_NUM_BYTES);
+        v0 = _mm256_shuffle_epi8(v0, shuffle);
+        v1 = _mm256_shuffle_epi8(v1, shuffle);
+        v0 = _mm256_and_si256(_mm256_mullo_epi16(v0, shift), mask);
+        v1 = _mm256_and_si256(_mm256_mullo_epi16(v1, shift), mask);
+        _mm256_storeu_si256((__m256i*)&out[i*PGROUP_NUM_PIXELS], v0);
+        _mm256_storeu_si256((__m256i*)&out[(i + 4)*PGROUP_NUM_PIXELS], v1);
+    }
+
+    // Let the SSSE3 kernel (a subset of AVX2) finish the rest, down to its own scalar tail
+    ProcessPGroupsSsse3(&in[i*PGROUP_NUM_BYTES], n_groups - i, &out[i*PGROUP_NUM_PIXELS]);
+}
+
+#endif // PGROUP_X86
+
+ProcessPGroupsFunc GetProcessPGroupsFunc(const char** name)
+{
+    ProcessPGroupsFunc func = ProcessPGroupsScalar;
+    const char* func_name = "scalar";
+
+#if PGROUP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        func = ProcessPGroupsAvx2;
+        func_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("ssse3"))
+    {
+        func = ProcessPGroupsSsse3;
+        func_name = "ssse3";
+    }
+#endif
+
+    if (name != nullptr)
+    {
+        *name = func_name;
+    }
+    return func;
+}
+
+void ProcessPGroups(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    static const ProcessPGroupsFunc func = GetProcessPGroupsFunc();
+    func(in, n_groups, out);
+}
+
+// -------------------------------------------------------------------------------------------------
+// PackPixels<BITS>() and UnpackPixels<BITS>()
+// -------------------------------------------------------------------------------------------------
+
+#if PGROUP_X86
+
+// Like the 10-bit kernel: pixel 2*g of 12-bit group `g` is the top 12 bits of the big-endian word
+// at byte 3*g, and pixel 2*g + 1 is the word at byte 3*g + 1, shifted left 4 bits. Each 16-byte
+// load uses 12 bytes (4 groups), so the vector loop stops while at least 6 groups remain.
+__attribute__((target("ssse3")))
+void UnpackPixels12Ssse3(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    using Format = PackedPixelFormat<12>;
+    const __m128i shuffle = _mm_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4,
+        7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i shift = _mm_setr_epi16(1, 16, 1, 16, 1, 16, 1, 16);
+    const __m128i mask = _mm_set1_epi16((short)0xFFF0);
+
+    size_t i = 0;
+    for (; i + 6 <= n_groups; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)&in[i*Format::GROUP_NUM_BYTES]);
+        v = _mm_shuffle_epi8(v, shuffle);
+        v = _mm_and_si128(_mm_mullo_epi16(v, shift), mask);
+        _mm_storeu_si128((__m128i*)&out[i*Format::GROUP_NUM_PIXELS], v);
+    }
+
+    UnpackPixelsScalar<12>(&in[i*Format::GROUP_NUM_BYTES], n_groups - i,
+        &out[i*Format::GROUP_NUM_PIXELS]);
+}
+
+// 8 groups (24 bytes in, 16 pixels out) per 256-bit vector. The high lane's load starts 12 bytes
+// in, so the vector loop stops while at least 28 bytes (10 groups) remain.
+__attribute__((target("avx2")))
+void UnpackPixels12Avx2(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    using Format = PackedPixelFormat<12>;
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4,
+        7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4,
+        7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shift = _mm256_setr_epi16(
+        1, 16, 1, 16, 1, 16, 1, 16,
+        1, 16, 1, 16, 1, 16, 1, 16);
+    const __m256i mask = _mm256_set1_epi16((short)0xFFF0);
+
+    size_t i = 0;
+    for (; i + 10 <= n_groups; i += 8)
+    {
+        const uint8_t* p = &in[i*Format::GROUP_NUM_BYTES];
+        __m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p));
+        v = _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_and_si256(_mm256_mullo_epi16(v, shift), mask);
+        _mm256_storeu_si256((__m256i*)&out[i*Format::GROUP_NUM_PIXELS], v);
+    }
+
+    UnpackPixels12Ssse3(&in[i*Format::GROUP_NUM_BYTES], n_groups - i,
+        &out[i*Format::GROUP_NUM_PIXELS]);
+}
+
+/// Pack 2 10-bit P groups (8 left-aligned pixels) into the low 10 bytes of a 128-bit vector.
+__attribute__((target("ssse3")))
+static inline __m128i PackPGroupsx2(__m128i v)
+{
+    // Right-align the pixels, then merge pixel pairs into 20-bit values: (p0 << 10) | p1
+    v = _mm_madd_epi16(_mm_srli_epi16(v, 6), _mm_setr_epi16(1024, 1, 1024, 1, 1024, 1, 1024, 1));
+    // Merge those pairs into one 40-bit P group per 64-bit lane: (p01 << 20) | p23
+    v = _mm_or_si128(_mm_srli_epi64(_mm_slli_epi64(v, 32), 12), _mm_srli_epi64(v, 32));
+    // Gather the 5 low bytes of each 64-bit lane, most-significant byte first
+    return _mm_shuffle_epi8(v, _mm_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10,
+        9, 8, -1, -1, -1, -1, -1, -1));
+}
+
+// Each 16-byte store writes 10 valid bytes (2 P groups), and 6 bytes which the next store
+// overwrites, so the vector loop stops while at least 16 output bytes (4 P groups) remain.
+__attribute__((target("ssse3")))
+void PackPixels10Ssse3(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+    using Format = PackedPixelFormat<10>;
+
+    size_t i = 0;
+    for (; i + 4 <= n_groups; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)&in[i*Format::GROUP_NUM_PIXELS]);
+        _mm_storeu_si128((__m128i*)&out[i*Format::GROUP_NUM_BYTES], PackPGroupsx2(v));
+    }
+
+    PackPixelsScalar<10>(&in[i*Format::GROUP_NUM_PIXELS], n_groups - i,
+        &out[i*Format::GROUP_NUM_BYTES]);
+}
+
+// The same math as `PackPGroupsx2()`, on 4 P groups per 256-bit vector, then each 128-bit lane's 10
+// bytes are stored separately. The high lane's store ends 26 bytes in, so the vector loop stops
+// while at least 6 P groups remain.
+__attribute__((target("avx2")))
+void PackPixels10Avx2(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+    using Format = PackedPixelFormat<10>;
+    const __m256i madd = _mm256_setr_epi16(
+        1024, 1, 1024, 1, 1024, 1, 1024, 1,
+        1024, 1, 1024, 1, 1024, 1, 1024, 1);
+    const __m256i shuffle = _mm256_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10,
+        9, 8, -1, -1, -1, -1, -1, -1,
+        4, 3, 2, 1, 0, 12, 11, 10,
+        9, 8, -1, -1, -1, -1, -1, -1);
+
+    size_t i = 0;
+    for (; i + 6 <= n_groups; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)&in[i*Format::GROUP_NUM_PIXELS]);
+        v = _mm256_madd_epi16(_mm256_srli_epi16(v, 6), madd);
+        v = _mm256_or_si256(_mm256_srli_epi64(_mm256_slli_epi64(v, 32), 12),
+            _mm256_srli_epi64(v, 32));
+        v = _mm256_shuffle_epi8(v, shuffle);
+        uint8_t* p = &out[i*Format::GROUP_NUM_BYTES];
+        _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i*)(p + 2*Format::GROUP_NUM_BYTES), _mm256_extracti128_si256(v, 1));
+    }
+
+    PackPixels10Ssse3(&in[i*Format::GROUP_NUM_PIXELS], n_groups - i,
+        &out[i*Format::GROUP_NUM_BYTES]);
+}
+
+// Right-align the pixels, merge each pair into one 24-bit group per 32-bit lane: (p0 << 12) | p1,
+// and gather the 3 low bytes of each lane, most-significant byte first. Each 16-byte store writes
+// 12 valid bytes (4 groups), so the vector loop stops while at least 6 groups remain.
+__attribute__((target("ssse3")))
+void PackPixels12Ssse3(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+    using Format = PackedPixelFormat<12>;
+    const __m128i madd = _mm_setr_epi16(4096, 1, 4096, 1, 4096, 1, 4096, 1);
+    const __m128i shuffle = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9,
+        8, 14, 13, 12, -1, -1, -1, -1);
+
+    size_t i = 0;
+    for (; i + 6 <= n_groups; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)&in[i*Format::GROUP_NUM_PIXELS]);
+        v = _mm_madd_epi16(_mm_srli_epi16(v, 4), madd);
+        v = _mm_shuffle_epi8(v, shuffle);
+        _mm_storeu_si128((__m128i*)&out[i*Format::GROUP_NUM_BYTES], v);
+    }
+
+    PackPixelsScalar<12>(&in[i*Format::GROUP_NUM_PIXELS], n_groups - i,
+        &out[i*Format::GROUP_NUM_BYTES]);
+}
+
+// 8 groups per 256-bit vector, with each 128-bit lane's 12 bytes stored separately. The high
+// lane's store ends 28 bytes in, so the vector loop stops while at least 10 groups remain.
+__attribute__((target("avx2")))
+void PackPixels12Avx2(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+    using Format = PackedPixelFormat<12>;
+    const __m256i madd = _mm256_setr_epi16(
+        4096, 1, 4096, 1, 4096, 1, 4096, 1,
+        4096, 1, 4096, 1, 4096, 1, 4096, 1);
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9,
+        8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9,
+        8, 14, 13, 12, -1, -1, -1, -1);
+
+    size_t i = 0;
+    for (; i + 10 <= n_groups; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)&in[i*Format::GROUP_NUM_PIXELS]);
+        v = _mm256_madd_epi16(_mm256_srli_epi16(v, 4), madd);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        uint8_t* p = &out[i*Format::GROUP_NUM_BYTES];
+        _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i*)(p + 12), _mm256_extracti128_si256(v, 1));
+    }
+
+    PackPixels12Ssse3(&in[i*Format::GROUP_NUM_PIXELS], n_groups - i,
+        &out[i*Format::GROUP_NUM_BYTES]);
+}
+
+/// Pick the AVX2, SSSE3, or scalar version of a kernel, in that order of preference, for the CPU
+/// we are running on.
+template <typename Func>
+static Func SelectKernel(Func avx2, Func ssse3, Func scalar)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return avx2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return ssse3;
+    }
+    return scalar;
+}
+
+#endif // PGROUP_X86
+
+template <>
+void UnpackPixels<10>(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    ProcessPGroups(in, n_groups, out);
+}
+
+template <>
+void UnpackPixels<12>(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+#if PGROUP_X86
+    static const ProcessPGroupsFunc func = SelectKernel<ProcessPGroupsFunc>(
+        UnpackPixels12Avx2, UnpackPixels12Ssse3, UnpackPixelsScalar<12>);
+#else
+    static const ProcessPGroupsFunc func = UnpackPixelsScalar<12>;
+#endif
+    func(in, n_groups, out);
+}
+
+template <>
+void PackPixels<10>(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+#if PGROUP_X86
+    static const PackPixelsFunc func = SelectKernel<PackPixelsFunc>(
+        PackPixels10Avx2, PackPixels10Ssse3, PackPixelsScalar<10>);
+#else
+    static const PackPixelsFunc func = PackPixelsScalar<10>;
+#endif
+    func(in, n_groups, out);
+}
+
+template <>
+void PackPixels<12>(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+#if PGROUP_X86
+    static const PackPixelsFunc func = SelectKernel<PackPixelsFunc>(
+        PackPixels12Avx2, PackPixels12Ssse3, PackPixelsScalar<12>);
+#else
+    static const PackPixelsFunc func = PackPixelsScalar<12>;
+#endif
+    func(in, n_groups, out);
+}
+
+// -------------------------------------------------------------------------------------------------
+// VideoConversionPipeline
+// -------------------------------------------------------------------------------------------------
+
+VideoConversionPipeline::VideoConversionPipeline(size_t width, size_t height, size_t num_workers,
+    size_t stripe_num_bytes)
+    : width_(width),
+      height_(height),
+      num_pixels_(width*height),
+      packed_frame_num_bytes_(num_pixels_/PGROUP_NUM_PIXELS*PGROUP_NUM_BYTES)
+{
+    size_t row_num_bytes = width_/PGROUP_NUM_PIXELS*PGROUP_NUM_BYTES + width_*sizeof(uint16_t);
+    rows_per_stripe_ = row_num_bytes == 0 ? 1 : stripe_num_bytes/row_num_bytes;
+    if (rows_per_stripe_ == 0)
+    {
+        rows_per_stripe_ = 1;
+    }
+    num_stripes_ = (height_ + rows_per_stripe_ - 1)/rows_per_stripe_;
+
+    for (size_t i = 0; i < NUM_BUFFERS; i++)
+    {
+        packed_frames_[i].resize(packed_frame_num_bytes_);
+        frames_[i].resize(num_pixels_);
+    }
+
+    if (num_workers == 0)
+    {
+        num_workers = std::thread::hardware_concurrency();
+        if (num_workers == 0)
+        {
+            num_workers = 1;
+        }
+    }
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        workers_.emplace_back(&VideoConversionPipeline::WorkerLoop, this);
+    }
+}
+
+VideoConversionPipeline::~VideoConversionPipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exit_ = true;
+    }
+    job_cv_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void VideoConversionPipeline::WorkerLoop()
+{
+    uint64_t generation_seen = 0;
+    const size_t row_num_groups = width_/PGROUP_NUM_PIXELS;
+
+    while (true)
+    {
+        const uint8_t* in;
+        uint16_t* out;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_cv_.wait(lock, [&]{ return exit_ || job_generation_ != generation_seen; });
+            if (exit_)
+            {
+                return;
+            }
+            generation_seen = job_generation_;
+            in = job_in_;
+            out = job_out_;
+        }
+
+        size_t stripe;
+        while ((stripe = next_stripe_.fetch_add(1, std::memory_order_relaxed)) < num_stripes_)
+        {
+            size_t row_start = stripe*rows_per_stripe_;
+            size_t num_rows = std::min(rows_per_stripe_, height_ - row_start);
+            size_t group_start = row_start*row_num_groups;
+            ProcessPGroups(&in[group_start*PGROUP_NUM_BYTES], num_rows*row_num_groups,
+                &out[group_start*PGROUP_NUM_PIXELS]);
+        }
+
+        bool last_worker_done;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            num_workers_done_++;
+            last_worker_done = num_workers_done_ == workers_.size();
+        }
+        if (last_worker_done)
+        {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void VideoConversionPipeline::StartConversion(size_t buffer_index)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_in_ = packed_frames_[buffer_index].data();
+        job_out_ = frames_[buffer_index].data();
+        next_stripe_.store(0, std::memory_order_relaxed);
+        num_workers_done_ = 0;
+        job_generation_++;
+    }
+    job_cv_.notify_all();
+}
+
+void VideoConversionPipeline::WaitForConversion()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&]{ return num_workers_done_ == workers_.size(); });
+}
+
+std::string VideoConversionPipeline::Run(const ReadFrameFunc& read_frame,
+    const FrameDoneFunc& frame_done, uint64_t* num_frames)
+{
+    if (width_ % PGROUP_NUM_PIXELS != 0)
+    {
+        return "frame width (" + std::to_string(width_) + ") is not a multiple of "
+            + std::to_string(PGROUP_NUM_PIXELS);
+    }
+
+    // State shared with the reader thread: whether each input buffer holds a frame which has been
+    // read but not yet converted, and whether the stream has ended
+    std::mutex reader_mutex;
+    std::condition_variable reader_cv;
+    bool filled[NUM_BUFFERS] = {};
+    bool end_of_stream = false;
+
+    std::thread reader([&]
+    {
+        for (uint64_t i = 0; ; i++)
+        {
+            size_t b = i % NUM_BUFFERS;
+            {
+                std::unique_lock<std::mutex> lock(reader_mutex);
+                reader_cv.wait(lock, [&]{ return !filled[b]; });
+            }
+
+            bool ok = read_frame(packed_frames_[b].data());
+
+            {
+                std::lock_guard<std::mutex> lock(reader_mutex);
+                if (ok)
+                {
+                    filled[b] = true;
+                }
+                else
+                {
+                    end_of_stream = true;
+                }
+            }
+            reader_cv.notify_all();
+            if (!ok)
+            {
+                return;
+            }
+        }
+    });
+
+    uint64_t i = 0;
+    for (; ; i++)
+    {
+        size_t b = i % NUM_BUFFERS;
+        {
+            std::unique_lock<std::mutex> lock(reader_mutex);
+            reader_cv.wait(lock, [&]{ return filled[b] || end_of_stream; });
+            if (!filled[b])
+            {
+                break;
+            }
+        }
+
+        // Convert frame i while handing the previous frame, from the other output buffer, to the
+        // consumer
+        StartConversion(b);
+        if (i > 0)
+        {
+            frame_done(i - 1, frames_[(i - 1) % NUM_BUFFERS].data());
+        }
+        WaitForConversion();
+
+        // Let the reader reuse this input buffer
+        {
+            std::lock_guard<std::mutex> lock(reader_mutex);
+            filled[b] = false;
+        }
+        reader_cv.notify_all();
+    }
+
+    if (i > 0)
+    {
+        frame_done(i - 1, frames_[(i - 1) % NUM_BUFFERS].data());
+    }
+    reader.join();
+
+    if (num_frames != nullptr)
+    {
+        *num_frames = i;
+    }
+    return "OK";
+}
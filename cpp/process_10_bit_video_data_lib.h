@@ -0,0 +1,329 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+GS
+17 Mar. 2021
+
+A library to process packed 10-bit video data: unpack each "P group" of 4 pixels x 10 bits (5
+bytes) into 4 left-aligned `uint16_t` words.
+1. `ProcessPGroup()` unpacks one P group.
+2. `ProcessPGroups()` unpacks a whole frame at once, with SSSE3 or AVX2 byte-shuffle kernels when
+   the CPU supports them.
+3. `VideoConversionPipeline` unpacks a whole stream of frames, on a thread pool.
+4. `PackPixels<BITS>()` and `UnpackPixels<BITS>()` convert between left-aligned `uint16_t` pixels
+   and packed 10-bit or 12-bit pixels, in either direction, with SIMD kernels for both.
+
+How the SIMD kernels work:
+Pixel `k` (0 to 3) of a P group is the 10 bits which start `2*k` bits into byte `k` of the group,
+counting from the MSB. So, if we build the big-endian 16-bit word `(byte[k] << 8) | byte[k + 1]`,
+then pixel `k`, left-aligned, is just `(word << 2*k) & 0xFFC0`. One `pshufb` byte shuffle builds
+those words for 2 P groups (8 pixels) per 128-bit lane, one 16-bit multiply by {1, 4, 16, 64}
+does the per-pixel left shift (SSE and AVX2 have no per-16-bit-lane variable shift), and one AND
+clears the 6 low bits.
+
+Packing (the reverse direction) works the same way, backwards: shift each pixel right to
+right-align it, merge pairs of pixels into 32-bit words with one `pmaddwd` multiply-add (by
+{2^BITS, 1}), merge those into 40-bit P groups (10-bit only), and gather the bytes of each group in
+big-endian order with one `pshufb`.
+
+STATUS: done and works!
+
+To compile and run:
+- See "process_10_bit_video_data.cpp", "process_10_bit_video_data_pipeline.cpp", and
+  "process_10_bit_video_data_pack_unpack.cpp" as examples.
+
+References:
+1. [my answer] https://stackoverflow.com/questions/66676585/add-bit-padding-bit-shifting-to-10bit-values-stored-in-a-byte-array/66678338#66678338
+1. https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+1. https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html - for `__builtin_cpu_supports()`
+
+*/
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>  // For `size_t`
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PGROUP_X86 1
+#else
+#define PGROUP_X86 0
+#endif
+
+/// Number of bytes in one packed P group
+constexpr size_t PGROUP_NUM_BYTES = 5;
+/// Number of pixels (`uint16_t` output words) in one P group
+constexpr size_t PGROUP_NUM_PIXELS = 4;
+
+/// \brief      Process a packed video P group, which is 4 pixels of 10 bits each (exactly 5 uint8_t
+///             bytes) into a uint16_t 4-element array (1 element per pixel).
+/// \details    Each group of 10-bits for a pixel will be placed into a 16-bit word, with all 10
+///             bits left-shifted to the far left edge, leaving 6 empty (zero) bits in the right
+///             side of the word.
+/// \param[in]  byteArrayIn  5 bytes of 10-bit pixel data for exactly 4 pixels; any array size < 5
+///                        will result in undefined behavior! So, ensure you pass the proper array
+///                        size in!
+/// \param[out] twoByteArrayOut  The output array into which the 4 pixels will be packed, 10 bits per
+///                        16-bit word, all 10 bits shifted to the left edge; any array size < 4
+///                        will result in undefined behavior!
+/// \return     None
+void ProcessPGroup(const uint8_t byteArrayIn[5], uint16_t twoByteArrayOut[4]);
+
+/// \brief      Process `n_groups` consecutive P groups, one at a time, with `ProcessPGroup()`.
+/// \details    This is the portable reference implementation, and the tail path of the SIMD
+///             kernels below.
+/// \param[in]  in        `n_groups*5` bytes of packed 10-bit pixel data
+/// \param[in]  n_groups  Number of P groups to process
+/// \param[out] out       `n_groups*4` output words
+/// \return     None
+void ProcessPGroupsScalar(const uint8_t* in, size_t n_groups, uint16_t* out);
+
+#if PGROUP_X86
+/// SSSE3 kernel: 2 P groups (10 bytes in, 8 pixels out) per 128-bit vector. Only call it if
+/// `__builtin_cpu_supports("ssse3")`.
+void ProcessPGroupsSsse3(const uint8_t* in, size_t n_groups, uint16_t* out);
+/// AVX2 kernel: 4 P groups (20 bytes in, 16 pixels out) per 256-bit vector. Only call it if
+/// `__builtin_cpu_supports("avx2")`.
+void ProcessPGroupsAvx2(const uint8_t* in, size_t n_groups, uint16_t* out);
+#endif
+
+/// A `ProcessPGroups*()` implementation
+using ProcessPGroupsFunc = void (*)(const uint8_t* in, size_t n_groups, uint16_t* out);
+
+/// \brief      Get the fastest `ProcessPGroups*()` implementation which the CPU we are running on
+///             supports: AVX2, then SSSE3, then scalar.
+/// \param[out] name  (Optional) The name of the implementation
+/// \return     The implementation
+ProcessPGroupsFunc GetProcessPGroupsFunc(const char** name = nullptr);
+
+/// \brief      Process `n_groups` consecutive packed P groups (`n_groups*5` bytes) into
+///             `n_groups*4` left-aligned `uint16_t` pixels, exactly as if `ProcessPGroup()` were
+///             called on each P group, but several times faster, using the fastest SIMD kernel
+///             which the CPU supports.
+/// \details    The kernel is chosen once, at the first call. `in` and `out` need not be aligned,
+///             and must not overlap.
+/// \param[in]  in        `n_groups*5` bytes of packed 10-bit pixel data
+/// \param[in]  n_groups  Number of P groups to process; any number, including 0, is OK
+/// \param[out] out       `n_groups*4` output words
+/// \return     None
+void ProcessPGroups(const uint8_t* in, size_t n_groups, uint16_t* out);
+
+/// The layout of a packed pixel format with `BITS` bits per pixel: the pixels are packed MSB-first,
+/// into the smallest whole number of bytes (a "group"), exactly like the 10-bit P group. Each
+/// unpacked pixel is a `uint16_t`, with its `BITS` bits left-aligned and the rest 0.
+/// Only 10-bit and 12-bit formats are defined.
+template <unsigned BITS>
+struct PackedPixelFormat;
+
+template <>
+struct PackedPixelFormat<10>
+{
+    static constexpr size_t GROUP_NUM_BYTES = 5;
+    static constexpr size_t GROUP_NUM_PIXELS = 4;
+};
+
+template <>
+struct PackedPixelFormat<12>
+{
+    static constexpr size_t GROUP_NUM_BYTES = 3;
+    static constexpr size_t GROUP_NUM_PIXELS = 2;
+};
+
+/// \brief      Unpack `n_groups` groups of `BITS`-bit pixels into left-aligned `uint16_t`s, one
+///             pixel at a time. This is the portable reference implementation, and the tail path of
+///             the SIMD kernels. For `BITS` = 10, it matches `ProcessPGroup()` exactly.
+template <unsigned BITS>
+void UnpackPixelsScalar(const uint8_t* in, size_t n_groups, uint16_t* out)
+{
+    using Format = PackedPixelFormat<BITS>;
+    constexpr unsigned GROUP_NUM_BITS = Format::GROUP_NUM_BYTES*8;
+    constexpr uint64_t PIXEL_MASK = (1u << BITS) - 1;
+
+    for (size_t i = 0; i < n_groups; i++)
+    {
+        // Read the whole group as one big-endian integer, then slice the pixels out of it
+        uint64_t group = 0;
+        for (size_t b = 0; b < Format::GROUP_NUM_BYTES; b++)
+        {
+            group = (group << 8) | in[b];
+        }
+        for (size_t k = 0; k < Format::GROUP_NUM_PIXELS; k++)
+        {
+            uint64_t pixel = (group >> (GROUP_NUM_BITS - BITS*(k + 1))) & PIXEL_MASK;
+            out[k] = (uint16_t)(pixel << (16 - BITS));
+        }
+        in += Format::GROUP_NUM_BYTES;
+        out += Format::GROUP_NUM_PIXELS;
+    }
+}
+
+/// \brief      Pack `n_groups` groups of left-aligned `uint16_t` pixels into `BITS`-bit pixels, one
+///             pixel at a time; the inverse of `UnpackPixelsScalar()`. The low `16 - BITS` bits of
+///             each input pixel are ignored (truncated).
+template <unsigned BITS>
+void PackPixelsScalar(const uint16_t* in, size_t n_groups, uint8_t* out)
+{
+    using Format = PackedPixelFormat<BITS>;
+
+    for (size_t i = 0; i < n_groups; i++)
+    {
+        uint64_t group = 0;
+        for (size_t k = 0; k < Format::GROUP_NUM_PIXELS; k++)
+        {
+            group = (group << BITS) | (uint64_t)(in[k] >> (16 - BITS));
+        }
+        for (size_t b = 0; b < Format::GROUP_NUM_BYTES; b++)
+        {
+            out[b] = (uint8_t)(group >> (8*(Format::GROUP_NUM_BYTES - 1 - b)));
+        }
+        in += Format::GROUP_NUM_PIXELS;
+        out += Format::GROUP_NUM_BYTES;
+    }
+}
+
+/// \brief      Unpack `n_groups` groups (`n_groups*GROUP_NUM_BYTES` bytes) of packed `BITS`-bit
+///             pixels into `n_groups*GROUP_NUM_PIXELS` left-aligned `uint16_t` pixels, with the
+///             fastest SIMD kernel which the CPU supports. Bit-exact with `UnpackPixelsScalar()`.
+///             `UnpackPixels<10>()` is `ProcessPGroups()`.
+template <unsigned BITS>
+void UnpackPixels(const uint8_t* in, size_t n_groups, uint16_t* out);
+
+/// \brief      Pack `n_groups*GROUP_NUM_PIXELS` left-aligned `uint16_t` pixels into `n_groups`
+///             groups (`n_groups*GROUP_NUM_BYTES` bytes) of packed `BITS`-bit pixels, with the
+///             fastest SIMD kernel which the CPU supports. Bit-exact with `PackPixelsScalar()`.
+template <unsigned BITS>
+void PackPixels(const uint16_t* in, size_t n_groups, uint8_t* out);
+
+template <>
+void UnpackPixels<10>(const uint8_t* in, size_t n_groups, uint16_t* out);
+template <>
+void UnpackPixels<12>(const uint8_t* in, size_t n_groups, uint16_t* out);
+template <>
+void PackPixels<10>(const uint16_t* in, size_t n_groups, uint8_t* out);
+template <>
+void PackPixels<12>(const uint16_t* in, size_t n_groups, uint8_t* out);
+
+/// A `PackPixels*()` implementation
+using PackPixelsFunc = void (*)(const uint16_t* in, size_t n_groups, uint8_t* out);
+
+#if PGROUP_X86
+// The individual SIMD kernels behind `UnpackPixels<12>()` and `PackPixels<BITS>()`, for testing
+// and benchmarking. Only call them if `__builtin_cpu_supports()` the instruction set they're named
+// after.
+void UnpackPixels12Ssse3(const uint8_t* in, size_t n_groups, uint16_t* out);
+void UnpackPixels12Avx2(const uint8_t* in, size_t n_groups, uint16_t* out);
+void PackPixels10Ssse3(const uint16_t* in, size_t n_groups, uint8_t* out);
+void PackPixels10Avx2(const uint16_t* in, size_t n_groups, uint8_t* out);
+void PackPixels12Ssse3(const uint16_t* in, size_t n_groups, uint8_t* out);
+void PackPixels12Avx2(const uint16_t* in, size_t n_groups, uint8_t* out);
+#endif
+
+/// A multi-threaded pipeline to unpack a stream of packed 10-bit frames into `uint16_t` frames.
+///
+/// How it works:
+/// 1. Each frame is split into "stripes" of whole rows, sized so that a stripe's input plus output
+///    fits in a core's L2 cache, and a pool of worker threads converts the stripes in parallel with
+///    `ProcessPGroups()`, each worker grabbing the next stripe from a shared atomic counter.
+/// 2. Double buffering: there are 2 packed input frame buffers and 2 output frame buffers, all
+///    allocated once, in the constructor, and reused for every frame. While the workers convert
+///    frame N, a reader thread reads frame N + 1 into the other input buffer, and the calling
+///    thread hands frame N - 1 to the `frame_done` callback from the other output buffer.
+/// 3. Frames are converted one at a time, by all workers together, so they always come out in
+///    order, without any reordering buffer.
+class VideoConversionPipeline
+{
+public:
+    /// Read (ie: capture, or read from a file or socket) the next packed frame into `packed_frame`,
+    /// which is `GetPackedFrameNumBytes()` long. Return false at the end of the stream.
+    /// This is called from the pipeline's reader thread.
+    using ReadFrameFunc = std::function<bool(uint8_t* packed_frame)>;
+    /// Consume converted frame number `frame_index` (0, 1, 2, ...), which is `GetNumPixels()` long
+    /// and is only valid until this function returns. This is called from the thread which called
+    /// `Run()`, in frame order.
+    using FrameDoneFunc = std::function<void(uint64_t frame_index, const uint16_t* frame)>;
+
+    /// The default stripe size: input + output bytes per stripe, to fit in a typical L2 cache
+    static constexpr size_t DEFAULT_STRIPE_NUM_BYTES = 256*1024;
+
+    /// \brief      Create the pipeline, allocate all of its frame buffers, and start its worker
+    ///             threads.
+    /// \param[in]  width             Frame width, in pixels; must be a multiple of 4, so that each
+    ///                     row is a whole number of P groups
+    /// \param[in]  height            Frame height, in pixels
+    /// \param[in]  num_workers       Number of worker threads; 0 means 1 per CPU core
+    /// \param[in]  stripe_num_bytes  The target input + output bytes per stripe; each stripe is at
+    ///                     least 1 row
+    VideoConversionPipeline(size_t width, size_t height, size_t num_workers = 0,
+        size_t stripe_num_bytes = DEFAULT_STRIPE_NUM_BYTES);
+    ~VideoConversionPipeline();
+
+    VideoConversionPipeline(const VideoConversionPipeline&) = delete;
+    VideoConversionPipeline& operator=(const VideoConversionPipeline&) = delete;
+
+    /// \brief      Convert frames until `read_frame()` returns false, calling `frame_done()` for
+    ///             each converted frame, in order. This blocks until the whole stream is done. It
+    ///             may be called again, for another stream, reusing the same buffers and threads.
+    /// \param[in]  read_frame   Function to read each packed input frame
+    /// \param[in]  frame_done   Function to consume each converted output frame
+    /// \param[out] num_frames   (Optional) The number of frames converted
+    /// \return     An error string to describe the error if there is an error, or "OK" otherwise.
+    std::string Run(const ReadFrameFunc& read_frame, const FrameDoneFunc& frame_done,
+        uint64_t* num_frames = nullptr);
+
+    size_t GetPackedFrameNumBytes() const { return packed_frame_num_bytes_; }
+    size_t GetNumPixels() const { return num_pixels_; }
+    size_t GetNumWorkers() const { return workers_.size(); }
+    size_t GetNumStripes() const { return num_stripes_; }
+
+private:
+    /// Number of input and output frame buffers
+    static constexpr size_t NUM_BUFFERS = 2;
+
+    /// Convert all stripes of `packed_frames_[buffer_index]` into `frames_[buffer_index]`, without
+    /// waiting for the conversion to finish.
+    void StartConversion(size_t buffer_index);
+    /// Wait for the conversion started by `StartConversion()` to finish.
+    void WaitForConversion();
+    /// The worker thread function
+    void WorkerLoop();
+
+    size_t width_;
+    size_t height_;
+    size_t num_pixels_;
+    size_t packed_frame_num_bytes_;
+    size_t rows_per_stripe_;
+    size_t num_stripes_;
+
+    std::vector<uint8_t> packed_frames_[NUM_BUFFERS];
+    std::vector<uint16_t> frames_[NUM_BUFFERS];
+
+    // Worker pool state. One conversion job (1 frame) is in flight at a time; each new job bumps
+    // `job_generation_` to wake up the workers.
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+    uint64_t job_generation_ = 0;
+    bool exit_ = false;
+    const uint8_t* job_in_ = nullptr;
+    uint16_t* job_out_ = nullptr;
+    std::atomic<size_t> next_stripe_{0};
+    size_t num_workers_done_ = 0;
+};
@@ -0,0 +1,148 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Convert a stream of packed 10-bit 4K frames with the multi-threaded `VideoConversionPipeline` from
+"process_10_bit_video_data_lib.h", check that every frame comes out correct and in order, and
+measure the throughput vs. the number of worker threads.
+
+The "reader" here just copies from one of a few pre-generated packed frames, to stand in for a
+capture card or file read at memory speed, and the consumer checks each converted frame against a
+single-threaded `ProcessPGroups()` conversion of the same source frame.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread \
+    process_10_bit_video_data_pipeline.cpp process_10_bit_video_data_lib.cpp \
+    -o bin/a && bin/a
+```
+
+*/
+
+// Local includes
+#include "process_10_bit_video_data_lib.h"
+
+// C and C++ includes
+#include <chrono>
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t WIDTH = 3840;
+constexpr size_t HEIGHT = 2160;
+constexpr size_t NUM_SOURCE_FRAMES = 3;
+constexpr uint64_t NUM_FRAMES = 120;
+
+int main()
+{
+    printf("Multi-threaded 10-bit video conversion pipeline demo: %zu x %zu frames\n\n",
+        WIDTH, HEIGHT);
+
+    // Make a few different packed source frames, and their expected conversions
+    const size_t packed_num_bytes = WIDTH*HEIGHT/PGROUP_NUM_PIXELS*PGROUP_NUM_BYTES;
+    std::vector<std::vector<uint8_t>> source_frames(NUM_SOURCE_FRAMES);
+    std::vector<std::vector<uint16_t>> expected_frames(NUM_SOURCE_FRAMES);
+    std::mt19937 rng(12345);
+    for (size_t i = 0; i < NUM_SOURCE_FRAMES; i++)
+    {
+        source_frames[i].resize(packed_num_bytes);
+        for (uint8_t& byte : source_frames[i])
+        {
+            byte = (uint8_t)rng();
+        }
+        expected_frames[i].resize(WIDTH*HEIGHT);
+        ProcessPGroups(source_frames[i].data(), packed_num_bytes/PGROUP_NUM_BYTES,
+            expected_frames[i].data());
+    }
+
+    size_t max_workers = std::thread::hardware_concurrency();
+    if (max_workers == 0)
+    {
+        max_workers = 1;
+    }
+    std::vector<size_t> worker_counts;
+    for (size_t num_workers = 1; num_workers < max_workers; num_workers *= 2)
+    {
+        worker_counts.push_back(num_workers);
+    }
+    worker_counts.push_back(max_workers);
+
+    printf("workers  stripes      GB/s in   frames/sec   result\n");
+    printf("-------  -------      -------   ----------   ------\n");
+    for (size_t num_workers : worker_counts)
+    {
+        VideoConversionPipeline pipeline(WIDTH, HEIGHT, num_workers);
+
+        uint64_t frames_read = 0;
+        auto read_frame = [&](uint8_t* packed_frame)
+        {
+            if (frames_read == NUM_FRAMES)
+            {
+                return false;
+            }
+            const std::vector<uint8_t>& source = source_frames[frames_read % NUM_SOURCE_FRAMES];
+            memcpy(packed_frame, source.data(), source.size());
+            frames_read++;
+            return true;
+        };
+
+        uint64_t next_frame_index = 0;
+        uint64_t error_cnt = 0;
+        auto frame_done = [&](uint64_t frame_index, const uint16_t* frame)
+        {
+            // Frames must come out in order, and match the single-threaded conversion. Only check
+            // every 8th frame in full, to keep the consumer from being the bottleneck.
+            if (frame_index != next_frame_index)
+            {
+                error_cnt++;
+            }
+            next_frame_index = frame_index + 1;
+
+            const std::vector<uint16_t>& expected = expected_frames[frame_index % NUM_SOURCE_FRAMES];
+            size_t num_bytes_to_check = frame_index % 8 == 0 ?
+                expected.size()*sizeof(uint16_t) : 4096;
+            if (memcmp(frame, expected.data(), num_bytes_to_check) != 0)
+            {
+                error_cnt++;
+            }
+        };
+
+        uint64_t num_frames = 0;
+        auto t_start = std::chrono::steady_clock::now();
+        std::string error = pipeline.Run(read_frame, frame_done, &num_frames);
+        auto t_end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(t_end - t_start).count();
+        bool passed = error == "OK" && error_cnt == 0 && num_frames == NUM_FRAMES;
+        printf("%7zu  %7zu  %11.2f  %11.1f   %s\n", num_workers, pipeline.GetNumStripes(),
+            (double)(packed_num_bytes*num_frames)/seconds/1e9, num_frames/seconds,
+            passed ? "TEST PASSED!" : "TEST ==FAILED!==");
+        if (error != "OK")
+        {
+            printf("  error: %s\n", error.c_str());
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT:
+
+On a 1-core VM (so only 1 worker is tested, and the reader, the worker, and the consumer all
+share the 1 core; on a many-core machine, each doubling of workers is listed, up to 1 per core):
+
+    $ mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread process_10_bit_video_data_pipeline.cpp process_10_bit_video_data_lib.cpp -o bin/a && bin/a
+    Multi-threaded 10-bit video conversion pipeline demo: 3840 x 2160 frames
+
+    workers  stripes      GB/s in   frames/sec   result
+    -------  -------      -------   ----------   ------
+          1      103         2.28        219.7   TEST PASSED!
+
+*/
@@ -16,6 +16,9 @@ References:
 1. https://en.cppreference.com/w/cpp/string/basic_string
 1. https://en.cppreference.com/w/cpp/string/basic_string/basic_string (constructor)
 1. https://en.cppreference.com/w/cpp/string/basic_string/find
+1. For fast case-sensitive and case-insensitive substring search, and for searching for many
+   substrings at once in a single pass, see "eRCaGuy_hello_world/c/string_search_lib.h", and
+   "eRCaGuy_hello_world/c/string_search_lib_benchmark.c" for its speed vs. `std::string::find()`.
 
 */
 
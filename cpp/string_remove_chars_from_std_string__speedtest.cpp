@@ -0,0 +1,389 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+GS
+17 Feb. 2022
+
+Q: What's the most efficient way to remove a newline (or any other char) from a C++ std::string? I
+don't know! Let's find out!
+
+See this Q here: https://stackoverflow.com/q/1488775/4561887. My goal is to answer it definitively
+with real data and timestamps! See also my notes at the bottom of my answer here:
+https://stackoverflow.com/a/71565411/4561887:
+
+> Whats the most efficient way of removing a 'newline' from a `std::string`?
+
+As far as the _most efficient_ way goes--that I'd have to speed test/profile and see. I'll see if I
+can get back to you on that and run some speed tests between the top two answers here, and a
+C-style way like I did here: [Removing elements from array in C]
+(https://stackoverflow.com/a/70043744/4561887). I'll use [my `nanos()` timestamp function][2] for
+speed testing.
+
+So, this program removes 3 different sets of chars (just '\n', the vowels, and whitespace plus
+punctuation) from text strings of 3 sizes, with each of these ways, and prints the speed of each,
+in MB/sec of input text:
+1. `RemoveChars()` from "string_remove_chars_lib.h", with each of its kernels which this CPU
+   supports: the C-style in-place way, with a 256-bit lookup set, and SIMD (SSSE3 or AVX2)
+   kernels which check and remove 16 or 32 chars at a time
+2. "erase-remove": `str.erase(std::remove(...), str.end())` for 1 char, or
+   `str.erase(std::remove_if(...), str.end())` with a `chars.find(c)` lookup for a set of chars
+3. erase-remove_if, but with a `CharSet::Contains()` lookup instead, to separate the cost of the
+   lookup from the cost of `std::remove_if()` itself
+4. copy each char which is not in the set into a new string, with `push_back()`
+5. `std::regex_replace()` with a "[...]" regex
+6. repeated `str.find_first_of(chars)` and `str.erase(pos, 1)`, which is O(n^2), since each
+   `erase()` moves the whole rest of the string. So, it is skipped for the biggest strings.
+
+Each result is checked against `RemoveCharsScalar()`'s result, and each timing is the fastest of
+several runs, measured with `nanos()` from "eRCaGuy_hello_world/c/timinglib.h".
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+1. In C++
+```bash
+g++ -Wall -Wextra -Werror -O3 -std=c++17 string_remove_chars_from_std_string__speedtest.cpp \
+    string_remove_chars_lib.cpp ../c/timinglib.c -o bin/a && bin/a
+```
+
+References:
+1. The question that inspired me to write this:
+   [C++ Remove new line from multiline string](https://stackoverflow.com/q/1488775/4561887)
+1. [my answer] https://stackoverflow.com/a/71565411/4561887
+1. [my answer on the C-style way] https://stackoverflow.com/a/70043744/4561887
+1. [my answer on the `nanos()` function] https://stackoverflow.com/a/49066369/4561887
+1. https://en.cppreference.com/w/cpp/algorithm/remove
+1. https://en.cppreference.com/w/cpp/regex/regex_replace
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "string_remove_chars_lib.h"
+
+// C++ includes
+#include <algorithm>  // For `std::remove()`, `std::remove_if()`
+#include <regex>
+#include <string>
+#include <utility>  // For `std::move()`
+#include <vector>
+
+// C includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+
+/// Run each method at least this many times, and for at least this long, and report the fastest
+/// run
+constexpr size_t MIN_RUNS = 3;
+constexpr uint64_t MIN_TIME_NS = 100*1000*1000ULL;
+/// Skip the O(n^2) find/erase method for strings larger than this
+constexpr size_t MAX_FIND_ERASE_LEN = 64*1024;
+
+/// One way to remove all of the chars in `chars` (or `set`, which holds the same chars) from
+/// `*str`
+using RemoveMethodFunc = void (*)(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex);
+
+struct RemoveMethod
+{
+    const char* name;
+    RemoveMethodFunc func;
+    /// Don't run this method on strings longer than this
+    size_t max_len;
+};
+
+/// `RemoveChars()` with one particular kernel
+template <RemoveCharsFunc kernel>
+void RemoveWithKernel(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex)
+{
+    (void)chars;
+    (void)regex;
+    str->resize(kernel(&(*str)[0], str->size(), set));
+}
+
+void RemoveWithEraseRemove(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex)
+{
+    (void)set;
+    (void)regex;
+    if (chars.size() == 1)
+    {
+        str->erase(std::remove(str->begin(), str->end(), chars[0]), str->end());
+        return;
+    }
+    str->erase(std::remove_if(str->begin(), str->end(),
+        [&chars](char c) { return chars.find(c) != std::string::npos; }), str->end());
+}
+
+void RemoveWithEraseRemoveIfCharSet(std::string* str, const std::string& chars,
+    const CharSet& set, const std::regex& regex)
+{
+    (void)chars;
+    (void)regex;
+    str->erase(std::remove_if(str->begin(), str->end(),
+        [&set](char c) { return set.Contains(c); }), str->end());
+}
+
+void RemoveWithCopyToNewString(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex)
+{
+    (void)chars;
+    (void)regex;
+    std::string new_str;
+    new_str.reserve(str->size());
+    for (char c : *str)
+    {
+        if (!set.Contains(c))
+        {
+            new_str.push_back(c);
+        }
+    }
+    *str = std::move(new_str);
+}
+
+void RemoveWithRegex(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex)
+{
+    (void)chars;
+    (void)set;
+    *str = std::regex_replace(*str, regex, "");
+}
+
+void RemoveWithFindErase(std::string* str, const std::string& chars, const CharSet& set,
+    const std::regex& regex)
+{
+    (void)set;
+    (void)regex;
+    size_t pos = 0;
+    while ((pos = str->find_first_of(chars, pos)) != std::string::npos)
+    {
+        str->erase(pos, 1);
+    }
+}
+
+/// Get all of the methods to test, including only the `RemoveChars()` kernels which this CPU
+/// supports
+std::vector<RemoveMethod> GetRemoveMethods()
+{
+    std::vector<RemoveMethod> methods = {
+        {"RemoveChars(scalar)", RemoveWithKernel<RemoveCharsScalar>, SIZE_MAX}};
+#if REMOVE_CHARS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt"))
+    {
+        methods.push_back({"RemoveChars(ssse3)", RemoveWithKernel<RemoveCharsSsse3>, SIZE_MAX});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        methods.push_back({"RemoveChars(avx2)", RemoveWithKernel<RemoveCharsAvx2>, SIZE_MAX});
+    }
+#endif
+    methods.push_back({"erase-remove", RemoveWithEraseRemove, SIZE_MAX});
+    methods.push_back({"erase-remove_if(CharSet)", RemoveWithEraseRemoveIfCharSet, SIZE_MAX});
+    methods.push_back({"copy to new string", RemoveWithCopyToNewString, SIZE_MAX});
+    methods.push_back({"std::regex_replace", RemoveWithRegex, SIZE_MAX});
+    methods.push_back({"find_first_of + erase", RemoveWithFindErase, MAX_FIND_ERASE_LEN});
+    return methods;
+}
+
+/// Make `len` chars of English-like text: lowercase words with some capitals, spaces,
+/// punctuation, and a newline about every 80 chars.
+std::string MakeText(size_t len)
+{
+    static const char* const WORDS[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy",
+        "dog", "Lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+        "performance", "string", "remove", "char", "newline", "vector"};
+    static const char PUNCTUATION[] = ",.;:!?";
+    const size_t NUM_WORDS = sizeof(WORDS)/sizeof(WORDS[0]);
+
+    std::string text;
+    text.reserve(len + 16);
+    size_t line_len = 0;
+    uint32_t random = 12345;
+    while (text.size() < len)
+    {
+        random = random*1103515245 + 12345;
+        text += WORDS[(random >> 16) % NUM_WORDS];
+        line_len += 8;
+        if ((random >> 8) % 8 == 0)
+        {
+            text += PUNCTUATION[(random >> 4) % (sizeof(PUNCTUATION) - 1)];
+        }
+        if (line_len >= 80)
+        {
+            text += '\n';
+            line_len = 0;
+        }
+        else
+        {
+            text += ' ';
+        }
+    }
+    text.resize(len);
+    return text;
+}
+
+/// Make a regex which matches any one of `chars`.
+std::regex MakeRegex(const std::string& chars)
+{
+    std::string pattern = "[";
+    for (char c : chars)
+    {
+        if (c == '\\' || c == ']' || c == '^' || c == '-' || c == '[')
+        {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    pattern += "]";
+    return std::regex(pattern);
+}
+
+/// Time one method on one text, and return its speed in MB/sec, or a negative number if its
+/// result doesn't match `expected`.
+double TimeMethod(const RemoveMethod& method, const std::string& text, const std::string& chars,
+    const CharSet& set, const std::regex& regex, const std::string& expected)
+{
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t total_ns = 0;
+    std::string str;
+    for (size_t run = 0; run < MIN_RUNS || total_ns < MIN_TIME_NS; run++)
+    {
+        // Start each run from a fresh copy of the text, outside of the timing
+        str = text;
+        uint64_t start_ns = nanos();
+        method.func(&str, chars, set, regex);
+        uint64_t duration_ns = nanos() - start_ns;
+        best_ns = std::min(best_ns, duration_ns);
+        total_ns += duration_ns;
+    }
+    if (str != expected)
+    {
+        return -1;
+    }
+    return (double)text.size()*1e3/(double)std::max<uint64_t>(best_ns, 1);
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    struct CharsToRemove
+    {
+        const char* description;
+        std::string chars;
+    };
+    const CharsToRemove CHARS_TO_REMOVE[] = {
+        {"newlines", "\n"},
+        {"vowels", "aeiouAEIOU"},
+        {"whitespace and punctuation", " \t\n,.;:!?"},
+    };
+    const size_t TEXT_LENS[] = {1024, 64*1024, 1024*1024};
+
+    const char* kernel_name;
+    GetRemoveCharsFunc(&kernel_name);
+    printf("Remove chars from a `std::string`, in MB/sec of input text. `RemoveChars()` uses the "
+        "\"%s\" kernel on this CPU.\n", kernel_name);
+
+    const std::vector<RemoveMethod> methods = GetRemoveMethods();
+    bool all_match = true;
+    for (const CharsToRemove& to_remove : CHARS_TO_REMOVE)
+    {
+        const CharSet set(to_remove.chars);
+        const std::regex regex = MakeRegex(to_remove.chars);
+
+        printf("\nRemove %s:\n", to_remove.description);
+        printf("  %-26s", "method");
+        for (size_t len : TEXT_LENS)
+        {
+            printf(" %11zu B", len);
+        }
+        printf("\n");
+
+        std::vector<std::string> texts;
+        std::vector<std::string> expected_results;
+        for (size_t len : TEXT_LENS)
+        {
+            texts.push_back(MakeText(len));
+            std::string expected = texts.back();
+            expected.resize(RemoveCharsScalar(&expected[0], expected.size(), set));
+            expected_results.push_back(expected);
+        }
+
+        for (const RemoveMethod& method : methods)
+        {
+            printf("  %-26s", method.name);
+            for (size_t i = 0; i < texts.size(); i++)
+            {
+                if (texts[i].size() > method.max_len)
+                {
+                    printf(" %13s", "-");
+                    continue;
+                }
+                double mb_per_sec = TimeMethod(method, texts[i], to_remove.chars, set, regex,
+                    expected_results[i]);
+                if (mb_per_sec < 0)
+                {
+                    printf(" %13s", "MISMATCH!");
+                    all_match = false;
+                    continue;
+                }
+                printf(" %13.1f", mb_per_sec);
+            }
+            printf("\n");
+        }
+    }
+
+    if (!all_match)
+    {
+        printf("\nFAILED: some results did not match `RemoveCharsScalar()`'s!\n");
+        return 1;
+    }
+    printf("\nAll results match.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM with AVX2; the numbers vary from run to run):
+
+    eRCaGuy_hello_world/cpp$ g++ -Wall -Wextra -Werror -O3 -std=c++17 string_remove_chars_from_std_string__speedtest.cpp string_remove_chars_lib.cpp ../c/timinglib.c -o bin/a && bin/a
+    Remove chars from a `std::string`, in MB/sec of input text. `RemoveChars()` uses the "avx2" kernel on this CPU.
+
+    Remove newlines:
+      method                            1024 B       65536 B     1048576 B
+      RemoveChars(scalar)                576.3         761.2         577.7
+      RemoveChars(ssse3)                2813.2        6994.2        4564.6
+      RemoveChars(avx2)                 2976.7        7636.4        5628.2
+      erase-remove                      1750.4        1186.6        1134.8
+      erase-remove_if(CharSet)           862.7         592.5         581.9
+      copy to new string                 528.1         473.0         420.0
+      std::regex_replace                  51.6          46.8          44.0
+      find_first_of + erase              325.4          97.9             -
+
+    Remove vowels:
+      method                            1024 B       65536 B     1048576 B
+      RemoveChars(scalar)                946.4        1091.5        1047.8
+      RemoveChars(ssse3)                2652.8        5195.1        5293.5
+      RemoveChars(avx2)                 2738.0        5724.7        5897.3
+      erase-remove                       139.2         102.4          94.8
+      erase-remove_if(CharSet)           867.1         240.5         223.9
+      copy to new string                 590.5         181.8         169.5
+      std::regex_replace                  13.6          11.8          10.8
+      find_first_of + erase              142.0           6.3             -
+
+    Remove whitespace and punctuation:
+      method                            1024 B       65536 B     1048576 B
+      RemoveChars(scalar)                925.9        1094.8        1073.2
+      RemoveChars(ssse3)                2646.0        5038.1        5092.4
+      RemoveChars(avx2)                 2612.2        4839.5        4243.9
+      erase-remove                       119.5          79.8          78.4
+      erase-remove_if(CharSet)           891.2         329.6         238.3
+      copy to new string                 554.7         197.9         178.5
+      std::regex_replace                  21.1          24.6          16.1
+      find_first_of + erase              174.0           8.4             -
+
+    All results match.
+
+*/
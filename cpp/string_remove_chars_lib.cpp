@@ -0,0 +1,267 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+See the .h file for details.
+
+*/
+
+// Local includes
+#include "string_remove_chars_lib.h"
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#if REMOVE_CHARS_X86
+#include <immintrin.h>
+#endif
+
+/// Filter the chars from `buf[i_read]` to `buf[len - 1]`, writing the kept ones from
+/// `buf[i_write]` on, one char at a time. Returns the new `i_write`.
+static inline size_t RemoveCharsFrom(char* buf, size_t i_read, size_t len, size_t i_write,
+    const CharSet& set)
+{
+    for (; i_read < len; i_read++)
+    {
+        // Always write the char, but only advance past it if it is kept. This has no branch to
+        // mispredict when the chars to remove are scattered randomly.
+        char c = buf[i_read];
+        buf[i_write] = c;
+        i_write += !set.Contains(c);
+    }
+    return i_write;
+}
+
+size_t RemoveCharsScalar(char* buf, size_t len, const CharSet& set)
+{
+    return RemoveCharsFrom(buf, 0, len, 0, set);
+}
+
+#if REMOVE_CHARS_X86
+
+/// The 256-bit set as the 2 `pshufb` lookup tables described in the .h file: byte `lo` of
+/// `low_half` has bit `hi` set if char `(hi << 4) | lo` is in the set, for `hi` = 0 to 7, and
+/// `high_half` the same, for `hi` = 8 to 15
+struct NibbleTables
+{
+    uint8_t low_half[16];
+    uint8_t high_half[16];
+
+    explicit NibbleTables(const CharSet& set)
+    {
+        for (unsigned lo = 0; lo < 16; lo++)
+        {
+            low_half[lo] = 0;
+            high_half[lo] = 0;
+            for (unsigned hi = 0; hi < 8; hi++)
+            {
+                low_half[lo] |= (uint8_t)(set.Contains((char)((hi << 4) | lo)) << hi);
+                high_half[lo] |= (uint8_t)(set.Contains((char)(((hi + 8) << 4) | lo)) << hi);
+            }
+        }
+    }
+};
+
+/// For each 8-bit "keep" mask, the `pshufb` indices which move the kept bytes of an 8-byte group
+/// to its front, in order. The rest of the indices don't matter, since the bytes they produce are
+/// either overwritten by the next store or are past the end of the kept chars.
+struct CompressTable
+{
+    uint64_t shuffles[256] = {};
+
+    constexpr CompressTable()
+    {
+        for (unsigned mask = 0; mask < 256; mask++)
+        {
+            uint64_t shuffle = 0;
+            unsigned num_kept = 0;
+            for (unsigned i = 0; i < 8; i++)
+            {
+                if (mask & (1u << i))
+                {
+                    shuffle |= (uint64_t)i << (8*num_kept);
+                    num_kept++;
+                }
+            }
+            shuffles[mask] = shuffle;
+        }
+    }
+};
+
+static constexpr CompressTable compress_table;
+
+/// Adds 8 to each byte of a shuffle pattern, to point it at the high 8 bytes of a vector
+constexpr uint64_t HIGH_HALF_OFFSET = 0x0808080808080808ULL;
+
+/// Get a mask with bytes 0xFF for each of the 16 chars in `chars` which is in the set, for the
+/// set's `low_half` and `high_half` lookup tables, and the `bit_masks` table {1, 2, 4, ..., 128,
+/// 1, 2, 4, ..., 128}.
+__attribute__((target("ssse3")))
+static inline __m128i InSetSsse3(__m128i chars, __m128i low_half, __m128i high_half,
+    __m128i bit_masks)
+{
+    const __m128i low_nibble_and_bit_7 = _mm_set1_epi8((char)0x8F);
+    // For chars 0x00 to 0x7F, `low_half[lo]`, else 0; then, for chars 0x80 to 0xFF,
+    // `high_half[lo]`, else 0
+    __m128i row = _mm_or_si128(
+        _mm_shuffle_epi8(low_half, _mm_and_si128(chars, low_nibble_and_bit_7)),
+        _mm_shuffle_epi8(high_half, _mm_and_si128(_mm_xor_si128(chars, _mm_set1_epi8((char)0x80)),
+            low_nibble_and_bit_7)));
+    // Bits 4-6 of the char select the bit in the row (`bit_masks` repeats, so bit 7 is ignored)
+    __m128i high_nibble = _mm_and_si128(_mm_srli_epi16(chars, 4), _mm_set1_epi8(0x0F));
+    __m128i bit = _mm_shuffle_epi8(bit_masks, high_nibble);
+    return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+}
+
+/// Store the chars of the 16 `chars` which have their bit set in `keep` (bit `i` for char `i`) to
+/// `out`, in order. Writes up to 16 bytes to `out`, even if fewer chars are kept.
+/// Returns the number of chars kept.
+__attribute__((target("ssse3,popcnt")))
+static inline size_t CompressStoreSsse3(__m128i chars, uint32_t keep, char* out)
+{
+    uint32_t keep_low = keep & 0xFF;
+    uint32_t keep_high = (keep >> 8) & 0xFF;
+    __m128i shuffle = _mm_set_epi64x(
+        (long long)(compress_table.shuffles[keep_high] + HIGH_HALF_OFFSET),
+        (long long)compress_table.shuffles[keep_low]);
+    __m128i compressed = _mm_shuffle_epi8(chars, shuffle);
+    size_t num_kept_low = __builtin_popcount(keep_low);
+    _mm_storel_epi64((__m128i*)out, compressed);
+    _mm_storel_epi64((__m128i*)(out + num_kept_low), _mm_srli_si128(compressed, 8));
+    return num_kept_low + __builtin_popcount(keep_high);
+}
+
+// The stores for each block start at or before the block's read position, and end within the block
+// (which is already loaded into a register), so they never clobber chars which haven't been read
+// yet. The vector loop stops while < 16 chars remain, and leaves the rest to the scalar tail.
+__attribute__((target("ssse3,popcnt")))
+size_t RemoveCharsSsse3(char* buf, size_t len, const CharSet& set)
+{
+    NibbleTables tables(set);
+    const __m128i low_half = _mm_loadu_si128((const __m128i*)tables.low_half);
+    const __m128i high_half = _mm_loadu_si128((const __m128i*)tables.high_half);
+    const __m128i bit_masks = _mm_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, (char)128,
+        1, 2, 4, 8, 16, 32, 64, (char)128);
+
+    size_t i_read = 0;
+    size_t i_write = 0;
+    for (; i_read + 16 <= len; i_read += 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i*)&buf[i_read]);
+        uint32_t keep = ~(uint32_t)_mm_movemask_epi8(
+            InSetSsse3(chars, low_half, high_half, bit_masks)) & 0xFFFF;
+        if (keep == 0xFFFF)
+        {
+            // Nothing to remove: just move the block, if anything has been removed before it
+            if (i_write != i_read)
+            {
+                _mm_storeu_si128((__m128i*)&buf[i_write], chars);
+            }
+            i_write += 16;
+            continue;
+        }
+        i_write += CompressStoreSsse3(chars, keep, &buf[i_write]);
+    }
+
+    return RemoveCharsFrom(buf, i_read, len, i_write, set);
+}
+
+/// Same as `InSetSsse3()`, for 32 chars. `vpshufb` looks up each 128-bit lane in its own lane of
+/// the table, so the tables must hold the same 16 bytes in both lanes.
+__attribute__((target("avx2")))
+static inline __m256i InSetAvx2(__m256i chars, __m256i low_half, __m256i high_half,
+    __m256i bit_masks)
+{
+    const __m256i low_nibble_and_bit_7 = _mm256_set1_epi8((char)0x8F);
+    __m256i row = _mm256_or_si256(
+        _mm256_shuffle_epi8(low_half, _mm256_and_si256(chars, low_nibble_and_bit_7)),
+        _mm256_shuffle_epi8(high_half, _mm256_and_si256(
+            _mm256_xor_si256(chars, _mm256_set1_epi8((char)0x80)), low_nibble_and_bit_7)));
+    __m256i high_nibble = _mm256_and_si256(_mm256_srli_epi16(chars, 4), _mm256_set1_epi8(0x0F));
+    __m256i bit = _mm256_shuffle_epi8(bit_masks, high_nibble);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+// The same as the SSSE3 kernel, but with the set lookup done on 32 chars at once. There is no AVX2
+// byte compress, so each 16-char half is compressed and stored with the SSSE3 code.
+__attribute__((target("avx2,popcnt")))
+size_t RemoveCharsAvx2(char* buf, size_t len, const CharSet& set)
+{
+    NibbleTables tables(set);
+    const __m256i low_half = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)tables.low_half));
+    const __m256i high_half = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)tables.high_half));
+    const __m256i bit_masks = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, (char)128,
+        1, 2, 4, 8, 16, 32, 64, (char)128,
+        1, 2, 4, 8, 16, 32, 64, (char)128,
+        1, 2, 4, 8, 16, 32, 64, (char)128);
+
+    size_t i_read = 0;
+    size_t i_write = 0;
+    for (; i_read + 32 <= len; i_read += 32)
+    {
+        __m256i chars = _mm256_loadu_si256((const __m256i*)&buf[i_read]);
+        uint32_t keep = ~(uint32_t)_mm256_movemask_epi8(
+            InSetAvx2(chars, low_half, high_half, bit_masks));
+        if (keep == 0xFFFFFFFF)
+        {
+            if (i_write != i_read)
+            {
+                _mm256_storeu_si256((__m256i*)&buf[i_write], chars);
+            }
+            i_write += 32;
+            continue;
+        }
+        i_write += CompressStoreSsse3(_mm256_castsi256_si128(chars), keep & 0xFFFF,
+            &buf[i_write]);
+        i_write += CompressStoreSsse3(_mm256_extracti128_si256(chars, 1), keep >> 16,
+            &buf[i_write]);
+    }
+
+    return RemoveCharsFrom(buf, i_read, len, i_write, set);
+}
+
+#endif // REMOVE_CHARS_X86
+
+RemoveCharsFunc GetRemoveCharsFunc(const char** name)
+{
+    RemoveCharsFunc func = RemoveCharsScalar;
+    const char* func_name = "scalar";
+
+#if REMOVE_CHARS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        func = RemoveCharsAvx2;
+        func_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt"))
+    {
+        func = RemoveCharsSsse3;
+        func_name = "ssse3";
+    }
+#endif
+
+    if (name != nullptr)
+    {
+        *name = func_name;
+    }
+    return func;
+}
+
+size_t RemoveChars(char* buf, size_t len, const CharSet& set)
+{
+    static const RemoveCharsFunc func = GetRemoveCharsFunc();
+    return func(buf, len, set);
+}
+
+void RemoveChars(std::string* str, const CharSet& set)
+{
+    str->resize(RemoveChars(&(*str)[0], str->size(), set));
+}
@@ -0,0 +1,142 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+A library to remove any set of chars (ex: all newlines, all vowels, or all whitespace and
+punctuation) from a `std::string` or a `char` buffer, in place, in a single pass.
+
+The set of chars to remove is a `CharSet`: a 256-bit bitmap, with 1 bit per possible char value, so
+checking whether or not a char is in the set is a single bit test, no matter how many chars are in
+the set.
+
+How the SIMD kernels work, for each block of 16 chars:
+1. Look up all 16 chars in the 256-bit set at once, with 2 `pshufb` byte shuffles used as 16-entry
+   lookup tables. The set is stored as 2 tables of 16 bytes, indexed by the low 4 bits of a char:
+   byte `lo` of the first table holds the bits of chars 0x0lo to 0x7lo, and of the second table,
+   those of chars 0x8lo to 0xFlo. Bit 7 of the char selects the table (`pshufb` returns 0 for an
+   index with bit 7 set, so each table lookup only "sees" the chars for its own half), and a third
+   `pshufb` turns bits 4-6 of the char into the bit mask to test the looked-up byte with.
+2. "Compress" the chars to keep to the left of the block, with 1 more `pshufb` per 8 chars, using a
+   precomputed table of shuffle patterns for each of the 256 possible 8-bit "keep" masks, and store
+   them at the write position, which never passes the read position, so it works in place.
+3. Blocks with no chars to remove (the common case, for a rare char like '\n') are just copied, or
+   skipped entirely while nothing has been removed yet.
+The AVX2 kernel does step 1 on 32 chars at once, and then step 2 on each half.
+
+STATUS: done and works!
+
+To compile and run:
+- See "string_remove_chars_from_std_string__speedtest.cpp" and "string_remove_vowels.cpp" as
+  examples.
+
+References:
+1. Wojciech Mula, "SIMD byte lookup": http://0x80.pl/articles/simd-byte-lookup.html - for the
+   `pshufb` 256-bit set lookup
+1. Daniel Lemire's simdprune library: https://github.com/lemire/simdprune - for the
+   compress-with-a-shuffle-table approach, which AVX-512 VBMI2 `vpcompressb` does in 1 instruction
+1. https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+1. https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html - for `__builtin_cpu_supports()`
+
+*/
+
+#pragma once
+
+// Local includes
+// NA
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstddef>  // For `size_t`
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define REMOVE_CHARS_X86 1
+#else
+#define REMOVE_CHARS_X86 0
+#endif
+
+/// A set of chars: a 256-bit bitmap, with 1 bit per possible char value
+class CharSet
+{
+public:
+    /// An empty set
+    CharSet() = default;
+
+    /// A set of the first `len` chars in `chars`
+    CharSet(const char* chars, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            Add(chars[i]);
+        }
+    }
+
+    /// A set of all of the chars in `chars`
+    explicit CharSet(const std::string& chars) : CharSet(chars.data(), chars.size()) {}
+
+    void Add(char c)
+    {
+        uint8_t u = (uint8_t)c;
+        bits_[u / 64] |= 1ULL << (u % 64);
+    }
+
+    bool Contains(char c) const
+    {
+        uint8_t u = (uint8_t)c;
+        return (bits_[u / 64] >> (u % 64)) & 1;
+    }
+
+    /// Get the number of chars in the set.
+    size_t Size() const
+    {
+        return __builtin_popcountll(bits_[0]) + __builtin_popcountll(bits_[1])
+            + __builtin_popcountll(bits_[2]) + __builtin_popcountll(bits_[3]);
+    }
+
+private:
+    /// Bit `c % 64` of `bits_[c / 64]` is set if char `c` (as a `uint8_t`) is in the set
+    uint64_t bits_[4] = {};
+};
+
+/// \brief      Remove all chars which are in `set` from the first `len` chars of `buf`, in place,
+///             one char at a time. This is the portable reference implementation, and the tail
+///             path of the SIMD kernels below.
+/// \param[in,out] buf  The chars to filter. The chars kept are moved to the front of `buf`, in
+///                     their original order. The chars after those are left unspecified.
+/// \param[in]  len     Number of chars in `buf`
+/// \param[in]  set     The chars to remove
+/// \return     The new number of chars in `buf`
+size_t RemoveCharsScalar(char* buf, size_t len, const CharSet& set);
+
+#if REMOVE_CHARS_X86
+/// SSSE3 kernel: 16 chars per loop iteration. Only call it if `__builtin_cpu_supports("ssse3")`.
+size_t RemoveCharsSsse3(char* buf, size_t len, const CharSet& set);
+/// AVX2 kernel: 32 chars per loop iteration. Only call it if `__builtin_cpu_supports("avx2")`.
+size_t RemoveCharsAvx2(char* buf, size_t len, const CharSet& set);
+#endif
+
+/// A `RemoveChars*()` implementation
+using RemoveCharsFunc = size_t (*)(char* buf, size_t len, const CharSet& set);
+
+/// \brief      Get the fastest `RemoveChars*()` implementation which the CPU we are running on
+///             supports: AVX2, then SSSE3, then scalar.
+/// \param[out] name  (Optional) The name of the implementation
+/// \return     The implementation
+RemoveCharsFunc GetRemoveCharsFunc(const char** name = nullptr);
+
+/// \brief      Remove all chars which are in `set` from the first `len` chars of `buf`, in place,
+///             in a single pass, exactly as `RemoveCharsScalar()` does, but using the fastest SIMD
+///             kernel which the CPU supports. The kernel is chosen once, at the first call.
+/// \note       `buf` is NOT null-terminated afterwards. To filter a C-string, include its null
+///             terminator in `len` (and don't put '\0' in `set`).
+/// \return     The new number of chars in `buf`
+size_t RemoveChars(char* buf, size_t len, const CharSet& set);
+
+/// \brief      Remove all chars which are in `set` from `str`, in place, in a single pass, with
+///             `RemoveChars()`, and shrink `str` to its new size (its capacity is unchanged).
+void RemoveChars(std::string* str, const CharSet& set);
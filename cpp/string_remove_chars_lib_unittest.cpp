@@ -0,0 +1,194 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Googletest (gtest) unit tests for string_remove_chars_lib.h/.cpp. Every SIMD kernel this CPU
+supports is checked against `RemoveCharsScalar()`, and the scalar one against `std::remove_if()`,
+on random buffers and sets which cover all 256 char values. Chars >= 0x80 are the interesting ones,
+since bit 7 of the char is what selects the half of the set the `pshufb` lookup uses.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the detailed clone and build steps here to clone the googletest repo and manually
+# build the necessary *.a static library files for gtest and gmock:
+# "eRCaGuy_hello_world/cpp/README.md"
+
+# 2. THEN, build and run this unit test with this command!:
+time ( \
+    time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread \
+    -I"googletest/googletest/include" -I"googletest/googlemock/include" \
+    string_remove_chars_lib_unittest.cpp \
+    string_remove_chars_lib.cpp \
+    bin/libgtest.a bin/libgtest_main.a \
+    -o bin/a \
+    && time bin/a \
+)
+```
+
+References:
+1. https://github.com/google/googletest
+    1. https://github.com/google/googletest/blob/main/docs/reference/assertions.md - for
+       `EXPECT_EQ()`, `EXPECT_STREQ()`--for C-strings only, etc.!
+1. [my answer on how to build gtest with gcc] https://stackoverflow.com/a/72108315/4561887
+
+*/
+
+
+// Local includes
+#include "string_remove_chars_lib.h"
+
+// 3rd-party library includes
+// #include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <algorithm>  // For `std::remove_if()`
+#include <cstdint>    // For `uint8_t`, `int8_t`, etc.
+#include <random>
+#include <string>
+#include <vector>
+
+
+// anonymous namespace
+namespace
+{
+
+struct Kernel
+{
+    const char* name;
+    RemoveCharsFunc func;
+};
+
+/// Get every `RemoveChars*()` implementation this CPU supports, except the scalar reference one.
+std::vector<Kernel> GetKernelsToTest()
+{
+    std::vector<Kernel> kernels;
+#if REMOVE_CHARS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        kernels.push_back({"RemoveCharsSsse3", RemoveCharsSsse3});
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.push_back({"RemoveCharsAvx2", RemoveCharsAvx2});
+    }
+#endif
+    kernels.push_back({"RemoveChars", RemoveChars});
+    return kernels;
+}
+
+/// A buffer of `len` random chars, with every one of the 256 char values equally likely
+std::string RandomBuffer(size_t len, std::mt19937* rng)
+{
+    std::string buf(len, '\0');
+    for (char& c : buf)
+    {
+        c = (char)(uint8_t)((*rng)() & 0xFF);
+    }
+    return buf;
+}
+
+/// Check that each kernel removes exactly the same chars as `RemoveCharsScalar()` from `buf`, and
+/// that `RemoveCharsScalar()` matches `std::remove_if()`. `buf` is copied into a bigger buffer at
+/// `offset`, so the kernels see it at every alignment.
+void ExpectAllKernelsMatch(const std::vector<Kernel>& kernels, const std::string& buf,
+    const CharSet& set, size_t offset, const std::string& set_description)
+{
+    std::string expected = buf;
+    expected.erase(std::remove_if(expected.begin(), expected.end(),
+        [&set](char c) { return set.Contains(c); }), expected.end());
+
+    std::string scalar = buf;
+    scalar.resize(RemoveCharsScalar(&scalar[0], scalar.size(), set));
+    ASSERT_EQ(scalar, expected) << "RemoveCharsScalar(), set = " << set_description;
+
+    for (const Kernel& kernel : kernels)
+    {
+        std::string padded(offset, '-');
+        padded += buf;
+        size_t new_len = kernel.func(&padded[offset], buf.size(), set);
+        ASSERT_EQ(padded.substr(offset, new_len), expected) << kernel.name << "(), len = "
+            << buf.size() << ", offset = " << offset << ", set = " << set_description;
+    }
+}
+
+/// Each char value on its own, as a 1-char set, and as the only char NOT in the set
+TEST(RemoveCharsTest, EachCharValueAlone)
+{
+    std::vector<Kernel> kernels = GetKernelsToTest();
+    std::mt19937 rng(1);
+    for (int value = 0; value < 256; value++)
+    {
+        char c = (char)(uint8_t)value;
+        CharSet just_c(&c, 1);
+        CharSet all_but_c;
+        for (int other = 0; other < 256; other++)
+        {
+            if (other != value)
+            {
+                all_but_c.Add((char)(uint8_t)other);
+            }
+        }
+        ASSERT_EQ(just_c.Size(), 1U);
+        ASSERT_EQ(all_but_c.Size(), 255U);
+
+        // Buffers with every char value in them, so each kernel sees `c` and all of its neighbors
+        // in both halves of the set (`c ^ 0x80`), and in every lane
+        for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 64, 255, 256, 257, 1000})
+        {
+            std::string buf = RandomBuffer(len, &rng);
+            for (size_t i = 0; i < len; i += 3)
+            {
+                buf[i] = c;
+            }
+            size_t offset = rng() % 32;
+            std::string description = "{" + std::to_string(value) + "}";
+            ExpectAllKernelsMatch(kernels, buf, just_c, offset, description);
+            ExpectAllKernelsMatch(kernels, buf, all_but_c, offset, "all but " + description);
+        }
+    }
+}
+
+/// Random sets, of random densities, of chars from all 256 values, or from just the upper (>= 0x80)
+/// or lower half
+TEST(RemoveCharsTest, RandomSetsAndBuffers)
+{
+    std::vector<Kernel> kernels = GetKernelsToTest();
+    std::mt19937 rng(2);
+    constexpr size_t NUM_TESTS = 20000;
+    for (size_t i_test = 0; i_test < NUM_TESTS; i_test++)
+    {
+        // 0: all values; 1: only >= 0x80; 2: only < 0x80
+        int which_values = i_test % 3;
+        // The chance, out of 256, of each value being in the set
+        uint32_t density = rng() % 257;
+        CharSet set;
+        for (int value = 0; value < 256; value++)
+        {
+            bool allowed = which_values == 0 || (which_values == 1) == (value >= 0x80);
+            if (allowed && rng() % 256 < density)
+            {
+                set.Add((char)(uint8_t)value);
+            }
+        }
+
+        std::string buf = RandomBuffer(rng() % 300, &rng);
+        size_t offset = rng() % 32;
+        ExpectAllKernelsMatch(kernels, buf, set, offset,
+            "random #" + std::to_string(i_test) + " of size " + std::to_string(set.Size()));
+    }
+}
+
+TEST(RemoveCharsTest, StdString)
+{
+    std::string str = "Hello,\n\xe9t\xe9\r\n world!\xff";
+    RemoveChars(&str, CharSet(std::string("\r\n\xff\xe9")));
+    EXPECT_EQ(str, "Hello,t world!");
+}
+
+} // anonymous namespace
@@ -6,16 +6,25 @@ GS
 
 See: https://stackoverflow.com/questions/70712858/removing-all-the-vowels-in-a-string-in-c
 
+Approach 4 uses `RemoveChars()` from "string_remove_chars_lib.h", which does the same thing as
+approach 3, but with a 256-bit lookup set and SIMD kernels. See
+"string_remove_chars_from_std_string__speedtest.cpp" for how fast each of these approaches is.
+
+STATUS: done and works!
+
 To compile and run (assuming you've already `cd`ed into this dir):
 1. In C++
-    mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -std=c++17 -save-temps=obj remove_vowels_in_string.cpp \
-    -o bin/remove_vowels_in_string && bin/remove_vowels_in_string
+    mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -std=c++17 string_remove_vowels.cpp \
+    string_remove_chars_lib.cpp -o bin/string_remove_vowels && bin/string_remove_vowels
 
 References:
-1.
+1. https://stackoverflow.com/a/70043744/4561887
 
 */
 
+// Local includes
+#include "string_remove_chars_lib.h"
+
 // C++ includes
 #include <iostream>  // For `std::cin`, `std::cout`, `std::endl`, etc.
 #include <string>
@@ -75,22 +84,22 @@ References:
 /// Get the number of elements in an array
 #define ARRAY_LEN(array) (sizeof(array)/sizeof(array[0]))
 
-int main()
+void RemoveVowelsCStyle()
 {
     char input_str[] = "zjuotps";
     char vowels[] = "aeiouyAEIOUY";
 
     std::cout << "BEFORE: input_str = " << input_str << std::endl;
 
-    // Iterate over all chars in the input string
+    // Iterate over all chars in the input string, except its null terminator
     size_t i_write = 0;
-    for (size_t i_read = 0; i_read < ARRAY_LEN(input_str); i_read++)
+    for (size_t i_read = 0; i_read < ARRAY_LEN(input_str) - 1; i_read++)
     {
         // Iterate over all chars in the vowels string. Only retain in the input
         // string (copying chars into the left side of the input string) all
         // chars which are NOT vowels!
         bool char_is_a_vowel = false;
-        for (size_t j = 0; j < ARRAY_LEN(input_str); j++)
+        for (size_t j = 0; j < ARRAY_LEN(vowels) - 1; j++)
         {
             if (input_str[i_read] == vowels[j])
             {
@@ -106,7 +115,7 @@ int main()
     }
     // null-terminate the input string at its new end location; the number of
     // chars in it (its new length) is now equal to `i_write`!
-    input_str[i_write] = '\n';
+    input_str[i_write] = '\0';
 
     std::cout << "AFTER:  input_str = " << input_str << std::endl;
     // Just in case you need it back in this form now:
@@ -114,11 +123,38 @@ int main()
     std::cout << "          C++ str = " << str << std::endl;
 }
 
+///////////// APPROACH 4: same as approach 3, but with `RemoveChars()`
+void RemoveVowelsWithRemoveChars()
+{
+    std::string input_str = "zjuotps";
+    const CharSet vowels("aeiouyAEIOUY");
+
+    std::cout << "BEFORE: input_str = " << input_str << std::endl;
+    RemoveChars(&input_str, vowels);
+    std::cout << "AFTER:  input_str = " << input_str << std::endl;
+}
+
+int main()
+{
+    std::cout << "Approach 3: C-style, in place:" << std::endl;
+    RemoveVowelsCStyle();
+    std::cout << "\nApproach 4: with `RemoveChars()`:" << std::endl;
+    RemoveVowelsWithRemoveChars();
+}
+
 /*
 SAMPLE OUTPUT:
 
 In C++:
 
+    eRCaGuy_hello_world/cpp$ mkdir -p bin && g++ -Wall -Wextra -Werror -O3 -std=c++17 string_remove_vowels.cpp string_remove_chars_lib.cpp -o bin/string_remove_vowels && bin/string_remove_vowels
+    Approach 3: C-style, in place:
+    BEFORE: input_str = zjuotps
+    AFTER:  input_str = zjtps
+              C++ str = zjtps
 
+    Approach 4: with `RemoveChars()`:
+    BEFORE: input_str = zjuotps
+    AFTER:  input_str = zjtps
 
 */
@@ -18,6 +18,15 @@ References:
 1. "eRCaGuy_hello_world/c/read_system_call_via_pipe__arrow_keypresses.c" - example of using a pipe
    with `popen()` to read back the response from a system call in C or C++
 1. *****+ "eRCaGuy_hello_world/c/read_system_call_via_pipe__keypress.c"
+1. For `system_call_spawn()`:
+    1. https://man7.org/linux/man-pages/man3/posix_spawn.3.html
+    1. https://man7.org/linux/man-pages/man2/pipe.2.html - for `pipe2()` and `O_CLOEXEC`
+    1. https://man7.org/linux/man-pages/man2/poll.2.html
+    1. https://man7.org/linux/man-pages/man2/waitpid.2.html
+1. For `ProcessPool`:
+    1. https://man7.org/linux/man-pages/man7/epoll.7.html
+    1. https://man7.org/linux/man-pages/man2/pidfd_open.2.html
+    1. https://man7.org/linux/man-pages/man2/eventfd.2.html
 
 */
 
@@ -29,11 +38,26 @@ References:
 #include <fmt/format.h>
 
 // Linux includes
-// NA
+#include <fcntl.h>        // For `O_CLOEXEC`
+#include <poll.h>
+#include <signal.h>       // For `kill()`
+#include <spawn.h>        // For `posix_spawnp()`
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>  // For `SYS_pidfd_open`
+#include <sys/wait.h>     // For `waitpid()`
+#include <unistd.h>       // For `pipe2()`, `read()`, `close()`, `usleep()`, `environ`, `syscall()`
 
 // C and C++ includes
+#include <cerrno>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio> // `popen()`
+#include <cstring> // `strerror()`
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 
 namespace systemcall
@@ -207,4 +231,904 @@ std::string system_call2(const char* cmd, std::string* response_str, int* cmd_re
     return error;
 }
 
+/// Read size for `system_call_spawn()`: much bigger than `system_call()`'s 4096 bytes, so a big
+/// response takes 16x fewer `read()` calls. This is also the default size of a Linux pipe's buffer,
+/// so one read can empty a full pipe.
+static constexpr size_t SPAWN_READ_SIZE = 64*1024;
+
+// Close `*fd` if it is open, and mark it closed with -1.
+static void close_fd(int* fd)
+{
+    if (*fd >= 0)
+    {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+/// Read from the 2 pipe read ends `fds[0]` and `fds[1]` into `strs[0]` and `strs[1]`,
+/// respectively, until both reach EOF (the child closed its end, usually by exiting), closing
+/// each fd at EOF. A fd of -1 is skipped. Both pipes are read at once, with `poll()`, since a child
+/// which fills up one pipe's buffer blocks until that pipe is read, so reading them one at a time
+/// could deadlock.
+/// Returns `ERROR_OK`, or an error string if `poll()` or `read()` fails.
+static std::string spawn_read_pipes(int fds[2], std::string* strs[2])
+{
+    char buf[SPAWN_READ_SIZE];
+
+    while (fds[0] >= 0 || fds[1] >= 0)
+    {
+        struct pollfd pollfds[2];
+        size_t pollfd_to_fd_index[2];
+        nfds_t num_pollfds = 0;
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                pollfds[num_pollfds] = {fds[i], POLLIN, 0};
+                pollfd_to_fd_index[num_pollfds] = i;
+                num_pollfds++;
+            }
+        }
+
+        int retval = poll(pollfds, num_pollfds, -1);
+        if (retval == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return fmt::format(FMT_STRING("Failed to poll the pipes. errno = {}: {}"),
+                errno, strerror(errno));
+        }
+
+        for (nfds_t j = 0; j < num_pollfds; j++)
+        {
+            if (pollfds[j].revents == 0)
+            {
+                continue;
+            }
+            size_t i = pollfd_to_fd_index[j];
+            ssize_t num_bytes_read = read(fds[i], buf, sizeof(buf));
+            if (num_bytes_read > 0)
+            {
+                strs[i]->append(buf, (size_t)num_bytes_read);
+            }
+            else if (num_bytes_read == 0)
+            {
+                // EOF
+                close_fd(&fds[i]);
+            }
+            else if (errno != EINTR && errno != EAGAIN)
+            {
+                return fmt::format(FMT_STRING("Failed to read from pipe. errno = {}: {}"),
+                    errno, strerror(errno));
+            }
+        }
+    }
+
+    return ERROR_OK;
+}
+
+/// \brief      Start the program `argv[0]` with `posix_spawnp()`, with its `stdout` and `stderr`
+///             going into new pipes.
+/// \param[in]  argv        The program to run, and its arguments. Must not be empty.
+/// \param[out] pid         The child's process ID.
+/// \param[out] stdout_fd   (Optional) Receives the read end of the child's `stdout` pipe. If
+///                 `nullptr`, the child's `stdout` goes to `/dev/null`.
+/// \param[out] stderr_fd   (Optional) Receives the read end of the child's `stderr` pipe. If
+///                 `nullptr`, the child inherits this process's `stderr`.
+/// \param[in]  own_process_group   If `true`, start the child in a new process group, whose ID is
+///                 its `pid`, so that it and all of its own children can be signaled at once with
+///                 `kill(-pid, sig)`. Its `stdin` is then `/dev/null`, since a process outside
+///                 of the terminal's foreground process group is stopped if it reads from the
+///                 terminal.
+/// \return     `ERROR_OK`, or an error string if the child could not be started, in which case no
+///             fds are left open.
+static std::string spawn_child(const std::vector<std::string>& argv, pid_t* pid, int* stdout_fd,
+    int* stderr_fd, bool own_process_group = false)
+{
+    std::string error = ERROR_OK;
+
+    // `posix_spawnp()` needs a null-terminated array of C-strings
+    std::vector<char*> c_argv;
+    c_argv.reserve(argv.size() + 1);
+    for (const std::string& arg : argv)
+    {
+        c_argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    c_argv.push_back(nullptr);
+
+    // `O_CLOEXEC` so that the pipes are never inherited by any child, including those spawned at
+    // the same time by other threads: each child only gets the write ends `dup2()`ed onto its
+    // `stdout` and `stderr` below. Otherwise, another child holding a copy of a write end would
+    // keep us from seeing EOF until it exits.
+    int stdout_pipe[2] = {-1, -1};
+    int stderr_pipe[2] = {-1, -1};
+    if ((stdout_fd != nullptr && pipe2(stdout_pipe, O_CLOEXEC) == -1)
+        || (stderr_fd != nullptr && pipe2(stderr_pipe, O_CLOEXEC) == -1))
+    {
+        error = fmt::format(FMT_STRING("Failed to open pipe. errno = {}: {}"),
+            errno, strerror(errno));
+        close_fd(&stdout_pipe[0]);
+        close_fd(&stdout_pipe[1]);
+        return error;
+    }
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    if (stdout_fd != nullptr)
+    {
+        posix_spawn_file_actions_adddup2(&file_actions, stdout_pipe[1], STDOUT_FILENO);
+    }
+    else
+    {
+        // Discard the response, rather than letting it print to our own `stdout`
+        posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    }
+    if (stderr_fd != nullptr)
+    {
+        posix_spawn_file_actions_adddup2(&file_actions, stderr_pipe[1], STDERR_FILENO);
+    }
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    if (own_process_group)
+    {
+        posix_spawn_file_actions_addopen(&file_actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        // A process group ID of 0 means a new group, with the child's own pid as its ID
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attr, 0);
+    }
+
+    // NB: `posix_spawnp()` returns the error number; it doesn't set `errno`. glibc also reports
+    // a failed `exec` here, ex: `ENOENT` if the program isn't found.
+    int retval = posix_spawnp(pid, c_argv[0], &file_actions, &attr, c_argv.data(), environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&file_actions);
+    // Close our copies of the write ends, so we see EOF once the child closes its copies
+    close_fd(&stdout_pipe[1]);
+    close_fd(&stderr_pipe[1]);
+    if (retval != 0)
+    {
+        error = fmt::format(FMT_STRING("Failed to spawn \"{}\". errno = {}: {}"),
+            argv[0], retval, strerror(retval));
+        close_fd(&stdout_pipe[0]);
+        close_fd(&stderr_pipe[0]);
+        return error;
+    }
+
+    if (stdout_fd != nullptr)
+    {
+        *stdout_fd = stdout_pipe[0];
+    }
+    if (stderr_fd != nullptr)
+    {
+        *stderr_fd = stderr_pipe[0];
+    }
+    return error;
+}
+
+/// Set `*error` for a child which was reaped with wait status `status`, unless there already is an
+/// error.
+static void set_exit_status_error(int status, std::string* error)
+{
+    if (status != 0 && *error == ERROR_OK)
+    {
+        *error = fmt::format(FMT_STRING("Command exited with error status exit code {}."), status);
+        // keep going; the command ran, and just failed
+    }
+}
+
+/// Reap child `pid` with a blocking `waitpid()`, retrying if interrupted by a signal.
+/// Returns `ERROR_OK`, or an error string if `waitpid()` fails.
+static std::string wait_for_child(pid_t pid, int* status)
+{
+    int retval;
+    while ((retval = waitpid(pid, status, 0)) == -1 && errno == EINTR)
+    {
+        // retry
+    }
+    if (retval == -1)
+    {
+        return fmt::format(FMT_STRING("Failed to wait for the child process. Therefore: could "
+            "not obtain its exit status code. errno = {}: {}"), errno, strerror(errno));
+    }
+    return ERROR_OK;
+}
+
+/// How long `system_call_stream()` waits for a command it stopped early to exit after `SIGTERM`,
+/// before it sends `SIGKILL`
+static constexpr int STREAM_STOP_TIMEOUT_MS = 1000;
+
+/// Stop the command started by `system_call_stream_impl()` as process group `pid`, and reap it:
+/// send its whole process group `SIGTERM`, then `SIGKILL` if it hasn't exited within
+/// `STREAM_STOP_TIMEOUT_MS`.
+/// Returns `ERROR_OK`, or an error string if `waitpid()` fails.
+static std::string stop_stream_child(pid_t pid, int* status)
+{
+    kill(-pid, SIGTERM);
+    for (int i = 0; i < STREAM_STOP_TIMEOUT_MS; i++)
+    {
+        pid_t retval = waitpid(pid, status, WNOHANG);
+        if (retval == pid)
+        {
+            return ERROR_OK;
+        }
+        if (retval == -1 && errno != EINTR)
+        {
+            return fmt::format(FMT_STRING("Failed to wait for the child process. Therefore: "
+                "could not obtain its exit status code. errno = {}: {}"), errno, strerror(errno));
+        }
+        usleep(1000);
+    }
+    kill(-pid, SIGKILL);
+    return wait_for_child(pid, status);
+}
+
+/// \brief      Call system call `cmd`, reading its `stdout` response into one fixed buffer, and
+///             calling `consume()` after each `read()`.
+/// \details    `consume(buf, len, at_eof, &num_bytes_left)` is called with the `len` bytes in
+///             `buf`, and with `at_eof` set once the response has all been read. It sets
+///             `num_bytes_left` to the number of bytes at the end of `buf` which it did NOT use
+///             yet, which are moved to the front of `buf` for the next `read()` to append to. This
+///             must be less than `STREAM_BUF_SIZE`, so that there is room to read more. It returns
+///             `false` to stop reading early.
+///
+///             `cmd` is run with `/bin/sh -c`, just like `popen()` does, but with a known pid, and
+///             in its own process group, so that it can be stopped if `consume()` stops early.
+///             With `popen()`, `pclose()` would instead block until the command exits on its own,
+///             which, for a command that doesn't write any more, ex: `echo a; sleep 1000`, could
+///             be a long time.
+static std::string system_call_stream_impl(const char* cmd, int* cmd_retcode,
+    const std::function<bool(char* buf, size_t len, bool at_eof, size_t* num_bytes_left)>& consume)
+{
+    std::string error = ERROR_OK;
+
+    if (cmd == nullptr)
+    {
+        error = "INVALID ARGUMENT: nullptr";
+        return error;
+    }
+
+    pid_t pid;
+    int fd = -1;
+    error = spawn_child({"/bin/sh", "-c", cmd}, &pid, &fd, nullptr, true);
+    if (error != ERROR_OK)
+    {
+        return error;
+    }
+
+    // Use `read()` on the pipe, NOT `fread()`: `fread()` keeps reading until the whole buffer is
+    // full or it hits EOF, which would hold back the first lines of a slow command until it had
+    // written 64 KiB.
+    char buf[STREAM_BUF_SIZE];
+    size_t len = 0;
+    bool stopped_early = false;
+    while (true)
+    {
+        ssize_t num_bytes_read = read(fd, buf + len, sizeof(buf) - len);
+        if (num_bytes_read == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            error = fmt::format(FMT_STRING("Failed to read from pipe. errno = {}: {}"),
+                errno, strerror(errno));
+            break;
+        }
+        len += (size_t)num_bytes_read;
+        bool at_eof = num_bytes_read == 0;
+
+        size_t num_bytes_left = 0;
+        if (!consume(buf, len, at_eof, &num_bytes_left))
+        {
+            stopped_early = true;
+            break;
+        }
+        if (at_eof)
+        {
+            break;
+        }
+        memmove(buf, buf + len - num_bytes_left, num_bytes_left);
+        len = num_bytes_left;
+    }
+    close_fd(&fd);
+
+    int status;
+    if (stopped_early)
+    {
+        // We killed the command, so don't report its exit status as an error
+        std::string wait_error = stop_stream_child(pid, &status);
+        if (wait_error != ERROR_OK)
+        {
+            return wait_error;
+        }
+    }
+    else
+    {
+        std::string wait_error = wait_for_child(pid, &status);
+        if (wait_error != ERROR_OK)
+        {
+            return wait_error;
+        }
+        set_exit_status_error(status, &error);
+    }
+
+    if (cmd_retcode != nullptr)
+    {
+        // pass back the cmd's return code to the user
+        *cmd_retcode = status;
+    }
+
+    return error;
+}
+
+std::string system_call_stream(const char* cmd, const StreamChunkCallback& callback,
+    int* cmd_retcode)
+{
+    return system_call_stream_impl(cmd, cmd_retcode,
+        [&callback](char* buf, size_t len, bool at_eof, size_t* num_bytes_left)
+    {
+        (void)at_eof;
+        *num_bytes_left = 0;
+        return len == 0 || callback(buf, len);
+    });
+}
+
+std::string system_call_stream_lines(const char* cmd, const StreamLineCallback& callback,
+    int* cmd_retcode)
+{
+    return system_call_stream_impl(cmd, cmd_retcode,
+        [&callback](char* buf, size_t len, bool at_eof, size_t* num_bytes_left)
+    {
+        const char* start = buf;
+        const char* end = buf + len;
+        const char* newline;
+        while ((newline = (const char*)memchr(start, '\n', (size_t)(end - start))) != nullptr)
+        {
+            if (!callback(std::string_view(start, (size_t)(newline - start))))
+            {
+                return false;
+            }
+            start = newline + 1;
+        }
+
+        // The start of the next line, which `read()` will append the rest of to; unless this is
+        // the last line, with no trailing `\n`, or the line is too long to fit in the buffer, in
+        // which case pass on what we have of it now
+        *num_bytes_left = (size_t)(end - start);
+        if (*num_bytes_left > 0 && (at_eof || *num_bytes_left == STREAM_BUF_SIZE))
+        {
+            *num_bytes_left = 0;
+            return callback(std::string_view(start, (size_t)(end - start)));
+        }
+        return true;
+    });
+}
+
+std::string system_call_spawn(const std::vector<std::string>& argv, std::string* response_str,
+    int* cmd_retcode, std::string* stderr_str)
+{
+    std::string error = ERROR_OK;
+
+    if (argv.empty())
+    {
+        error = "INVALID ARGUMENT: empty argv";
+        return error;
+    }
+
+    pid_t pid;
+    int read_fds[2] = {-1, -1};
+    error = spawn_child(argv, &pid, response_str != nullptr ? &read_fds[0] : nullptr,
+        stderr_str != nullptr ? &read_fds[1] : nullptr);
+    if (error != ERROR_OK)
+    {
+        return error;
+    }
+
+    std::string* strs[2] = {response_str, stderr_str};
+    for (std::string* str : strs)
+    {
+        if (str != nullptr)
+        {
+            str->clear();
+            // pre-reserve room for 1 full read, so that small responses need only this one
+            // allocation
+            str->reserve(SPAWN_READ_SIZE);
+        }
+    }
+    error = spawn_read_pipes(read_fds, strs);
+    // Still close the pipes and reap the child if reading failed, so no fds or zombies are leaked
+    close_fd(&read_fds[0]);
+    close_fd(&read_fds[1]);
+
+    int status;
+    std::string wait_error = wait_for_child(pid, &status);
+    if (wait_error != ERROR_OK)
+    {
+        return wait_error;
+    }
+    set_exit_status_error(status, &error);
+
+    if (cmd_retcode != nullptr)
+    {
+        // pass back the cmd's return code to the user
+        *cmd_retcode = status;
+    }
+
+    return error;
+}
+
+/// Open a pidfd for child `pid`: a fd which becomes readable once the child exits, so that exits
+/// can be waited for in the same `epoll` loop as the pipes. Needs Linux >= 5.3. pidfds have
+/// `O_CLOEXEC` set automatically.
+/// Returns the fd, or -1 with `errno` set.
+static int pidfd_open(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/// All of the state of a `ProcessPool`, kept out of the header so that it needn't include any
+/// Linux headers.
+class ProcessPool::Impl
+{
+public:
+    explicit Impl(size_t max_num_running);
+    ~Impl();
+
+    void submit(std::vector<std::string>&& argv, Callback&& callback);
+    void wait_all();
+
+private:
+    /// A command waiting in the queue to be started
+    struct QueuedCommand
+    {
+        std::vector<std::string> argv;
+        Callback callback;
+    };
+
+    /// A running command
+    struct Job
+    {
+        CommandResult result;
+        Callback callback;
+        pid_t pid = -1;
+        /// Read ends of the `stdout` and `stderr` pipes; -1 once closed at EOF
+        int fds[2] = {-1, -1};
+        /// -1 if pidfds are not supported, or once the child has been reaped
+        int pidfd = -1;
+        bool reaped = false;
+    };
+
+    /// Each fd in the `epoll` set is identified by `job_id*4 + FdKind`. Job IDs start at 1, so key
+    /// `WAKE` (job ID 0) is the `eventfd` which `submit()` and the destructor use to wake the loop.
+    enum FdKind : uint64_t
+    {
+        STDOUT_FD = 0,
+        STDERR_FD = 1,
+        PIDFD = 2,
+        WAKE = 3,
+    };
+
+    void run_loop();
+    void start_queued_commands();
+    void add_fd_to_epoll(int fd, uint64_t key, std::string* error);
+    void remove_fd_from_epoll(int* fd);
+    void handle_pipe_event(Job* job, size_t i);
+    void handle_pidfd_event(Job* job);
+    void finish_job_if_done(uint64_t job_id);
+    void finish_job_blocking(uint64_t job_id);
+    void complete(CommandResult&& result, Callback& callback);
+
+    const size_t max_num_running_;
+    /// `ERROR_OK`, or why the `epoll` loop could not be set up, in which case every command fails
+    /// with this error
+    std::string init_error_ = ERROR_OK;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+
+    /// Guards everything below it, up to the loop-thread-only members
+    std::mutex mutex_;
+    std::condition_variable all_done_cv_;
+    std::deque<QueuedCommand> queue_;
+    /// Commands submitted whose callbacks haven't returned yet
+    size_t num_unfinished_ = 0;
+    bool stopping_ = false;
+
+    // Only used by the loop thread
+    std::unordered_map<uint64_t, Job> jobs_;
+    uint64_t next_job_id_ = 1;
+    std::vector<char> buf_;
+
+    std::thread loop_thread_;
+};
+
+ProcessPool::Impl::Impl(size_t max_num_running)
+    : max_num_running_(max_num_running > 0 ? max_num_running : 1), buf_(SPAWN_READ_SIZE)
+{
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1)
+    {
+        init_error_ = fmt::format(FMT_STRING("Failed to create the epoll instance. errno = {}: {}"),
+            errno, strerror(errno));
+        return;
+    }
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ == -1)
+    {
+        init_error_ = fmt::format(FMT_STRING("Failed to create the eventfd. errno = {}: {}"),
+            errno, strerror(errno));
+        return;
+    }
+    add_fd_to_epoll(wake_fd_, WAKE, &init_error_);
+    if (init_error_ != ERROR_OK)
+    {
+        return;
+    }
+
+    loop_thread_ = std::thread(&Impl::run_loop, this);
+}
+
+ProcessPool::Impl::~Impl()
+{
+    wait_all();
+    if (loop_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        uint64_t one = 1;
+        ssize_t retval = write(wake_fd_, &one, sizeof(one));
+        (void)retval;  // it can only fail if the counter is already non-zero, which wakes it too
+        loop_thread_.join();
+    }
+    close_fd(&wake_fd_);
+    close_fd(&epoll_fd_);
+}
+
+void ProcessPool::Impl::submit(std::vector<std::string>&& argv, Callback&& callback)
+{
+    if (init_error_ != ERROR_OK || argv.empty())
+    {
+        CommandResult result;
+        result.error = init_error_ != ERROR_OK ? init_error_ : "INVALID ARGUMENT: empty argv";
+        callback(std::move(result));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back({std::move(argv), std::move(callback)});
+        num_unfinished_++;
+    }
+    uint64_t one = 1;
+    ssize_t retval = write(wake_fd_, &one, sizeof(one));
+    (void)retval;  // it can only fail if the counter is already non-zero, which wakes it too
+}
+
+void ProcessPool::Impl::wait_all()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_done_cv_.wait(lock, [this]() { return num_unfinished_ == 0; });
+}
+
+void ProcessPool::Impl::add_fd_to_epoll(int fd, uint64_t key, std::string* error)
+{
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = key;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1 && *error == ERROR_OK)
+    {
+        *error = fmt::format(FMT_STRING("Failed to add a fd to the epoll set. errno = {}: {}"),
+            errno, strerror(errno));
+    }
+}
+
+/// Remove `*fd` from the `epoll` set, then close it. Just closing it isn't enough: `epoll` watches
+/// the open file description, not the fd, and a child spawned at about the same time may still
+/// hold a copy of `*fd` for a moment, until its `exec` closes it, so we could still get events
+/// for it after closing it.
+void ProcessPool::Impl::remove_fd_from_epoll(int* fd)
+{
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *fd, nullptr);
+    close_fd(fd);
+}
+
+void ProcessPool::Impl::run_loop()
+{
+    constexpr int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (true)
+    {
+        start_queued_commands();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ && queue_.empty() && jobs_.empty())
+            {
+                break;
+            }
+        }
+
+        // Sleep until a pipe has data or hits EOF, a child exits, or a command is submitted
+        int num_events = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if (num_events == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // This should never happen, but if it does, don't hang the callers: finish each
+            // running command the same way `system_call_spawn()` does
+            while (!jobs_.empty())
+            {
+                finish_job_blocking(jobs_.begin()->first);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            uint64_t key = events[i].data.u64;
+            uint64_t job_id = key / 4;
+            FdKind fd_kind = (FdKind)(key % 4);
+            if (fd_kind == WAKE)
+            {
+                uint64_t count;
+                ssize_t retval = read(wake_fd_, &count, sizeof(count));
+                (void)retval;
+                continue;
+            }
+
+            // A job finished earlier in this batch of events may have had more events pending
+            auto it = jobs_.find(job_id);
+            if (it == jobs_.end())
+            {
+                continue;
+            }
+            if (fd_kind == PIDFD)
+            {
+                handle_pidfd_event(&it->second);
+            }
+            else
+            {
+                handle_pipe_event(&it->second, fd_kind);
+            }
+            finish_job_if_done(job_id);
+        }
+    }
+}
+
+void ProcessPool::Impl::start_queued_commands()
+{
+    while (jobs_.size() < max_num_running_)
+    {
+        QueuedCommand command;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty())
+            {
+                return;
+            }
+            command = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        uint64_t job_id = next_job_id_++;
+        Job& job = jobs_[job_id];
+        job.callback = std::move(command.callback);
+        job.result.error = spawn_child(command.argv, &job.pid, &job.fds[0], &job.fds[1]);
+        if (job.result.error != ERROR_OK)
+        {
+            job.reaped = true;
+            finish_job_if_done(job_id);
+            continue;
+        }
+
+        for (size_t i = 0; i < 2; i++)
+        {
+            // Non-blocking, so a spurious wakeup can never block the whole loop in `read()`. Only
+            // our read end is changed; the child's write end is a separate open file description.
+            fcntl(job.fds[i], F_SETFL, O_NONBLOCK);
+            add_fd_to_epoll(job.fds[i], job_id*4 + i, &job.result.error);
+        }
+        job.pidfd = pidfd_open(job.pid);
+        if (job.pidfd >= 0)
+        {
+            add_fd_to_epoll(job.pidfd, job_id*4 + PIDFD, &job.result.error);
+        }
+        // else: no pidfds (Linux < 5.3), so `finish_job_if_done()` reaps the child with a
+        // blocking `waitpid()` once both pipes hit EOF, which is normally when it exits anyway
+
+        if (job.result.error != ERROR_OK)
+        {
+            // Some fd isn't in the `epoll` set, so we'd never hear about it
+            finish_job_blocking(job_id);
+        }
+    }
+}
+
+void ProcessPool::Impl::handle_pipe_event(Job* job, size_t i)
+{
+    if (job->fds[i] < 0)
+    {
+        // already closed earlier in this batch of events
+        return;
+    }
+
+    // Only 1 read per event, so one command with lots of output can't starve the others. With
+    // level-triggered `epoll`, any data left in the pipe wakes the next `epoll_wait()` right away.
+    ssize_t num_bytes_read = read(job->fds[i], buf_.data(), buf_.size());
+    if (num_bytes_read > 0)
+    {
+        std::string& str = i == STDOUT_FD ? job->result.response_str : job->result.stderr_str;
+        str.append(buf_.data(), (size_t)num_bytes_read);
+    }
+    else if (num_bytes_read == 0)
+    {
+        // EOF
+        remove_fd_from_epoll(&job->fds[i]);
+    }
+    else if (errno != EINTR && errno != EAGAIN)
+    {
+        if (job->result.error == ERROR_OK)
+        {
+            job->result.error = fmt::format(FMT_STRING("Failed to read from pipe. errno = {}: {}"),
+                errno, strerror(errno));
+        }
+        remove_fd_from_epoll(&job->fds[i]);
+    }
+}
+
+void ProcessPool::Impl::handle_pidfd_event(Job* job)
+{
+    if (job->reaped)
+    {
+        return;
+    }
+
+    int status;
+    pid_t retval = waitpid(job->pid, &status, WNOHANG);
+    if (retval == 0)
+    {
+        // not exited yet; can't really happen once the pidfd is readable
+        return;
+    }
+    if (retval == -1)
+    {
+        if (errno == EINTR)
+        {
+            return;
+        }
+        if (job->result.error == ERROR_OK)
+        {
+            job->result.error = fmt::format(FMT_STRING("Failed to wait for the child process. "
+                "Therefore: could not obtain its exit status code. errno = {}: {}"),
+                errno, strerror(errno));
+        }
+    }
+    else
+    {
+        job->result.cmd_retcode = status;
+    }
+    job->reaped = true;
+    remove_fd_from_epoll(&job->pidfd);
+}
+
+void ProcessPool::Impl::finish_job_if_done(uint64_t job_id)
+{
+    auto it = jobs_.find(job_id);
+    Job& job = it->second;
+    if (job.fds[0] >= 0 || job.fds[1] >= 0)
+    {
+        return;
+    }
+    if (!job.reaped)
+    {
+        if (job.pidfd >= 0)
+        {
+            // the pidfd will wake us up once the child exits
+            return;
+        }
+        int status;
+        std::string wait_error = wait_for_child(job.pid, &status);
+        if (wait_error != ERROR_OK)
+        {
+            job.result.error = wait_error;
+        }
+        else
+        {
+            job.result.cmd_retcode = status;
+        }
+        job.reaped = true;
+    }
+    if (job.result.cmd_retcode != -1)
+    {
+        set_exit_status_error(job.result.cmd_retcode, &job.result.error);
+    }
+
+    CommandResult result = std::move(job.result);
+    Callback callback = std::move(job.callback);
+    jobs_.erase(it);
+    complete(std::move(result), callback);
+}
+
+void ProcessPool::Impl::finish_job_blocking(uint64_t job_id)
+{
+    Job& job = jobs_.at(job_id);
+    std::string* strs[2] = {&job.result.response_str, &job.result.stderr_str};
+    for (int fd : job.fds)
+    {
+        if (fd >= 0)
+        {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            // back to blocking, so `spawn_read_pipes()` doesn't spin on `EAGAIN`
+            fcntl(fd, F_SETFL, 0);
+        }
+    }
+    std::string error = spawn_read_pipes(job.fds, strs);
+    close_fd(&job.fds[0]);
+    close_fd(&job.fds[1]);
+    if (job.result.error == ERROR_OK)
+    {
+        job.result.error = error;
+    }
+    // `finish_job_if_done()` then reaps the child with a blocking `waitpid()`
+    if (job.pidfd >= 0)
+    {
+        remove_fd_from_epoll(&job.pidfd);
+    }
+    finish_job_if_done(job_id);
+}
+
+void ProcessPool::Impl::complete(CommandResult&& result, Callback& callback)
+{
+    callback(std::move(result));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_unfinished_--;
+    if (num_unfinished_ == 0)
+    {
+        all_done_cv_.notify_all();
+    }
+}
+
+ProcessPool::ProcessPool(size_t max_num_running)
+    : impl_(std::make_unique<Impl>(max_num_running))
+{
+}
+
+ProcessPool::~ProcessPool() = default;
+
+std::future<CommandResult> ProcessPool::submit(std::vector<std::string> argv)
+{
+    // `std::function` must be copyable, and `std::promise` isn't, so share it
+    auto promise = std::make_shared<std::promise<CommandResult>>();
+    std::future<CommandResult> future = promise->get_future();
+    impl_->submit(std::move(argv), [promise](CommandResult&& result)
+    {
+        promise->set_value(std::move(result));
+    });
+    return future;
+}
+
+void ProcessPool::submit(std::vector<std::string> argv, Callback callback)
+{
+    impl_->submit(std::move(argv), std::move(callback));
+}
+
+void ProcessPool::wait_all()
+{
+    impl_->wait_all();
+}
+
 } // namespace systemcall
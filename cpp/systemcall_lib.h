@@ -36,7 +36,12 @@ References:
 // NA
 
 // C and C++ includes
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 namespace systemcall
@@ -67,5 +72,159 @@ std::string system_call(const char* cmd, std::string* response_str = nullptr,
 std::string system_call2(const char* cmd, std::string* response_str = nullptr,
    int* cmd_retcode = nullptr);
 
+/// Size of the fixed buffer which `system_call_stream()` and `system_call_stream_lines()` read a
+/// command's output into. It's the most they ever pass to the callback at once.
+constexpr size_t STREAM_BUF_SIZE = 64*1024;
+
+/// Called by `system_call_stream()` with each chunk of output, `len` bytes at `data`. Return `true`
+/// to keep going, or `false` to stop reading.
+using StreamChunkCallback = std::function<bool(const char* data, size_t len)>;
+
+/// Called by `system_call_stream_lines()` with each line of output, withOUT its trailing `\n`.
+/// Return `true` to keep going, or `false` to stop reading.
+using StreamLineCallback = std::function<bool(std::string_view line)>;
+
+/// \brief          Call system call `cmd`, just like `system_call()`, but pass its `stdout`
+///      response to `callback` chunk by chunk as it arrives, instead of buffering it all into a
+///      string.
+/// \details        The output is read with `read()` into one fixed `STREAM_BUF_SIZE` buffer on the
+///      stack, which is reused for every chunk, so memory use stays the same no matter how much
+///      output there is, and `callback` gets each chunk as soon as the command writes it (rather
+///      than once `fread()` has filled a whole buffer). This also gives backpressure for free:
+///      nothing more is read while `callback` runs, so if it is slower than the command, the pipe
+///      fills up and the command blocks in `write()` until `callback` catches up.
+///
+///      If `callback` returns `false`, the pipe is closed, and the command is stopped right away,
+///      rather than waited for, since it might not exit for a long time on its own, ex:
+///      `echo a; sleep 1000`: its whole process group is sent `SIGTERM`, and then `SIGKILL` if it
+///      hasn't exited within 1 second. The exit status it dies with is NOT reported as an error.
+///
+///      Unlike with `system_call()`, `cmd` runs in its own process group, so that all of the
+///      processes it starts can be stopped at once. So its `stdin` is `/dev/null` rather than this
+///      process's, and it doesn't get the terminal's signals, such as `SIGINT` from Ctrl + C.
+/// \param[in]      cmd             A null-terminated command string to call as though at the
+///                     command-line.
+/// \param[in]      callback        Called with each chunk of the command's `stdout` response, of
+///                     1 to `STREAM_BUF_SIZE` bytes.
+/// \param[out]     cmd_retcode     (Optional) A pointer to receive the command's return error code
+///                     back, if desired.
+/// \return         An error string to describe the error if there is an error, or
+///                 `ERROR_OK` otherwise.
+std::string system_call_stream(const char* cmd, const StreamChunkCallback& callback,
+   int* cmd_retcode = nullptr);
+
+/// Same as `system_call_stream()`, but pass the response to `callback` line by line. Each line
+/// points into the fixed buffer, so it is only valid until `callback` returns. A last line with no
+/// trailing `\n` is passed too. A line longer than `STREAM_BUF_SIZE` is passed in pieces of
+/// `STREAM_BUF_SIZE` bytes, plus the rest.
+std::string system_call_stream_lines(const char* cmd, const StreamLineCallback& callback,
+   int* cmd_retcode = nullptr);
+
+/// \brief          Run the program `argv[0]` with arguments `argv[1]`, `argv[2]`, etc. directly,
+///      withOUT a shell, optionally reading back its `stdout` into `response_str` and its
+///      `stderr` into `stderr_str`.
+/// \details        This is much faster than `system_call()` when running many short commands:
+///      `popen()` forks a whole `/bin/sh` process to parse and run `cmd`, whereas this uses
+///      `posix_spawnp()` (which glibc implements with `vfork()` semantics: the child shares the
+///      parent's memory until it calls `exec`, so no page tables are copied) to start the
+///      program itself, found in the `PATH` like at the command-line. The output is read through
+///      `pipe2(O_CLOEXEC)` pipes, 64 KiB at a time, into pre-reserved strings.
+///
+///      Since there is no shell, there are also no shell features: no pipes (`|`), redirection,
+///      globs, or variables, and no quoting needed for arguments with spaces or special chars.
+///      Ex: `system_call_spawn({"ls", "-1", "my dir"}, &response_str)`.
+/// \param[in]      argv            The program to run, and its arguments. Must not be empty.
+/// \param[out]     response_str    (Optional) A pointer to a `std::string` to receive the
+///                     command's `stdout` response back, if desired. If `nullptr`, the command's
+///                     `stdout` goes to `/dev/null`.
+/// \param[out]     cmd_retcode     (Optional) A pointer to receive the command's return error code
+///                     back, if desired. Just like for `system_call()`, this is the raw wait
+///                     status, as returned by `waitpid()`, so use `WEXITSTATUS()` on it to get the
+///                     exit code.
+/// \param[out]     stderr_str      (Optional) A pointer to a `std::string` to receive the
+///                     command's `stderr` output back, if desired. If `nullptr`, the command's
+///                     `stderr` goes to this process's `stderr`, just like for `system_call()`.
+/// \return         An error string to describe the error if there is an error, or
+///                 `ERROR_OK` otherwise.
+std::string system_call_spawn(const std::vector<std::string>& argv,
+   std::string* response_str = nullptr, int* cmd_retcode = nullptr,
+   std::string* stderr_str = nullptr);
+
+/// The result of one command run by a `ProcessPool`
+struct CommandResult
+{
+   /// `ERROR_OK`, or an error string to describe the error, just like `system_call_spawn()`
+   /// returns
+   std::string error = ERROR_OK;
+   /// The command's `stdout` output
+   std::string response_str;
+   /// The command's `stderr` output
+   std::string stderr_str;
+   /// The raw wait status, just like `cmd_retcode` from `system_call_spawn()`, or -1 if the
+   /// command could not be run at all
+   int cmd_retcode = -1;
+};
+
+/// \brief          Run many commands at once, up to `max_num_running` at a time, capturing the
+///      `stdout` and `stderr` of each.
+/// \details        Each command is started just like with `system_call_spawn()`: directly, with
+///      `posix_spawnp()`, with no shell. A single background thread then waits in one `epoll`
+///      loop on all of the running commands' pipes, plus a pidfd per child, which becomes
+///      readable when the child exits, so children are reaped as they exit, with no polling or
+///      busy-waiting, and no `SIGCHLD` handler which could interfere with the rest of the
+///      program. (On Linux < 5.3, which has no pidfds, each child is reaped with a blocking
+///      `waitpid()` once it closes both of its pipes instead.) As each command finishes, the
+///      next queued command is started.
+///
+///      This way, a batch of hundreds of small commands is limited by the CPU, not by waiting on
+///      each one in turn. Ex:
+///      ```
+///      systemcall::ProcessPool pool(8);
+///      std::vector<std::future<systemcall::CommandResult>> futures;
+///      for (const std::string& file : files)
+///      {
+///          futures.push_back(pool.submit({"md5sum", file}));
+///      }
+///      for (auto& future : futures)
+///      {
+///          systemcall::CommandResult result = future.get();
+///          // use `result.response_str`, etc.
+///      }
+///      ```
+///      The destructor waits for all submitted commands to finish.
+class ProcessPool
+{
+public:
+   /// Called with each command's result, from the pool's thread, in the order the commands
+   /// finish. It must not throw, and must not call `wait_all()` or destroy the pool, and should
+   /// return quickly, since no other command's output is read while it runs. It may call
+   /// `submit()`.
+   using Callback = std::function<void(CommandResult&& result)>;
+
+   /// \param[in]      max_num_running The max number of commands to run at once. 0 is treated
+   ///                     as 1.
+   explicit ProcessPool(size_t max_num_running);
+   ~ProcessPool();
+
+   ProcessPool(const ProcessPool&) = delete;
+   ProcessPool& operator=(const ProcessPool&) = delete;
+
+   /// \brief          Queue up the program `argv[0]` to run with arguments `argv[1]`, `argv[2]`,
+   ///      etc., just like `system_call_spawn()`.
+   /// \return         A future which receives the command's result once it finishes
+   std::future<CommandResult> submit(std::vector<std::string> argv);
+
+   /// Same as above, but call `callback` with the result instead. If the command can't be queued
+   /// at all (ex: `argv` is empty), `callback` is called right away, from this thread.
+   void submit(std::vector<std::string> argv, Callback callback);
+
+   /// Block until every command submitted so far has finished, and its callback has returned.
+   void wait_all();
+
+private:
+   class Impl;
+   std::unique_ptr<Impl> impl_;
+};
+
 } // namespace systemcall
 
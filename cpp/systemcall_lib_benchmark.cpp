@@ -0,0 +1,273 @@
+/*
+This file is part of eRCaGuy_hello_world: https://github.com/ElectricRCAircraftGuy/eRCaGuy_hello_world
+
+Benchmark the 3 ways to run a command in "systemcall_lib.h", in commands per second:
+1. `system_call()` - `popen()`, which runs the command through `/bin/sh -c`, and reads its output
+   4096 bytes at a time
+2. `system_call2()` - the same as `system_call()`, just written without `goto`
+3. `system_call_spawn()` - `posix_spawnp()` of the program itself, with no shell, reading its
+   output 64 KiB at a time
+
+...for programs with no output (`/bin/true`), a short output (`/bin/echo hello`), and 1 MiB of
+output (`head -c 1048576 /dev/zero`), plus `true`, which is a shell builtin: `/bin/sh` runs it
+without starting any other program, so that is the one case where the shell costs almost nothing
+extra. Each response is checked.
+
+Then, benchmark running a batch of commands one at a time with `system_call_spawn()` vs. all at
+once with a `ProcessPool`, with various limits on the number running at once, in commands per
+second. Commands which mostly wait (`sleep 0.01`) speed up with the number running at once, even on
+1 CPU, whereas commands which only use the CPU speed up with no more than the number of CPUs.
+
+STATUS: done and works!
+
+To compile and run (assuming you've already `cd`ed into this dir):
+```bash
+# 1. FIRST, follow the steps in "eRCaGuy_hello_world/cpp/README.md" to install the fmt library.
+# 2. THEN:
+time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING \
+    systemcall_lib_benchmark.cpp systemcall_lib.cpp ../c/timinglib.c -lfmt -o bin/a && bin/a
+```
+
+References:
+1. "systemcall_lib.h"
+
+*/
+
+
+// Local includes
+#include "../c/timinglib.h"
+#include "systemcall_lib.h"
+
+// 3rd-party library includes
+// NA
+
+// Linux includes
+// NA
+
+// C and C++ includes
+#include <cstdint>  // For `uint8_t`, `int8_t`, etc.
+#include <cstdio>   // For `printf()`
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+/// Run each command at least this many times, and for at least this long
+constexpr size_t MIN_RUNS = 20;
+constexpr uint64_t MIN_TIME_NS = 2000*1000*1000ULL;
+
+/// One way to run a command, given both as a shell command string, and as argv
+using RunCommandFunc = std::function<std::string(const char* cmd,
+    const std::vector<std::string>& argv, std::string* response_str, int* cmd_retcode)>;
+
+/// \brief      Run a command over and over with `run_command`, checking each response.
+/// \return     The number of commands run per second, or a negative number if any response was
+///             wrong
+double BenchmarkCommand(const RunCommandFunc& run_command, const char* cmd,
+    const std::vector<std::string>& argv, const std::string& expected_response)
+{
+    std::string response_str;
+    size_t num_runs = 0;
+    uint64_t start_ns = nanos();
+    uint64_t elapsed_ns = 0;
+    while (num_runs < MIN_RUNS || elapsed_ns < MIN_TIME_NS)
+    {
+        int cmd_retcode = -1;
+        std::string error = run_command(cmd, argv, &response_str, &cmd_retcode);
+        if (error != systemcall::ERROR_OK || cmd_retcode != 0 || response_str != expected_response)
+        {
+            printf("ERROR running \"%s\": %s\n", cmd, error.c_str());
+            return -1;
+        }
+        num_runs++;
+        elapsed_ns = nanos() - start_ns;
+    }
+    return (double)num_runs * 1e9 / (double)elapsed_ns;
+}
+
+/// \brief      Run `num_commands` copies of command `argv`: one at a time with
+///             `system_call_spawn()` if `max_num_running` is 0, or else all at once with a
+///             `ProcessPool` which runs up to `max_num_running` at a time, checking each response.
+/// \return     The number of commands run per second, or a negative number if any response was
+///             wrong
+double BenchmarkBatch(const std::vector<std::string>& argv, const std::string& expected_response,
+    size_t num_commands, size_t max_num_running)
+{
+    bool all_ok = true;
+    uint64_t start_ns = nanos();
+    if (max_num_running == 0)
+    {
+        std::string response_str;
+        for (size_t i = 0; i < num_commands; i++)
+        {
+            int cmd_retcode = -1;
+            std::string error = systemcall::system_call_spawn(argv, &response_str, &cmd_retcode);
+            all_ok &= error == systemcall::ERROR_OK && cmd_retcode == 0
+                && response_str == expected_response;
+        }
+    }
+    else
+    {
+        systemcall::ProcessPool pool(max_num_running);
+        std::vector<std::future<systemcall::CommandResult>> futures;
+        futures.reserve(num_commands);
+        for (size_t i = 0; i < num_commands; i++)
+        {
+            futures.push_back(pool.submit(argv));
+        }
+        for (std::future<systemcall::CommandResult>& future : futures)
+        {
+            systemcall::CommandResult result = future.get();
+            all_ok &= result.error == systemcall::ERROR_OK && result.cmd_retcode == 0
+                && result.response_str == expected_response;
+        }
+    }
+    uint64_t elapsed_ns = nanos() - start_ns;
+
+    if (!all_ok)
+    {
+        printf("ERROR running \"%s\"\n", argv[0].c_str());
+        return -1;
+    }
+    return (double)num_commands * 1e9 / (double)elapsed_ns;
+}
+
+// int main(int argc, char *argv[])  // alternative prototype
+int main()
+{
+    struct Command
+    {
+        const char* cmd;
+        std::vector<std::string> argv;
+        std::string expected_response;
+    };
+    const Command COMMANDS[] = {
+        {"true", {"true"}, ""},
+        {"/bin/true", {"/bin/true"}, ""},
+        {"/bin/echo hello", {"/bin/echo", "hello"}, "hello\n"},
+        {"head -c 1048576 /dev/zero", {"head", "-c", "1048576", "/dev/zero"},
+            std::string(1048576, '\0')},
+    };
+
+    struct Method
+    {
+        const char* name;
+        RunCommandFunc run_command;
+    };
+    const Method METHODS[] = {
+        {"system_call()", [](const char* cmd, const std::vector<std::string>& argv,
+            std::string* response_str, int* cmd_retcode)
+        {
+            (void)argv;
+            return systemcall::system_call(cmd, response_str, cmd_retcode);
+        }},
+        {"system_call2()", [](const char* cmd, const std::vector<std::string>& argv,
+            std::string* response_str, int* cmd_retcode)
+        {
+            (void)argv;
+            return systemcall::system_call2(cmd, response_str, cmd_retcode);
+        }},
+        {"system_call_spawn()", [](const char* cmd, const std::vector<std::string>& argv,
+            std::string* response_str, int* cmd_retcode)
+        {
+            (void)cmd;
+            return systemcall::system_call_spawn(argv, response_str, cmd_retcode);
+        }},
+    };
+
+    printf("Commands per second:\n");
+    printf("  %-22s", "method");
+    for (const Command& command : COMMANDS)
+    {
+        printf(" %26s", command.cmd);
+    }
+    printf("\n");
+
+    bool all_ok = true;
+    for (const Method& method : METHODS)
+    {
+        printf("  %-22s", method.name);
+        fflush(stdout);
+        for (const Command& command : COMMANDS)
+        {
+            double commands_per_sec = BenchmarkCommand(method.run_command, command.cmd,
+                command.argv, command.expected_response);
+            all_ok &= commands_per_sec >= 0;
+            printf(" %26.1f", commands_per_sec);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    struct BatchCommand
+    {
+        const char* cmd;
+        std::vector<std::string> argv;
+        std::string expected_response;
+        size_t num_commands;
+    };
+    const BatchCommand BATCH_COMMANDS[] = {
+        {"500 x /bin/echo hello", {"/bin/echo", "hello"}, "hello\n", 500},
+        {"200 x sleep 0.01", {"sleep", "0.01"}, "", 200},
+    };
+    // 0 means one at a time, with `system_call_spawn()`
+    const size_t MAX_NUMS_RUNNING[] = {0, 1, 4, 16, 64};
+
+    printf("\nBatches of commands, in commands per second:\n");
+    printf("  %-22s", "method");
+    for (const BatchCommand& command : BATCH_COMMANDS)
+    {
+        printf(" %26s", command.cmd);
+    }
+    printf("\n");
+
+    for (size_t max_num_running : MAX_NUMS_RUNNING)
+    {
+        std::string name = max_num_running == 0 ? "system_call_spawn()"
+            : "ProcessPool(" + std::to_string(max_num_running) + ")";
+        printf("  %-22s", name.c_str());
+        fflush(stdout);
+        for (const BatchCommand& command : BATCH_COMMANDS)
+        {
+            double commands_per_sec = BenchmarkBatch(command.argv, command.expected_response,
+                command.num_commands, max_num_running);
+            all_ok &= commands_per_sec >= 0;
+            printf(" %26.1f", commands_per_sec);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    if (!all_ok)
+    {
+        printf("\nFAILED: some commands failed or gave the wrong response!\n");
+        return 1;
+    }
+    printf("\nAll responses are correct.\n");
+    return 0;
+}
+
+
+/*
+SAMPLE OUTPUT (on a 1-core 2 GHz VM; the numbers vary quite a bit from run to run). With only 1
+CPU, running `/bin/echo` many at a time can't help much, but the mostly-waiting `sleep 0.01`s go
+~11x faster with 16 at a time; beyond that, starting ~1000 processes/sec on 1 CPU is the limit:
+
+    eRCaGuy_hello_world/cpp$ time g++ -Wall -Wextra -Werror -O3 -std=c++17 -pthread -DFMT_ENFORCE_COMPILE_STRING systemcall_lib_benchmark.cpp systemcall_lib.cpp ../c/timinglib.c -lfmt -o bin/a && bin/a
+    Commands per second:
+      method                                       true                  /bin/true            /bin/echo hello  head -c 1048576 /dev/zero
+      system_call()                              1147.4                      661.8                      556.6                      286.4
+      system_call2()                             1034.1                      549.7                      611.0                      305.0
+      system_call_spawn()                        1180.1                     1264.8                     1143.5                      474.7
+
+    Batches of commands, in commands per second:
+      method                      500 x /bin/echo hello           200 x sleep 0.01
+      system_call_spawn()                        1153.1                       84.6
+      ProcessPool(1)                             1132.3                       80.4
+      ProcessPool(4)                             1301.0                      317.0
+      ProcessPool(16)                            1164.3                      940.1
+      ProcessPool(64)                            1004.9                      917.3
+
+    All responses are correct.
+
+*/
@@ -47,12 +47,21 @@ References:
 #include "gtest/gtest.h"
 
 // Linux includes
-// NA
+#include <signal.h>    // For `SIGTERM`, `SIGKILL`
+#include <stdlib.h>    // For `mkdtemp()`
+#include <sys/stat.h>  // For `mkdir()`
+#include <sys/wait.h>  // For `WEXITSTATUS()`
 
 // C and C++ includes
+#include <atomic>
+#include <chrono>
 #include <cstdint>  // For `uint8_t`, `int8_t`, etc.
 #include <cstdio>   // For `printf()`
+#include <future>
 #include <iostream>  // For `std::cin`, `std::cout`, `std::endl`, etc.
+#include <mutex>
+#include <string>
+#include <vector>
 
 
 // anonymous namespace
@@ -87,6 +96,406 @@ TEST(SystemCallTest, ListFile)
     EXPECT_EQ(cmd_return_code, 0);
 }
 
+/// Chunks, put back together, are the same response as from `system_call()`
+TEST(SystemCallStreamTest, ChunksMatchSystemCall)
+{
+    constexpr char CMD[] = "seq 1 100000";
+    std::string expected_response;
+    std::string error = systemcall::system_call(CMD, &expected_response);
+    ASSERT_EQ(error, systemcall::ERROR_OK);
+
+    std::string response_str;
+    size_t num_chunks = 0;
+    int cmd_return_code = -1;
+    error = systemcall::system_call_stream(CMD,
+        [&response_str, &num_chunks](const char* data, size_t len)
+    {
+        EXPECT_GT(len, 0U);
+        EXPECT_LE(len, systemcall::STREAM_BUF_SIZE);
+        response_str.append(data, len);
+        num_chunks++;
+        return true;
+    }, &cmd_return_code);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(cmd_return_code, 0);
+    EXPECT_EQ(response_str, expected_response);
+    EXPECT_GT(num_chunks, 1U);
+}
+
+TEST(SystemCallStreamTest, Lines)
+{
+    std::vector<std::string> lines;
+    auto add_line = [&lines](std::string_view line)
+    {
+        lines.push_back(std::string(line));
+        return true;
+    };
+
+    // Empty lines, and a last line with no trailing newline
+    std::string error = systemcall::system_call_stream_lines("printf 'one\n\nthree\nfour'",
+        add_line);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(lines, (std::vector<std::string>{"one", "", "three", "four"}));
+
+    // Many lines, spanning many reads
+    lines.clear();
+    error = systemcall::system_call_stream_lines("seq 1 100000", add_line);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    ASSERT_EQ(lines.size(), 100000U);
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        ASSERT_EQ(lines[i], std::to_string(i + 1));
+    }
+
+    // No output at all
+    lines.clear();
+    error = systemcall::system_call_stream_lines("true", add_line);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_TRUE(lines.empty());
+}
+
+/// A line longer than the buffer is passed in buffer-sized pieces
+TEST(SystemCallStreamTest, LineLongerThanTheBuffer)
+{
+    constexpr size_t LINE_LEN = 2*systemcall::STREAM_BUF_SIZE + 100;
+    std::vector<size_t> line_lens;
+    std::string error = systemcall::system_call_stream_lines(
+        ("head -c " + std::to_string(LINE_LEN) + " /dev/zero | tr '\\0' x; echo; echo end").c_str(),
+        [&line_lens](std::string_view line)
+    {
+        line_lens.push_back(line.size());
+        return true;
+    });
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(line_lens, (std::vector<size_t>{systemcall::STREAM_BUF_SIZE,
+        systemcall::STREAM_BUF_SIZE, 100, 3}));
+}
+
+/// Each line is passed on as soon as the command writes it, not once the command finishes
+TEST(SystemCallStreamTest, LinesArriveAsTheyAreWritten)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> times_sec;
+    std::string error = systemcall::system_call_stream_lines("echo first; sleep 0.5; echo second",
+        [&start, &times_sec](std::string_view line)
+    {
+        (void)line;
+        times_sec.push_back(
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return true;
+    });
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    ASSERT_EQ(times_sec.size(), 2U);
+    EXPECT_LT(times_sec[0], 0.3);
+    EXPECT_GE(times_sec[1], 0.5);
+}
+
+/// Returning `false` stops the command early, without waiting for all of its output
+TEST(SystemCallStreamTest, StopEarly)
+{
+    size_t num_lines = 0;
+    // `yes` never ends on its own
+    std::string error = systemcall::system_call_stream_lines("yes",
+        [&num_lines](std::string_view line)
+    {
+        EXPECT_EQ(line, "y");
+        num_lines++;
+        return num_lines < 10;
+    });
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(num_lines, 10U);
+
+    error = systemcall::system_call_stream(nullptr, [](const char* data, size_t len)
+    {
+        (void)data;
+        (void)len;
+        return true;
+    });
+    EXPECT_EQ(error, "INVALID ARGUMENT: nullptr");
+}
+
+/// A command which stops writing, but doesn't exit, is killed rather than waited for: with
+/// `SIGTERM`, or with `SIGKILL` if it ignores `SIGTERM`
+TEST(SystemCallStreamTest, StopEarlyKillsACommandWhichDoesNotExit)
+{
+    struct TestCase
+    {
+        const char* cmd;
+        int signal;
+    };
+    const TestCase TEST_CASES[] = {
+        {"echo a; sleep 1000", SIGTERM},
+        {"trap '' TERM; echo a; sleep 1000", SIGKILL},
+    };
+
+    for (const TestCase& test_case : TEST_CASES)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int cmd_retcode = 0;
+        std::string error = systemcall::system_call_stream_lines(test_case.cmd,
+            [](std::string_view line)
+        {
+            EXPECT_EQ(line, "a");
+            return false;
+        }, &cmd_retcode);
+        double duration_sec =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        EXPECT_EQ(error, systemcall::ERROR_OK) << test_case.cmd;
+        EXPECT_TRUE(WIFSIGNALED(cmd_retcode)) << test_case.cmd;
+        EXPECT_EQ(WTERMSIG(cmd_retcode), test_case.signal) << test_case.cmd;
+        // Nowhere near the 1000 sec the command would take on its own
+        EXPECT_LT(duration_sec, 30) << test_case.cmd;
+    }
+}
+
+/// Same as `SystemCallTest.ListFile`, but with `system_call_spawn()`
+TEST(SystemCallSpawnTest, ListFile)
+{
+    std::string response_str;
+    int cmd_return_code;
+    const std::vector<std::string> ARGV = {"ls", "hello_world.cpp"};
+    const std::string EXPECTED_RESPONSE_STR = "hello_world.cpp\n";
+    std::string error;
+
+    error = systemcall::system_call_spawn(ARGV, &response_str, &cmd_return_code);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, EXPECTED_RESPONSE_STR);
+    EXPECT_EQ(cmd_return_code, 0);
+
+    // Again, to ensure the `response_str` is cleared and not just appended
+    error = systemcall::system_call_spawn(ARGV, &response_str, &cmd_return_code);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, EXPECTED_RESPONSE_STR);
+    EXPECT_EQ(cmd_return_code, 0);
+
+    // Without reading back the response
+    error = systemcall::system_call_spawn(ARGV);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+}
+
+/// Arguments are passed to the program as-is, with no shell to split or expand them
+TEST(SystemCallSpawnTest, NoShell)
+{
+    std::string response_str;
+    std::string error = systemcall::system_call_spawn({"echo", "a  b", "$HOME", "*"},
+        &response_str);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, "a  b $HOME *\n");
+}
+
+/// A failing command: its exit code and `stderr` are passed back
+TEST(SystemCallSpawnTest, CommandFails)
+{
+    std::string response_str = "old contents";
+    std::string stderr_str = "old contents";
+    int cmd_return_code = 0;
+    std::string error = systemcall::system_call_spawn({"ls", "this_file_does_not_exist"},
+        &response_str, &cmd_return_code, &stderr_str);
+    EXPECT_NE(error, systemcall::ERROR_OK);
+    EXPECT_EQ(response_str, "");
+    EXPECT_NE(stderr_str.find("this_file_does_not_exist"), std::string::npos);
+    EXPECT_EQ(WEXITSTATUS(cmd_return_code), 2);
+}
+
+TEST(SystemCallSpawnTest, InvalidArguments)
+{
+    std::string error = systemcall::system_call_spawn({});
+    EXPECT_EQ(error, "INVALID ARGUMENT: empty argv");
+
+    error = systemcall::system_call_spawn({"this_program_does_not_exist_12345"});
+    EXPECT_EQ(error.rfind("Failed to spawn", 0), 0U) << error;
+}
+
+/// Lots of output on both `stdout` and `stderr`, with `stderr` written first. This would deadlock
+/// if the pipes were read one at a time, `stdout` first.
+TEST(SystemCallSpawnTest, LargeOutputOnBothPipes)
+{
+    constexpr size_t NUM_BYTES = 1000000;
+    std::string response_str;
+    std::string stderr_str;
+    int cmd_return_code;
+    std::string error = systemcall::system_call_spawn({"sh", "-c",
+        "head -c 1000000 /dev/zero >&2; head -c 1000000 /dev/zero"},
+        &response_str, &cmd_return_code, &stderr_str);
+    EXPECT_EQ(error, systemcall::ERROR_OK);
+    EXPECT_EQ(cmd_return_code, 0);
+    EXPECT_EQ(response_str, std::string(NUM_BYTES, '\0'));
+    EXPECT_EQ(stderr_str, std::string(NUM_BYTES, '\0'));
+}
+
+/// Many more commands than the parallelism limit, each with its own output
+TEST(ProcessPoolTest, ManyCommandsWithFutures)
+{
+    constexpr size_t NUM_COMMANDS = 200;
+    systemcall::ProcessPool pool(16);
+    std::vector<std::future<systemcall::CommandResult>> futures;
+    for (size_t i = 0; i < NUM_COMMANDS; i++)
+    {
+        futures.push_back(pool.submit({"echo", std::to_string(i)}));
+    }
+    for (size_t i = 0; i < NUM_COMMANDS; i++)
+    {
+        systemcall::CommandResult result = futures[i].get();
+        EXPECT_EQ(result.error, systemcall::ERROR_OK);
+        EXPECT_EQ(result.response_str, std::to_string(i) + "\n");
+        EXPECT_EQ(result.stderr_str, "");
+        EXPECT_EQ(result.cmd_retcode, 0);
+    }
+}
+
+TEST(ProcessPoolTest, Callbacks)
+{
+    constexpr size_t NUM_COMMANDS = 50;
+    systemcall::ProcessPool pool(4);
+    std::mutex mutex;
+    std::vector<std::string> responses(NUM_COMMANDS);
+    for (size_t i = 0; i < NUM_COMMANDS; i++)
+    {
+        pool.submit({"echo", std::to_string(i)},
+            [i, &mutex, &responses](systemcall::CommandResult&& result)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            responses[i] = std::move(result.response_str);
+        });
+    }
+    pool.wait_all();
+    for (size_t i = 0; i < NUM_COMMANDS; i++)
+    {
+        EXPECT_EQ(responses[i], std::to_string(i) + "\n");
+    }
+}
+
+/// No more than `max_num_running` commands run at once, but that many do. Rather than timing the
+/// commands, which is flaky on a loaded machine, each command drops a marker file into a temporary
+/// dir while it runs, and counts the markers it sees there.
+TEST(ProcessPoolTest, RunsInParallelUpToTheLimit)
+{
+    constexpr size_t MAX_NUM_RUNNING = 3;
+    char dir_template[] = "/tmp/process_pool_test_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    ASSERT_NE(dir, nullptr);
+    const std::string running_dir = std::string(dir) + "/running";
+    const std::string started_dir = std::string(dir) + "/started";
+    ASSERT_EQ(mkdir(running_dir.c_str(), 0700), 0);
+    ASSERT_EQ(mkdir(started_dir.c_str(), 0700), 0);
+
+    // Never more than the limit: each command prints the number of commands running at once,
+    // itself included, and stays running a little while so that the others overlap it. It removes
+    // its marker before it exits, and so before the pool can start another command.
+    {
+        systemcall::ProcessPool pool(MAX_NUM_RUNNING);
+        std::vector<std::future<systemcall::CommandResult>> futures;
+        for (size_t i = 0; i < 4 * MAX_NUM_RUNNING; i++)
+        {
+            futures.push_back(pool.submit({"sh", "-c",
+                "touch $0/$$; ls $0 | wc -l; sleep 0.05; rm $0/$$", running_dir}));
+        }
+        for (std::future<systemcall::CommandResult>& future : futures)
+        {
+            systemcall::CommandResult result = future.get();
+            EXPECT_EQ(result.error, systemcall::ERROR_OK);
+            size_t num_running = std::stoul(result.response_str);
+            EXPECT_GE(num_running, 1U);
+            EXPECT_LE(num_running, MAX_NUM_RUNNING);
+        }
+    }
+
+    // But that many at once: exactly the limit's worth of commands, each of which waits (for up to
+    // 10 sec) until all of them have started, so they only all finish quickly if they all run at
+    // once, and print a lower count if they don't
+    {
+        systemcall::ProcessPool pool(MAX_NUM_RUNNING);
+        std::vector<std::future<systemcall::CommandResult>> futures;
+        for (size_t i = 0; i < MAX_NUM_RUNNING; i++)
+        {
+            futures.push_back(pool.submit({"sh", "-c",
+                "touch $0/$$; i=0; "
+                "while [ $(ls $0 | wc -l) -lt $1 ] && [ $i -lt 1000 ]; do "
+                "sleep 0.01; i=$((i+1)); done; "
+                "ls $0 | wc -l",
+                started_dir, std::to_string(MAX_NUM_RUNNING)}));
+        }
+        for (std::future<systemcall::CommandResult>& future : futures)
+        {
+            systemcall::CommandResult result = future.get();
+            EXPECT_EQ(result.error, systemcall::ERROR_OK);
+            EXPECT_EQ(std::stoul(result.response_str), MAX_NUM_RUNNING);
+        }
+    }
+
+    EXPECT_EQ(systemcall::system_call(("rm -r " + std::string(dir)).c_str()),
+        systemcall::ERROR_OK);
+}
+
+TEST(ProcessPoolTest, ErrorsArePassedBack)
+{
+    systemcall::ProcessPool pool(4);
+    std::future<systemcall::CommandResult> fails = pool.submit({"ls", "this_file_does_not_exist"});
+    std::future<systemcall::CommandResult> not_found =
+        pool.submit({"this_program_does_not_exist_12345"});
+    std::future<systemcall::CommandResult> empty = pool.submit({});
+
+    systemcall::CommandResult result = fails.get();
+    EXPECT_NE(result.error, systemcall::ERROR_OK);
+    EXPECT_EQ(result.response_str, "");
+    EXPECT_NE(result.stderr_str.find("this_file_does_not_exist"), std::string::npos);
+    EXPECT_EQ(WEXITSTATUS(result.cmd_retcode), 2);
+
+    result = not_found.get();
+    EXPECT_EQ(result.error.rfind("Failed to spawn", 0), 0U) << result.error;
+    EXPECT_EQ(result.cmd_retcode, -1);
+
+    result = empty.get();
+    EXPECT_EQ(result.error, "INVALID ARGUMENT: empty argv");
+    EXPECT_EQ(result.cmd_retcode, -1);
+}
+
+/// Several commands at once, each writing lots of output to both pipes, so that all of them
+/// block on full pipes unless every pipe is read
+TEST(ProcessPoolTest, LargeOutputOnBothPipes)
+{
+    constexpr size_t NUM_BYTES = 1000000;
+    systemcall::ProcessPool pool(4);
+    std::vector<std::future<systemcall::CommandResult>> futures;
+    for (size_t i = 0; i < 8; i++)
+    {
+        futures.push_back(pool.submit({"sh", "-c",
+            "head -c 1000000 /dev/zero >&2; head -c 1000000 /dev/zero"}));
+    }
+    for (std::future<systemcall::CommandResult>& future : futures)
+    {
+        systemcall::CommandResult result = future.get();
+        EXPECT_EQ(result.error, systemcall::ERROR_OK);
+        EXPECT_EQ(result.cmd_retcode, 0);
+        EXPECT_EQ(result.response_str, std::string(NUM_BYTES, '\0'));
+        EXPECT_EQ(result.stderr_str, std::string(NUM_BYTES, '\0'));
+    }
+}
+
+/// A callback may queue up more commands, and the destructor waits for all of them
+TEST(ProcessPoolTest, DestructorWaitsForAllCommands)
+{
+    std::atomic<size_t> num_done{0};
+    {
+        systemcall::ProcessPool pool(2);
+        for (size_t i = 0; i < 4; i++)
+        {
+            pool.submit({"sleep", "0.05"}, [&pool, &num_done](systemcall::CommandResult&& result)
+            {
+                EXPECT_EQ(result.error, systemcall::ERROR_OK);
+                num_done++;
+                pool.submit({"true"}, [&num_done](systemcall::CommandResult&& result)
+                {
+                    EXPECT_EQ(result.error, systemcall::ERROR_OK);
+                    num_done++;
+                });
+            });
+        }
+    }
+    EXPECT_EQ(num_done, 8U);
+}
+
 } // anonymous namespace
 
 
@@ -110,20 +519,63 @@ SAMPLE OUTPUT:
     user    0m1.481s
     sys 0m0.107s
     Running main() from googletest/googletest/src/gtest_main.cc
-    [==========] Running 1 test from 1 test suite.
+    [==========] Running 18 tests from 4 test suites.
     [----------] Global test environment set-up.
     [----------] 1 test from SystemCallTest
     [ RUN      ] SystemCallTest.ListFile
-    [       OK ] SystemCallTest.ListFile (3 ms)
-    [----------] 1 test from SystemCallTest (3 ms total)
+    [       OK ] SystemCallTest.ListFile (4 ms)
+    [----------] 1 test from SystemCallTest (4 ms total)
+
+    [----------] 6 tests from SystemCallStreamTest
+    [ RUN      ] SystemCallStreamTest.ChunksMatchSystemCall
+    [       OK ] SystemCallStreamTest.ChunksMatchSystemCall (6 ms)
+    [ RUN      ] SystemCallStreamTest.Lines
+    [       OK ] SystemCallStreamTest.Lines (11 ms)
+    [ RUN      ] SystemCallStreamTest.LineLongerThanTheBuffer
+    [       OK ] SystemCallStreamTest.LineLongerThanTheBuffer (2 ms)
+    [ RUN      ] SystemCallStreamTest.LinesArriveAsTheyAreWritten
+    [       OK ] SystemCallStreamTest.LinesArriveAsTheyAreWritten (502 ms)
+    [ RUN      ] SystemCallStreamTest.StopEarly
+    [       OK ] SystemCallStreamTest.StopEarly (2 ms)
+    [ RUN      ] SystemCallStreamTest.StopEarlyKillsACommandWhichDoesNotExit
+    [       OK ] SystemCallStreamTest.StopEarlyKillsACommandWhichDoesNotExit (1083 ms)
+    [----------] 6 tests from SystemCallStreamTest (1609 ms total)
+
+    [----------] 5 tests from SystemCallSpawnTest
+    [ RUN      ] SystemCallSpawnTest.ListFile
+    [       OK ] SystemCallSpawnTest.ListFile (2 ms)
+    [ RUN      ] SystemCallSpawnTest.NoShell
+    [       OK ] SystemCallSpawnTest.NoShell (0 ms)
+    [ RUN      ] SystemCallSpawnTest.CommandFails
+    [       OK ] SystemCallSpawnTest.CommandFails (0 ms)
+    [ RUN      ] SystemCallSpawnTest.InvalidArguments
+    [       OK ] SystemCallSpawnTest.InvalidArguments (0 ms)
+    [ RUN      ] SystemCallSpawnTest.LargeOutputOnBothPipes
+    [       OK ] SystemCallSpawnTest.LargeOutputOnBothPipes (4 ms)
+    [----------] 5 tests from SystemCallSpawnTest (8 ms total)
+
+    [----------] 6 tests from ProcessPoolTest
+    [ RUN      ] ProcessPoolTest.ManyCommandsWithFutures
+    [       OK ] ProcessPoolTest.ManyCommandsWithFutures (107 ms)
+    [ RUN      ] ProcessPoolTest.Callbacks
+    [       OK ] ProcessPoolTest.Callbacks (27 ms)
+    [ RUN      ] ProcessPoolTest.RunsInParallelUpToTheLimit
+    [       OK ] ProcessPoolTest.RunsInParallelUpToTheLimit (262 ms)
+    [ RUN      ] ProcessPoolTest.ErrorsArePassedBack
+    [       OK ] ProcessPoolTest.ErrorsArePassedBack (1 ms)
+    [ RUN      ] ProcessPoolTest.LargeOutputOnBothPipes
+    [       OK ] ProcessPoolTest.LargeOutputOnBothPipes (32 ms)
+    [ RUN      ] ProcessPoolTest.DestructorWaitsForAllCommands
+    [       OK ] ProcessPoolTest.DestructorWaitsForAllCommands (105 ms)
+    [----------] 6 tests from ProcessPoolTest (535 ms total)
 
     [----------] Global test environment tear-down
-    [==========] 1 test from 1 test suite ran. (3 ms total)
-    [  PASSED  ] 1 test.
+    [==========] 18 tests from 4 test suites ran. (2158 ms total)
+    [  PASSED  ] 18 tests.
 
-    real    0m0.005s
-    user    0m0.005s
-    sys 0m0.000s
+    real    0m2.163s
+    user    0m0.252s
+    sys 0m0.089s
 
     real    0m1.651s
     user    0m1.485s